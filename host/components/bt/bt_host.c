@@ -0,0 +1,185 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_log.h"
+#include "esp_bt.h"
+#include "esp_bt_main.h"
+#include "esp_bt_device.h"
+#include "esp_gap_bt_api.h"
+
+// Controller, Bluedroid and GAP stand-ins. Pairing is implicit: the scripted phone in
+// fake_phone.c behaves as an already bonded device, so no GAP events are raised.
+
+static const char *TAG = "bt_host";
+
+static const esp_bd_addr_t local_address = { 0x24, 0x0a, 0xc4, 0x00, 0x00, 0x01 };
+
+static bool controller_initialized;
+static bool controller_enabled;
+static bool bluedroid_initialized;
+static bool bluedroid_enabled;
+static esp_bt_gap_cb_t gap_callback;
+
+esp_err_t esp_bt_controller_mem_release(esp_bt_mode_t mode)
+{
+    (void)mode;
+    return controller_initialized ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+esp_err_t esp_bt_controller_init(esp_bt_controller_config_t *cfg)
+{
+    if (!cfg || cfg->magic != ESP_BT_CONTROLLER_CONFIG_MAGIC_VAL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (controller_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    controller_initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_bt_controller_deinit(void)
+{
+    if (!controller_initialized || controller_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    controller_initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_bt_controller_enable(esp_bt_mode_t mode)
+{
+    if (!controller_initialized || controller_enabled || mode == ESP_BT_MODE_IDLE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    controller_enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_bt_controller_disable(void)
+{
+    if (!controller_enabled || bluedroid_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    controller_enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_bluedroid_init(void)
+{
+    if (!controller_enabled || bluedroid_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    bluedroid_initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_bluedroid_deinit(void)
+{
+    if (!bluedroid_initialized || bluedroid_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    bluedroid_initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_bluedroid_enable(void)
+{
+    if (!bluedroid_initialized || bluedroid_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    bluedroid_enabled = true;
+    ESP_LOGI(TAG, "Bluedroid stand-in enabled");
+    return ESP_OK;
+}
+
+esp_err_t esp_bluedroid_disable(void)
+{
+    if (!bluedroid_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    bluedroid_enabled = false;
+    return ESP_OK;
+}
+
+// Used by fake_phone.c, which needs the stack up before it can connect
+bool bt_host_bluedroid_enabled(void)
+{
+    return bluedroid_enabled;
+}
+
+const uint8_t *esp_bt_dev_get_address(void)
+{
+    return bluedroid_enabled ? local_address : NULL;
+}
+
+esp_err_t esp_bt_gap_register_callback(esp_bt_gap_cb_t callback)
+{
+    if (!bluedroid_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    gap_callback = callback;
+    return ESP_OK;
+}
+
+esp_err_t esp_bt_gap_set_security_param(esp_bt_sp_param_t param_type, void *value, uint8_t len)
+{
+    (void)param_type;
+    return (bluedroid_enabled && value && len > 0) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_bt_gap_set_pin(esp_bt_pin_type_t pin_type, uint8_t pin_code_len, esp_bt_pin_code_t pin_code)
+{
+    (void)pin_type;
+    (void)pin_code;
+    if (pin_code_len > ESP_BT_PIN_CODE_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return bluedroid_enabled ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_bt_gap_pin_reply(esp_bd_addr_t bd_addr, bool accept, uint8_t pin_code_len, esp_bt_pin_code_t pin_code)
+{
+    (void)bd_addr;
+    (void)accept;
+    (void)pin_code_len;
+    (void)pin_code;
+    return bluedroid_enabled ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_bt_gap_ssp_confirm_reply(esp_bd_addr_t bd_addr, bool accept)
+{
+    (void)bd_addr;
+    (void)accept;
+    return bluedroid_enabled ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_bt_gap_ssp_passkey_reply(esp_bd_addr_t bd_addr, bool accept, uint32_t passkey)
+{
+    (void)bd_addr;
+    (void)accept;
+    (void)passkey;
+    return bluedroid_enabled ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_bt_gap_set_cod(esp_bt_cod_t cod, esp_bt_cod_mode_t mode)
+{
+    (void)cod;
+    (void)mode;
+    return bluedroid_enabled ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_bt_gap_set_scan_mode(esp_bt_connection_mode_t c_mode, esp_bt_discovery_mode_t d_mode)
+{
+    (void)c_mode;
+    (void)d_mode;
+    return bluedroid_enabled ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_bt_gap_set_device_name(const char *name)
+{
+    if (!bluedroid_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ESP_LOGI(TAG, "Device name: %s", name);
+    return ESP_OK;
+}
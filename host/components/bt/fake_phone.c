@@ -0,0 +1,611 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_hf_client_api.h"
+#include "fake_phone.h"
+
+static const char *TAG = "fake_phone";
+
+#define FAKE_PHONE_TASK_STACK 4096
+#define FAKE_PHONE_TASK_PRIORITY 10 // Above the firmware's tasks, like the Bluedroid task
+#define FAKE_PHONE_QUEUE_LEN 8
+#define FAKE_PHONE_MAX_STEPS 16
+#define FAKE_PHONE_SCRIPT_MAX 128
+#define FAKE_PHONE_NUMBER_MAX 32
+#define FAKE_PHONE_MEMORY_SLOTS 9 // ATD>n; dials 555010n
+
+#define FAKE_PHONE_CONNECT_MS_DEFAULT 500
+#define FAKE_PHONE_RING_MS_DEFAULT 2000
+#define FAKE_PHONE_TALK_MS_DEFAULT 5000
+#define FAKE_PHONE_AWAY_MS_DEFAULT 10000
+#define FAKE_PHONE_PAGE_TIMEOUT_MS 1280 // Page to failure while out of range (real phones: ~5 s)
+#define FAKE_PHONE_AT_MS 30        // ATD to OK/ERROR
+#define FAKE_PHONE_DIALING_MS 80   // ATD to callsetup=2
+#define FAKE_PHONE_ALERTING_MS 400 // ATD to callsetup=3
+#define FAKE_PHONE_BUSY_MS 1500    // Alerting to idle for a busy line
+
+bool bt_host_bluedroid_enabled(void);
+
+static const esp_bd_addr_t phone_bda = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+
+typedef enum {
+    OUTCOME_ANSWER,
+    OUTCOME_NO_ANSWER,
+    OUTCOME_BUSY,
+    OUTCOME_ERROR,
+    OUTCOME_DROP,
+    OUTCOME_LOST,
+} outcome_t;
+
+typedef enum {
+    CMD_DIAL,
+    CMD_LINK,
+    CMD_CONNECT,
+    CMD_SCRIPT,
+    CMD_QUERY_CALLS,
+    CMD_HANGUP,
+} cmd_type_t;
+
+typedef struct {
+    cmd_type_t type;
+    bool redial;  // CMD_DIAL: number is empty and the last number is used
+    int memory;   // CMD_DIAL: memory location to dial instead of number; 0 if none
+    bool up;      // CMD_LINK
+    bool ours;    // CMD_CONNECT: paged at the phone's address
+    char *script; // CMD_SCRIPT, freed by the phone task
+    char number[FAKE_PHONE_NUMBER_MAX];
+} phone_cmd_t;
+
+typedef enum {
+    STEP_LINK_UP,
+    STEP_LINK_DOWN,
+    STEP_CONNECT_FAILED,
+    STEP_AT_RESPONSE,
+    STEP_CALL_SETUP,
+    STEP_CALL,
+    STEP_CLCC,
+} step_type_t;
+
+typedef struct {
+    bool used;
+    bool ends_call; // The phone is free for the next dial once this step has run
+    bool call_step; // Cancelled when the link drops
+    step_type_t type;
+    int value;
+    int cme;
+    TickType_t due;
+    uint32_t order; // Steps due on the same tick run in the order they were scheduled
+} phone_step_t;
+
+typedef struct {
+    uint32_t connect_ms;
+    uint32_t ring_ms;
+    uint32_t talk_ms;
+    uint32_t away_ms;
+} phone_timing_t;
+
+static QueueHandle_t cmd_queue;
+static SemaphoreHandle_t stats_lock;
+static esp_hf_client_cb_t hf_callback;
+static bool hf_initialized;
+static bool task_started;
+static phone_timing_t timing;
+static fake_phone_stats_t stats;
+
+// Phone task state
+static phone_step_t steps[FAKE_PHONE_MAX_STEPS];
+static uint32_t next_order;
+static bool link_up;
+static bool in_call;
+static bool call_active;                             // As last reported by the indicators
+static esp_hf_call_setup_status_t call_setup;
+static TickType_t back_in_range; // Pages fail until then, after a "lost" outcome
+static char script[FAKE_PHONE_SCRIPT_MAX] = "answer";
+static const char *script_pos = script;
+static char last_number[FAKE_PHONE_NUMBER_MAX];
+
+static uint32_t env_ms(const char *name, uint32_t fallback)
+{
+    const char *value = getenv(name);
+    return (value && value[0] != '\0') ? (uint32_t)strtoul(value, NULL, 10) : fallback;
+}
+
+static void count(uint32_t *counter)
+{
+    xSemaphoreTake(stats_lock, portMAX_DELAY);
+    (*counter)++;
+    xSemaphoreGive(stats_lock);
+}
+
+// Take the next outcome from the script, wrapping around at the end
+static outcome_t next_outcome(void)
+{
+    if (*script_pos == '\0') {
+        script_pos = script;
+    }
+    const char *comma = strchr(script_pos, ',');
+    size_t len = comma ? (size_t)(comma - script_pos) : strlen(script_pos);
+    char word[16] = {0};
+    memcpy(word, script_pos, len < sizeof(word) - 1 ? len : sizeof(word) - 1);
+    script_pos += len + (comma ? 1 : 0);
+
+    if (strcmp(word, "noanswer") == 0) return OUTCOME_NO_ANSWER;
+    if (strcmp(word, "busy") == 0) return OUTCOME_BUSY;
+    if (strcmp(word, "error") == 0) return OUTCOME_ERROR;
+    if (strcmp(word, "drop") == 0) return OUTCOME_DROP;
+    if (strcmp(word, "lost") == 0) return OUTCOME_LOST;
+    if (strcmp(word, "answer") != 0) {
+        ESP_LOGW(TAG, "Unknown script outcome '%s', answering", word);
+    }
+    return OUTCOME_ANSWER;
+}
+
+static phone_step_t *schedule(uint32_t delay_ms, step_type_t type, int value, bool call_step, bool ends_call)
+{
+    for (int i = 0; i < FAKE_PHONE_MAX_STEPS; i++) {
+        if (!steps[i].used) {
+            steps[i] = (phone_step_t){
+                .used = true,
+                .ends_call = ends_call,
+                .call_step = call_step,
+                .type = type,
+                .value = value,
+                .due = xTaskGetTickCount() + pdMS_TO_TICKS(delay_ms),
+                .order = next_order++,
+            };
+            return &steps[i];
+        }
+    }
+    ESP_LOGE(TAG, "Step table full, dropping step %d", type);
+    return NULL;
+}
+
+static void schedule_at_error(uint32_t delay_ms, esp_hf_cme_err_t cme)
+{
+    phone_step_t *step = schedule(delay_ms, STEP_AT_RESPONSE, ESP_HF_AT_RESPONSE_CODE_ERR, false, false);
+    if (step) {
+        step->cme = cme;
+    }
+}
+
+// Whether step a runs before step b; tick counts may wrap
+static bool runs_before(const phone_step_t *a, const phone_step_t *b)
+{
+    if (a->due != b->due) {
+        return (TickType_t)(b->due - a->due) < portMAX_DELAY / 2;
+    }
+    return (int32_t)(b->order - a->order) > 0;
+}
+
+static void deliver(esp_hf_client_cb_event_t event, esp_hf_client_cb_param_t *param)
+{
+    if (hf_callback) {
+        hf_callback(event, param);
+    }
+}
+
+static void handle_dial(const phone_cmd_t *cmd)
+{
+    count(&stats.dials);
+    if (!link_up) {
+        // Bluedroid drops commands without a service level connection; nothing comes back
+        ESP_LOGW(TAG, "Dial ignored: no service level connection");
+        return;
+    }
+    if (in_call) {
+        count(&stats.rejected);
+        schedule_at_error(FAKE_PHONE_AT_MS, ESP_HF_CME_OPERATION_NOT_ALLOWED);
+        return;
+    }
+    if (cmd->redial && last_number[0] == '\0') {
+        count(&stats.rejected);
+        schedule_at_error(FAKE_PHONE_AT_MS, ESP_HF_CME_AG_FAILURE); // Nothing to redial
+        return;
+    }
+    if (cmd->memory > FAKE_PHONE_MEMORY_SLOTS) {
+        count(&stats.rejected);
+        schedule_at_error(FAKE_PHONE_AT_MS, ESP_HF_CME_INVALID_INDEX); // Empty location
+        return;
+    }
+    if (cmd->memory > 0) {
+        snprintf(last_number, sizeof(last_number), "555010%d", cmd->memory);
+    } else if (!cmd->redial) {
+        memcpy(last_number, cmd->number, sizeof(last_number));
+    }
+
+    outcome_t outcome = next_outcome();
+    ESP_LOGI(TAG, "%s %s -> outcome %d", cmd->memory > 0 ? "Memory dialing" : cmd->redial ? "Redialing" : "Dialing",
+             last_number, outcome);
+    if (outcome == OUTCOME_ERROR) {
+        count(&stats.rejected);
+        schedule_at_error(FAKE_PHONE_AT_MS, ESP_HF_CME_NO_NETWORK_SERVICE);
+        return;
+    }
+
+    in_call = true;
+    schedule(FAKE_PHONE_AT_MS, STEP_AT_RESPONSE, ESP_HF_AT_RESPONSE_CODE_OK, false, false);
+    schedule(FAKE_PHONE_DIALING_MS, STEP_CALL_SETUP, ESP_HF_CALL_SETUP_STATUS_OUTGOING_DIALING, true, false);
+    schedule(FAKE_PHONE_ALERTING_MS, STEP_CALL_SETUP, ESP_HF_CALL_SETUP_STATUS_OUTGOING_ALERTING, true, false);
+
+    uint32_t ringing_end = FAKE_PHONE_ALERTING_MS + timing.ring_ms;
+    switch (outcome) {
+        case OUTCOME_ANSWER:
+            // A phone raises call=1 before it clears callsetup
+            schedule(ringing_end, STEP_CALL, ESP_HF_CALL_STATUS_CALL_IN_PROGRESS, true, false);
+            schedule(ringing_end, STEP_CALL_SETUP, ESP_HF_CALL_SETUP_STATUS_IDLE, true, false);
+            schedule(ringing_end + timing.talk_ms, STEP_CALL, ESP_HF_CALL_STATUS_NO_CALLS, true, true);
+            break;
+        case OUTCOME_NO_ANSWER:
+            schedule(ringing_end, STEP_CALL_SETUP, ESP_HF_CALL_SETUP_STATUS_IDLE, true, true);
+            break;
+        case OUTCOME_BUSY:
+            schedule(FAKE_PHONE_ALERTING_MS + FAKE_PHONE_BUSY_MS, STEP_CALL_SETUP,
+                     ESP_HF_CALL_SETUP_STATUS_IDLE, true, true);
+            break;
+        case OUTCOME_DROP:
+            schedule(FAKE_PHONE_ALERTING_MS + timing.ring_ms / 2, STEP_LINK_DOWN, 0, true, true);
+            schedule(FAKE_PHONE_ALERTING_MS + timing.ring_ms / 2 + timing.connect_ms, STEP_LINK_UP, 0, false, false);
+            break;
+        case OUTCOME_LOST:
+            // value 1: out of range, so the link stays down until paged after away_ms
+            schedule(FAKE_PHONE_ALERTING_MS + timing.ring_ms / 2, STEP_LINK_DOWN, 1, true, true);
+            break;
+        default:
+            break;
+    }
+}
+
+// One +CLCC line for the call, if there is one, followed by OK
+static void handle_query_calls(void)
+{
+    count(&stats.queries);
+    if (!link_up) {
+        ESP_LOGW(TAG, "Call list query ignored: no service level connection");
+        return;
+    }
+    schedule(FAKE_PHONE_AT_MS, STEP_CLCC, 0, false, false);
+    schedule(FAKE_PHONE_AT_MS, STEP_AT_RESPONSE, ESP_HF_AT_RESPONSE_CODE_OK, false, false);
+}
+
+static void handle_hangup(void)
+{
+    count(&stats.hangups);
+    if (!link_up) {
+        ESP_LOGW(TAG, "Hang-up ignored: no service level connection");
+        return;
+    }
+    if (!in_call) {
+        count(&stats.rejected);
+        schedule_at_error(FAKE_PHONE_AT_MS, ESP_HF_CME_OPERATION_NOT_ALLOWED); // Nothing to end
+        return;
+    }
+    for (int i = 0; i < FAKE_PHONE_MAX_STEPS; i++) {
+        if (steps[i].call_step) {
+            steps[i].used = false; // The rest of the scripted call never happens
+        }
+    }
+    in_call = false;
+    ESP_LOGI(TAG, "Hanging up %s", last_number);
+    schedule(FAKE_PHONE_AT_MS, STEP_AT_RESPONSE, ESP_HF_AT_RESPONSE_CODE_OK, false, false);
+    if (call_active) {
+        schedule(FAKE_PHONE_AT_MS, STEP_CALL, ESP_HF_CALL_STATUS_NO_CALLS, false, false);
+    } else {
+        schedule(FAKE_PHONE_AT_MS, STEP_CALL_SETUP, ESP_HF_CALL_SETUP_STATUS_IDLE, false, false);
+    }
+}
+
+static void run_step(const phone_step_t *step)
+{
+    esp_hf_client_cb_param_t param;
+    memset(&param, 0, sizeof(param));
+
+    switch (step->type) {
+        case STEP_LINK_UP:
+            if (link_up) {
+                return;
+            }
+            link_up = true;
+            count(&stats.connects);
+            // RFCOMM first, then the service level connection and the initial indicators
+            param.conn_stat.state = ESP_HF_CLIENT_CONNECTION_STATE_CONNECTED;
+            memcpy(param.conn_stat.remote_bda, phone_bda, sizeof(phone_bda));
+            deliver(ESP_HF_CLIENT_CONNECTION_STATE_EVT, &param);
+            param.conn_stat.state = ESP_HF_CLIENT_CONNECTION_STATE_SLC_CONNECTED;
+            deliver(ESP_HF_CLIENT_CONNECTION_STATE_EVT, &param);
+            memset(&param, 0, sizeof(param));
+            param.service_availability.status = ESP_HF_SERVICE_AVAILABILITY_STATUS_AVAILABLE;
+            deliver(ESP_HF_CLIENT_CIND_SERVICE_AVAILABILITY_EVT, &param);
+            memset(&param, 0, sizeof(param));
+            param.call.status = ESP_HF_CALL_STATUS_NO_CALLS;
+            deliver(ESP_HF_CLIENT_CIND_CALL_EVT, &param);
+            memset(&param, 0, sizeof(param));
+            param.call_setup.status = ESP_HF_CALL_SETUP_STATUS_IDLE;
+            deliver(ESP_HF_CLIENT_CIND_CALL_SETUP_EVT, &param);
+            break;
+        case STEP_LINK_DOWN:
+            if (!link_up) {
+                return;
+            }
+            link_up = false;
+            in_call = false;
+            call_active = false;
+            call_setup = ESP_HF_CALL_SETUP_STATUS_IDLE;
+            if (step->value) {
+                back_in_range = xTaskGetTickCount() + pdMS_TO_TICKS(timing.away_ms);
+            }
+            for (int i = 0; i < FAKE_PHONE_MAX_STEPS; i++) {
+                if (steps[i].call_step) {
+                    steps[i].used = false; // Indicators of the lost call never arrive
+                }
+            }
+            param.conn_stat.state = ESP_HF_CLIENT_CONNECTION_STATE_DISCONNECTED;
+            memcpy(param.conn_stat.remote_bda, phone_bda, sizeof(phone_bda));
+            deliver(ESP_HF_CLIENT_CONNECTION_STATE_EVT, &param);
+            break;
+        case STEP_CONNECT_FAILED:
+            if (link_up) {
+                return; // The phone connected by itself in the meantime
+            }
+            param.conn_stat.state = ESP_HF_CLIENT_CONNECTION_STATE_DISCONNECTED;
+            deliver(ESP_HF_CLIENT_CONNECTION_STATE_EVT, &param);
+            break;
+        case STEP_AT_RESPONSE:
+            param.at_response.code = (esp_hf_at_response_code_t)step->value;
+            param.at_response.cme = (esp_hf_cme_err_t)step->cme;
+            deliver(ESP_HF_CLIENT_AT_RESPONSE_EVT, &param);
+            break;
+        case STEP_CALL_SETUP:
+            call_setup = (esp_hf_call_setup_status_t)step->value;
+            param.call_setup.status = (esp_hf_call_setup_status_t)step->value;
+            deliver(ESP_HF_CLIENT_CIND_CALL_SETUP_EVT, &param);
+            break;
+        case STEP_CALL:
+            if (step->value == ESP_HF_CALL_STATUS_CALL_IN_PROGRESS) {
+                count(&stats.answered);
+            }
+            call_active = step->value == ESP_HF_CALL_STATUS_CALL_IN_PROGRESS;
+            param.call.status = (esp_hf_call_status_t)step->value;
+            deliver(ESP_HF_CLIENT_CIND_CALL_EVT, &param);
+            break;
+        case STEP_CLCC:
+            if (call_active) {
+                param.clcc.status = ESP_HF_CURRENT_CALL_STATUS_ACTIVE;
+            } else if (call_setup == ESP_HF_CALL_SETUP_STATUS_OUTGOING_DIALING) {
+                param.clcc.status = ESP_HF_CURRENT_CALL_STATUS_DIALING;
+            } else if (call_setup == ESP_HF_CALL_SETUP_STATUS_OUTGOING_ALERTING) {
+                param.clcc.status = ESP_HF_CURRENT_CALL_STATUS_ALERTING;
+            } else {
+                return; // No calls: the OK alone answers
+            }
+            param.clcc.idx = 1;
+            param.clcc.dir = ESP_HF_CURRENT_CALL_DIRECTION_OUTGOING;
+            param.clcc.mpty = ESP_HF_CURRENT_CALL_MPTY_TYPE_SINGLE;
+            param.clcc.number = last_number;
+            deliver(ESP_HF_CLIENT_CLCC_EVT, &param);
+            break;
+    }
+    if (step->ends_call) {
+        in_call = false;
+    }
+}
+
+static void handle_command(phone_cmd_t *cmd)
+{
+    TickType_t away_left;
+    switch (cmd->type) {
+        case CMD_DIAL:
+            handle_dial(cmd);
+            break;
+        case CMD_QUERY_CALLS:
+            handle_query_calls();
+            break;
+        case CMD_HANGUP:
+            handle_hangup();
+            break;
+        case CMD_LINK:
+            schedule(0, cmd->up ? STEP_LINK_UP : STEP_LINK_DOWN, 0, false, false);
+            break;
+        case CMD_CONNECT:
+            count(&stats.pages);
+            if (link_up) {
+                break;
+            }
+            away_left = back_in_range - xTaskGetTickCount();
+            // Tick counts may wrap, as in runs_before()
+            if (cmd->ours && (away_left == 0 || away_left > portMAX_DELAY / 2)) {
+                schedule(timing.connect_ms, STEP_LINK_UP, 0, false, false);
+            } else {
+                schedule(FAKE_PHONE_PAGE_TIMEOUT_MS, STEP_CONNECT_FAILED, 0, false, false);
+            }
+            break;
+        case CMD_SCRIPT:
+            strncpy(script, cmd->script, sizeof(script) - 1);
+            script[sizeof(script) - 1] = '\0';
+            script_pos = script;
+            free(cmd->script);
+            break;
+    }
+}
+
+// Stands in for the phone and the Bluedroid task: commands come in on the queue and
+// events go out through the registered callback, in due order
+static void fake_phone_task(void *arg)
+{
+    (void)arg;
+    schedule(timing.connect_ms, STEP_LINK_UP, 0, false, false);
+
+    while (1) {
+        TickType_t now = xTaskGetTickCount();
+        int next = -1;
+        for (int i = 0; i < FAKE_PHONE_MAX_STEPS; i++) {
+            if (steps[i].used && (next < 0 || runs_before(&steps[i], &steps[next]))) {
+                next = i;
+            }
+        }
+
+        TickType_t wait = portMAX_DELAY;
+        if (next >= 0) {
+            TickType_t remaining = steps[next].due - now;
+            wait = remaining > portMAX_DELAY / 2 ? 0 : remaining; // Already due if it wrapped
+        }
+
+        phone_cmd_t cmd;
+        if (xQueueReceive(cmd_queue, &cmd, wait) == pdTRUE) {
+            handle_command(&cmd);
+            continue;
+        }
+        if (next >= 0) {
+            phone_step_t step = steps[next];
+            steps[next].used = false;
+            run_step(&step);
+        }
+    }
+}
+
+static esp_err_t start_phone(void)
+{
+    if (task_started) {
+        return ESP_OK;
+    }
+    if (xTaskCreate(fake_phone_task, "fake_phone", FAKE_PHONE_TASK_STACK, NULL,
+                    FAKE_PHONE_TASK_PRIORITY, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    task_started = true;
+    ESP_LOGI(TAG, "Phone connects in %lu ms, script \"%s\"", (unsigned long)timing.connect_ms, script);
+    return ESP_OK;
+}
+
+static esp_err_t send_command(const phone_cmd_t *cmd)
+{
+    if (!cmd_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return xQueueSend(cmd_queue, cmd, portMAX_DELAY) == pdTRUE ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_hf_client_init(void)
+{
+    if (!bt_host_bluedroid_enabled() || hf_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    timing.connect_ms = env_ms("REMOTEHEAD_FAKE_PHONE_CONNECT_MS", FAKE_PHONE_CONNECT_MS_DEFAULT);
+    timing.ring_ms = env_ms("REMOTEHEAD_FAKE_PHONE_RING_MS", FAKE_PHONE_RING_MS_DEFAULT);
+    timing.talk_ms = env_ms("REMOTEHEAD_FAKE_PHONE_TALK_MS", FAKE_PHONE_TALK_MS_DEFAULT);
+    timing.away_ms = env_ms("REMOTEHEAD_FAKE_PHONE_AWAY_MS", FAKE_PHONE_AWAY_MS_DEFAULT);
+    back_in_range = xTaskGetTickCount();
+    const char *env_script = getenv("REMOTEHEAD_FAKE_PHONE_SCRIPT");
+    if (env_script && env_script[0] != '\0') {
+        strncpy(script, env_script, sizeof(script) - 1);
+    }
+
+    cmd_queue = xQueueCreate(FAKE_PHONE_QUEUE_LEN, sizeof(phone_cmd_t));
+    stats_lock = xSemaphoreCreateMutex();
+    if (!cmd_queue || !stats_lock) {
+        return ESP_ERR_NO_MEM;
+    }
+    hf_initialized = true;
+    return hf_callback ? start_phone() : ESP_OK;
+}
+
+esp_err_t esp_hf_client_deinit(void)
+{
+    return ESP_ERR_NOT_SUPPORTED; // The firmware never tears the HFP client down
+}
+
+esp_err_t esp_hf_client_register_callback(esp_hf_client_cb_t callback)
+{
+    if (!callback) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    hf_callback = callback;
+    // The phone only connects once someone is listening for the events
+    return hf_initialized ? start_phone() : ESP_OK;
+}
+
+esp_err_t esp_hf_client_connect(esp_bd_addr_t remote_bda)
+{
+    if (!hf_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    phone_cmd_t cmd = { .type = CMD_CONNECT, .ours = memcmp(remote_bda, phone_bda, sizeof(phone_bda)) == 0 };
+    return send_command(&cmd);
+}
+
+esp_err_t esp_hf_client_disconnect(esp_bd_addr_t remote_bda)
+{
+    (void)remote_bda;
+    fake_phone_set_link(false);
+    return hf_initialized ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_hf_client_dial(const char *number)
+{
+    if (!hf_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    phone_cmd_t cmd = { .type = CMD_DIAL, .redial = (number == NULL || number[0] == '\0') };
+    if (!cmd.redial) {
+        strncpy(cmd.number, number, sizeof(cmd.number) - 1);
+    }
+    return send_command(&cmd);
+}
+
+esp_err_t esp_hf_client_dial_memory(int location)
+{
+    if (!hf_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    phone_cmd_t cmd = { .type = CMD_DIAL, .memory = location > 0 ? location : FAKE_PHONE_MEMORY_SLOTS + 1 };
+    return send_command(&cmd);
+}
+
+esp_err_t esp_hf_client_query_current_calls(void)
+{
+    if (!hf_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    phone_cmd_t cmd = { .type = CMD_QUERY_CALLS };
+    return send_command(&cmd);
+}
+
+esp_err_t esp_hf_client_reject_call(void)
+{
+    if (!hf_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    phone_cmd_t cmd = { .type = CMD_HANGUP };
+    return send_command(&cmd);
+}
+
+void fake_phone_set_script(const char *new_script)
+{
+    phone_cmd_t cmd = { .type = CMD_SCRIPT, .script = strdup(new_script) };
+    if (!cmd.script || send_command(&cmd) != ESP_OK) {
+        free(cmd.script);
+    }
+}
+
+void fake_phone_set_link(bool up)
+{
+    phone_cmd_t cmd = { .type = CMD_LINK, .up = up };
+    send_command(&cmd);
+}
+
+void fake_phone_get_stats(fake_phone_stats_t *out)
+{
+    if (!stats_lock) {
+        *out = (fake_phone_stats_t){0};
+        return;
+    }
+    xSemaphoreTake(stats_lock, portMAX_DELAY);
+    *out = stats;
+    xSemaphoreGive(stats_lock);
+}
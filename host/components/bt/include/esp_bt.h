@@ -0,0 +1,29 @@
+#ifndef ESP_BT_H
+#define ESP_BT_H
+
+#include "esp_err.h"
+
+// Stand-in for the Bluetooth controller API. There is no controller on the host; these
+// only track the init/enable order so misuse fails the way it does on the device.
+
+typedef enum {
+    ESP_BT_MODE_IDLE = 0x00,
+    ESP_BT_MODE_BLE = 0x01,
+    ESP_BT_MODE_CLASSIC_BT = 0x02,
+    ESP_BT_MODE_BTDM = 0x03,
+} esp_bt_mode_t;
+
+typedef struct {
+    int magic; // Controller tuning has no meaning on the host
+} esp_bt_controller_config_t;
+
+#define ESP_BT_CONTROLLER_CONFIG_MAGIC_VAL 0x20221207
+#define BT_CONTROLLER_INIT_CONFIG_DEFAULT() { .magic = ESP_BT_CONTROLLER_CONFIG_MAGIC_VAL }
+
+esp_err_t esp_bt_controller_mem_release(esp_bt_mode_t mode);
+esp_err_t esp_bt_controller_init(esp_bt_controller_config_t *cfg);
+esp_err_t esp_bt_controller_deinit(void);
+esp_err_t esp_bt_controller_enable(esp_bt_mode_t mode);
+esp_err_t esp_bt_controller_disable(void);
+
+#endif // ESP_BT_H
@@ -0,0 +1,93 @@
+#ifndef ESP_HF_CLIENT_API_H
+#define ESP_HF_CLIENT_API_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_bt_defs.h"
+#include "esp_hf_defs.h"
+
+// Stand-in for the HFP client API. Events come from the scripted phone in
+// fake_phone.c, on its own task like the Bluedroid task on the device.
+
+typedef enum {
+    ESP_HF_CLIENT_CONNECTION_STATE_DISCONNECTED = 0,
+    ESP_HF_CLIENT_CONNECTION_STATE_CONNECTING,
+    ESP_HF_CLIENT_CONNECTION_STATE_CONNECTED,
+    ESP_HF_CLIENT_CONNECTION_STATE_SLC_CONNECTED,
+    ESP_HF_CLIENT_CONNECTION_STATE_DISCONNECTING,
+} esp_hf_client_connection_state_t;
+
+typedef enum {
+    ESP_HF_CLIENT_CONNECTION_STATE_EVT = 0,
+    ESP_HF_CLIENT_AUDIO_STATE_EVT,
+    ESP_HF_CLIENT_BVRA_EVT,
+    ESP_HF_CLIENT_CIND_CALL_EVT,
+    ESP_HF_CLIENT_CIND_CALL_SETUP_EVT,
+    ESP_HF_CLIENT_CIND_CALL_HELD_EVT,
+    ESP_HF_CLIENT_CIND_SERVICE_AVAILABILITY_EVT,
+    ESP_HF_CLIENT_CIND_SIGNAL_STRENGTH_EVT,
+    ESP_HF_CLIENT_CIND_ROAMING_STATUS_EVT,
+    ESP_HF_CLIENT_CIND_BATTERY_LEVEL_EVT,
+    ESP_HF_CLIENT_COPS_CURRENT_OPERATOR_EVT,
+    ESP_HF_CLIENT_BTRH_EVT,
+    ESP_HF_CLIENT_CLIP_EVT,
+    ESP_HF_CLIENT_CCWA_EVT,
+    ESP_HF_CLIENT_CLCC_EVT,
+    ESP_HF_CLIENT_VOLUME_CONTROL_EVT,
+    ESP_HF_CLIENT_AT_RESPONSE_EVT,
+    ESP_HF_CLIENT_CNUM_EVT,
+    ESP_HF_CLIENT_BSIR_EVT,
+    ESP_HF_CLIENT_BINP_EVT,
+    ESP_HF_CLIENT_RING_IND_EVT,
+    ESP_HF_CLIENT_PKT_STAT_NUMS_GET_EVT,
+    ESP_HF_CLIENT_PROF_STATE_EVT,
+} esp_hf_client_cb_event_t;
+
+typedef union {
+    struct {
+        esp_hf_client_connection_state_t state;
+        esp_bd_addr_t remote_bda;
+        uint32_t peer_feat;
+        uint32_t chld_feat;
+    } conn_stat;
+    struct {
+        esp_hf_audio_state_t state;
+        esp_bd_addr_t remote_bda;
+    } audio_stat;
+    struct {
+        esp_hf_call_status_t status;
+    } call;
+    struct {
+        esp_hf_call_setup_status_t status;
+    } call_setup;
+    struct {
+        esp_hf_network_state_t status;
+    } service_availability;
+    struct {
+        int idx;
+        esp_hf_current_call_direction_t dir;
+        esp_hf_current_call_status_t status;
+        esp_hf_current_call_mpty_type_t mpty;
+        char *number;
+    } clcc;
+    struct {
+        esp_hf_at_response_code_t code;
+        esp_hf_cme_err_t cme;
+    } at_response;
+} esp_hf_client_cb_param_t;
+
+typedef void (*esp_hf_client_cb_t)(esp_hf_client_cb_event_t event, esp_hf_client_cb_param_t *param);
+
+esp_err_t esp_hf_client_register_callback(esp_hf_client_cb_t callback);
+esp_err_t esp_hf_client_init(void);
+esp_err_t esp_hf_client_deinit(void);
+esp_err_t esp_hf_client_connect(esp_bd_addr_t remote_bda);
+esp_err_t esp_hf_client_disconnect(esp_bd_addr_t remote_bda);
+// number == NULL redials the last number (AT+BLDN)
+esp_err_t esp_hf_client_dial(const char *number);
+esp_err_t esp_hf_client_dial_memory(int location);
+esp_err_t esp_hf_client_query_current_calls(void);
+// AT+CHUP: ends the current call or the one being set up
+esp_err_t esp_hf_client_reject_call(void);
+
+#endif // ESP_HF_CLIENT_API_H
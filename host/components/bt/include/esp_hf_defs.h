@@ -0,0 +1,72 @@
+#ifndef ESP_HF_DEFS_H
+#define ESP_HF_DEFS_H
+
+typedef enum {
+    ESP_HF_AUDIO_STATE_DISCONNECTED = 0,
+    ESP_HF_AUDIO_STATE_CONNECTING,
+    ESP_HF_AUDIO_STATE_CONNECTED,
+    ESP_HF_AUDIO_STATE_CONNECTED_MSBC,
+} esp_hf_audio_state_t;
+
+typedef enum {
+    ESP_HF_CALL_STATUS_NO_CALLS = 0,
+    ESP_HF_CALL_STATUS_CALL_IN_PROGRESS = 1,
+} esp_hf_call_status_t;
+
+typedef enum {
+    ESP_HF_CALL_SETUP_STATUS_IDLE = 0,
+    ESP_HF_CALL_SETUP_STATUS_INCOMING = 1,
+    ESP_HF_CALL_SETUP_STATUS_OUTGOING_DIALING = 2,
+    ESP_HF_CALL_SETUP_STATUS_OUTGOING_ALERTING = 3,
+} esp_hf_call_setup_status_t;
+
+typedef enum {
+    ESP_HF_SERVICE_AVAILABILITY_STATUS_UNAVAILABLE = 0,
+    ESP_HF_SERVICE_AVAILABILITY_STATUS_AVAILABLE,
+} esp_hf_network_state_t;
+
+typedef enum {
+    ESP_HF_AT_RESPONSE_CODE_OK = 0,
+    ESP_HF_AT_RESPONSE_CODE_ERR,
+    ESP_HF_AT_RESPONSE_CODE_NO_CARRIER,
+    ESP_HF_AT_RESPONSE_CODE_BUSY,
+    ESP_HF_AT_RESPONSE_CODE_NO_ANSWER,
+    ESP_HF_AT_RESPONSE_CODE_DELAYED,
+    ESP_HF_AT_RESPONSE_CODE_BLACKLISTED,
+    ESP_HF_AT_RESPONSE_CODE_CME,
+} esp_hf_at_response_code_t;
+
+typedef enum {
+    ESP_HF_AT_RESPONSE_ERROR = 0,
+    ESP_HF_AT_RESPONSE_OK,
+} esp_hf_at_response_t;
+
+typedef enum {
+    ESP_HF_CME_AG_FAILURE = 0,
+    ESP_HF_CME_NO_CONNECTION_TO_PHONE = 1,
+    ESP_HF_CME_OPERATION_NOT_ALLOWED = 3,
+    ESP_HF_CME_INVALID_INDEX = 21,
+    ESP_HF_CME_NO_NETWORK_SERVICE = 30,
+} esp_hf_cme_err_t;
+
+typedef enum {
+    ESP_HF_CURRENT_CALL_DIRECTION_OUTGOING = 0,
+    ESP_HF_CURRENT_CALL_DIRECTION_INCOMING = 1,
+} esp_hf_current_call_direction_t;
+
+typedef enum {
+    ESP_HF_CURRENT_CALL_STATUS_ACTIVE = 0,
+    ESP_HF_CURRENT_CALL_STATUS_HELD = 1,
+    ESP_HF_CURRENT_CALL_STATUS_DIALING = 2,
+    ESP_HF_CURRENT_CALL_STATUS_ALERTING = 3,
+    ESP_HF_CURRENT_CALL_STATUS_INCOMING = 4,
+    ESP_HF_CURRENT_CALL_STATUS_WAITING = 5,
+    ESP_HF_CURRENT_CALL_STATUS_HELD_BY_RESP_HOLD = 6,
+} esp_hf_current_call_status_t;
+
+typedef enum {
+    ESP_HF_CURRENT_CALL_MPTY_TYPE_SINGLE = 0,
+    ESP_HF_CURRENT_CALL_MPTY_TYPE_MULTI = 1,
+} esp_hf_current_call_mpty_type_t;
+
+#endif // ESP_HF_DEFS_H
@@ -0,0 +1,55 @@
+#ifndef FAKE_PHONE_H
+#define FAKE_PHONE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host-only controls for the scripted phone behind the HFP client stand-in.
+//
+// The phone connects once the firmware has initialized the HFP client and registered
+// its callback. Each ATD/BLDN takes the next outcome from the script, a comma-separated
+// list that repeats:
+//   answer    OK, dialing, alerting, answered after the ring time, hung up after the talk time
+//   noanswer  OK, dialing, alerting, back to idle after the ring time
+//   busy      OK, dialing, alerting, back to idle after a short busy tone
+//   error     ERROR response, no call indicators
+//   drop      OK, dialing, alerting, then the Bluetooth link drops and comes back
+//   lost      OK, dialing, alerting, then the phone goes out of range: the link drops,
+//             and pages fail until it has been away for the away time
+// A dial while a call is in progress is answered with ERROR, as a phone would.
+// ATD>n; (memory dial) dials 555010n for locations 1 to 9 and is answered +CME ERROR: 21
+// for any other. AT+CLCC lists the call in progress, if any, then answers OK. AT+CHUP
+// ends the call in progress, or the one being set up, and answers OK; with no call it
+// is answered with ERROR. Answers come back in the order the commands were sent.
+//
+// Environment, read at esp_hf_client_init():
+//   REMOTEHEAD_FAKE_PHONE_SCRIPT      outcome list (default "answer")
+//   REMOTEHEAD_FAKE_PHONE_CONNECT_MS  delay before the link comes up (default 500)
+//   REMOTEHEAD_FAKE_PHONE_RING_MS     alerting time (default 2000)
+//   REMOTEHEAD_FAKE_PHONE_TALK_MS     answered call length (default 5000)
+//   REMOTEHEAD_FAKE_PHONE_AWAY_MS     how long a "lost" phone stays out of range (default 10000)
+//
+// esp_hf_client_connect() pages the phone: the link comes up after the connect delay,
+// or the page fails with a disconnect event while the phone is out of range or the
+// address is not the phone's. Connection events carry the phone's address,
+// 02:00:00:00:00:02.
+
+typedef struct {
+    uint32_t dials;         // ATD/BLDN commands received, memory dials included
+    uint32_t rejected;      // Answered with ERROR
+    uint32_t answered;
+    uint32_t connects;      // Times the service level connection came up
+    uint32_t pages;         // esp_hf_client_connect() calls
+    uint32_t queries;       // AT+CLCC commands received
+    uint32_t hangups;       // AT+CHUP commands received
+} fake_phone_stats_t;
+
+// Replace the outcome script; the next dial takes its first entry
+void fake_phone_set_script(const char *script);
+
+// Bring the Bluetooth link up or down, e.g. to simulate the phone going out of range
+void fake_phone_set_link(bool up);
+
+void fake_phone_get_stats(fake_phone_stats_t *stats);
+
+#endif // FAKE_PHONE_H
@@ -0,0 +1,79 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "driver/gpio.h"
+
+static const char *TAG = "gpio_host";
+
+static uint8_t levels[GPIO_NUM_MAX];
+static gpio_mode_t modes[GPIO_NUM_MAX];
+static bool held_low[GPIO_NUM_MAX];
+static bool env_loaded;
+
+static void load_env(void)
+{
+    if (env_loaded) {
+        return;
+    }
+    env_loaded = true;
+    const char *low = getenv("REMOTEHEAD_HOST_GPIO_LOW");
+    for (const char *p = low; p && *p; ) {
+        char *end;
+        long pin = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        if (pin >= 0 && pin < GPIO_NUM_MAX) {
+            held_low[pin] = true;
+        }
+        p = (*end == ',') ? end + 1 : end;
+    }
+}
+
+static bool valid_pin(gpio_num_t gpio_num)
+{
+    return gpio_num >= 0 && gpio_num < GPIO_NUM_MAX;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    if (!valid_pin(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    load_env();
+    modes[gpio_num] = mode;
+    if (mode == GPIO_MODE_INPUT) {
+        levels[gpio_num] = held_low[gpio_num] ? 0 : 1;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull)
+{
+    if (!valid_pin(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    load_env();
+    if (modes[gpio_num] == GPIO_MODE_INPUT && !held_low[gpio_num]) {
+        levels[gpio_num] = (pull == GPIO_PULLDOWN_ONLY) ? 0 : 1;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (!valid_pin(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (modes[gpio_num] == GPIO_MODE_OUTPUT || modes[gpio_num] == GPIO_MODE_INPUT_OUTPUT) {
+        levels[gpio_num] = level ? 1 : 0;
+        ESP_LOGV(TAG, "GPIO%d -> %u", gpio_num, levels[gpio_num]);
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    return valid_pin(gpio_num) ? levels[gpio_num] : 0;
+}
@@ -0,0 +1,105 @@
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_netif.h"
+
+ESP_EVENT_DEFINE_BASE(IP_EVENT);
+
+struct esp_netif_obj {
+    char if_key[16];
+    esp_netif_ip_info_t ip_info;
+    esp_netif_dns_info_t dns[ESP_NETIF_DNS_FALLBACK + 1];
+    bool dhcpc_stopped;
+};
+
+esp_err_t esp_netif_init(void)
+{
+    return ESP_OK;
+}
+
+esp_netif_t *esp_netif_new(const esp_netif_config_t *config)
+{
+    if (!config || !config->base || !config->base->if_key) {
+        return NULL;
+    }
+    esp_netif_t *netif = calloc(1, sizeof(*netif));
+    if (netif) {
+        snprintf(netif->if_key, sizeof(netif->if_key), "%s", config->base->if_key);
+    }
+    return netif;
+}
+
+void esp_netif_destroy(esp_netif_t *esp_netif)
+{
+    free(esp_netif);
+}
+
+const char *esp_netif_get_ifkey(esp_netif_t *esp_netif)
+{
+    return esp_netif ? esp_netif->if_key : NULL;
+}
+
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info)
+{
+    if (!esp_netif || !ip_info) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ip_info = esp_netif->ip_info;
+    return ESP_OK;
+}
+
+esp_err_t esp_netif_set_ip_info(esp_netif_t *esp_netif, const esp_netif_ip_info_t *ip_info)
+{
+    if (!esp_netif || !ip_info) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_netif->ip_info = *ip_info;
+    return ESP_OK;
+}
+
+char *esp_ip4addr_ntoa(const esp_ip4_addr_t *addr, char *buf, int buflen)
+{
+    int len = snprintf(buf, (size_t)buflen, IPSTR, IP2STR(addr));
+    return (len < 0 || len >= buflen) ? NULL : buf;
+}
+
+esp_err_t esp_netif_str_to_ip4(const char *src, esp_ip4_addr_t *dst)
+{
+    struct in_addr addr;
+    if (!src || !dst || inet_pton(AF_INET, src, &addr) != 1) {
+        return ESP_FAIL;
+    }
+    dst->addr = addr.s_addr;
+    return ESP_OK;
+}
+
+esp_err_t esp_netif_dhcpc_stop(esp_netif_t *esp_netif)
+{
+    if (!esp_netif) {
+        return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+    }
+    if (esp_netif->dhcpc_stopped) {
+        return ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED;
+    }
+    esp_netif->dhcpc_stopped = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_netif_dhcpc_get_status(esp_netif_t *esp_netif, esp_netif_dhcp_status_t *status)
+{
+    if (!esp_netif || !status) {
+        return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+    }
+    *status = esp_netif->dhcpc_stopped ? ESP_NETIF_DHCP_STOPPED : ESP_NETIF_DHCP_STARTED;
+    return ESP_OK;
+}
+
+esp_err_t esp_netif_set_dns_info(esp_netif_t *esp_netif, esp_netif_dns_type_t type, esp_netif_dns_info_t *dns)
+{
+    if (!esp_netif || !dns || type > ESP_NETIF_DNS_FALLBACK) {
+        return ESP_ERR_ESP_NETIF_INVALID_PARAMS;
+    }
+    esp_netif->dns[type] = *dns; // Name lookups use the host's resolver regardless
+    return ESP_OK;
+}
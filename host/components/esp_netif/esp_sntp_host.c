@@ -0,0 +1,47 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_log.h"
+#include "esp_sntp.h"
+
+static const char *TAG = "sntp_host";
+
+static sntp_sync_time_cb_t sync_cb;
+static bool running;
+
+void esp_sntp_setoperatingmode(esp_sntp_operatingmode_t operating_mode)
+{
+    (void)operating_mode;
+}
+
+void esp_sntp_setservername(uint8_t idx, const char *server)
+{
+    ESP_LOGD(TAG, "Server %u: %s (not contacted on the host)", idx, server);
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback)
+{
+    sync_cb = callback;
+}
+
+void esp_sntp_init(void)
+{
+    if (running) {
+        return; // lwIP ignores a second init as well
+    }
+    running = true;
+    if (sync_cb) {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        sync_cb(&tv);
+    }
+}
+
+void esp_sntp_stop(void)
+{
+    running = false;
+}
+
+bool esp_sntp_enabled(void)
+{
+    return running;
+}
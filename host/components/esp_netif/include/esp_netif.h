@@ -0,0 +1,103 @@
+#ifndef ESP_NETIF_H
+#define ESP_NETIF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_event.h"
+
+// Stand-in for the esp_netif API used by the firmware. The host's own network stack
+// carries the traffic, so an interface is only a name and the address it was given.
+
+typedef struct {
+    uint32_t addr; // Network byte order, as on the device
+} esp_ip4_addr_t;
+
+typedef struct {
+    esp_ip4_addr_t ip;
+    esp_ip4_addr_t netmask;
+    esp_ip4_addr_t gw;
+} esp_netif_ip_info_t;
+
+typedef struct esp_netif_obj esp_netif_t;
+
+#define ESP_IPADDR_TYPE_V4 0
+
+typedef struct {
+    union {
+        esp_ip4_addr_t ip4;
+    } u_addr;
+    uint8_t type;
+} esp_ip_addr_t;
+
+typedef struct {
+    esp_ip_addr_t ip;
+} esp_netif_dns_info_t;
+
+typedef enum {
+    ESP_NETIF_DNS_MAIN,
+    ESP_NETIF_DNS_BACKUP,
+    ESP_NETIF_DNS_FALLBACK,
+} esp_netif_dns_type_t;
+
+typedef enum {
+    ESP_NETIF_DHCP_INIT,
+    ESP_NETIF_DHCP_STARTED,
+    ESP_NETIF_DHCP_STOPPED,
+} esp_netif_dhcp_status_t;
+
+#define ESP_ERR_ESP_NETIF_BASE 0x5000
+#define ESP_ERR_ESP_NETIF_INVALID_PARAMS        (ESP_ERR_ESP_NETIF_BASE + 0x01)
+#define ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED  (ESP_ERR_ESP_NETIF_BASE + 0x04)
+
+typedef struct {
+    const char *if_key;
+} esp_netif_inherent_config_t;
+
+typedef struct {
+    const esp_netif_inherent_config_t *base;
+} esp_netif_config_t;
+
+ESP_EVENT_DECLARE_BASE(IP_EVENT);
+
+typedef enum {
+    IP_EVENT_STA_GOT_IP,
+    IP_EVENT_STA_LOST_IP,
+    IP_EVENT_AP_STAIPASSIGNED,
+} ip_event_t;
+
+typedef struct {
+    esp_netif_t *esp_netif;
+    esp_netif_ip_info_t ip_info;
+    bool ip_changed;
+} ip_event_got_ip_t;
+
+#define esp_ip4_addr_get_byte(ipaddr, idx) (((const uint8_t *)(&(ipaddr)->addr))[idx])
+#define esp_ip4_addr1_16(ipaddr) ((uint16_t)esp_ip4_addr_get_byte(ipaddr, 0))
+#define esp_ip4_addr2_16(ipaddr) ((uint16_t)esp_ip4_addr_get_byte(ipaddr, 1))
+#define esp_ip4_addr3_16(ipaddr) ((uint16_t)esp_ip4_addr_get_byte(ipaddr, 2))
+#define esp_ip4_addr4_16(ipaddr) ((uint16_t)esp_ip4_addr_get_byte(ipaddr, 3))
+
+#define IP2STR(ipaddr) esp_ip4_addr1_16(ipaddr), esp_ip4_addr2_16(ipaddr), \
+                       esp_ip4_addr3_16(ipaddr), esp_ip4_addr4_16(ipaddr)
+#define IPSTR "%d.%d.%d.%d"
+
+#define ESP_IP4TOADDR(a, b, c, d) ((uint32_t)(((d) & 0xff) << 24) | (((c) & 0xff) << 16) | \
+                                   (((b) & 0xff) << 8) | ((a) & 0xff))
+
+esp_err_t esp_netif_init(void);
+esp_netif_t *esp_netif_new(const esp_netif_config_t *config);
+void esp_netif_destroy(esp_netif_t *esp_netif);
+const char *esp_netif_get_ifkey(esp_netif_t *esp_netif);
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info);
+esp_err_t esp_netif_set_ip_info(esp_netif_t *esp_netif, const esp_netif_ip_info_t *ip_info);
+char *esp_ip4addr_ntoa(const esp_ip4_addr_t *addr, char *buf, int buflen);
+esp_err_t esp_netif_str_to_ip4(const char *src, esp_ip4_addr_t *dst);
+
+// The host has no DHCP client; stopping it only makes the fake radio report the
+// address set with esp_netif_set_ip_info() instead of 127.0.0.1
+esp_err_t esp_netif_dhcpc_stop(esp_netif_t *esp_netif);
+esp_err_t esp_netif_dhcpc_get_status(esp_netif_t *esp_netif, esp_netif_dhcp_status_t *status);
+esp_err_t esp_netif_set_dns_info(esp_netif_t *esp_netif, esp_netif_dns_type_t type, esp_netif_dns_info_t *dns);
+
+#endif // ESP_NETIF_H
@@ -0,0 +1,25 @@
+#ifndef ESP_SNTP_H
+#define ESP_SNTP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+// Stand-in for the lwIP SNTP client. The host clock is already synchronized, so
+// esp_sntp_init() reports a sync straight away instead of polling servers.
+
+typedef enum {
+    SNTP_OPMODE_POLL,
+    SNTP_OPMODE_LISTENONLY,
+} esp_sntp_operatingmode_t;
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval *tv);
+
+void esp_sntp_setoperatingmode(esp_sntp_operatingmode_t operating_mode);
+void esp_sntp_setservername(uint8_t idx, const char *server);
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+void esp_sntp_init(void);
+void esp_sntp_stop(void);
+bool esp_sntp_enabled(void);
+
+#endif // ESP_SNTP_H
@@ -0,0 +1,382 @@
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "fake_wifi.h"
+
+static const char *TAG = "fake_wifi";
+
+ESP_EVENT_DEFINE_BASE(WIFI_EVENT);
+
+#define FAKE_WIFI_CONNECT_MS_DEFAULT 200
+#define FAKE_WIFI_SSIDS_MAX 256
+#define FAKE_WIFI_CHANNEL 6
+
+static const uint8_t fake_bssid[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+static SemaphoreHandle_t wifi_lock;
+static TimerHandle_t connect_timer;
+static uint32_t connect_ms;
+static bool initialized;
+static bool started;
+static bool connecting;
+static bool connected;
+static bool ap_in_range = true;
+static wifi_mode_t mode = WIFI_MODE_NULL;
+static wifi_config_t sta_config;
+static wifi_config_t ap_config;
+static esp_netif_t *sta_netif;
+static esp_netif_t *ap_netif;
+static char ssids_in_range[FAKE_WIFI_SSIDS_MAX];
+static fake_wifi_stats_t stats;
+
+// Whether the configured SSID is one of REMOTEHEAD_FAKE_WIFI_SSIDS; the caller holds wifi_lock
+static bool ssid_reachable(void)
+{
+    if (!ap_in_range) {
+        return false;
+    }
+    if (sta_config.sta.bssid_set &&
+        (memcmp(sta_config.sta.bssid, fake_bssid, sizeof(fake_bssid)) != 0 ||
+         (sta_config.sta.channel != 0 && sta_config.sta.channel != FAKE_WIFI_CHANNEL))) {
+        return false;
+    }
+    if (ssids_in_range[0] == '\0') {
+        return true;
+    }
+    const char *ssid = (const char *)sta_config.sta.ssid;
+    size_t len = strnlen(ssid, sizeof(sta_config.sta.ssid));
+    for (const char *p = ssids_in_range; *p; ) {
+        const char *comma = strchr(p, ',');
+        size_t item_len = comma ? (size_t)(comma - p) : strlen(p);
+        if (item_len == len && memcmp(p, ssid, len) == 0) {
+            return true;
+        }
+        p += item_len + (comma ? 1 : 0);
+    }
+    return false;
+}
+
+static void post_disconnected(wifi_err_reason_t reason)
+{
+    wifi_event_sta_disconnected_t event = { .reason = (uint8_t)reason, .rssi = -90 };
+    size_t len = strnlen((const char *)sta_config.sta.ssid, sizeof(event.ssid));
+    memcpy(event.ssid, sta_config.sta.ssid, len);
+    event.ssid_len = (uint8_t)len;
+    esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &event, sizeof(event), portMAX_DELAY);
+}
+
+// Runs on the FreeRTOS timer task, standing in for the driver's association delay
+static void connect_timer_cb(TimerHandle_t timer)
+{
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    if (!connecting) {
+        xSemaphoreGive(wifi_lock); // Stopped or disconnected meanwhile
+        return;
+    }
+    connecting = false;
+    bool reachable = ssid_reachable();
+    connected = reachable;
+    if (reachable) {
+        stats.got_ip++;
+    } else {
+        stats.disconnects++;
+    }
+    xSemaphoreGive(wifi_lock);
+
+    if (!reachable) {
+        ESP_LOGI(TAG, "No AP found for '%s'", (const char *)sta_config.sta.ssid);
+        post_disconnected(WIFI_REASON_NO_AP_FOUND);
+        return;
+    }
+
+    wifi_event_sta_connected_t connected_event = { .channel = FAKE_WIFI_CHANNEL, .authmode = sta_config.sta.threshold.authmode };
+    memcpy(connected_event.bssid, fake_bssid, sizeof(fake_bssid));
+    size_t len = strnlen((const char *)sta_config.sta.ssid, sizeof(connected_event.ssid));
+    memcpy(connected_event.ssid, sta_config.sta.ssid, len);
+    connected_event.ssid_len = (uint8_t)len;
+    esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_CONNECTED, &connected_event, sizeof(connected_event), portMAX_DELAY);
+
+    ip_event_got_ip_t got_ip = {
+        .esp_netif = sta_netif,
+        .ip_info = {
+            .ip.addr = ESP_IP4TOADDR(127, 0, 0, 1),
+            .netmask.addr = ESP_IP4TOADDR(255, 0, 0, 0),
+            .gw.addr = ESP_IP4TOADDR(127, 0, 0, 1),
+        },
+        .ip_changed = true,
+    };
+    esp_netif_dhcp_status_t dhcp = ESP_NETIF_DHCP_STARTED;
+    if (sta_netif) {
+        esp_netif_dhcpc_get_status(sta_netif, &dhcp);
+    }
+    if (dhcp == ESP_NETIF_DHCP_STOPPED) {
+        esp_netif_get_ip_info(sta_netif, &got_ip.ip_info); // Static address set by the firmware
+    } else if (sta_netif) {
+        esp_netif_set_ip_info(sta_netif, &got_ip.ip_info);
+    }
+    esp_event_post(IP_EVENT, IP_EVENT_STA_GOT_IP, &got_ip, sizeof(got_ip), portMAX_DELAY);
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config)
+{
+    if (!config || config->magic != WIFI_INIT_CONFIG_MAGIC) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (initialized) {
+        return ESP_OK;
+    }
+
+    connect_ms = FAKE_WIFI_CONNECT_MS_DEFAULT;
+    const char *env = getenv("REMOTEHEAD_FAKE_WIFI_CONNECT_MS");
+    if (env && env[0] != '\0') {
+        connect_ms = (uint32_t)strtoul(env, NULL, 10);
+    }
+    env = getenv("REMOTEHEAD_FAKE_WIFI_SSIDS");
+    if (env) {
+        strncpy(ssids_in_range, env, sizeof(ssids_in_range) - 1);
+    }
+
+    wifi_lock = xSemaphoreCreateMutex();
+    connect_timer = xTimerCreate("fake_wifi", pdMS_TO_TICKS(connect_ms) > 0 ? pdMS_TO_TICKS(connect_ms) : 1,
+                                 pdFALSE, NULL, connect_timer_cb);
+    if (!wifi_lock || !connect_timer) {
+        return ESP_ERR_NO_MEM;
+    }
+    initialized = true;
+    ESP_LOGI(TAG, "Fake Wi-Fi ready (connect delay %lu ms)", (unsigned long)connect_ms);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_deinit(void)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    esp_wifi_stop();
+    initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t new_mode)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    if (new_mode >= WIFI_MODE_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    mode = new_mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_mode(wifi_mode_t *out_mode)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    *out_mode = mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    if (interface == WIFI_IF_STA) {
+        sta_config = *conf;
+    } else {
+        ap_config = *conf;
+    }
+    xSemaphoreGive(wifi_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t *conf)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    *conf = (interface == WIFI_IF_STA) ? sta_config : ap_config;
+    xSemaphoreGive(wifi_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    if (started) {
+        return ESP_OK;
+    }
+    started = true;
+    if (mode == WIFI_MODE_STA || mode == WIFI_MODE_APSTA) {
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_START, NULL, 0, portMAX_DELAY);
+    }
+    if (mode == WIFI_MODE_AP || mode == WIFI_MODE_APSTA) {
+        ESP_LOGI(TAG, "Soft-AP '%s' up", (const char *)ap_config.ap.ssid);
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_AP_START, NULL, 0, portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_stop(void)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    if (!started) {
+        return ESP_OK;
+    }
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    started = false;
+    connecting = false;
+    connected = false;
+    xSemaphoreGive(wifi_lock);
+    xTimerStop(connect_timer, portMAX_DELAY);
+
+    if (mode == WIFI_MODE_STA || mode == WIFI_MODE_APSTA) {
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_STOP, NULL, 0, portMAX_DELAY);
+    }
+    if (mode == WIFI_MODE_AP || mode == WIFI_MODE_APSTA) {
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_AP_STOP, NULL, 0, portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_connect(void)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    if (!started) {
+        return ESP_ERR_WIFI_NOT_STARTED;
+    }
+    if (mode != WIFI_MODE_STA && mode != WIFI_MODE_APSTA) {
+        return ESP_ERR_WIFI_MODE;
+    }
+
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    bool start_attempt = !connecting && !connected;
+    bool targeted = sta_config.sta.bssid_set;
+    if (start_attempt) {
+        connecting = true;
+        stats.connects++;
+        stats.targeted += targeted ? 1 : 0;
+    }
+    xSemaphoreGive(wifi_lock);
+
+    if (start_attempt) {
+        TickType_t delay = pdMS_TO_TICKS(targeted ? connect_ms / 4 : connect_ms); // No scan when targeted
+        xTimerChangePeriod(connect_timer, delay > 0 ? delay : 1, portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_disconnect(void)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    fake_wifi_drop_link(WIFI_REASON_ASSOC_LEAVE);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_storage(wifi_storage_t storage)
+{
+    (void)storage; // Nothing here outlives the process anyway
+    return initialized ? ESP_OK : ESP_ERR_WIFI_NOT_INIT;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    if (!initialized) {
+        return ESP_ERR_WIFI_NOT_INIT;
+    }
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    bool up = connected;
+    if (up) {
+        *ap_info = (wifi_ap_record_t){ .primary = FAKE_WIFI_CHANNEL, .rssi = -50,
+                                       .authmode = sta_config.sta.threshold.authmode };
+        memcpy(ap_info->bssid, fake_bssid, sizeof(fake_bssid));
+        memcpy(ap_info->ssid, sta_config.sta.ssid, sizeof(sta_config.sta.ssid));
+    }
+    xSemaphoreGive(wifi_lock);
+    return up ? ESP_OK : ESP_ERR_WIFI_CONN;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_sta(void)
+{
+    static const esp_netif_inherent_config_t base = { .if_key = "WIFI_STA_DEF" };
+    const esp_netif_config_t config = { .base = &base };
+    sta_netif = esp_netif_new(&config);
+    return sta_netif;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_ap(void)
+{
+    static const esp_netif_inherent_config_t base = { .if_key = "WIFI_AP_DEF" };
+    const esp_netif_config_t config = { .base = &base };
+    ap_netif = esp_netif_new(&config);
+    if (ap_netif) {
+        const esp_netif_ip_info_t ip_info = {
+            .ip.addr = ESP_IP4TOADDR(192, 168, 4, 1),
+            .netmask.addr = ESP_IP4TOADDR(255, 255, 255, 0),
+            .gw.addr = ESP_IP4TOADDR(192, 168, 4, 1),
+        };
+        esp_netif_set_ip_info(ap_netif, &ip_info);
+    }
+    return ap_netif;
+}
+
+void fake_wifi_drop_link(wifi_err_reason_t reason)
+{
+    if (!initialized) {
+        return;
+    }
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    bool was_up = connected || connecting;
+    connected = false;
+    connecting = false;
+    if (was_up) {
+        stats.disconnects++;
+    }
+    xSemaphoreGive(wifi_lock);
+
+    if (was_up) {
+        ESP_LOGI(TAG, "Dropping station link (reason %d)", (int)reason);
+        post_disconnected(reason);
+    }
+}
+
+void fake_wifi_set_ap_in_range(bool in_range)
+{
+    if (!initialized) {
+        ap_in_range = in_range;
+        return;
+    }
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    ap_in_range = in_range;
+    xSemaphoreGive(wifi_lock);
+    if (!in_range) {
+        fake_wifi_drop_link(WIFI_REASON_BEACON_TIMEOUT);
+    }
+}
+
+void fake_wifi_get_stats(fake_wifi_stats_t *out)
+{
+    if (!initialized) {
+        *out = (fake_wifi_stats_t){0};
+        return;
+    }
+    xSemaphoreTake(wifi_lock, portMAX_DELAY);
+    *out = stats;
+    xSemaphoreGive(wifi_lock);
+}
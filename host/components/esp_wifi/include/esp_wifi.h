@@ -0,0 +1,163 @@
+#ifndef ESP_WIFI_H
+#define ESP_WIFI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+
+// Stand-in for the Wi-Fi driver API used by the firmware. The fake radio posts the
+// same WIFI_EVENT and IP_EVENT sequence as the driver; see fake_wifi.h for how to
+// steer it.
+
+#define ESP_ERR_WIFI_BASE       0x3000
+#define ESP_ERR_WIFI_NOT_INIT   (ESP_ERR_WIFI_BASE + 1)
+#define ESP_ERR_WIFI_NOT_STARTED (ESP_ERR_WIFI_BASE + 2)
+#define ESP_ERR_WIFI_MODE       (ESP_ERR_WIFI_BASE + 5)
+#define ESP_ERR_WIFI_CONN       (ESP_ERR_WIFI_BASE + 7)
+
+typedef enum {
+    WIFI_MODE_NULL = 0,
+    WIFI_MODE_STA,
+    WIFI_MODE_AP,
+    WIFI_MODE_APSTA,
+    WIFI_MODE_MAX
+} wifi_mode_t;
+
+typedef enum {
+    WIFI_IF_STA = 0,
+    WIFI_IF_AP = 1,
+} wifi_interface_t;
+
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK,
+    WIFI_AUTH_ENTERPRISE,
+    WIFI_AUTH_WPA3_PSK,
+    WIFI_AUTH_WPA2_WPA3_PSK,
+} wifi_auth_mode_t;
+
+typedef enum {
+    WPA3_SAE_PWE_UNSPECIFIED,
+    WPA3_SAE_PWE_HUNT_AND_PECK,
+    WPA3_SAE_PWE_HASH_TO_ELEMENT,
+    WPA3_SAE_PWE_BOTH,
+} wifi_sae_pwe_method_t;
+
+typedef struct {
+    uint8_t ssid[32];
+    uint8_t password[64];
+    uint8_t ssid_len;
+    uint8_t channel;
+    wifi_auth_mode_t authmode;
+    uint8_t ssid_hidden;
+    uint8_t max_connection;
+} wifi_ap_config_t;
+
+typedef struct {
+    wifi_auth_mode_t authmode;
+} wifi_scan_threshold_t;
+
+typedef struct {
+    uint8_t ssid[32];
+    uint8_t password[64];
+    bool bssid_set;     // Connect only to bssid
+    uint8_t bssid[6];
+    uint8_t channel;    // 0 scans every channel
+    wifi_scan_threshold_t threshold;
+    wifi_sae_pwe_method_t sae_pwe_h2e;
+} wifi_sta_config_t;
+
+typedef union {
+    wifi_ap_config_t ap;
+    wifi_sta_config_t sta;
+} wifi_config_t;
+
+typedef struct {
+    int magic; // Driver tuning has no meaning for the fake radio
+} wifi_init_config_t;
+
+typedef enum {
+    WIFI_STORAGE_FLASH,
+    WIFI_STORAGE_RAM,
+} wifi_storage_t;
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t ssid[33];
+    uint8_t primary;
+    int8_t rssi;
+    wifi_auth_mode_t authmode;
+} wifi_ap_record_t;
+
+#define WIFI_INIT_CONFIG_MAGIC 0x1F2F3F4F
+#define WIFI_INIT_CONFIG_DEFAULT() { .magic = WIFI_INIT_CONFIG_MAGIC }
+
+ESP_EVENT_DECLARE_BASE(WIFI_EVENT);
+
+typedef enum {
+    WIFI_EVENT_WIFI_READY = 0,
+    WIFI_EVENT_SCAN_DONE,
+    WIFI_EVENT_STA_START,
+    WIFI_EVENT_STA_STOP,
+    WIFI_EVENT_STA_CONNECTED,
+    WIFI_EVENT_STA_DISCONNECTED,
+    WIFI_EVENT_STA_AUTHMODE_CHANGE,
+    WIFI_EVENT_STA_WPS_ER_SUCCESS,
+    WIFI_EVENT_STA_WPS_ER_FAILED,
+    WIFI_EVENT_STA_WPS_ER_TIMEOUT,
+    WIFI_EVENT_STA_WPS_ER_PIN,
+    WIFI_EVENT_STA_WPS_ER_PBC_OVERLAP,
+    WIFI_EVENT_AP_START,
+    WIFI_EVENT_AP_STOP,
+    WIFI_EVENT_AP_STACONNECTED,
+    WIFI_EVENT_AP_STADISCONNECTED,
+} wifi_event_t;
+
+typedef struct {
+    uint8_t ssid[32];
+    uint8_t ssid_len;
+    uint8_t bssid[6];
+    uint8_t channel;
+    wifi_auth_mode_t authmode;
+    uint16_t aid;
+} wifi_event_sta_connected_t;
+
+typedef struct {
+    uint8_t ssid[32];
+    uint8_t ssid_len;
+    uint8_t bssid[6];
+    uint8_t reason;
+    int8_t rssi;
+} wifi_event_sta_disconnected_t;
+
+typedef enum {
+    WIFI_REASON_AUTH_EXPIRE = 2,
+    WIFI_REASON_ASSOC_LEAVE = 8,
+    WIFI_REASON_BEACON_TIMEOUT = 200,
+    WIFI_REASON_NO_AP_FOUND = 201,
+    WIFI_REASON_AUTH_FAIL = 202,
+} wifi_err_reason_t;
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config);
+esp_err_t esp_wifi_deinit(void);
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode);
+esp_err_t esp_wifi_get_mode(wifi_mode_t *mode);
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_start(void);
+esp_err_t esp_wifi_stop(void);
+esp_err_t esp_wifi_connect(void);
+esp_err_t esp_wifi_disconnect(void);
+esp_err_t esp_wifi_set_storage(wifi_storage_t storage);
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info);
+
+// From esp_wifi_default.h on the device
+esp_netif_t *esp_netif_create_default_wifi_sta(void);
+esp_netif_t *esp_netif_create_default_wifi_ap(void);
+
+#endif // ESP_WIFI_H
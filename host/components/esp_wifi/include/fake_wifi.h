@@ -0,0 +1,38 @@
+#ifndef FAKE_WIFI_H
+#define FAKE_WIFI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_wifi.h"
+
+// Host-only controls for the fake radio.
+//
+// Environment, read at esp_wifi_init():
+//   REMOTEHEAD_FAKE_WIFI_CONNECT_MS  delay from esp_wifi_connect() to GOT_IP (default 200)
+//   REMOTEHEAD_FAKE_WIFI_SSIDS       comma-separated networks that are in range; empty or
+//                                    unset means any SSID connects
+//
+// The station gets 127.0.0.1, so the web server is reachable on localhost, unless the
+// firmware stopped the DHCP client and set a static address. The one access point has
+// BSSID 02:00:00:00:00:01 on channel 6. A connect aimed at a BSSID skips the scan and
+// takes a quarter of the delay; aimed at any other BSSID or channel it fails with
+// WIFI_REASON_NO_AP_FOUND.
+
+typedef struct {
+    uint32_t connects;      // esp_wifi_connect() calls
+    uint32_t targeted;      // ...of which aimed at a BSSID
+    uint32_t got_ip;        // IP_EVENT_STA_GOT_IP posted
+    uint32_t disconnects;   // WIFI_EVENT_STA_DISCONNECTED posted
+} fake_wifi_stats_t;
+
+// Drop the station link as if the access point went away; the firmware sees
+// WIFI_EVENT_STA_DISCONNECTED with the given reason
+void fake_wifi_drop_link(wifi_err_reason_t reason);
+
+// Take the access point in or out of range. While out of range, connects fail with
+// WIFI_REASON_NO_AP_FOUND.
+void fake_wifi_set_ap_in_range(bool in_range);
+
+void fake_wifi_get_stats(fake_wifi_stats_t *stats);
+
+#endif // FAKE_WIFI_H
@@ -0,0 +1,11 @@
+#ifndef NVS_FLASH_H
+#define NVS_FLASH_H
+
+#include "esp_err.h"
+#include "nvs.h"
+
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_deinit(void);
+esp_err_t nvs_flash_erase(void);
+
+#endif // NVS_FLASH_H
@@ -0,0 +1,20 @@
+#ifndef NVS_MEM_H
+#define NVS_MEM_H
+
+#include <stdint.h>
+
+// Host-only hooks into the in-memory NVS.
+//
+// At nvs_flash_init() the store is seeded from REMOTEHEAD_HOST_NVS, a comma-separated
+// list of <namespace>/<key>=<value> entries. Values that are all digits are stored as
+// u32, anything else as a string, e.g.
+//   REMOTEHEAD_HOST_NVS="redial_config/ssid=home,redial_config/password=secret"
+
+typedef struct {
+    uint32_t writes;  // Successful nvs_set_* and nvs_erase_* calls
+    uint32_t commits; // nvs_commit calls, i.e. what would reach flash on the device
+} nvs_mem_stats_t;
+
+void nvs_mem_get_stats(nvs_mem_stats_t *stats);
+
+#endif // NVS_MEM_H
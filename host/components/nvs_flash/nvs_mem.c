@@ -0,0 +1,405 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+#include "nvs_mem.h"
+
+static const char *TAG = "nvs_mem";
+
+#define NVS_MEM_MAX_HANDLES 16
+#define NVS_MEM_SEED_ENV "REMOTEHEAD_HOST_NVS"
+
+typedef enum {
+    NVS_MEM_U8,
+    NVS_MEM_U32,
+    NVS_MEM_STR,
+    NVS_MEM_BLOB,
+} nvs_mem_type_t;
+
+typedef struct nvs_mem_entry {
+    struct nvs_mem_entry *next;
+    char ns[NVS_KEY_NAME_MAX_SIZE];
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    nvs_mem_type_t type;
+    uint32_t value;     // U8 and U32
+    uint8_t *data;      // STR (with terminator) and BLOB
+    size_t len;
+} nvs_mem_entry_t;
+
+typedef struct {
+    bool in_use;
+    nvs_open_mode_t mode;
+    char ns[NVS_KEY_NAME_MAX_SIZE];
+} nvs_mem_handle_t;
+
+static SemaphoreHandle_t nvs_lock;
+static bool initialized;
+static nvs_mem_entry_t *entries;
+static nvs_mem_handle_t handles[NVS_MEM_MAX_HANDLES];
+static nvs_mem_stats_t stats;
+
+static bool valid_name(const char *name)
+{
+    return name && name[0] != '\0' && strlen(name) < NVS_KEY_NAME_MAX_SIZE;
+}
+
+static nvs_mem_entry_t *find_entry(const char *ns, const char *key)
+{
+    for (nvs_mem_entry_t *e = entries; e; e = e->next) {
+        if (strcmp(e->ns, ns) == 0 && strcmp(e->key, key) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void free_entry(nvs_mem_entry_t *e)
+{
+    free(e->data);
+    free(e);
+}
+
+// Unlink and free every entry in ns, or only key when it is not NULL. Returns the count.
+static int remove_entries(const char *ns, const char *key)
+{
+    int removed = 0;
+    nvs_mem_entry_t **link = &entries;
+    while (*link) {
+        nvs_mem_entry_t *e = *link;
+        if (strcmp(e->ns, ns) == 0 && (!key || strcmp(e->key, key) == 0)) {
+            *link = e->next;
+            free_entry(e);
+            removed++;
+        } else {
+            link = &e->next;
+        }
+    }
+    return removed;
+}
+
+// Handles only exist after nvs_flash_init(), which also creates the lock
+#define RETURN_IF_NOT_INITIALIZED() do { \
+    if (!initialized) { \
+        return ESP_ERR_NVS_NOT_INITIALIZED; \
+    } \
+} while (0)
+
+// Resolve a handle; the caller holds nvs_lock
+static nvs_mem_handle_t *get_handle(nvs_handle_t handle, bool for_write, esp_err_t *err)
+{
+    if (handle == 0 || handle > NVS_MEM_MAX_HANDLES || !handles[handle - 1].in_use) {
+        *err = ESP_ERR_NVS_INVALID_HANDLE;
+        return NULL;
+    }
+    nvs_mem_handle_t *h = &handles[handle - 1];
+    if (for_write && h->mode != NVS_READWRITE) {
+        *err = ESP_ERR_NVS_READ_ONLY;
+        return NULL;
+    }
+    *err = ESP_OK;
+    return h;
+}
+
+// Replace key in ns with a new value of any type, like the device does
+static esp_err_t store(nvs_handle_t handle, const char *key, nvs_mem_type_t type,
+                       uint32_t value, const void *data, size_t len)
+{
+    RETURN_IF_NOT_INITIALIZED();
+    if (!valid_name(key)) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+
+    xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    esp_err_t err;
+    nvs_mem_handle_t *h = get_handle(handle, true, &err);
+    if (!h) {
+        xSemaphoreGive(nvs_lock);
+        return err;
+    }
+
+    nvs_mem_entry_t *e = calloc(1, sizeof(*e));
+    uint8_t *copy = len ? malloc(len) : NULL;
+    if (!e || (len && !copy)) {
+        free(e);
+        free(copy);
+        xSemaphoreGive(nvs_lock);
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    if (len) {
+        memcpy(copy, data, len);
+    }
+    snprintf(e->ns, sizeof(e->ns), "%s", h->ns);
+    snprintf(e->key, sizeof(e->key), "%s", key);
+    e->type = type;
+    e->value = value;
+    e->data = copy;
+    e->len = len;
+
+    remove_entries(h->ns, key);
+    e->next = entries;
+    entries = e;
+    stats.writes++;
+    xSemaphoreGive(nvs_lock);
+    return ESP_OK;
+}
+
+// Copy out key if it exists with the requested type. Scalars are returned in *value;
+// for strings and blobs, out may be NULL to query the length.
+static esp_err_t load(nvs_handle_t handle, const char *key, nvs_mem_type_t type,
+                      uint32_t *value, void *out, size_t *len)
+{
+    RETURN_IF_NOT_INITIALIZED();
+    xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    esp_err_t err;
+    nvs_mem_handle_t *h = get_handle(handle, false, &err);
+    if (!h) {
+        xSemaphoreGive(nvs_lock);
+        return err;
+    }
+
+    nvs_mem_entry_t *e = find_entry(h->ns, key);
+    if (!e || e->type != type) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else if (type == NVS_MEM_U8 || type == NVS_MEM_U32) {
+        *value = e->value;
+    } else if (!out) {
+        *len = e->len;
+    } else if (*len < e->len) {
+        err = ESP_ERR_NVS_INVALID_LENGTH;
+    } else {
+        memcpy(out, e->data, e->len);
+        *len = e->len;
+    }
+    xSemaphoreGive(nvs_lock);
+    return err;
+}
+
+// Parse REMOTEHEAD_HOST_NVS into the store
+static void seed_from_env(void)
+{
+    const char *seed = getenv(NVS_MEM_SEED_ENV);
+    if (!seed || seed[0] == '\0') {
+        return;
+    }
+
+    char *list = strdup(seed);
+    char *save = NULL;
+    for (char *item = strtok_r(list, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        char *slash = strchr(item, '/');
+        char *equals = slash ? strchr(slash, '=') : NULL;
+        if (!equals) {
+            ESP_LOGW(TAG, "Ignoring seed entry '%s', expected <namespace>/<key>=<value>", item);
+            continue;
+        }
+        *slash = '\0';
+        *equals = '\0';
+        const char *key = slash + 1;
+        const char *value = equals + 1;
+
+        nvs_handle_t handle;
+        if (nvs_open(item, NVS_READWRITE, &handle) != ESP_OK) {
+            ESP_LOGW(TAG, "Ignoring seed entry for namespace '%s'", item);
+            continue;
+        }
+        bool numeric = value[0] != '\0' && strspn(value, "0123456789") == strlen(value);
+        esp_err_t err = numeric ? nvs_set_u32(handle, key, (uint32_t)strtoul(value, NULL, 10))
+                                : nvs_set_str(handle, key, value);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Seeding %s/%s failed: %s", item, key, esp_err_to_name(err));
+        }
+        nvs_close(handle);
+    }
+    free(list);
+    stats = (nvs_mem_stats_t){0}; // Seeding does not count as firmware writes
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    if (!nvs_lock) {
+        nvs_lock = xSemaphoreCreateMutex();
+        if (!nvs_lock) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (!initialized) {
+        initialized = true;
+        seed_from_env();
+    }
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_deinit(void)
+{
+    if (!initialized) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    if (nvs_lock) {
+        xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    }
+    while (entries) {
+        nvs_mem_entry_t *e = entries;
+        entries = e->next;
+        free_entry(e);
+    }
+    if (nvs_lock) {
+        xSemaphoreGive(nvs_lock);
+    }
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!initialized) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if (!valid_name(namespace_name)) {
+        return ESP_ERR_NVS_INVALID_NAME;
+    }
+
+    xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    esp_err_t err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    if (open_mode == NVS_READONLY) {
+        // A read-only open of a namespace that was never written fails on the device too
+        bool exists = false;
+        for (nvs_mem_entry_t *e = entries; e && !exists; e = e->next) {
+            exists = strcmp(e->ns, namespace_name) == 0;
+        }
+        if (!exists) {
+            xSemaphoreGive(nvs_lock);
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+    }
+    for (int i = 0; i < NVS_MEM_MAX_HANDLES; i++) {
+        if (!handles[i].in_use) {
+            handles[i].in_use = true;
+            handles[i].mode = open_mode;
+            snprintf(handles[i].ns, sizeof(handles[i].ns), "%s", namespace_name);
+            *out_handle = (nvs_handle_t)(i + 1);
+            err = ESP_OK;
+            break;
+        }
+    }
+    xSemaphoreGive(nvs_lock);
+    return err;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    if (!initialized) {
+        return;
+    }
+    xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    if (handle > 0 && handle <= NVS_MEM_MAX_HANDLES) {
+        handles[handle - 1].in_use = false;
+    }
+    xSemaphoreGive(nvs_lock);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    RETURN_IF_NOT_INITIALIZED();
+    xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    esp_err_t err;
+    if (get_handle(handle, false, &err)) {
+        stats.commits++;
+    }
+    xSemaphoreGive(nvs_lock);
+    return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    RETURN_IF_NOT_INITIALIZED();
+    xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    esp_err_t err;
+    nvs_mem_handle_t *h = get_handle(handle, true, &err);
+    if (h) {
+        if (remove_entries(h->ns, key) > 0) {
+            stats.writes++;
+        } else {
+            err = ESP_ERR_NVS_NOT_FOUND;
+        }
+    }
+    xSemaphoreGive(nvs_lock);
+    return err;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    RETURN_IF_NOT_INITIALIZED();
+    xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    esp_err_t err;
+    nvs_mem_handle_t *h = get_handle(handle, true, &err);
+    if (h) {
+        remove_entries(h->ns, NULL);
+        stats.writes++;
+    }
+    xSemaphoreGive(nvs_lock);
+    return err;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value)
+{
+    return store(handle, key, NVS_MEM_U8, value, NULL, 0);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return store(handle, key, NVS_MEM_U32, value, NULL, 0);
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return store(handle, key, NVS_MEM_STR, 0, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return store(handle, key, NVS_MEM_BLOB, 0, value, length);
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value)
+{
+    uint32_t value;
+    esp_err_t err = load(handle, key, NVS_MEM_U8, &value, NULL, NULL);
+    if (err == ESP_OK) {
+        *out_value = (uint8_t)value;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    return load(handle, key, NVS_MEM_U32, out_value, NULL, NULL);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return load(handle, key, NVS_MEM_STR, NULL, out_value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return load(handle, key, NVS_MEM_BLOB, NULL, out_value, length);
+}
+
+void nvs_mem_get_stats(nvs_mem_stats_t *out)
+{
+    if (!nvs_lock) {
+        *out = (nvs_mem_stats_t){0};
+        return;
+    }
+    xSemaphoreTake(nvs_lock, portMAX_DELAY);
+    *out = stats;
+    xSemaphoreGive(nvs_lock);
+}
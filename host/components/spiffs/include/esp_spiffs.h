@@ -0,0 +1,24 @@
+#ifndef ESP_SPIFFS_H
+#define ESP_SPIFFS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Stand-in for the SPIFFS VFS driver. Nothing is mounted: base_path must already be a
+// host directory (the host build points WEB_MOUNT_POINT at the staged web UI), and
+// files are opened there directly.
+
+typedef struct {
+    const char *base_path;
+    const char *partition_label;
+    size_t max_files;
+    bool format_if_mount_failed;
+} esp_vfs_spiffs_conf_t;
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf);
+esp_err_t esp_vfs_spiffs_unregister(const char *partition_label);
+// total is reported as the partition size from partitions.csv; used is the directory's file bytes
+esp_err_t esp_spiffs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes);
+
+#endif // ESP_SPIFFS_H
@@ -0,0 +1,81 @@
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_spiffs.h"
+
+static const char *TAG = "spiffs_host";
+
+#define SPIFFS_HOST_PARTITION_SIZE 0x270000 // Size of the spiffs entry in partitions.csv
+
+static char mounted_path[PATH_MAX];
+
+// Sum the sizes of the regular files below path
+static size_t directory_bytes(const char *path)
+{
+    DIR *dir = opendir(path);
+    if (!dir) {
+        return 0;
+    }
+    size_t total = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        char child[PATH_MAX];
+        struct stat st;
+        if (snprintf(child, sizeof(child), "%s/%s", path, entry->d_name) >= (int)sizeof(child) ||
+            stat(child, &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            total += directory_bytes(child);
+        } else if (S_ISREG(st.st_mode)) {
+            total += (size_t)st.st_size;
+        }
+    }
+    closedir(dir);
+    return total;
+}
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf)
+{
+    struct stat st;
+    if (!conf || !conf->base_path) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (mounted_path[0] != '\0') {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (stat(conf->base_path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        ESP_LOGE(TAG, "%s is not a directory; build the host project to stage the web UI", conf->base_path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    snprintf(mounted_path, sizeof(mounted_path), "%s", conf->base_path);
+    ESP_LOGI(TAG, "Serving %s in place of the SPIFFS partition", mounted_path);
+    return ESP_OK;
+}
+
+esp_err_t esp_vfs_spiffs_unregister(const char *partition_label)
+{
+    (void)partition_label;
+    if (mounted_path[0] == '\0') {
+        return ESP_ERR_INVALID_STATE;
+    }
+    mounted_path[0] = '\0';
+    return ESP_OK;
+}
+
+esp_err_t esp_spiffs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes)
+{
+    (void)partition_label;
+    if (mounted_path[0] == '\0') {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *total_bytes = SPIFFS_HOST_PARTITION_SIZE;
+    *used_bytes = directory_bytes(mounted_path);
+    return ESP_OK;
+}
@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "esp_log.h"
+#include "asset_manifest.h"
+
+#define TAG "ASSET_MANIFEST"
+
+static char *manifest_text = NULL; // Owns the strings the entries point into
+static asset_manifest_entry_t *manifest_entries = NULL;
+static size_t manifest_entry_count = 0;
+
+static int compare_entries(const void *a, const void *b)
+{
+    return strcmp(((const asset_manifest_entry_t *)a)->path, ((const asset_manifest_entry_t *)b)->path);
+}
+
+void asset_manifest_free(void)
+{
+    free(manifest_entries);
+    free(manifest_text);
+    manifest_entries = NULL;
+    manifest_text = NULL;
+    manifest_entry_count = 0;
+}
+
+esp_err_t asset_manifest_parse(const char *text, size_t len)
+{
+    asset_manifest_free();
+
+    manifest_text = (char *)malloc(len + 1);
+    if (!manifest_text) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(manifest_text, text, len);
+    manifest_text[len] = '\0';
+
+    // One entry per line is an upper bound on the table size
+    size_t max_entries = 1;
+    for (size_t i = 0; i < len; i++) {
+        if (manifest_text[i] == '\n') max_entries++;
+    }
+    manifest_entries = (asset_manifest_entry_t *)calloc(max_entries, sizeof(asset_manifest_entry_t));
+    if (!manifest_entries) {
+        asset_manifest_free();
+        return ESP_ERR_NO_MEM;
+    }
+
+    char *save_line = NULL;
+    for (char *line = strtok_r(manifest_text, "\r\n", &save_line); line != NULL;
+         line = strtok_r(NULL, "\r\n", &save_line)) {
+        char *save_field = NULL;
+        char *path = strtok_r(line, " ", &save_field);
+        char *hash = strtok_r(NULL, " ", &save_field);
+        char *gzip_flag = strtok_r(NULL, " ", &save_field);
+        if (!path || !hash || path[0] != '/') {
+            ESP_LOGW(TAG, "Skipping malformed manifest line");
+            continue;
+        }
+        asset_manifest_entry_t *entry = &manifest_entries[manifest_entry_count++];
+        entry->path = path;
+        entry->hash = hash;
+        entry->has_gzip = (gzip_flag != NULL && strcmp(gzip_flag, "1") == 0);
+    }
+
+    qsort(manifest_entries, manifest_entry_count, sizeof(asset_manifest_entry_t), compare_entries);
+    return ESP_OK;
+}
+
+esp_err_t asset_manifest_load(const char *manifest_path)
+{
+    FILE *fd = fopen(manifest_path, "r");
+    if (!fd) {
+        ESP_LOGW(TAG, "No asset manifest at %s, static files will be served without ETags", manifest_path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    fseek(fd, 0, SEEK_END);
+    long size = ftell(fd);
+    fseek(fd, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(fd);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    char *buf = (char *)malloc((size_t)size);
+    if (!buf) {
+        fclose(fd);
+        return ESP_ERR_NO_MEM;
+    }
+    size_t read_bytes = fread(buf, 1, (size_t)size, fd);
+    fclose(fd);
+
+    esp_err_t err = asset_manifest_parse(buf, read_bytes);
+    free(buf);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Loaded asset manifest with %u entries", (unsigned)manifest_entry_count);
+    }
+    return err;
+}
+
+const asset_manifest_entry_t *asset_manifest_find(const char *path)
+{
+    if (manifest_entry_count == 0) {
+        return NULL;
+    }
+    asset_manifest_entry_t key = { .path = path };
+    return (const asset_manifest_entry_t *)bsearch(&key, manifest_entries, manifest_entry_count,
+                                                   sizeof(asset_manifest_entry_t), compare_entries);
+}
+
+size_t asset_manifest_count(void)
+{
+    return manifest_entry_count;
+}
+
+bool etag_matches(const char *if_none_match, const char *etag)
+{
+    if (!if_none_match || !etag) {
+        return false;
+    }
+    size_t etag_len = strlen(etag);
+    const char *p = if_none_match;
+    while (*p) {
+        // Skip list separators and whitespace
+        while (*p == ' ' || *p == ',' || *p == '\t') p++;
+        if (*p == '\0') break;
+        if (*p == '*') return true;
+        // Weak validators compare equal for If-None-Match (RFC 9110 weak comparison)
+        if (p[0] == 'W' && p[1] == '/') p += 2;
+
+        const char *end = p;
+        if (*end == '"') {
+            end = strchr(end + 1, '"');
+            end = end ? end + 1 : p + strlen(p);
+        } else {
+            while (*end && *end != ',') end++;
+        }
+        if ((size_t)(end - p) == etag_len && strncmp(p, etag, etag_len) == 0) {
+            return true;
+        }
+        p = end;
+    }
+    return false;
+}
+
+// q-value of one Accept-Encoding entry; params runs from just after the coding to the
+// next ',' or the end. No q parameter means 1.
+static double coding_qvalue(const char *params, const char *end)
+{
+    const char *p = params;
+    while (p < end) {
+        while (p < end && (*p == ';' || *p == ' ' || *p == '\t')) p++;
+        if (end - p >= 2 && (p[0] == 'q' || p[0] == 'Q') && p[1] == '=') {
+            return strtod(p + 2, NULL);
+        }
+        while (p < end && *p != ';') p++;
+    }
+    return 1.0;
+}
+
+bool accept_encoding_allows_gzip(const char *accept_encoding)
+{
+    if (!accept_encoding) {
+        return false;
+    }
+    int gzip = -1;     // -1 not listed, else 0/1 by its q-value
+    int wildcard = -1;
+    const char *p = accept_encoding;
+    while (*p) {
+        while (*p == ' ' || *p == ',' || *p == '\t') p++;
+        if (*p == '\0') break;
+        const char *end = strchr(p, ',');
+        end = end ? end : p + strlen(p);
+        const char *name_end = p;
+        while (name_end < end && *name_end != ';' && *name_end != ' ' && *name_end != '\t') name_end++;
+        size_t name_len = (size_t)(name_end - p);
+        int allowed = coding_qvalue(name_end, end) > 0.0;
+        if ((name_len == 4 && strncasecmp(p, "gzip", 4) == 0) ||
+            (name_len == 6 && strncasecmp(p, "x-gzip", 6) == 0)) {
+            gzip = allowed;
+        } else if (name_len == 1 && *p == '*') {
+            wildcard = allowed;
+        }
+        p = end;
+    }
+    // An explicit entry wins over the wildcard
+    return gzip >= 0 ? gzip == 1 : wildcard == 1;
+}
@@ -0,0 +1,41 @@
+#ifndef ASSET_MANIFEST_H
+#define ASSET_MANIFEST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Build-time manifest of the SPIFFS web assets, written by tools/prepare_spiffs_image.py.
+// Each line is "<uri path> <content hash> <has .gz sibling (0/1)>".
+#define ASSET_MANIFEST_FILENAME "/.manifest"
+
+typedef struct {
+    const char *path;   // URI path, e.g. "/static/js/main.1a2b3c4d.js"
+    const char *hash;   // Hex content hash of the uncompressed file
+    bool has_gzip;      // A precompressed .gz sibling exists
+} asset_manifest_entry_t;
+
+// Parse manifest text into the in-memory lookup table, replacing any previous one.
+// The text is copied, so the caller keeps ownership of the buffer.
+esp_err_t asset_manifest_parse(const char *text, size_t len);
+
+// Read and parse the manifest file from the mounted web filesystem
+esp_err_t asset_manifest_load(const char *manifest_path);
+
+// Release the lookup table
+void asset_manifest_free(void);
+
+// Binary search for a URI path; returns NULL if the asset is not in the manifest
+const asset_manifest_entry_t *asset_manifest_find(const char *path);
+
+// Number of entries currently loaded
+size_t asset_manifest_count(void);
+
+// Check an If-None-Match header value (a list of ETags, or "*") against an ETag
+bool etag_matches(const char *if_none_match, const char *etag);
+
+// Check an Accept-Encoding header value for gzip: listed (or covered by "*") with a
+// non-zero q-value. "gzip;q=0" is an explicit refusal.
+bool accept_encoding_allows_gzip(const char *accept_encoding);
+
+#endif // ASSET_MANIFEST_H
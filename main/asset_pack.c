@@ -0,0 +1,186 @@
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_crc.h"
+#include "esp_partition.h"
+#include "asset_pack.h"
+
+#define TAG "ASSET_PACK"
+
+// Set once at boot, read-only afterwards
+static const uint8_t *pack_base = NULL;
+static size_t pack_len = 0;
+static const asset_pack_entry_t *pack_entries = NULL;
+static uint32_t pack_count = 0;
+static esp_partition_mmap_handle_t pack_mmap_handle;
+static bool pack_mapped = false;
+
+uint32_t asset_pack_hash(const char *path)
+{
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// A string table offset is usable if a terminator follows it inside the table
+static bool valid_string(const asset_pack_header_t *hdr, uint32_t offset)
+{
+    if (offset >= hdr->strings_size) {
+        return false;
+    }
+    const char *start = (const char *)pack_base + hdr->strings_offset + offset;
+    return memchr(start, '\0', hdr->strings_size - offset) != NULL;
+}
+
+static bool valid_range(size_t image_len, uint32_t offset, uint32_t len)
+{
+    return offset <= image_len && len <= image_len - offset;
+}
+
+esp_err_t asset_pack_attach(const void *image, size_t image_len)
+{
+    asset_pack_detach();
+    const asset_pack_header_t *hdr = (const asset_pack_header_t *)image;
+    if (image_len < sizeof(*hdr) || hdr->magic != ASSET_PACK_MAGIC || hdr->version != ASSET_PACK_VERSION ||
+        hdr->header_size != sizeof(*hdr) || hdr->entry_size != sizeof(asset_pack_entry_t)) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    size_t index_len = (size_t)hdr->entry_count * sizeof(asset_pack_entry_t);
+    if (hdr->total_size > image_len || hdr->entry_count > hdr->total_size / sizeof(asset_pack_entry_t) ||
+        hdr->strings_offset != hdr->header_size + index_len ||
+        !valid_range(hdr->total_size, hdr->strings_offset, hdr->strings_size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const uint8_t *base = (const uint8_t *)image;
+    if (esp_crc32_le(0, base + hdr->header_size, index_len + hdr->strings_size) != hdr->index_crc32) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    // Check every offset once here so lookups can trust them
+    pack_base = base;
+    const asset_pack_entry_t *entries = (const asset_pack_entry_t *)(base + hdr->header_size);
+    for (uint32_t i = 0; i < hdr->entry_count; i++) {
+        const asset_pack_entry_t *e = &entries[i];
+        bool gzip = (e->flags & ASSET_PACK_FLAG_GZIP) != 0;
+        if (!valid_string(hdr, e->path) || !valid_string(hdr, e->mime) ||
+            !valid_string(hdr, e->etag) || !valid_string(hdr, e->etag_gzip) ||
+            !valid_range(hdr->total_size, e->data_offset, e->data_len) ||
+            (gzip && !valid_range(hdr->total_size, e->gzip_offset, e->gzip_len)) ||
+            (i > 0 && entries[i - 1].path_hash > e->path_hash)) {
+            pack_base = NULL;
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+    pack_len = hdr->total_size;
+    pack_entries = entries;
+    pack_count = hdr->entry_count;
+    return ESP_OK;
+}
+
+esp_err_t asset_pack_mount(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                           ASSET_PACK_PARTITION_LABEL);
+    if (part == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Map only what the image uses; the data address space is shared with the app's rodata
+    asset_pack_header_t hdr;
+    esp_err_t err = esp_partition_read(part, 0, &hdr, sizeof(hdr));
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (hdr.magic != ASSET_PACK_MAGIC) {
+        ESP_LOGE(TAG, "Partition '%s' holds no asset pack (was it flashed?)", part->label);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (hdr.total_size < sizeof(hdr) || hdr.total_size > part->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const void *image = NULL;
+    err = esp_partition_mmap(part, 0, hdr.total_size, ESP_PARTITION_MMAP_DATA, &image, &pack_mmap_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map %lu bytes of '%s': %s", (unsigned long)hdr.total_size, part->label,
+                 esp_err_to_name(err));
+        return err;
+    }
+    err = asset_pack_attach(image, hdr.total_size);
+    if (err != ESP_OK) {
+        esp_partition_munmap(pack_mmap_handle);
+        ESP_LOGE(TAG, "Asset pack in '%s' rejected: %s", part->label, esp_err_to_name(err));
+        return err;
+    }
+    pack_mapped = true;
+    ESP_LOGI(TAG, "Mapped %lu assets (%lu bytes) from partition '%s'", (unsigned long)pack_count,
+             (unsigned long)pack_len, part->label);
+    return ESP_OK;
+}
+
+bool asset_pack_is_mounted(void)
+{
+    return pack_entries != NULL;
+}
+
+size_t asset_pack_count(void)
+{
+    return pack_count;
+}
+
+static const char *pack_string(uint32_t offset)
+{
+    const asset_pack_header_t *hdr = (const asset_pack_header_t *)pack_base;
+    return (const char *)pack_base + hdr->strings_offset + offset;
+}
+
+bool asset_pack_find(const char *path, bool want_gzip, asset_pack_file_t *out)
+{
+    if (pack_entries == NULL) {
+        return false;
+    }
+    uint32_t hash = asset_pack_hash(path);
+
+    // Lower bound on the hash, then compare paths across any collisions
+    uint32_t lo = 0, hi = pack_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (pack_entries[mid].path_hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (uint32_t i = lo; i < pack_count && pack_entries[i].path_hash == hash; i++) {
+        const asset_pack_entry_t *e = &pack_entries[i];
+        if (strcmp(pack_string(e->path), path) != 0) {
+            continue;
+        }
+        bool gzip = want_gzip && (e->flags & ASSET_PACK_FLAG_GZIP);
+        *out = (asset_pack_file_t){
+            .path = pack_string(e->path),
+            .mime = pack_string(e->mime),
+            .etag = pack_string(gzip ? e->etag_gzip : e->etag),
+            .data = pack_base + (gzip ? e->gzip_offset : e->data_offset),
+            .len = gzip ? e->gzip_len : e->data_len,
+            .gzip = gzip,
+        };
+        return true;
+    }
+    return false;
+}
+
+void asset_pack_detach(void)
+{
+    if (pack_mapped) {
+        esp_partition_munmap(pack_mmap_handle);
+        pack_mapped = false;
+    }
+    pack_base = NULL;
+    pack_len = 0;
+    pack_entries = NULL;
+    pack_count = 0;
+}
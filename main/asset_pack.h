@@ -0,0 +1,83 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Read-only web asset image written by tools/pack_assets.py and flashed to its own data
+// partition. The partition is memory-mapped once at boot and responses are sent straight
+// from the mapping: no VFS, no file descriptors, no heap.
+//
+// Layout (little-endian, every section 4-byte aligned):
+//   asset_pack_header_t
+//   asset_pack_entry_t[entry_count], sorted by (path_hash, path)
+//   string table: NUL-terminated paths, MIME types and quoted ETags
+//   file data, one block per representation (identity and optional gzip)
+#define ASSET_PACK_PARTITION_LABEL "assets"
+#define ASSET_PACK_MAGIC 0x50414852 // "RHAP"
+#define ASSET_PACK_VERSION 1
+
+#define ASSET_PACK_FLAG_GZIP 0x1 // gzip_offset/gzip_len hold a precompressed copy
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;    // sizeof(asset_pack_header_t); the index starts here
+    uint32_t entry_count;
+    uint32_t entry_size;     // sizeof(asset_pack_entry_t)
+    uint32_t strings_offset;
+    uint32_t strings_size;
+    uint32_t total_size;     // Bytes used in the partition, data included
+    uint32_t index_crc32;    // CRC-32 of the index and the string table
+} asset_pack_header_t;
+
+typedef struct {
+    uint32_t path_hash;      // asset_pack_hash() of the URI path
+    uint32_t path;           // String table offsets
+    uint32_t mime;
+    uint32_t etag;           // "\"<content hash>\""
+    uint32_t etag_gzip;      // "\"<content hash>-gz\""
+    uint32_t flags;          // ASSET_PACK_FLAG_*
+    uint32_t data_offset;    // From the start of the image
+    uint32_t data_len;
+    uint32_t gzip_offset;
+    uint32_t gzip_len;
+} asset_pack_entry_t;
+
+// What a response needs, pointing into the image
+typedef struct {
+    const char *path;
+    const char *mime;
+    const char *etag;
+    const uint8_t *data;
+    size_t len;
+    bool gzip;
+} asset_pack_file_t;
+
+// 32-bit FNV-1a; pack_assets.py computes the same
+uint32_t asset_pack_hash(const char *path);
+
+// Validate an image already in memory and serve from it. The memory must outlive the
+// pack (a flash mapping or a test buffer). Returns ESP_ERR_INVALID_VERSION for a bad
+// magic or version, ESP_ERR_INVALID_SIZE for offsets outside the image and
+// ESP_ERR_INVALID_CRC for a damaged index.
+esp_err_t asset_pack_attach(const void *image, size_t image_len);
+
+// Find the asset partition, map the used part of it and attach it.
+// ESP_ERR_NOT_FOUND when the partition table has no asset partition.
+esp_err_t asset_pack_mount(void);
+
+bool asset_pack_is_mounted(void);
+
+size_t asset_pack_count(void);
+
+// Look up a URI path, preferring the gzip copy when want_gzip is set and one exists.
+// Returns false if the path is not in the pack.
+bool asset_pack_find(const char *path, bool want_gzip, asset_pack_file_t *out);
+
+// Forget the attached image (used by tests)
+void asset_pack_detach(void);
+
+#endif // ASSET_PACK_H
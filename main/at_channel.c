@@ -0,0 +1,176 @@
+#include <string.h>
+
+#include "at_channel.h"
+
+// All well inside Bluedroid's own AT timeout (about 30 s), after which it drops the
+// link and at_channel_flush() clears the lot anyway
+static const uint32_t timeout_ms[AT_CMD_TYPE_COUNT] = {
+    [AT_CMD_DIAL] = 15000,
+    [AT_CMD_REDIAL] = 15000,
+    [AT_CMD_MEMORY_DIAL] = 15000,
+    [AT_CMD_CLCC] = 5000,
+    [AT_CMD_HANGUP] = 5000,
+};
+
+static const char *const cmd_names[AT_CMD_TYPE_COUNT] = {
+    [AT_CMD_DIAL] = "dial",
+    [AT_CMD_REDIAL] = "redial",
+    [AT_CMD_MEMORY_DIAL] = "memory_dial",
+    [AT_CMD_CLCC] = "clcc",
+    [AT_CMD_HANGUP] = "hangup",
+};
+
+static const char *const result_names[AT_RESULT_COUNT] = {
+    [AT_RESULT_OK] = "ok",
+    [AT_RESULT_ERROR] = "error",
+    [AT_RESULT_BUSY] = "busy",
+    [AT_RESULT_TIMEOUT] = "timeout",
+    [AT_RESULT_LINK_LOST] = "link_lost",
+};
+
+void at_channel_init(at_channel_t *ch)
+{
+    memset(ch, 0, sizeof(*ch));
+}
+
+uint32_t at_channel_timeout_ms(at_cmd_type_t type)
+{
+    return type < AT_CMD_TYPE_COUNT ? timeout_ms[type] : 0;
+}
+
+const char *at_channel_cmd_name(at_cmd_type_t type)
+{
+    return type < AT_CMD_TYPE_COUNT ? cmd_names[type] : "unknown";
+}
+
+const char *at_channel_result_name(at_result_t result)
+{
+    return result < AT_RESULT_COUNT ? result_names[result] : "unknown";
+}
+
+static at_pending_t *oldest(at_channel_t *ch)
+{
+    return ch->count > 0 ? &ch->pending[ch->head] : NULL;
+}
+
+// Drop the oldest; the next one goes on the air now
+static void pop(at_channel_t *ch, int64_t now_us)
+{
+    ch->head = (ch->head + 1) % AT_CHANNEL_DEPTH;
+    ch->count--;
+    if (ch->count > 0) {
+        ch->pending[ch->head].head_us = now_us > 0 ? now_us : 1;
+    }
+}
+
+static void complete(const at_pending_t *p, at_result_t result, int64_t now_us, at_completion_t *done)
+{
+    done->id = p->id;
+    done->type = p->type;
+    done->result = result;
+    done->round_trip_us = now_us > p->head_us ? now_us - p->head_us : 0;
+}
+
+esp_err_t at_channel_sent(at_channel_t *ch, uint32_t id, at_cmd_type_t type, int64_t now_us)
+{
+    if (ch->count >= AT_CHANNEL_DEPTH) {
+        return ESP_ERR_NO_MEM;
+    }
+    at_pending_t *p = &ch->pending[(ch->head + ch->count) % AT_CHANNEL_DEPTH];
+    p->id = id;
+    p->type = type;
+    p->head_us = ch->count == 0 ? (now_us > 0 ? now_us : 1) : 0;
+    p->timed_out = false;
+    ch->count++;
+    ch->stats.sent++;
+    return ESP_OK;
+}
+
+bool at_channel_unsend(at_channel_t *ch, uint32_t id, int64_t now_us)
+{
+    // Newest first: normally it is the last one recorded
+    for (uint8_t n = ch->count; n-- > 0;) {
+        if (ch->pending[(ch->head + n) % AT_CHANNEL_DEPTH].id != id) {
+            continue;
+        }
+        if (n == 0) {
+            pop(ch, now_us);
+        } else {
+            for (uint8_t i = n; i + 1 < ch->count; i++) {
+                ch->pending[(ch->head + i) % AT_CHANNEL_DEPTH] = ch->pending[(ch->head + i + 1) % AT_CHANNEL_DEPTH];
+            }
+            ch->count--;
+        }
+        ch->stats.sent--;
+        return true;
+    }
+    return false;
+}
+
+bool at_channel_answer(at_channel_t *ch, at_result_t result, int64_t now_us, at_completion_t *done)
+{
+    at_pending_t *p = oldest(ch);
+    if (!p) {
+        ch->stats.unmatched++;
+        return false;
+    }
+    bool timed_out = p->timed_out;
+    if (timed_out) {
+        ch->stats.late++;
+    } else {
+        complete(p, result, now_us, done);
+        ch->stats.answered++;
+    }
+    pop(ch, now_us);
+    return !timed_out;
+}
+
+bool at_channel_expire(at_channel_t *ch, int64_t now_us, at_completion_t *done)
+{
+    at_pending_t *p = oldest(ch);
+    if (!p || p->timed_out || now_us < at_channel_next_deadline(ch)) {
+        return false;
+    }
+    p->timed_out = true; // Keeps its place until the answer it is owed turns up
+    complete(p, AT_RESULT_TIMEOUT, now_us, done);
+    ch->stats.timeouts++;
+    return true;
+}
+
+int64_t at_channel_next_deadline(const at_channel_t *ch)
+{
+    if (ch->count == 0 || ch->pending[ch->head].timed_out) {
+        return 0;
+    }
+    const at_pending_t *p = &ch->pending[ch->head];
+    return p->head_us + (int64_t)at_channel_timeout_ms(p->type) * 1000;
+}
+
+uint32_t at_channel_pending_id(const at_channel_t *ch, at_cmd_type_t type)
+{
+    for (uint8_t n = 0; n < ch->count; n++) {
+        const at_pending_t *p = &ch->pending[(ch->head + n) % AT_CHANNEL_DEPTH];
+        if (p->type == type && !p->timed_out) {
+            return p->id;
+        }
+    }
+    return 0;
+}
+
+bool at_channel_flush(at_channel_t *ch, at_completion_t *done)
+{
+    at_pending_t *p;
+    while ((p = oldest(ch)) != NULL) {
+        bool timed_out = p->timed_out;
+        if (!timed_out) {
+            complete(p, AT_RESULT_LINK_LOST, p->head_us, done); // No round trip to speak of
+            ch->stats.lost++;
+        }
+        ch->head = (ch->head + 1) % AT_CHANNEL_DEPTH;
+        ch->count--;
+        if (!timed_out) {
+            return true;
+        }
+    }
+    return false;
+}
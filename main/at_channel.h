@@ -0,0 +1,111 @@
+#ifndef AT_CHANNEL_H
+#define AT_CHANNEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Matching the phone's OK/ERROR answers to the AT commands that asked for them.
+// Bluedroid sends one command at a time and queues the rest, and the phone answers
+// each with exactly one final result code, so answers come back in the order the
+// commands went out: the oldest outstanding command owns the next answer. Several
+// commands can be outstanding at once (a dial, a +CLCC query, a hang-up).
+//
+// A command's clock starts when it reaches the head of the queue, i.e. when Bluedroid
+// puts it on the air, so round trips do not include time spent behind other commands.
+// A command that times out stays at the head, its answer still owed, until that late
+// answer or a link loss clears it; otherwise the late answer would be taken for the
+// next command's.
+//
+// Pure bookkeeping with caller-supplied timestamps (esp_timer_get_time()); hf_at.c
+// owns the lock, the timer and the HFP calls.
+#define AT_CHANNEL_DEPTH 8
+
+typedef enum {
+    AT_CMD_DIAL,        // ATD<number>;
+    AT_CMD_REDIAL,      // AT+BLDN
+    AT_CMD_MEMORY_DIAL, // ATD><location>;
+    AT_CMD_CLCC,        // AT+CLCC
+    AT_CMD_HANGUP,      // AT+CHUP
+    AT_CMD_TYPE_COUNT,
+} at_cmd_type_t;
+
+typedef enum {
+    AT_RESULT_OK,
+    AT_RESULT_ERROR,     // ERROR, +CME ERROR and the like: the command was refused
+    AT_RESULT_BUSY,      // BUSY, NO CARRIER, NO ANSWER: the line, not the command
+    AT_RESULT_TIMEOUT,   // No answer within at_channel_timeout_ms()
+    AT_RESULT_LINK_LOST, // The HFP link dropped with the command outstanding
+    AT_RESULT_COUNT,
+} at_result_t;
+
+typedef struct {
+    uint32_t id;          // Caller's ID, e.g. the call-control command ID
+    at_cmd_type_t type;
+    int64_t head_us;      // When it reached the head of the queue; 0 while behind others
+    bool timed_out;       // Reported as a timeout; its answer has not come yet
+} at_pending_t;
+
+typedef struct {
+    uint32_t id;
+    at_cmd_type_t type;
+    at_result_t result;
+    int64_t round_trip_us; // Head of the queue to the answer or the timeout
+} at_completion_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t answered;    // Answers matched to a waiting command
+    uint32_t timeouts;
+    uint32_t late;        // Answers to commands already reported as timed out
+    uint32_t unmatched;   // Answers with nothing outstanding
+    uint32_t lost;        // Outstanding when the link dropped
+} at_channel_stats_t;
+
+typedef struct {
+    at_pending_t pending[AT_CHANNEL_DEPTH]; // Ring buffer, oldest at head
+    uint8_t head;
+    uint8_t count;
+    at_channel_stats_t stats;
+} at_channel_t;
+
+void at_channel_init(at_channel_t *ch);
+
+// How long the phone gets to answer each command type
+uint32_t at_channel_timeout_ms(at_cmd_type_t type);
+
+const char *at_channel_cmd_name(at_cmd_type_t type);
+const char *at_channel_result_name(at_result_t result);
+
+// Record a command about to be handed to Bluedroid. Record it first: the answer can
+// arrive before the HFP call returns. ESP_ERR_NO_MEM when AT_CHANNEL_DEPTH are
+// outstanding.
+esp_err_t at_channel_sent(at_channel_t *ch, uint32_t id, at_cmd_type_t type, int64_t now_us);
+
+// Take back command id because handing it to Bluedroid failed. Other commands may have
+// been recorded or answered since it was; if it had reached the head, the next one
+// goes on the air in its place.
+bool at_channel_unsend(at_channel_t *ch, uint32_t id, int64_t now_us);
+
+// The phone answered. Completes the oldest outstanding command and returns true, or
+// returns false if nothing was waiting for the answer (nothing outstanding, or the
+// oldest already timed out).
+bool at_channel_answer(at_channel_t *ch, at_result_t result, int64_t now_us, at_completion_t *done);
+
+// Report the oldest command as timed out if its time is up. Only the oldest can time
+// out: the others are not on the air yet.
+bool at_channel_expire(at_channel_t *ch, int64_t now_us, at_completion_t *done);
+
+// When at_channel_expire() next has something to do; 0 if never
+int64_t at_channel_next_deadline(const at_channel_t *ch);
+
+// ID of the oldest command of this type still waiting for its answer, or 0 if none.
+// One that has timed out no longer counts.
+uint32_t at_channel_pending_id(const at_channel_t *ch, at_cmd_type_t type);
+
+// The link dropped: complete the oldest outstanding command with AT_RESULT_LINK_LOST.
+// Call until it returns false. A command already reported as timed out is cleared
+// without being reported again.
+bool at_channel_flush(at_channel_t *ch, at_completion_t *done);
+
+#endif // AT_CHANNEL_H
@@ -0,0 +1,167 @@
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "boot_timing.h"
+
+#define TAG "BOOT"
+
+static const char *const phase_names[BOOT_PHASE_COUNT] = {
+    [BOOT_PHASE_NVS] = "nvs",
+    [BOOT_PHASE_RESET_PIN] = "reset_pin",
+    [BOOT_PHASE_ASSETS] = "assets",
+    [BOOT_PHASE_SETTINGS] = "settings",
+    [BOOT_PHASE_BT_CONTROLLER] = "bt_controller",
+    [BOOT_PHASE_BLUEDROID] = "bluedroid",
+    [BOOT_PHASE_HFP] = "hfp",
+    [BOOT_PHASE_WIFI] = "wifi",
+};
+
+static const char *const milestone_names[BOOT_MILESTONE_COUNT] = {
+    [BOOT_MILESTONE_APP_MAIN_DONE] = "app_main_done",
+    [BOOT_MILESTONE_WEB_SERVER] = "web_server",
+    [BOOT_MILESTONE_NETWORK_UP] = "network_up",
+    [BOOT_MILESTONE_HFP_CONNECTED] = "hfp_connected",
+};
+
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+static boot_phase_timing_t phases[BOOT_PHASE_COUNT];
+static int64_t milestones[BOOT_MILESTONE_COUNT]; // 0 until reached
+
+const char *boot_phase_name(boot_phase_t phase)
+{
+    return phase < BOOT_PHASE_COUNT ? phase_names[phase] : "unknown";
+}
+
+const char *boot_milestone_name(boot_milestone_t milestone)
+{
+    return milestone < BOOT_MILESTONE_COUNT ? milestone_names[milestone] : "unknown";
+}
+
+void boot_timing_start(boot_phase_t phase, int64_t now_us)
+{
+    if (phase >= BOOT_PHASE_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&lock);
+    phases[phase] = (boot_phase_timing_t){ .start_us = now_us, .end_us = 0, .err = ESP_OK };
+    portEXIT_CRITICAL(&lock);
+}
+
+void boot_timing_end(boot_phase_t phase, int64_t now_us, esp_err_t err)
+{
+    if (phase >= BOOT_PHASE_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&lock);
+    phases[phase].end_us = now_us;
+    phases[phase].err = err;
+    int64_t took_us = now_us - phases[phase].start_us;
+    portEXIT_CRITICAL(&lock);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "%s: %" PRId64 " ms", phase_names[phase], took_us / 1000);
+    } else {
+        ESP_LOGE(TAG, "%s failed after %" PRId64 " ms: %s", phase_names[phase], took_us / 1000, esp_err_to_name(err));
+    }
+}
+
+void boot_timing_mark(boot_milestone_t milestone, int64_t now_us)
+{
+    if (milestone >= BOOT_MILESTONE_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&lock);
+    bool first = milestones[milestone] == 0;
+    if (first) {
+        milestones[milestone] = now_us;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (first) {
+        ESP_LOGI(TAG, "%s at %" PRId64 " ms", milestone_names[milestone], now_us / 1000);
+    }
+}
+
+void boot_timing_get(boot_phase_t phase, boot_phase_timing_t *out)
+{
+    if (phase >= BOOT_PHASE_COUNT) {
+        *out = (boot_phase_timing_t){0};
+        return;
+    }
+    portENTER_CRITICAL(&lock);
+    *out = phases[phase];
+    portEXIT_CRITICAL(&lock);
+}
+
+// Append to buf at *len; sticky failure once it no longer fits
+static void append(char *buf, size_t buf_len, size_t *len, bool *overflow, const char *fmt, ...)
+{
+    if (*overflow) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + *len, buf_len - *len, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= buf_len - *len) {
+        *overflow = true;
+        return;
+    }
+    *len += (size_t)n;
+}
+
+int boot_timing_write_json(const char *reset_reason, char *buf, size_t buf_len)
+{
+    if (buf_len == 0) {
+        return -1;
+    }
+    boot_phase_timing_t snapshot[BOOT_PHASE_COUNT];
+    int64_t reached[BOOT_MILESTONE_COUNT];
+    portENTER_CRITICAL(&lock);
+    memcpy(snapshot, phases, sizeof(snapshot));
+    memcpy(reached, milestones, sizeof(reached));
+    portEXIT_CRITICAL(&lock);
+
+    size_t len = 0;
+    bool overflow = false;
+    append(buf, buf_len, &len, &overflow, "{\"reset_reason\":\"%s\",\"phases\":[", reset_reason);
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        const boot_phase_timing_t *p = &snapshot[i];
+        const char *status = p->start_us == 0 ? "pending"
+                           : p->end_us == 0   ? "running"
+                           : p->err == ESP_OK ? "ok"
+                           : esp_err_to_name(p->err);
+        append(buf, buf_len, &len, &overflow, "%s{\"name\":\"%s\",\"status\":\"%s\"", i > 0 ? "," : "",
+               phase_names[i], status);
+        if (p->start_us != 0) {
+            append(buf, buf_len, &len, &overflow, ",\"start_us\":%" PRId64, p->start_us);
+        }
+        if (p->end_us != 0) {
+            append(buf, buf_len, &len, &overflow, ",\"end_us\":%" PRId64 ",\"duration_us\":%" PRId64,
+                   p->end_us, p->end_us - p->start_us);
+        }
+        append(buf, buf_len, &len, &overflow, "}");
+    }
+    append(buf, buf_len, &len, &overflow, "],\"milestones\":{");
+    for (int i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+        if (reached[i] != 0) {
+            append(buf, buf_len, &len, &overflow, "%s\"%s_us\":%" PRId64, i > 0 ? "," : "", milestone_names[i], reached[i]);
+        } else {
+            append(buf, buf_len, &len, &overflow, "%s\"%s_us\":null", i > 0 ? "," : "", milestone_names[i]);
+        }
+    }
+    append(buf, buf_len, &len, &overflow, "}}");
+    return overflow ? -1 : (int)len;
+}
+
+void boot_timing_reset(void)
+{
+    portENTER_CRITICAL(&lock);
+    memset(phases, 0, sizeof(phases));
+    memset(milestones, 0, sizeof(milestones));
+    portEXIT_CRITICAL(&lock);
+}
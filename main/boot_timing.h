@@ -0,0 +1,60 @@
+#ifndef BOOT_TIMING_H
+#define BOOT_TIMING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Start and end times of each bring-up phase, for GET /boot_timing. Phases run on
+// different boot tasks, so every phase has its own slot and updates take a short lock.
+// Timestamps are caller-supplied (esp_timer_get_time(), i.e. time since boot).
+
+typedef enum {
+    BOOT_PHASE_NVS,
+    BOOT_PHASE_RESET_PIN,     // Pin settle time plus a factory reset when it is held low
+    BOOT_PHASE_ASSETS,        // Asset pack mapping, or the SPIFFS mount it falls back to
+    BOOT_PHASE_SETTINGS,      // Settings store, call-control task, HTTP workers and redial timer
+    BOOT_PHASE_BT_CONTROLLER,
+    BOOT_PHASE_BLUEDROID,     // Host stack, GAP security, class of device, scan mode
+    BOOT_PHASE_HFP,           // HFP client init and callback; the phone can connect after this
+    BOOT_PHASE_WIFI,          // Netif, event loop, driver init and start in AP or STA mode
+    BOOT_PHASE_COUNT,
+} boot_phase_t;
+
+// One-off events after the phases, recorded the first time they happen
+typedef enum {
+    BOOT_MILESTONE_APP_MAIN_DONE,
+    BOOT_MILESTONE_WEB_SERVER,   // HTTP server accepting connections
+    BOOT_MILESTONE_NETWORK_UP,   // AP started or station got an IP
+    BOOT_MILESTONE_HFP_CONNECTED, // First service level connection to the phone
+    BOOT_MILESTONE_COUNT,
+} boot_milestone_t;
+
+typedef struct {
+    int64_t start_us; // 0 until started
+    int64_t end_us;   // 0 while running
+    esp_err_t err;
+} boot_phase_timing_t;
+
+// Upper bound for a rendered /boot_timing document, including the terminator
+#define BOOT_TIMING_JSON_MAX 1536
+
+const char *boot_phase_name(boot_phase_t phase);
+const char *boot_milestone_name(boot_milestone_t milestone);
+
+void boot_timing_start(boot_phase_t phase, int64_t now_us);
+void boot_timing_end(boot_phase_t phase, int64_t now_us, esp_err_t err);
+void boot_timing_mark(boot_milestone_t milestone, int64_t now_us);
+
+void boot_timing_get(boot_phase_t phase, boot_phase_timing_t *out);
+
+// Render every phase and milestone as JSON. reset_reason is reported as-is so the
+// numbers can be told apart after a power-on, brownout or watchdog reset. Returns the
+// length written (excluding the terminator), or -1 if buf is too small.
+int boot_timing_write_json(const char *reset_reason, char *buf, size_t buf_len);
+
+// Forget everything recorded (used by tests)
+void boot_timing_reset(void);
+
+#endif // BOOT_TIMING_H
@@ -0,0 +1,203 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "esp_hf_client_api.h"
+#include "metrics.h"
+#include "bt_link.h"
+
+#define TAG "BT_LINK"
+
+// Task notification bits, set by the HFP callback
+#define LINK_EVT_CONNECTED (1u << 0)
+#define LINK_EVT_LOST (1u << 1)
+#define LINK_EVT_CONNECT_FAILED (1u << 2)
+
+static bt_link_config_t config;
+static TaskHandle_t link_task = NULL;
+
+// Guarded by lock: the HFP callback writes the link state, the task the bookkeeping,
+// and /status and /metrics read both
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+static bt_reconnect_t reconnect;
+static bool link_up;
+static uint8_t link_bda[BT_RECONNECT_BDA_LEN]; // Phone the link last came up with
+
+// Link task only
+static uint8_t peer[BT_RECONNECT_BDA_LEN];
+static bool peer_known;
+static bool paging;          // A connect is out and has not reported back
+static int64_t deadline_us;  // When to page, or give up on the page; 0 when idle
+
+static void notify_changed(void)
+{
+    if (config.changed) {
+        config.changed();
+    }
+}
+
+// Count the next page and arm the wait before it
+static void plan_page(int64_t now_us)
+{
+    portENTER_CRITICAL(&lock);
+    uint32_t delay_ms = bt_reconnect_next_delay_ms(&reconnect, esp_random());
+    uint32_t attempt = reconnect.attempts;
+    portEXIT_CRITICAL(&lock);
+    deadline_us = now_us + (int64_t)delay_ms * 1000;
+    ESP_LOGI(TAG, "Paging the phone in %lu ms (attempt %lu)", (unsigned long)delay_ms, (unsigned long)attempt);
+}
+
+static void page(int64_t now_us)
+{
+    metrics_inc(METRIC_BT_RECONNECT_ATTEMPTS);
+    esp_err_t err = esp_hf_client_connect(peer);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Paging the phone failed: %s", esp_err_to_name(err));
+        plan_page(now_us);
+        return;
+    }
+    paging = true;
+    deadline_us = now_us + (int64_t)BT_LINK_CONNECT_TIMEOUT_MS * 1000;
+}
+
+static void link_came_up(int64_t now_us)
+{
+    uint8_t bda[BT_RECONNECT_BDA_LEN];
+    portENTER_CRITICAL(&lock);
+    memcpy(bda, link_bda, sizeof(bda));
+    bool ended = bt_reconnect_connected(&reconnect, now_us);
+    int64_t latency_us = reconnect.last_latency_us;
+    uint32_t attempts = reconnect.last_attempts;
+    portEXIT_CRITICAL(&lock);
+
+    paging = false;
+    deadline_us = 0;
+    if (ended) {
+        metrics_inc(METRIC_BT_RECONNECTS);
+        metrics_observe_bt_reconnect(latency_us);
+        ESP_LOGI(TAG, "Phone back after %lld ms and %lu pages", (long long)(latency_us / 1000), (unsigned long)attempts);
+    }
+    // Here rather than in the HFP callback, which must not wait on flash
+    memcpy(peer, bda, sizeof(bda));
+    peer_known = true;
+    bt_reconnect_store_peer(peer);
+}
+
+static void link_went_down(int64_t now_us, bool lost)
+{
+    if (!peer_known) {
+        return; // Never connected: nobody to page, the phone has to find us
+    }
+    if (lost) {
+        portENTER_CRITICAL(&lock);
+        bt_reconnect_link_lost(&reconnect, now_us);
+        portEXIT_CRITICAL(&lock);
+        ESP_LOGW(TAG, "Link to the phone lost, reconnecting");
+    } else if (paging) {
+        ESP_LOGI(TAG, "Phone did not answer the page");
+    } else {
+        return; // Not our page; the wait already running stands
+    }
+    paging = false;
+    plan_page(now_us);
+}
+
+static void bt_link_task(void *arg)
+{
+    peer_known = bt_reconnect_load_peer(peer) == ESP_OK;
+    portENTER_CRITICAL(&lock);
+    bool up = link_up;
+    portEXIT_CRITICAL(&lock);
+    int64_t now_us = esp_timer_get_time();
+    if (up) {
+        link_came_up(now_us); // The phone beat us to it
+    } else if (peer_known) {
+        // Boot counts as an outage: page the phone rather than wait for it to find us
+        portENTER_CRITICAL(&lock);
+        bt_reconnect_link_lost(&reconnect, now_us);
+        portEXIT_CRITICAL(&lock);
+        plan_page(now_us);
+        notify_changed();
+    }
+
+    for (;;) {
+        TickType_t wait = portMAX_DELAY;
+        if (deadline_us != 0) {
+            int64_t remaining_ms = (deadline_us - esp_timer_get_time() + 999) / 1000;
+            wait = remaining_ms > 0 ? pdMS_TO_TICKS(remaining_ms) : 0;
+        }
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, wait);
+        now_us = esp_timer_get_time();
+
+        portENTER_CRITICAL(&lock);
+        up = link_up;
+        portEXIT_CRITICAL(&lock);
+        if (events & LINK_EVT_CONNECTED) {
+            link_came_up(now_us);
+        }
+        if (!up && (events & (LINK_EVT_LOST | LINK_EVT_CONNECT_FAILED))) {
+            link_went_down(now_us, events & LINK_EVT_LOST);
+        }
+        if (!up && deadline_us != 0 && now_us >= deadline_us) {
+            if (paging) {
+                ESP_LOGW(TAG, "Page reported nothing in %d ms", BT_LINK_CONNECT_TIMEOUT_MS);
+                paging = false;
+                plan_page(now_us);
+            } else {
+                page(now_us);
+            }
+        }
+        notify_changed();
+    }
+}
+
+esp_err_t bt_link_start(const bt_link_config_t *cfg)
+{
+    if (link_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    config = *cfg;
+    bt_reconnect_init(&reconnect, config.base_ms, config.max_ms);
+    if (xTaskCreate(bt_link_task, "bt_link", BT_LINK_TASK_STACK, NULL, BT_LINK_TASK_PRIORITY, &link_task) != pdPASS) {
+        link_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void bt_link_connected(const uint8_t bda[BT_RECONNECT_BDA_LEN])
+{
+    portENTER_CRITICAL(&lock);
+    link_up = true;
+    memcpy(link_bda, bda, sizeof(link_bda));
+    portEXIT_CRITICAL(&lock);
+    if (link_task) {
+        xTaskNotify(link_task, LINK_EVT_CONNECTED, eSetBits);
+    }
+}
+
+void bt_link_disconnected(bool was_connected)
+{
+    portENTER_CRITICAL(&lock);
+    link_up = false;
+    portEXIT_CRITICAL(&lock);
+    if (link_task) {
+        xTaskNotify(link_task, was_connected ? LINK_EVT_LOST : LINK_EVT_CONNECT_FAILED, eSetBits);
+    }
+}
+
+void bt_link_get_stats(bt_link_stats_t *stats)
+{
+    portENTER_CRITICAL(&lock);
+    stats->reconnecting = bt_reconnect_active(&reconnect);
+    stats->attempts = reconnect.attempts;
+    stats->attempts_total = reconnect.attempts_total;
+    stats->reconnects = reconnect.reconnects;
+    stats->last_attempts = reconnect.last_attempts;
+    stats->last_latency_ms = (uint32_t)(reconnect.last_latency_us / 1000);
+    portEXIT_CRITICAL(&lock);
+}
@@ -0,0 +1,45 @@
+#ifndef BT_LINK_H
+#define BT_LINK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "bt_reconnect.h"
+
+// Runs bt_reconnect.c against the HFP client: one task remembers the phone the link
+// last came up with and, at boot and after every drop, pages it with
+// esp_hf_client_connect() on the backoff schedule until the link is back. The HFP
+// callback only reports what happened; flash writes and waits happen on the task.
+#define BT_LINK_TASK_STACK 3072
+#define BT_LINK_TASK_PRIORITY 4
+#define BT_LINK_CONNECT_TIMEOUT_MS 30000 // A page that never reports back counts as failed
+
+typedef struct {
+    uint32_t base_ms;          // See bt_reconnect_init()
+    uint32_t max_ms;
+    void (*changed)(void);     // Runs on the link task when bt_link_stats_t changes
+} bt_link_config_t;
+
+typedef struct {
+    bool reconnecting;         // An outage is being worked on
+    uint32_t attempts;         // Pages this outage
+    uint32_t attempts_total;
+    uint32_t reconnects;
+    uint32_t last_attempts;    // Pages the last ended outage needed
+    uint32_t last_latency_ms;  // Length of the last ended outage; 0 if none
+} bt_link_stats_t;
+
+// Start the link task once the HFP client is up; a connection it has already reported
+// is picked up
+esp_err_t bt_link_start(const bt_link_config_t *config);
+
+// From the HFP callback: the link came up with the phone at bda
+void bt_link_connected(const uint8_t bda[BT_RECONNECT_BDA_LEN]);
+
+// From the HFP callback: the link went down, or (was_connected false) a connect failed
+void bt_link_disconnected(bool was_connected);
+
+// All zero when the task is not running
+void bt_link_get_stats(bt_link_stats_t *stats);
+
+#endif // BT_LINK_H
@@ -0,0 +1,141 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "bt_reconnect.h"
+
+#define TAG "BT_RECONNECT"
+
+// Guarded by lock: the address last read from or written to flash. Loads and stores
+// come from different tasks.
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t on_flash[BT_RECONNECT_BDA_LEN];
+static bool on_flash_known;
+
+void bt_reconnect_init(bt_reconnect_t *r, uint32_t base_ms, uint32_t max_ms)
+{
+    memset(r, 0, sizeof(*r));
+    r->base_ms = base_ms > 0 ? base_ms : 1;
+    r->max_ms = max_ms > r->base_ms ? max_ms : r->base_ms;
+}
+
+void bt_reconnect_link_lost(bt_reconnect_t *r, int64_t now_us)
+{
+    if (r->lost_us != 0) {
+        return;
+    }
+    r->lost_us = now_us > 0 ? now_us : 1; // 0 means connected
+    r->attempts = 0;
+}
+
+uint32_t bt_reconnect_next_delay_ms(bt_reconnect_t *r, uint32_t random)
+{
+    // Doubling past max_ms (or 32 bits) only ever lands on the cap
+    uint32_t ceiling = r->max_ms;
+    if (r->attempts < 32 && r->base_ms <= (r->max_ms >> r->attempts)) {
+        ceiling = r->base_ms << r->attempts;
+    }
+    r->attempts++;
+    r->attempts_total++;
+    uint32_t half = ceiling / 2;
+    return half + random % (ceiling - half + 1);
+}
+
+bool bt_reconnect_connected(bt_reconnect_t *r, int64_t now_us)
+{
+    if (r->lost_us == 0) {
+        return false;
+    }
+    r->last_latency_us = now_us - r->lost_us;
+    r->last_attempts = r->attempts;
+    r->reconnects++;
+    r->lost_us = 0;
+    r->attempts = 0;
+    return true;
+}
+
+bool bt_reconnect_active(const bt_reconnect_t *r)
+{
+    return r->lost_us != 0;
+}
+
+static void remember_on_flash(const uint8_t *bda, bool known)
+{
+    portENTER_CRITICAL(&lock);
+    if (known) {
+        memcpy(on_flash, bda, BT_RECONNECT_BDA_LEN);
+    }
+    on_flash_known = known;
+    portEXIT_CRITICAL(&lock);
+}
+
+esp_err_t bt_reconnect_load_peer(uint8_t bda[BT_RECONNECT_BDA_LEN])
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(BT_RECONNECT_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return err == ESP_ERR_NVS_NOT_FOUND ? ESP_ERR_NOT_FOUND : err;
+    }
+    uint8_t blob[BT_RECONNECT_BDA_LEN];
+    size_t len = sizeof(blob);
+    err = nvs_get_blob(handle, BT_RECONNECT_KEY, blob, &len);
+    nvs_close(handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (err == ESP_OK && len != sizeof(blob)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Stored phone address unusable (%s)", esp_err_to_name(err));
+        return ESP_ERR_NOT_FOUND;
+    }
+    memcpy(bda, blob, sizeof(blob));
+    remember_on_flash(blob, true);
+    return ESP_OK;
+}
+
+esp_err_t bt_reconnect_store_peer(const uint8_t bda[BT_RECONNECT_BDA_LEN])
+{
+    portENTER_CRITICAL(&lock);
+    bool unchanged = on_flash_known && memcmp(on_flash, bda, BT_RECONNECT_BDA_LEN) == 0;
+    portEXIT_CRITICAL(&lock);
+    if (unchanged) {
+        return ESP_OK;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(BT_RECONNECT_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, BT_RECONNECT_KEY, bda, BT_RECONNECT_BDA_LEN);
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error (%s) saving the phone address", esp_err_to_name(err));
+        return err;
+    }
+    remember_on_flash(bda, true);
+    ESP_LOGI(TAG, "Reconnecting to %02x:%02x:%02x:%02x:%02x:%02x from now on", bda[0], bda[1], bda[2],
+             bda[3], bda[4], bda[5]);
+    return ESP_OK;
+}
+
+esp_err_t bt_reconnect_forget_peer(void)
+{
+    remember_on_flash(NULL, false);
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(BT_RECONNECT_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
+    }
+    err = nvs_erase_key(handle, BT_RECONNECT_KEY);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
+}
@@ -0,0 +1,57 @@
+#ifndef BT_RECONNECT_H
+#define BT_RECONNECT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Bringing the HFP link back after it drops. Rather than wait for the phone to page us,
+// the device pages the last phone it was connected to, backing off exponentially
+// (capped) with jitter so a phone that stays away is not paged every few seconds and
+// several units that lost the same phone do not page it in lockstep.
+//
+// Pure bookkeeping with caller-supplied timestamps (esp_timer_get_time()) and random
+// values (esp_random()); bt_link.c owns the task, the locking and the HFP calls.
+#define BT_RECONNECT_NAMESPACE "redial_config"
+#define BT_RECONNECT_KEY "phone_bda"
+#define BT_RECONNECT_BDA_LEN 6 // As ESP_BD_ADDR_LEN
+
+typedef struct {
+    uint32_t base_ms;         // Ceiling of the first wait
+    uint32_t max_ms;          // Ceiling no wait goes past
+    int64_t lost_us;          // Start of the current outage; 0 while connected
+    uint32_t attempts;        // Connects started this outage
+    // Totals since boot
+    uint32_t attempts_total;
+    uint32_t reconnects;      // Outages that ended with the link back up
+    uint32_t last_attempts;   // Connects the last ended outage needed
+    int64_t last_latency_us;  // Length of the last ended outage; 0 if none
+} bt_reconnect_t;
+
+void bt_reconnect_init(bt_reconnect_t *r, uint32_t base_ms, uint32_t max_ms);
+
+// The link went down (or there is a known phone at boot); no-op if already counting
+void bt_reconnect_link_lost(bt_reconnect_t *r, int64_t now_us);
+
+// Count a connect and return how long to wait before starting it: uniformly between
+// half and all of min(max_ms, base_ms * 2^n), n being the connects already made this
+// outage. random supplies the jitter.
+uint32_t bt_reconnect_next_delay_ms(bt_reconnect_t *r, uint32_t random);
+
+// The link is up. Closes the outage and returns true if one was being counted, whether
+// our connect or the phone's own brought it back.
+bool bt_reconnect_connected(bt_reconnect_t *r, int64_t now_us);
+
+bool bt_reconnect_active(const bt_reconnect_t *r);
+
+// Read the last connected phone's address. ESP_ERR_NOT_FOUND if none is stored.
+esp_err_t bt_reconnect_load_peer(uint8_t bda[BT_RECONNECT_BDA_LEN]);
+
+// Persist the phone's address unless it is what was last loaded or stored, so every
+// reconnect to the same phone costs no flash write
+esp_err_t bt_reconnect_store_peer(const uint8_t bda[BT_RECONNECT_BDA_LEN]);
+
+// Erase the stored address, e.g. with the pairing data on a factory reset
+esp_err_t bt_reconnect_forget_peer(void);
+
+#endif // BT_RECONNECT_H
@@ -0,0 +1,209 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "call_control.h"
+
+#define TAG "CALL_CONTROL"
+
+// One queue per priority; work_sem counts the commands across both so the worker can
+// sleep on a single object and still drain manual commands first.
+static QueueHandle_t manual_queue = NULL;
+static QueueHandle_t auto_queue = NULL;
+static SemaphoreHandle_t work_sem = NULL;
+static TaskHandle_t worker_task = NULL;
+static call_cmd_executor_t executor_fn = NULL;
+
+// Guarded by lock: ID allocation, redial and query coalescing, and stats
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t next_id = 1;
+static uint32_t pending_redial_id[2]; // Indexed by call_cmd_priority_t; 0 when none
+static uint32_t pending_query_id;     // Queued call list query, whatever its priority; 0 when none
+static call_control_stats_t stats;
+
+static const char *const type_names[] = {
+    [CALL_CMD_DIAL] = "dial",
+    [CALL_CMD_REDIAL] = "redial",
+    [CALL_CMD_MEMORY_DIAL] = "memory dial",
+    [CALL_CMD_QUERY_CALLS] = "call list query",
+    [CALL_CMD_HANGUP] = "hang-up",
+};
+
+static void call_control_task(void *arg)
+{
+    call_cmd_t cmd;
+
+    for (;;) {
+        xSemaphoreTake(work_sem, portMAX_DELAY);
+        if (xQueueReceive(manual_queue, &cmd, 0) != pdTRUE &&
+            xQueueReceive(auto_queue, &cmd, 0) != pdTRUE) {
+            continue;
+        }
+
+        // A queued redial that is no longer the pending one was superseded by a manual
+        // redial; the manual one has already run, so drop it
+        bool skip = false;
+        portENTER_CRITICAL(&lock);
+        if (cmd.type == CALL_CMD_REDIAL) {
+            if (pending_redial_id[cmd.priority] == cmd.id) {
+                pending_redial_id[cmd.priority] = 0; // Later redials queue afresh
+            } else {
+                skip = true;
+            }
+        } else if (cmd.type == CALL_CMD_QUERY_CALLS && pending_query_id == cmd.id) {
+            pending_query_id = 0; // A query after this one would miss its answer, so it queues afresh
+        }
+        if (skip) {
+            stats.superseded++;
+        } else {
+            stats.executed++;
+        }
+        portEXIT_CRITICAL(&lock);
+
+        if (skip) {
+            ESP_LOGI(TAG, "Command %lu superseded by a manual redial", (unsigned long)cmd.id);
+            continue;
+        }
+        ESP_LOGD(TAG, "Running command %lu (type %d, priority %d)", (unsigned long)cmd.id, cmd.type, cmd.priority);
+        executor_fn(&cmd);
+    }
+}
+
+esp_err_t call_control_init(size_t queue_len, call_cmd_executor_t executor)
+{
+    if (queue_len == 0 || executor == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    manual_queue = xQueueCreate(queue_len, sizeof(call_cmd_t));
+    auto_queue = xQueueCreate(queue_len, sizeof(call_cmd_t));
+    work_sem = xSemaphoreCreateCounting(queue_len * 2, 0);
+    if (!manual_queue || !auto_queue || !work_sem) {
+        ESP_LOGE(TAG, "Failed to allocate command queues");
+        call_control_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+
+    executor_fn = executor;
+    next_id = 1;
+    memset(pending_redial_id, 0, sizeof(pending_redial_id));
+    pending_query_id = 0;
+    memset(&stats, 0, sizeof(stats));
+
+    if (xTaskCreate(call_control_task, "call_control", CALL_CONTROL_TASK_STACK, NULL,
+                    CALL_CONTROL_TASK_PRIORITY, &worker_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create call control task");
+        call_control_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Call control task started (queue depth %u per priority)", (unsigned)queue_len);
+    return ESP_OK;
+}
+
+void call_control_deinit(void)
+{
+    if (worker_task) {
+        vTaskDelete(worker_task);
+        worker_task = NULL;
+    }
+    if (manual_queue) {
+        vQueueDelete(manual_queue);
+        manual_queue = NULL;
+    }
+    if (auto_queue) {
+        vQueueDelete(auto_queue);
+        auto_queue = NULL;
+    }
+    if (work_sem) {
+        vSemaphoreDelete(work_sem);
+        work_sem = NULL;
+    }
+    executor_fn = NULL;
+}
+
+esp_err_t call_control_submit(call_cmd_type_t type, call_cmd_priority_t priority,
+                              const char *number, uint32_t *out_id)
+{
+    if (!worker_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    call_cmd_t cmd = { .type = type, .priority = priority };
+    if (type == CALL_CMD_DIAL || type == CALL_CMD_MEMORY_DIAL) {
+        if (number == NULL || number[0] == '\0') {
+            return ESP_ERR_INVALID_ARG;
+        }
+        strncpy(cmd.number, number, sizeof(cmd.number) - 1);
+    }
+
+    uint32_t coalesced_id = 0;
+    uint32_t displaced_id = 0;
+    portENTER_CRITICAL(&lock);
+    if (type == CALL_CMD_REDIAL) {
+        if (pending_redial_id[CALL_CMD_PRIORITY_MANUAL] != 0) {
+            coalesced_id = pending_redial_id[CALL_CMD_PRIORITY_MANUAL];
+        } else if (priority == CALL_CMD_PRIORITY_AUTO && pending_redial_id[CALL_CMD_PRIORITY_AUTO] != 0) {
+            coalesced_id = pending_redial_id[CALL_CMD_PRIORITY_AUTO];
+        }
+    } else if (type == CALL_CMD_QUERY_CALLS) {
+        coalesced_id = pending_query_id; // Both would get the same answer
+    }
+    if (coalesced_id != 0) {
+        stats.coalesced++;
+    } else {
+        cmd.id = next_id++;
+        if (next_id == 0) next_id = 1; // 0 means "none"
+        if (type == CALL_CMD_REDIAL) {
+            pending_redial_id[priority] = cmd.id;
+            if (priority == CALL_CMD_PRIORITY_MANUAL && pending_redial_id[CALL_CMD_PRIORITY_AUTO] != 0) {
+                // The manual redial runs first and does the same thing
+                displaced_id = pending_redial_id[CALL_CMD_PRIORITY_AUTO];
+                pending_redial_id[CALL_CMD_PRIORITY_AUTO] = 0;
+            }
+        } else if (type == CALL_CMD_QUERY_CALLS) {
+            pending_query_id = cmd.id;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (coalesced_id != 0) {
+        *out_id = coalesced_id;
+        return ESP_OK;
+    }
+
+    QueueHandle_t queue = (priority == CALL_CMD_PRIORITY_MANUAL) ? manual_queue : auto_queue;
+    if (xQueueSendToBack(queue, &cmd, 0) != pdTRUE) {
+        portENTER_CRITICAL(&lock);
+        if (type == CALL_CMD_REDIAL && pending_redial_id[priority] == cmd.id) {
+            pending_redial_id[priority] = 0;
+        }
+        if (type == CALL_CMD_QUERY_CALLS && pending_query_id == cmd.id) {
+            pending_query_id = 0;
+        }
+        if (displaced_id != 0 && pending_redial_id[CALL_CMD_PRIORITY_AUTO] == 0) {
+            pending_redial_id[CALL_CMD_PRIORITY_AUTO] = displaced_id; // Nothing replaces it after all
+        }
+        stats.rejected++;
+        portEXIT_CRITICAL(&lock);
+        ESP_LOGW(TAG, "Command queue full, rejecting %s", type_names[type]);
+        return ESP_ERR_NO_MEM;
+    }
+
+    portENTER_CRITICAL(&lock);
+    stats.submitted++;
+    portEXIT_CRITICAL(&lock);
+    xSemaphoreGive(work_sem);
+    *out_id = cmd.id;
+    return ESP_OK;
+}
+
+void call_control_get_stats(call_control_stats_t *out)
+{
+    portENTER_CRITICAL(&lock);
+    *out = stats;
+    portEXIT_CRITICAL(&lock);
+}
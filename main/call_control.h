@@ -0,0 +1,61 @@
+#ifndef CALL_CONTROL_H
+#define CALL_CONTROL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Single call-control task that owns every call command sent to the HFP stack.
+// Callers enqueue a command and get its ID back immediately; commands run one at a
+// time, manual ones ahead of automatic ones.
+#define CALL_CONTROL_NUMBER_MAX 64
+#define CALL_CONTROL_TASK_STACK 3072
+#define CALL_CONTROL_TASK_PRIORITY 5
+
+typedef enum {
+    CALL_CMD_DIAL,        // Dial cmd->number
+    CALL_CMD_REDIAL,      // Redial the last number
+    CALL_CMD_MEMORY_DIAL, // Dial the phone's memory location cmd->number (decimal)
+    CALL_CMD_QUERY_CALLS, // List the phone's current calls (AT+CLCC)
+    CALL_CMD_HANGUP,      // End the current call or stop the one being set up
+} call_cmd_type_t;
+
+typedef enum {
+    CALL_CMD_PRIORITY_AUTO,   // Automatic redial timer
+    CALL_CMD_PRIORITY_MANUAL, // User request over HTTP; always served first
+} call_cmd_priority_t;
+
+typedef struct {
+    uint32_t id;
+    call_cmd_type_t type;
+    call_cmd_priority_t priority;
+    char number[CALL_CONTROL_NUMBER_MAX];
+} call_cmd_t;
+
+typedef struct {
+    uint32_t submitted;
+    uint32_t coalesced;   // Redials and call list queries folded into one already pending
+    uint32_t rejected;    // Refused because the queue was full
+    uint32_t executed;
+    uint32_t superseded;  // Pending automatic redials dropped for a manual one
+} call_control_stats_t;
+
+// Runs on the call-control task for each command, in priority order
+typedef void (*call_cmd_executor_t)(const call_cmd_t *cmd);
+
+// Create the queues and the worker task. queue_len bounds each priority level.
+esp_err_t call_control_init(size_t queue_len, call_cmd_executor_t executor);
+
+// Stop the worker and free everything (used by tests)
+void call_control_deinit(void);
+
+// Enqueue a command without blocking. Dial and memory dial need number. A redial while another redial of the same or
+// higher priority is pending returns that command's ID instead of queueing a new one,
+// and so does a call list query while another one is still queued.
+// Returns ESP_ERR_NO_MEM when the queue for this priority is full.
+esp_err_t call_control_submit(call_cmd_type_t type, call_cmd_priority_t priority,
+                              const char *number, uint32_t *out_id);
+
+void call_control_get_stats(call_control_stats_t *stats);
+
+#endif // CALL_CONTROL_H
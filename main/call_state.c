@@ -0,0 +1,123 @@
+#include <stddef.h>
+
+#include "call_state.h"
+
+#define FROM(state) (1u << (state))
+#define FROM_ANY    (FROM(CALL_STATE_COUNT) - 1)
+#define FROM_SETUP  (FROM(CALL_STATE_DIALING) | FROM(CALL_STATE_ALERTING))
+#define FROM_IDLE   (FROM(CALL_STATE_IDLE) | FROM(CALL_STATE_FAILED))
+
+typedef struct {
+    uint32_t from;    // Mask of states the transition applies in
+    call_event_t event;
+    call_state_t to;
+} call_transition_t;
+
+// First matching row wins. Anything not listed leaves the state unchanged, e.g.
+// callsetup=0 once the call is active, or call=0 while still dialing.
+static const call_transition_t transitions[] = {
+    { FROM_IDLE,                              CALL_EVT_DIAL_SENT,      CALL_STATE_DIALING  },
+    { FROM_IDLE,                              CALL_EVT_SETUP_DIALING,  CALL_STATE_DIALING  }, // Dialed from the handset
+    { FROM_IDLE | FROM(CALL_STATE_DIALING),   CALL_EVT_SETUP_ALERTING, CALL_STATE_ALERTING },
+    { FROM_IDLE | FROM_SETUP,                 CALL_EVT_CALL_ACTIVE,    CALL_STATE_ACTIVE   },
+    { FROM_SETUP,                             CALL_EVT_SETUP_IDLE,     CALL_STATE_FAILED   }, // Setup ended without an answer
+    { FROM_SETUP,                             CALL_EVT_AT_ERROR,       CALL_STATE_FAILED   },
+    { FROM_SETUP,                             CALL_EVT_LINE_BUSY,      CALL_STATE_FAILED   },
+    { FROM(CALL_STATE_ACTIVE),                CALL_EVT_CALL_NONE,      CALL_STATE_IDLE     },
+    { FROM_ANY & ~FROM(CALL_STATE_IDLE),      CALL_EVT_LINK_LOST,      CALL_STATE_IDLE     },
+};
+
+static const char *const state_names[CALL_STATE_COUNT] = {
+    [CALL_STATE_IDLE] = "idle",
+    [CALL_STATE_DIALING] = "dialing",
+    [CALL_STATE_ALERTING] = "alerting",
+    [CALL_STATE_ACTIVE] = "active",
+    [CALL_STATE_FAILED] = "failed",
+};
+
+static const char *const event_names[CALL_EVT_COUNT] = {
+    [CALL_EVT_DIAL_SENT] = "dial_sent",
+    [CALL_EVT_SETUP_DIALING] = "setup_dialing",
+    [CALL_EVT_SETUP_ALERTING] = "setup_alerting",
+    [CALL_EVT_SETUP_IDLE] = "setup_idle",
+    [CALL_EVT_CALL_ACTIVE] = "call_active",
+    [CALL_EVT_CALL_NONE] = "call_none",
+    [CALL_EVT_AT_ERROR] = "at_error",
+    [CALL_EVT_LINE_BUSY] = "line_busy",
+    [CALL_EVT_LINK_LOST] = "link_lost",
+};
+
+static void latency_add(call_latency_t *lat, int64_t us)
+{
+    if (lat->count == 0 || us < lat->min_us) lat->min_us = us;
+    if (lat->count == 0 || us > lat->max_us) lat->max_us = us;
+    lat->last_us = us;
+    lat->total_us += us;
+    lat->count++;
+}
+
+void call_fsm_init(call_fsm_t *fsm)
+{
+    *fsm = (call_fsm_t){ .state = CALL_STATE_IDLE };
+}
+
+bool call_fsm_handle(call_fsm_t *fsm, call_event_t event, int64_t now_us)
+{
+    const call_transition_t *t = NULL;
+    for (size_t i = 0; i < sizeof(transitions) / sizeof(transitions[0]); i++) {
+        if ((transitions[i].from & FROM(fsm->state)) && transitions[i].event == event) {
+            t = &transitions[i];
+            break;
+        }
+    }
+    if (t == NULL) {
+        return false;
+    }
+
+    call_state_t from = fsm->state;
+    switch (t->to) {
+        case CALL_STATE_DIALING:
+            fsm->dialing_us = now_us;
+            fsm->alerting_us = 0;
+            break;
+        case CALL_STATE_ALERTING:
+            if (from == CALL_STATE_DIALING) {
+                latency_add(&fsm->dial_to_alert, now_us - fsm->dialing_us);
+            } else {
+                fsm->dialing_us = 0; // Missed the dialing phase; no latency to report
+            }
+            fsm->alerting_us = now_us;
+            break;
+        case CALL_STATE_ACTIVE:
+            if (from == CALL_STATE_ALERTING) {
+                latency_add(&fsm->alert_to_answer, now_us - fsm->alerting_us);
+            }
+            if (from == CALL_STATE_DIALING || from == CALL_STATE_ALERTING) {
+                fsm->answered++;
+            }
+            break;
+        case CALL_STATE_FAILED:
+            fsm->failed++;
+            break;
+        default:
+            break;
+    }
+    fsm->state = t->to;
+    fsm->entered_us = now_us;
+    return true;
+}
+
+bool call_state_is_busy(call_state_t state)
+{
+    return state == CALL_STATE_DIALING || state == CALL_STATE_ALERTING || state == CALL_STATE_ACTIVE;
+}
+
+const char *call_state_name(call_state_t state)
+{
+    return state < CALL_STATE_COUNT ? state_names[state] : "unknown";
+}
+
+const char *call_event_name(call_event_t event)
+{
+    return event < CALL_EVT_COUNT ? event_names[event] : "unknown";
+}
@@ -0,0 +1,65 @@
+#ifndef CALL_STATE_H
+#define CALL_STATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Table-driven state machine for the outcome of a call, fed from the HFP client
+// callback. Pure logic with caller-supplied timestamps (esp_timer_get_time()), so it
+// carries no locking of its own and runs unchanged in host tests.
+
+typedef enum {
+    CALL_STATE_IDLE,
+    CALL_STATE_DIALING,
+    CALL_STATE_ALERTING,
+    CALL_STATE_ACTIVE,
+    CALL_STATE_FAILED,   // Last outgoing call did not connect; left on the next dial
+    CALL_STATE_COUNT,
+} call_state_t;
+
+typedef enum {
+    CALL_EVT_DIAL_SENT,      // We sent ATD / AT+BLDN
+    CALL_EVT_SETUP_DIALING,  // +CIEV callsetup=2
+    CALL_EVT_SETUP_ALERTING, // +CIEV callsetup=3
+    CALL_EVT_SETUP_IDLE,     // +CIEV callsetup=0
+    CALL_EVT_CALL_ACTIVE,    // +CIEV call=1
+    CALL_EVT_CALL_NONE,      // +CIEV call=0
+    CALL_EVT_AT_ERROR,       // ERROR / +CME ERROR from the phone
+    CALL_EVT_LINE_BUSY,      // BUSY / NO CARRIER / NO ANSWER result for the dial
+    CALL_EVT_LINK_LOST,      // HFP service level connection dropped
+    CALL_EVT_COUNT,
+} call_event_t;
+
+// Running statistics for one phase of a call, in microseconds
+typedef struct {
+    uint32_t count;
+    int64_t last_us;
+    int64_t min_us;
+    int64_t max_us;
+    int64_t total_us;
+} call_latency_t;
+
+typedef struct {
+    call_state_t state;
+    int64_t entered_us;             // When the current state was entered
+    int64_t dialing_us;             // When the current attempt started dialing; 0 if unknown
+    int64_t alerting_us;            // When the remote end started ringing; 0 if not yet
+    call_latency_t dial_to_alert;   // Dialing -> alerting
+    call_latency_t alert_to_answer; // Alerting -> active
+    uint32_t answered;
+    uint32_t failed;
+} call_fsm_t;
+
+void call_fsm_init(call_fsm_t *fsm);
+
+// Apply an event. Returns true if the state changed; events with no transition from
+// the current state are ignored.
+bool call_fsm_handle(call_fsm_t *fsm, call_event_t event, int64_t now_us);
+
+// True while an outgoing call is being set up or a call is up
+bool call_state_is_busy(call_state_t state);
+
+const char *call_state_name(call_state_t state);
+const char *call_event_name(call_event_t event);
+
+#endif // CALL_STATE_H
@@ -0,0 +1,114 @@
+#include <stdatomic.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "device_state.h"
+
+// Sequence lock: odd while a write is in progress. A reader copies the state and
+// keeps the copy only if the sequence was even and unchanged around it.
+static atomic_uint_fast32_t sequence;
+static device_state_t state;
+
+// Serializes writers. Interrupts stay off on the writer's core while it holds this,
+// so a reader can only ever spin for the length of one write, never a preemption.
+static portMUX_TYPE write_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void write_begin(void)
+{
+    portENTER_CRITICAL(&write_lock);
+    atomic_store_explicit(&sequence, atomic_load_explicit(&sequence, memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release); // Odd sequence is visible before any field changes
+}
+
+static void write_end(void)
+{
+    atomic_store_explicit(&sequence, atomic_load_explicit(&sequence, memory_order_relaxed) + 1, memory_order_release);
+    portEXIT_CRITICAL(&write_lock);
+}
+
+void device_state_read(device_state_t *out)
+{
+    uint_fast32_t before, after;
+    do {
+        before = atomic_load_explicit(&sequence, memory_order_acquire);
+        memcpy(out, &state, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire); // The copy completes before the recheck
+        after = atomic_load_explicit(&sequence, memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+}
+
+bool device_state_bluetooth_connected(void)
+{
+    device_state_t s;
+    device_state_read(&s);
+    return s.bluetooth_connected;
+}
+
+bool device_state_auto_redial_enabled(void)
+{
+    device_state_t s;
+    device_state_read(&s);
+    return s.auto_redial_enabled;
+}
+
+uint32_t device_state_redial_count(void)
+{
+    device_state_t s;
+    device_state_read(&s);
+    return s.redial_count;
+}
+
+void device_state_set_bluetooth_connected(bool connected)
+{
+    write_begin();
+    state.bluetooth_connected = connected;
+    write_end();
+}
+
+void device_state_set_auto_redial_enabled(bool enabled)
+{
+    write_begin();
+    state.auto_redial_enabled = enabled;
+    write_end();
+}
+
+void device_state_set_last_call_failed(bool failed)
+{
+    write_begin();
+    state.last_call_failed = failed;
+    write_end();
+}
+
+void device_state_set_ip_address(const char *ip)
+{
+    // Format outside the critical section; only the copy happens inside
+    char copy[DEVICE_STATE_IP_MAX] = {0};
+    if (ip != NULL) {
+        strncpy(copy, ip, sizeof(copy) - 1);
+    }
+    write_begin();
+    memcpy(state.ip_address, copy, sizeof(copy));
+    write_end();
+}
+
+uint32_t device_state_count_redial(void)
+{
+    write_begin();
+    uint32_t count = ++state.redial_count;
+    write_end();
+    return count;
+}
+
+void device_state_reset_redial_count(void)
+{
+    write_begin();
+    state.redial_count = 0;
+    write_end();
+}
+
+void device_state_reset(void)
+{
+    write_begin();
+    memset(&state, 0, sizeof(state));
+    write_end();
+}
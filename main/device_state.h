@@ -0,0 +1,45 @@
+#ifndef DEVICE_STATE_H
+#define DEVICE_STATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Live device state shared by the Bluetooth callback, the esp_timer task, the Wi-Fi
+// event task, the HTTP server and the LED task. Each field has one setter below.
+// Writers are serialized by a short critical section. Readers take a consistent copy
+// under a sequence lock: they never take a lock, so reading from /status or the LED
+// task can never hold up the Bluetooth stack.
+
+#define DEVICE_STATE_IP_MAX 16 // "255.255.255.255"
+
+typedef struct {
+    bool bluetooth_connected;  // HFP service level connection is up
+    bool auto_redial_enabled;
+    bool last_call_failed;
+    uint32_t redial_count;     // Redials sent in the current auto redial session
+    char ip_address[DEVICE_STATE_IP_MAX]; // Empty when no IP is assigned
+} device_state_t;
+
+// Copy the whole state. Retries while a write is in progress, which takes a few stores.
+void device_state_read(device_state_t *out);
+
+// Single-field reads, each a consistent snapshot on its own
+bool device_state_bluetooth_connected(void);
+bool device_state_auto_redial_enabled(void);
+uint32_t device_state_redial_count(void);
+
+void device_state_set_bluetooth_connected(bool connected);
+void device_state_set_auto_redial_enabled(bool enabled);
+void device_state_set_last_call_failed(bool failed);
+
+// NULL or "" clears the address; longer strings are truncated
+void device_state_set_ip_address(const char *ip);
+
+// Count one more redial and return the new total
+uint32_t device_state_count_redial(void);
+void device_state_reset_redial_count(void);
+
+// Back to all false, zero and empty (used by tests)
+void device_state_reset(void);
+
+#endif // DEVICE_STATE_H
@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "device_status.h"
+
+// Minimal JSON writer over a caller-provided buffer; sticky overflow flag
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+    bool need_comma;
+} json_writer_t;
+
+static void jw_raw(json_writer_t *w, const char *s, size_t n)
+{
+    if (w->overflow || w->len + n >= w->cap) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static void jw_string(json_writer_t *w, const char *s)
+{
+    jw_raw(w, "\"", 1);
+    for (; *s; s++) {
+        char escaped[7];
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            escaped[0] = '\\';
+            escaped[1] = (char)c;
+            jw_raw(w, escaped, 2);
+        } else if (c < 0x20) {
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            jw_raw(w, escaped, 6);
+        } else {
+            jw_raw(w, (const char *)&c, 1);
+        }
+    }
+    jw_raw(w, "\"", 1);
+}
+
+static void jw_key(json_writer_t *w, const char *key)
+{
+    if (w->need_comma) {
+        jw_raw(w, ",", 1);
+    }
+    w->need_comma = true;
+    jw_string(w, key);
+    jw_raw(w, ":", 1);
+}
+
+static void jw_bool(json_writer_t *w, const char *key, bool value)
+{
+    jw_key(w, key);
+    if (value) jw_raw(w, "true", 4);
+    else jw_raw(w, "false", 5);
+}
+
+static void jw_u32(json_writer_t *w, const char *key, uint32_t value)
+{
+    char digits[11];
+    size_t n = 0;
+    // Render backwards; avoids pulling printf into the hot path
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    jw_key(w, key);
+    jw_raw(w, digits + sizeof(digits) - n, n);
+}
+
+static void jw_u64(json_writer_t *w, const char *key, uint64_t value)
+{
+    if (value <= UINT32_MAX) {
+        jw_u32(w, key, (uint32_t)value); // Skip the 64-bit division when possible
+        return;
+    }
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    jw_key(w, key);
+    jw_raw(w, digits + sizeof(digits) - n, n);
+}
+
+static void jw_str(json_writer_t *w, const char *key, const char *value)
+{
+    jw_key(w, key);
+    jw_string(w, value);
+}
+
+bool device_status_equal(const device_status_t *a, const device_status_t *b)
+{
+    return a->bluetooth_connected == b->bluetooth_connected &&
+           strcmp(a->wifi_mode, b->wifi_mode) == 0 &&
+           strcmp(a->ip_address, b->ip_address) == 0 &&
+           a->auto_redial_enabled == b->auto_redial_enabled &&
+           a->redial_period == b->redial_period &&
+           a->redial_random_delay == b->redial_random_delay &&
+           a->last_random_delay == b->last_random_delay &&
+           a->last_call_failed == b->last_call_failed &&
+           a->redial_max_count == b->redial_max_count &&
+           a->redial_current_count == b->redial_current_count &&
+           a->redial_next_deadline_ms == b->redial_next_deadline_ms &&
+           a->redial_drift_ms == b->redial_drift_ms &&
+           strcmp(a->redial_mode, b->redial_mode) == 0 &&
+           a->redial_guard == b->redial_guard &&
+           a->redial_attempts_per_hour == b->redial_attempts_per_hour &&
+           a->redial_time_to_connect_ms == b->redial_time_to_connect_ms &&
+           strcmp(a->call_state, b->call_state) == 0 &&
+           a->call_dial_to_alert_ms == b->call_dial_to_alert_ms &&
+           a->call_alert_to_answer_ms == b->call_alert_to_answer_ms &&
+           a->bt_reconnecting == b->bt_reconnecting &&
+           a->bt_reconnect_attempts == b->bt_reconnect_attempts &&
+           a->bt_last_reconnect_ms == b->bt_last_reconnect_ms &&
+           a->bt_last_reconnect_attempts == b->bt_last_reconnect_attempts;
+}
+
+// Add a field when rendering the full status or when it changed since prev
+#define CHANGED(field) (prev == NULL || prev->field != status->field)
+#define CHANGED_STR(field) (prev == NULL || strcmp(prev->field, status->field) != 0)
+
+int device_status_write_json(const device_status_t *status, const device_status_t *prev, char *buf, size_t buf_len)
+{
+    json_writer_t w = { .buf = buf, .cap = buf_len };
+
+    jw_raw(&w, "{", 1);
+    if (CHANGED(bluetooth_connected)) {
+        jw_bool(&w, "bluetooth_connected", status->bluetooth_connected);
+    }
+    if (CHANGED_STR(wifi_mode)) jw_str(&w, "wifi_mode", status->wifi_mode);
+    if (CHANGED_STR(ip_address)) {
+        jw_str(&w, "ip_address", strlen(status->ip_address) > 0 ? status->ip_address : "N/A");
+    }
+    if (CHANGED(auto_redial_enabled)) jw_bool(&w, "auto_redial_enabled", status->auto_redial_enabled);
+    if (CHANGED(redial_period)) jw_u32(&w, "redial_period", status->redial_period);
+    if (CHANGED(redial_random_delay)) jw_u32(&w, "redial_random_delay", status->redial_random_delay);
+    if (CHANGED(last_random_delay)) jw_u32(&w, "last_random_delay", status->last_random_delay);
+    if (CHANGED(last_call_failed)) jw_bool(&w, "last_call_failed", status->last_call_failed);
+    if (CHANGED(redial_max_count)) jw_u32(&w, "redial_max_count", status->redial_max_count);
+    if (CHANGED(redial_current_count)) jw_u32(&w, "redial_current_count", status->redial_current_count);
+    if (CHANGED(redial_next_deadline_ms)) jw_u64(&w, "redial_next_deadline_ms", status->redial_next_deadline_ms);
+    if (CHANGED(redial_drift_ms)) jw_u64(&w, "redial_drift_ms", status->redial_drift_ms);
+    if (CHANGED_STR(redial_mode)) jw_str(&w, "redial_mode", status->redial_mode);
+    if (CHANGED(redial_guard)) jw_u32(&w, "redial_guard", status->redial_guard);
+    if (CHANGED(redial_attempts_per_hour)) jw_u32(&w, "redial_attempts_per_hour", status->redial_attempts_per_hour);
+    if (CHANGED(redial_time_to_connect_ms)) jw_u32(&w, "redial_time_to_connect_ms", status->redial_time_to_connect_ms);
+    if (CHANGED_STR(call_state)) jw_str(&w, "call_state", status->call_state);
+    if (CHANGED(call_dial_to_alert_ms)) jw_u32(&w, "call_dial_to_alert_ms", status->call_dial_to_alert_ms);
+    if (CHANGED(call_alert_to_answer_ms)) jw_u32(&w, "call_alert_to_answer_ms", status->call_alert_to_answer_ms);
+    if (CHANGED(bt_reconnecting)) jw_bool(&w, "bt_reconnecting", status->bt_reconnecting);
+    if (CHANGED(bt_reconnect_attempts)) jw_u32(&w, "bt_reconnect_attempts", status->bt_reconnect_attempts);
+    if (CHANGED(bt_last_reconnect_ms)) jw_u32(&w, "bt_last_reconnect_ms", status->bt_last_reconnect_ms);
+    if (CHANGED(bt_last_reconnect_attempts)) {
+        jw_u32(&w, "bt_last_reconnect_attempts", status->bt_last_reconnect_attempts);
+    }
+    if (CHANGED(bluetooth_connected)) {
+        jw_str(&w, "message", status->bluetooth_connected ? "Bluetooth connected" : "Bluetooth disconnected");
+    }
+    jw_raw(&w, "}", 1);
+
+    if (w.overflow) {
+        if (buf_len > 0) buf[0] = '\0';
+        return -1;
+    }
+    buf[w.len] = '\0';
+    return (int)w.len;
+}
+
+// Single cached rendering shared by every /status request. Both listeners serve /status,
+// so it is only read or replaced under the lock; the render itself happens outside it.
+static portMUX_TYPE cache_lock = portMUX_INITIALIZER_UNLOCKED;
+static device_status_t cached_status;
+static char cached_json[DEVICE_STATUS_JSON_MAX];
+static size_t cached_len = 0;
+static uint32_t cached_generation = 0; // 0 means nothing rendered yet
+
+void device_status_render_cached(const device_status_t *status, char *buf, size_t buf_len,
+                                 device_status_rendered_t *out)
+{
+    out->json = buf;
+    out->len = 0;
+    if (buf_len < DEVICE_STATUS_JSON_MAX) {
+        out->generation = 0;
+        if (buf_len > 0) buf[0] = '\0';
+        return;
+    }
+
+    portENTER_CRITICAL(&cache_lock);
+    bool hit = cached_generation != 0 && device_status_equal(status, &cached_status);
+    if (hit) {
+        memcpy(buf, cached_json, cached_len + 1);
+        out->len = cached_len;
+        out->generation = cached_generation;
+    }
+    portEXIT_CRITICAL(&cache_lock);
+    if (hit) {
+        return;
+    }
+
+    int len = device_status_write_json(status, NULL, buf, buf_len);
+    out->len = len > 0 ? (size_t)len : 0;
+    portENTER_CRITICAL(&cache_lock);
+    // Another task may have cached this same snapshot meanwhile; it keeps its generation
+    if (cached_generation == 0 || !device_status_equal(status, &cached_status)) {
+        memcpy(cached_json, buf, out->len + 1);
+        cached_len = out->len;
+        cached_status = *status;
+        cached_generation++;
+        if (cached_generation == 0) cached_generation = 1; // Skip the "never rendered" marker on wrap
+    }
+    out->generation = cached_generation;
+    portEXIT_CRITICAL(&cache_lock);
+}
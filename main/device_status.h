@@ -0,0 +1,63 @@
+#ifndef DEVICE_STATUS_H
+#define DEVICE_STATUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Point-in-time copy of everything reported by /status and pushed over /events.
+// Field names double as the JSON keys.
+typedef struct {
+    bool bluetooth_connected;
+    const char *wifi_mode;      // "AP", "STA" or "Unknown"
+    char ip_address[16];        // Empty when no IP is assigned
+    bool auto_redial_enabled;
+    uint32_t redial_period;
+    uint32_t redial_random_delay;
+    uint32_t last_random_delay;
+    bool last_call_failed;
+    uint32_t redial_max_count;
+    uint32_t redial_current_count;
+    uint64_t redial_next_deadline_ms; // Uptime of the next automatic redial; 0 when none is scheduled
+    uint64_t redial_drift_ms;         // How far the redial schedule has slipped behind plan
+    const char *redial_mode;          // "periodic" or "back_to_back"
+    uint32_t redial_guard;            // Back-to-back gap after call setup ends, seconds
+    uint32_t redial_attempts_per_hour; // Current session, else the last one that connected
+    uint32_t redial_time_to_connect_ms; // Enable -> answered for the last session that connected
+    const char *call_state;     // "idle", "dialing", "alerting", "active" or "failed"
+    uint32_t call_dial_to_alert_ms;   // Latest dialing -> ringing latency; 0 until measured
+    uint32_t call_alert_to_answer_ms; // Latest ringing -> answered latency; 0 until measured
+    bool bt_reconnecting;             // Paging the last phone after the link dropped
+    uint32_t bt_reconnect_attempts;   // Pages this outage
+    uint32_t bt_last_reconnect_ms;    // Link lost -> back up for the last ended outage; 0 if none
+    uint32_t bt_last_reconnect_attempts; // Pages the last ended outage needed
+} device_status_t;
+
+// Upper bound for a rendered status document, including the terminator
+#define DEVICE_STATUS_JSON_MAX 832
+
+// Rendered status bytes tagged with the generation they were produced for
+typedef struct {
+    uint32_t generation;
+    const char *json;
+    size_t len;
+} device_status_rendered_t;
+
+// Fill in a snapshot from the live device state (implemented in main.c)
+void device_status_capture(device_status_t *status);
+
+bool device_status_equal(const device_status_t *a, const device_status_t *b);
+
+// Render a snapshot as JSON into buf without allocating. With prev == NULL every field is
+// written; otherwise only the fields that differ from prev. Returns the length written
+// (excluding the terminator), or -1 if buf is too small.
+int device_status_write_json(const device_status_t *status, const device_status_t *prev, char *buf, size_t buf_len);
+
+// Copy the full JSON for a snapshot into buf (at least DEVICE_STATUS_JSON_MAX bytes), from a
+// shared cache when the snapshot is unchanged. The generation only increments when the
+// snapshot differs from the previously rendered one, so unchanged state is neither
+// re-rendered nor re-sent. Safe from any task; out->json points into buf.
+void device_status_render_cached(const device_status_t *status, char *buf, size_t buf_len,
+                                 device_status_rendered_t *out);
+
+#endif // DEVICE_STATUS_H
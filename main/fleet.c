@@ -0,0 +1,520 @@
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fleet.h"
+
+// Datagram layout, little-endian:
+//   0  'R' 'H' 'F' version
+//   4  type
+//   5  sender ID (4)
+//   9  payload
+#define FLEET_MAGIC "RHF"
+#define FLEET_WIRE_VERSION 1
+#define FLEET_HEADER_SIZE 9
+
+// Heartbeat payload: HTTP port (2), flags (1), report campaign (4), attempt (4), outcome (1)
+#define FLEET_HEARTBEAT_PAYLOAD 12
+#define FLEET_FLAG_BLUETOOTH 0x01
+#define FLEET_FLAG_BUSY 0x02
+
+// Campaign payload: ID (4), version (4), last attempt (4), count (1), then per entry
+// state (1), attempts left (1), node (4), attempt (4), number length (1), number
+#define FLEET_CAMPAIGN_HEADER 13
+#define FLEET_ENTRY_FIXED 11
+
+typedef enum {
+    FLEET_MSG_HEARTBEAT = 1,
+    FLEET_MSG_CAMPAIGN = 2,
+} fleet_msg_type_t;
+
+static const char *const entry_state_names[] = {
+    [FLEET_ENTRY_PENDING] = "pending",
+    [FLEET_ENTRY_ASSIGNED] = "assigned",
+    [FLEET_ENTRY_ANSWERED] = "answered",
+    [FLEET_ENTRY_EXHAUSTED] = "exhausted",
+};
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+const char *fleet_entry_state_name(fleet_entry_state_t state)
+{
+    return state <= FLEET_ENTRY_EXHAUSTED ? entry_state_names[state] : "unknown";
+}
+
+void fleet_init(fleet_t *fleet, uint32_t self_id, uint16_t http_port,
+                int64_t peer_timeout_us, int64_t attempt_timeout_us)
+{
+    memset(fleet, 0, sizeof(*fleet));
+    fleet->self.id = self_id;
+    fleet->self.http_port = http_port;
+    fleet->leader = self_id;
+    fleet->peer_timeout_us = peer_timeout_us;
+    fleet->attempt_timeout_us = attempt_timeout_us;
+}
+
+void fleet_set_local(fleet_t *fleet, bool bluetooth_connected, bool busy)
+{
+    fleet->self.bluetooth_connected = bluetooth_connected;
+    fleet->self.busy = busy;
+}
+
+bool fleet_is_leader(const fleet_t *fleet)
+{
+    return fleet->leader == fleet->self.id;
+}
+
+static bool valid_number(const char *number)
+{
+    size_t len = strlen(number);
+    if (len == 0 || len >= FLEET_NUMBER_MAX) {
+        return false;
+    }
+    for (const char *c = number; *c; c++) {
+        if (!((*c >= '0' && *c <= '9') || *c == '+' || *c == '*' || *c == '#')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t fleet_start_campaign(fleet_t *fleet, uint32_t campaign_id, const char *const *numbers,
+                               size_t count, uint8_t attempts)
+{
+    if (!fleet_is_leader(fleet)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (campaign_id == 0 || count == 0 || count > FLEET_CAMPAIGN_MAX_NUMBERS || attempts == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!valid_number(numbers[i])) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    fleet_campaign_t *c = &fleet->campaign;
+    uint32_t version = c->version + 1;
+    memset(c, 0, sizeof(*c));
+    c->id = campaign_id;
+    c->version = version;
+    c->count = (uint8_t)count;
+    for (size_t i = 0; i < count; i++) {
+        strcpy(c->entries[i].number, numbers[i]);
+        c->entries[i].attempts_left = attempts;
+        c->entries[i].state = FLEET_ENTRY_PENDING;
+    }
+    fleet->attempt_started = 0;
+    return ESP_OK;
+}
+
+// This unit or a live peer; NULL if the ID is not a current member
+static fleet_peer_t *find_member(fleet_t *fleet, uint32_t id)
+{
+    if (id == fleet->self.id) {
+        return &fleet->self;
+    }
+    for (size_t i = 0; i < fleet->peer_count; i++) {
+        if (fleet->peers[i].id == id) {
+            return &fleet->peers[i];
+        }
+    }
+    return NULL;
+}
+
+static bool holds_assignment(const fleet_campaign_t *c, uint32_t id)
+{
+    for (size_t i = 0; i < c->count; i++) {
+        if (c->entries[i].state == FLEET_ENTRY_ASSIGNED && c->entries[i].node == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool self_busy(const fleet_t *fleet)
+{
+    return fleet->self.busy || fleet->attempt_current != 0;
+}
+
+static bool can_take_number(const fleet_t *fleet, const fleet_peer_t *member)
+{
+    bool busy = member == &fleet->self ? self_busy(fleet) : member->busy;
+    return member->bluetooth_connected && !busy && !holds_assignment(&fleet->campaign, member->id);
+}
+
+static void release_entry(fleet_entry_t *e)
+{
+    e->state = FLEET_ENTRY_PENDING;
+    e->node = 0;
+    e->assigned_us = 0;
+}
+
+// Leader: settle assigned numbers from reports and dropouts, then hand out pending ones
+static bool lead_campaign(fleet_t *fleet, int64_t now_us)
+{
+    fleet_campaign_t *c = &fleet->campaign;
+    bool changed = false;
+
+    for (size_t i = 0; i < c->count; i++) {
+        fleet_entry_t *e = &c->entries[i];
+        if (e->state != FLEET_ENTRY_ASSIGNED) {
+            continue;
+        }
+        if (e->assigned_us == 0) {
+            e->assigned_us = now_us; // Inherited from the previous leader: give it a full timeout
+        }
+        const fleet_peer_t *node = find_member(fleet, e->node);
+        const fleet_report_t *r = node ? &node->report : NULL;
+        if (r && r->campaign == c->id && r->attempt == e->attempt && r->outcome != FLEET_OUTCOME_NONE) {
+            if (r->outcome == FLEET_OUTCOME_ANSWERED) {
+                e->state = FLEET_ENTRY_ANSWERED;
+            } else if (r->outcome == FLEET_OUTCOME_FAILED && --e->attempts_left == 0) {
+                e->state = FLEET_ENTRY_EXHAUSTED;
+            } else {
+                release_entry(e);
+            }
+            changed = true;
+        } else if (!node || !node->bluetooth_connected || now_us - e->assigned_us > fleet->attempt_timeout_us) {
+            // Its unit left, lost its phone or never reported: someone else tries it
+            release_entry(e);
+            changed = true;
+        }
+    }
+
+    for (size_t i = 0; i < c->count; i++) {
+        fleet_entry_t *e = &c->entries[i];
+        if (e->state != FLEET_ENTRY_PENDING) {
+            continue;
+        }
+        fleet_peer_t *node = NULL;
+        if (can_take_number(fleet, &fleet->self)) {
+            node = &fleet->self;
+        }
+        for (size_t p = 0; node == NULL && p < fleet->peer_count; p++) {
+            if (can_take_number(fleet, &fleet->peers[p])) {
+                node = &fleet->peers[p];
+            }
+        }
+        if (node == NULL) {
+            break; // Every unit with a phone is busy
+        }
+        e->state = FLEET_ENTRY_ASSIGNED;
+        e->node = node->id;
+        e->attempt = ++c->last_attempt;
+        e->assigned_us = now_us;
+        changed = true;
+    }
+
+    if (changed) {
+        c->version++;
+    }
+    return changed;
+}
+
+bool fleet_tick(fleet_t *fleet, int64_t now_us)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < fleet->peer_count; i++) {
+        if (now_us - fleet->peers[i].last_seen_us <= fleet->peer_timeout_us) {
+            fleet->peers[kept++] = fleet->peers[i];
+        }
+    }
+    fleet->peer_count = kept;
+
+    fleet->leader = fleet->self.id;
+    for (size_t i = 0; i < fleet->peer_count; i++) {
+        if (fleet->peers[i].id < fleet->leader) {
+            fleet->leader = fleet->peers[i].id;
+        }
+    }
+
+    if (!fleet_is_leader(fleet) || fleet->campaign.id == 0) {
+        return false;
+    }
+    return lead_campaign(fleet, now_us);
+}
+
+static void put_header(uint8_t *buf, fleet_msg_type_t type, uint32_t sender)
+{
+    memcpy(buf, FLEET_MAGIC, 3);
+    buf[3] = FLEET_WIRE_VERSION;
+    buf[4] = (uint8_t)type;
+    put_u32(buf + 5, sender);
+}
+
+size_t fleet_encode_heartbeat(const fleet_t *fleet, uint8_t *buf, size_t buf_len)
+{
+    if (buf_len < FLEET_HEADER_SIZE + FLEET_HEARTBEAT_PAYLOAD) {
+        return 0;
+    }
+    put_header(buf, FLEET_MSG_HEARTBEAT, fleet->self.id);
+    uint8_t *p = buf + FLEET_HEADER_SIZE;
+    put_u16(p, fleet->self.http_port);
+    p[2] = (fleet->self.bluetooth_connected ? FLEET_FLAG_BLUETOOTH : 0) | (self_busy(fleet) ? FLEET_FLAG_BUSY : 0);
+    put_u32(p + 3, fleet->self.report.campaign);
+    put_u32(p + 7, fleet->self.report.attempt);
+    p[11] = fleet->self.report.outcome;
+    return FLEET_HEADER_SIZE + FLEET_HEARTBEAT_PAYLOAD;
+}
+
+size_t fleet_encode_campaign(const fleet_t *fleet, uint8_t *buf, size_t buf_len)
+{
+    const fleet_campaign_t *c = &fleet->campaign;
+    size_t len = FLEET_HEADER_SIZE + FLEET_CAMPAIGN_HEADER;
+    if (buf_len < len) {
+        return 0;
+    }
+    put_header(buf, FLEET_MSG_CAMPAIGN, fleet->self.id);
+    uint8_t *p = buf + FLEET_HEADER_SIZE;
+    put_u32(p, c->id);
+    put_u32(p + 4, c->version);
+    put_u32(p + 8, c->last_attempt);
+    p[12] = c->count;
+
+    for (size_t i = 0; i < c->count; i++) {
+        const fleet_entry_t *e = &c->entries[i];
+        size_t number_len = strlen(e->number);
+        if (buf_len - len < FLEET_ENTRY_FIXED + number_len) {
+            return 0;
+        }
+        p = buf + len;
+        p[0] = e->state;
+        p[1] = e->attempts_left;
+        put_u32(p + 2, e->node);
+        put_u32(p + 6, e->attempt);
+        p[10] = (uint8_t)number_len;
+        memcpy(p + FLEET_ENTRY_FIXED, e->number, number_len);
+        len += FLEET_ENTRY_FIXED + number_len;
+    }
+    return len;
+}
+
+static esp_err_t decode_campaign(const uint8_t *p, size_t len, fleet_campaign_t *out)
+{
+    if (len < FLEET_CAMPAIGN_HEADER) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(out, 0, sizeof(*out));
+    out->id = get_u32(p);
+    out->version = get_u32(p + 4);
+    out->last_attempt = get_u32(p + 8);
+    out->count = p[12];
+    if (out->count > FLEET_CAMPAIGN_MAX_NUMBERS) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t offset = FLEET_CAMPAIGN_HEADER;
+    for (size_t i = 0; i < out->count; i++) {
+        if (len - offset < FLEET_ENTRY_FIXED) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        const uint8_t *q = p + offset;
+        fleet_entry_t *e = &out->entries[i];
+        size_t number_len = q[10];
+        if (q[0] > FLEET_ENTRY_EXHAUSTED || number_len >= FLEET_NUMBER_MAX ||
+            len - offset - FLEET_ENTRY_FIXED < number_len) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        e->state = q[0];
+        e->attempts_left = q[1];
+        e->node = get_u32(q + 2);
+        e->attempt = get_u32(q + 6);
+        memcpy(e->number, q + FLEET_ENTRY_FIXED, number_len);
+        e->number[number_len] = '\0';
+        if (!valid_number(e->number)) {
+            return ESP_ERR_INVALID_ARG; // Anyone on the LAN can send one; it would be dialed
+        }
+        offset += FLEET_ENTRY_FIXED + number_len;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t receive_heartbeat(fleet_t *fleet, uint32_t sender, const uint8_t *p, size_t len,
+                                   uint32_t addr, int64_t now_us)
+{
+    if (len < FLEET_HEARTBEAT_PAYLOAD) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    fleet_peer_t *peer = find_member(fleet, sender);
+    if (peer == NULL) {
+        if (fleet->peer_count == FLEET_MAX_PEERS) {
+            return ESP_ERR_NO_MEM;
+        }
+        peer = &fleet->peers[fleet->peer_count++];
+        memset(peer, 0, sizeof(*peer));
+        peer->id = sender;
+    }
+    peer->addr = addr;
+    peer->http_port = get_u16(p);
+    peer->bluetooth_connected = (p[2] & FLEET_FLAG_BLUETOOTH) != 0;
+    peer->busy = (p[2] & FLEET_FLAG_BUSY) != 0;
+    peer->report.campaign = get_u32(p + 3);
+    peer->report.attempt = get_u32(p + 7);
+    peer->report.outcome = p[11];
+    peer->last_seen_us = now_us;
+    return ESP_OK;
+}
+
+static esp_err_t receive_campaign(fleet_t *fleet, uint32_t sender, const uint8_t *p, size_t len)
+{
+    fleet_campaign_t incoming;
+    esp_err_t err = decode_campaign(p, len, &incoming);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    const fleet_campaign_t *held = &fleet->campaign;
+    bool newer = incoming.id == held->id && incoming.version > held->version;
+    bool first = held->id == 0 && incoming.id != 0;
+    bool replaced = sender == fleet->leader && incoming.id != held->id;
+    if (!newer && !first && !replaced) {
+        return ESP_OK;
+    }
+    if (incoming.id != held->id) {
+        fleet->attempt_started = 0;
+    }
+    fleet->campaign = incoming; // assigned_us starts at 0 for a future leader to fill in
+    return ESP_OK;
+}
+
+esp_err_t fleet_receive(fleet_t *fleet, const uint8_t *buf, size_t len, uint32_t addr, int64_t now_us)
+{
+    if (len < FLEET_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (memcmp(buf, FLEET_MAGIC, 3) != 0 || buf[3] != FLEET_WIRE_VERSION) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    uint32_t sender = get_u32(buf + 5);
+    if (sender == fleet->self.id || sender == 0) {
+        return ESP_OK; // Our own datagram looped back by the multicast group
+    }
+
+    const uint8_t *payload = buf + FLEET_HEADER_SIZE;
+    size_t payload_len = len - FLEET_HEADER_SIZE;
+    switch (buf[4]) {
+        case FLEET_MSG_HEARTBEAT:
+            return receive_heartbeat(fleet, sender, payload, payload_len, addr, now_us);
+        case FLEET_MSG_CAMPAIGN:
+            return receive_campaign(fleet, sender, payload, payload_len);
+        default:
+            return ESP_ERR_NOT_SUPPORTED;
+    }
+}
+
+bool fleet_next_dial(fleet_t *fleet, char *number, size_t number_len, uint32_t *attempt)
+{
+    if (fleet->attempt_current != 0) {
+        return false;
+    }
+    const fleet_campaign_t *c = &fleet->campaign;
+    for (size_t i = 0; i < c->count; i++) {
+        const fleet_entry_t *e = &c->entries[i];
+        if (e->state == FLEET_ENTRY_ASSIGNED && e->node == fleet->self.id && e->attempt > fleet->attempt_started) {
+            fleet->attempt_started = e->attempt;
+            fleet->attempt_current = e->attempt;
+            fleet->attempt_campaign = c->id;
+            snprintf(number, number_len, "%s", e->number);
+            if (attempt) {
+                *attempt = e->attempt;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void fleet_attempt_finished(fleet_t *fleet, fleet_outcome_t outcome)
+{
+    if (fleet->attempt_current == 0) {
+        return;
+    }
+    fleet->self.report = (fleet_report_t){
+        .campaign = fleet->attempt_campaign,
+        .attempt = fleet->attempt_current,
+        .outcome = (uint8_t)outcome,
+    };
+    fleet->attempt_current = 0;
+}
+
+// Append to buf at *len; sticky failure once it no longer fits
+static void append(char *buf, size_t buf_len, size_t *len, bool *overflow, const char *fmt, ...)
+{
+    if (*overflow) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + *len, buf_len - *len, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= buf_len - *len) {
+        *overflow = true;
+        return;
+    }
+    *len += (size_t)n;
+}
+
+static void append_member(char *buf, size_t buf_len, size_t *len, bool *overflow,
+                          const fleet_t *fleet, const fleet_peer_t *m, int64_t now_us)
+{
+    const uint8_t *ip = (const uint8_t *)&m->addr; // Network order: first octet first
+    bool self = m == &fleet->self;
+    append(buf, buf_len, len, overflow,
+           "{\"id\":%" PRIu32 ",\"self\":%s,\"address\":\"%u.%u.%u.%u\",\"http_port\":%u,"
+           "\"bluetooth_connected\":%s,\"busy\":%s,\"age_ms\":%" PRId64 "}",
+           m->id, self ? "true" : "false", ip[0], ip[1], ip[2], ip[3], (unsigned)m->http_port,
+           m->bluetooth_connected ? "true" : "false", (self ? self_busy(fleet) : m->busy) ? "true" : "false",
+           self ? (int64_t)0 : (now_us - m->last_seen_us) / 1000);
+}
+
+int fleet_write_json(const fleet_t *fleet, int64_t now_us, char *buf, size_t buf_len)
+{
+    if (buf_len == 0) {
+        return -1;
+    }
+    size_t len = 0;
+    bool overflow = false;
+    append(buf, buf_len, &len, &overflow, "{\"self\":%" PRIu32 ",\"leader\":%" PRIu32 ",\"role\":\"%s\",\"members\":[",
+           fleet->self.id, fleet->leader, fleet_is_leader(fleet) ? "leader" : "follower");
+    append_member(buf, buf_len, &len, &overflow, fleet, &fleet->self, now_us);
+    for (size_t i = 0; i < fleet->peer_count; i++) {
+        append(buf, buf_len, &len, &overflow, ",");
+        append_member(buf, buf_len, &len, &overflow, fleet, &fleet->peers[i], now_us);
+    }
+
+    const fleet_campaign_t *c = &fleet->campaign;
+    append(buf, buf_len, &len, &overflow, "],\"campaign\":{\"id\":%" PRIu32 ",\"version\":%" PRIu32 ",\"numbers\":[",
+           c->id, c->version);
+    for (size_t i = 0; i < c->count; i++) {
+        const fleet_entry_t *e = &c->entries[i];
+        append(buf, buf_len, &len, &overflow,
+               "%s{\"number\":\"%s\",\"state\":\"%s\",\"attempts_left\":%u,\"node\":%" PRIu32 ",\"attempt\":%" PRIu32 "}",
+               i > 0 ? "," : "", e->number, fleet_entry_state_name(e->state), (unsigned)e->attempts_left,
+               e->node, e->attempt);
+    }
+    append(buf, buf_len, &len, &overflow, "]}}");
+    return overflow ? -1 : (int)len;
+}
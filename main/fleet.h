@@ -0,0 +1,129 @@
+#ifndef FLEET_H
+#define FLEET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Several units on one LAN sharing a dial campaign. Every unit multicasts a heartbeat
+// with its Bluetooth link and call status; the live unit with the lowest ID leads. The
+// leader owns the campaign: it hands each number to an idle unit with a phone, counts
+// the outcomes those units report back in their heartbeats, and takes a number back
+// when its unit drops out. It multicasts the whole campaign after every change, so
+// any follower can carry on from its copy if the leader goes away.
+//
+// Pure logic with caller-supplied timestamps (esp_timer_get_time()); fleet_node.c
+// owns the socket and the locking.
+
+#define FLEET_MAX_PEERS 8             // Other units tracked besides this one
+#define FLEET_CAMPAIGN_MAX_NUMBERS 16
+#define FLEET_NUMBER_MAX 24           // Including the terminator
+#define FLEET_ATTEMPTS_MAX 255
+#define FLEET_MSG_MAX 640             // Largest datagram: a full campaign
+
+typedef enum {
+    FLEET_ENTRY_PENDING,   // Waiting for a free unit
+    FLEET_ENTRY_ASSIGNED,  // A unit is dialing it
+    FLEET_ENTRY_ANSWERED,  // Got through; done
+    FLEET_ENTRY_EXHAUSTED, // Out of attempts; done
+} fleet_entry_state_t;
+
+typedef enum {
+    FLEET_OUTCOME_NONE,
+    FLEET_OUTCOME_ANSWERED,
+    FLEET_OUTCOME_FAILED,   // Dialed, did not connect; uses up an attempt
+    FLEET_OUTCOME_NOT_SENT, // Never reached the phone; the number goes back to the pool
+} fleet_outcome_t;
+
+typedef struct {
+    char number[FLEET_NUMBER_MAX];
+    uint8_t attempts_left;
+    uint8_t state;        // fleet_entry_state_t
+    uint32_t node;        // Unit dialing it while assigned, or the one that got through
+    uint32_t attempt;     // Campaign-wide sequence number of the latest assignment
+    int64_t assigned_us;  // Leader's clock; not sent, 0 in a copy received from another unit
+} fleet_entry_t;
+
+typedef struct {
+    uint32_t id;          // 0 when there is no campaign
+    uint32_t version;     // Bumped by the leader on every change
+    uint32_t last_attempt;
+    uint8_t count;
+    fleet_entry_t entries[FLEET_CAMPAIGN_MAX_NUMBERS];
+} fleet_campaign_t;
+
+// Outcome of a unit's latest attempt, repeated in its heartbeats until superseded
+typedef struct {
+    uint32_t campaign;
+    uint32_t attempt;
+    uint8_t outcome;      // fleet_outcome_t
+} fleet_report_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t addr;        // IPv4 address in network order
+    uint16_t http_port;
+    bool bluetooth_connected;
+    bool busy;            // A call is being set up or is up, fleet or not
+    fleet_report_t report;
+    int64_t last_seen_us;
+} fleet_peer_t;
+
+typedef struct {
+    fleet_peer_t self;
+    fleet_peer_t peers[FLEET_MAX_PEERS];
+    size_t peer_count;
+    uint32_t leader;
+    fleet_campaign_t campaign; // Owned by the leader; a replica everywhere else
+    uint32_t attempt_started;  // Latest attempt of this campaign this unit has taken on
+    uint32_t attempt_current;  // Attempt being dialed now; 0 when none
+    uint32_t attempt_campaign; // Campaign attempt_current belongs to
+    int64_t peer_timeout_us;
+    int64_t attempt_timeout_us;
+} fleet_t;
+
+// self_id must be non-zero; lower IDs win the election
+void fleet_init(fleet_t *fleet, uint32_t self_id, uint16_t http_port,
+                int64_t peer_timeout_us, int64_t attempt_timeout_us);
+
+void fleet_set_local(fleet_t *fleet, bool bluetooth_connected, bool busy);
+
+bool fleet_is_leader(const fleet_t *fleet);
+
+// Leader only: replace the campaign with count numbers, each tried up to attempts
+// times. ESP_ERR_INVALID_STATE on a follower; ESP_ERR_INVALID_ARG for an empty or
+// oversized list, or a number with anything but digits, '+', '*' and '#'.
+esp_err_t fleet_start_campaign(fleet_t *fleet, uint32_t campaign_id, const char *const *numbers,
+                               size_t count, uint8_t attempts);
+
+// Expire silent peers, re-elect, and on the leader fold in reports, take numbers back
+// from units that dropped out and hand pending numbers to idle ones. Returns true if
+// the campaign changed and should be multicast now rather than at the next heartbeat.
+bool fleet_tick(fleet_t *fleet, int64_t now_us);
+
+// Apply a datagram from addr. Heartbeats update the sender's entry. A campaign is
+// taken if it is a newer version of the copy held, or if this unit has none; from the
+// current leader, a different campaign also replaces the copy. So a unit that takes
+// over the lead starts from the latest state it has seen. A campaign carrying any number
+// that fleet_start_campaign() would refuse is dropped whole with ESP_ERR_INVALID_ARG.
+esp_err_t fleet_receive(fleet_t *fleet, const uint8_t *buf, size_t len, uint32_t addr, int64_t now_us);
+
+// Encode this unit's heartbeat or (leader only) the campaign. Return the length, or
+// 0 if buf is too small.
+size_t fleet_encode_heartbeat(const fleet_t *fleet, uint8_t *buf, size_t buf_len);
+size_t fleet_encode_campaign(const fleet_t *fleet, uint8_t *buf, size_t buf_len);
+
+// If the campaign has a new attempt assigned to this unit, take it on and copy its
+// number out. The unit counts as busy until fleet_attempt_finished().
+bool fleet_next_dial(fleet_t *fleet, char *number, size_t number_len, uint32_t *attempt);
+
+// Record how the current attempt ended; no-op when there is none
+void fleet_attempt_finished(fleet_t *fleet, fleet_outcome_t outcome);
+
+const char *fleet_entry_state_name(fleet_entry_state_t state);
+
+// Render members and campaign as JSON. Returns the length, or -1 if buf is too small.
+int fleet_write_json(const fleet_t *fleet, int64_t now_us, char *buf, size_t buf_len);
+
+#endif // FLEET_H
@@ -0,0 +1,334 @@
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "fleet_node.h"
+
+#define TAG "FLEET"
+
+#define FLEET_PEER_TIMEOUT_HEARTBEATS 3
+
+static fleet_node_config_t config;
+static int sock = -1;
+static struct sockaddr_in group_addr;
+static struct in_addr interface_addr;
+static TaskHandle_t fleet_task = NULL;
+
+// Guarded by fleet_mutex; also taken by the HTTP handlers, so never held across a send
+static SemaphoreHandle_t fleet_mutex = NULL;
+static fleet_t fleet;
+static uint8_t tx_buf[FLEET_MSG_MAX]; // Only the fleet task sends
+static uint8_t rx_buf[FLEET_MSG_MAX];
+static int64_t attempt_began_us; // Fleet task only
+
+// Outcome handed over by fleet_node_attempt_finished(), which runs on the BT callback
+// path and must not wait for fleet_mutex; the fleet task folds it in under the mutex
+static portMUX_TYPE outcome_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool outcome_pending;
+static fleet_outcome_t pending_outcome;
+
+static esp_err_t open_socket(void)
+{
+    struct in_addr group, iface;
+    if (inet_aton(config.group, &group) == 0 || inet_aton(config.interface_ip, &iface) == 0) {
+        ESP_LOGE(TAG, "Bad group %s or interface %s", config.group, config.interface_ip);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "socket() failed: errno %d", errno);
+        return ESP_FAIL;
+    }
+    // Several units may share a host (the host build), and each must get every datagram
+    int on = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    struct sockaddr_in bind_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(config.port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    struct ip_mreq mreq = { .imr_multiaddr = group, .imr_interface = iface };
+    uint8_t ttl = 1; // Stay on the LAN
+    uint8_t loop = 1;
+    if (bind(sock, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) != 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) != 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0) {
+        ESP_LOGE(TAG, "Joining %s:%u on %s failed: errno %d", config.group, config.port, config.interface_ip, errno);
+        close(sock);
+        sock = -1;
+        return ESP_FAIL;
+    }
+
+    group_addr = (struct sockaddr_in){
+        .sin_family = AF_INET,
+        .sin_port = htons(config.port),
+        .sin_addr = group,
+    };
+    interface_addr = iface;
+    return ESP_OK;
+}
+
+static void send_datagram(size_t len)
+{
+    if (len > 0 && sendto(sock, tx_buf, len, 0, (struct sockaddr *)&group_addr, sizeof(group_addr)) < 0) {
+        ESP_LOGD(TAG, "sendto failed: errno %d", errno);
+    }
+}
+
+// Tick, log a change of leader, and send the campaign if this unit leads and it
+// changed (or force is set). Called with fleet_mutex held; sends after releasing it.
+static void tick_and_release(int64_t now_us, bool force_campaign)
+{
+    uint32_t leader = fleet.leader;
+    bool changed = fleet_tick(&fleet, now_us);
+    if (fleet.leader != leader) {
+        ESP_LOGI(TAG, "Leader is now %08lx%s", (unsigned long)fleet.leader, fleet_is_leader(&fleet) ? " (this unit)" : "");
+    }
+    size_t len = 0;
+    if ((changed || force_campaign) && fleet_is_leader(&fleet) && fleet.campaign.id != 0) {
+        len = fleet_encode_campaign(&fleet, tx_buf, sizeof(tx_buf));
+    }
+    xSemaphoreGive(fleet_mutex);
+    send_datagram(len);
+}
+
+// Called with fleet_mutex held
+static void finish_attempt_locked(fleet_outcome_t outcome)
+{
+    uint32_t attempt = fleet.attempt_current;
+    fleet_attempt_finished(&fleet, outcome);
+    if (attempt != 0) {
+        ESP_LOGI(TAG, "Campaign attempt %lu finished: outcome %d", (unsigned long)attempt, outcome);
+    }
+}
+
+// Called with fleet_mutex held, before anything that reads or replaces the current attempt
+static void apply_reported_outcome(void)
+{
+    portENTER_CRITICAL(&outcome_lock);
+    bool pending = outcome_pending;
+    fleet_outcome_t outcome = pending_outcome;
+    outcome_pending = false;
+    portEXIT_CRITICAL(&outcome_lock);
+    if (pending) {
+        finish_attempt_locked(outcome);
+    }
+}
+
+static void send_heartbeat(int64_t now_us)
+{
+    bool bluetooth_connected = false, busy = false;
+    config.local_status(&bluetooth_connected, &busy);
+
+    xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+    apply_reported_outcome(); // Its report rides this heartbeat
+    fleet_set_local(&fleet, bluetooth_connected, busy);
+    size_t len = fleet_encode_heartbeat(&fleet, tx_buf, sizeof(tx_buf));
+    xSemaphoreGive(fleet_mutex);
+    send_datagram(len);
+
+    // The campaign goes out every period too, so a lost datagram costs one heartbeat
+    xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+    tick_and_release(now_us, true);
+}
+
+// An attempt whose call never reported an outcome would keep this unit busy for good;
+// by now the leader has given the number to someone else anyway
+static void expire_attempt(int64_t now_us)
+{
+    xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+    apply_reported_outcome(); // A real outcome beats the timeout
+    bool stuck = fleet.attempt_current != 0 && now_us - attempt_began_us > fleet.attempt_timeout_us;
+    if (stuck) {
+        ESP_LOGW(TAG, "Campaign call reported no outcome in time");
+        finish_attempt_locked(FLEET_OUTCOME_NOT_SENT);
+    }
+    xSemaphoreGive(fleet_mutex);
+}
+
+static void dial_if_assigned(void)
+{
+    char number[FLEET_NUMBER_MAX];
+    uint32_t attempt = 0;
+
+    xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+    apply_reported_outcome(); // Whatever was reported belongs to the previous attempt
+    bool assigned = fleet_next_dial(&fleet, number, sizeof(number), &attempt);
+    xSemaphoreGive(fleet_mutex);
+    if (!assigned) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "Campaign attempt %lu: dialing %s", (unsigned long)attempt, number);
+    attempt_began_us = esp_timer_get_time();
+    esp_err_t err = config.dial(number);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Campaign attempt %lu not dialed: %s", (unsigned long)attempt, esp_err_to_name(err));
+        xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+        finish_attempt_locked(FLEET_OUTCOME_NOT_SENT);
+        xSemaphoreGive(fleet_mutex);
+    }
+}
+
+static void fleet_node_task(void *arg)
+{
+    int64_t next_heartbeat_us = 0;
+
+    for (;;) {
+        int64_t now_us = esp_timer_get_time();
+        if (now_us >= next_heartbeat_us) {
+            expire_attempt(now_us);
+            send_heartbeat(now_us);
+            next_heartbeat_us = now_us + (int64_t)config.heartbeat_ms * 1000;
+        }
+        dial_if_assigned();
+
+        int64_t wait_us = next_heartbeat_us - esp_timer_get_time();
+        struct timeval timeout = {
+            .tv_sec = wait_us > 0 ? wait_us / 1000000 : 0,
+            .tv_usec = wait_us > 0 ? wait_us % 1000000 : 0,
+        };
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(sock, &readable);
+        if (select(sock + 1, &readable, NULL, NULL, &timeout) <= 0) {
+            continue;
+        }
+
+        struct sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        int len = recvfrom(sock, rx_buf, sizeof(rx_buf), 0, (struct sockaddr *)&from, &from_len);
+        if (len <= 0) {
+            continue;
+        }
+        now_us = esp_timer_get_time();
+        xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+        esp_err_t err = fleet_receive(&fleet, rx_buf, (size_t)len, from.sin_addr.s_addr, now_us);
+        if (err != ESP_OK) {
+            ESP_LOGD(TAG, "Datagram from %s dropped: %s", inet_ntoa(from.sin_addr), esp_err_to_name(err));
+        }
+        tick_and_release(now_us, false); // A report may settle a number; tell everyone at once
+    }
+}
+
+esp_err_t fleet_node_start(const fleet_node_config_t *cfg)
+{
+    if (fleet_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!cfg->dial || !cfg->local_status || cfg->heartbeat_ms == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    config = *cfg;
+
+    fleet_mutex = xSemaphoreCreateMutex();
+    if (!fleet_mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t err = open_socket();
+    if (err != ESP_OK) {
+        vSemaphoreDelete(fleet_mutex);
+        fleet_mutex = NULL;
+        return err;
+    }
+
+    uint32_t id;
+    do {
+        id = esp_random(); // Random per boot: who leads only has to be agreed, not chosen
+    } while (id == 0);
+    fleet_init(&fleet, id, config.http_port, (int64_t)config.heartbeat_ms * 1000 * FLEET_PEER_TIMEOUT_HEARTBEATS,
+               (int64_t)config.attempt_timeout_ms * 1000);
+    fleet.self.addr = interface_addr.s_addr;
+
+    if (xTaskCreate(fleet_node_task, "fleet", FLEET_NODE_TASK_STACK, NULL, FLEET_NODE_TASK_PRIORITY, &fleet_task) != pdPASS) {
+        close(sock);
+        sock = -1;
+        vSemaphoreDelete(fleet_mutex);
+        fleet_mutex = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Unit %08lx joined fleet %s:%u", (unsigned long)id, config.group, config.port);
+    return ESP_OK;
+}
+
+bool fleet_node_running(void)
+{
+    return fleet_task != NULL;
+}
+
+void fleet_node_attempt_finished(fleet_outcome_t outcome)
+{
+    if (!fleet_mutex) {
+        return;
+    }
+    portENTER_CRITICAL(&outcome_lock);
+    if (!outcome_pending) { // As in fleet_attempt_finished(), the first outcome counts
+        pending_outcome = outcome;
+        outcome_pending = true;
+    }
+    portEXIT_CRITICAL(&outcome_lock);
+}
+
+esp_err_t fleet_node_start_campaign(const char *const *numbers, size_t count, uint8_t attempts)
+{
+    if (!fleet_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint32_t id;
+    do {
+        id = esp_random();
+    } while (id == 0);
+
+    xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+    esp_err_t err = fleet_start_campaign(&fleet, id, numbers, count, attempts);
+    xSemaphoreGive(fleet_mutex);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Campaign %08lx started: %u numbers, %u attempts each", (unsigned long)id,
+                 (unsigned)count, (unsigned)attempts);
+    }
+    return err; // Handed out at the next heartbeat
+}
+
+bool fleet_node_leader_address(char *ip, size_t ip_len, uint16_t *http_port)
+{
+    if (!fleet_mutex) {
+        return false;
+    }
+    bool found = false;
+    xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < fleet.peer_count; i++) {
+        if (fleet.peers[i].id == fleet.leader) {
+            struct in_addr addr = { .s_addr = fleet.peers[i].addr };
+            inet_ntop(AF_INET, &addr, ip, ip_len);
+            *http_port = fleet.peers[i].http_port;
+            found = true;
+        }
+    }
+    xSemaphoreGive(fleet_mutex);
+    return found;
+}
+
+int fleet_node_write_json(char *buf, size_t buf_len)
+{
+    if (!fleet_mutex) {
+        return -1;
+    }
+    xSemaphoreTake(fleet_mutex, portMAX_DELAY);
+    int len = fleet_write_json(&fleet, esp_timer_get_time(), buf, buf_len);
+    xSemaphoreGive(fleet_mutex);
+    return len;
+}
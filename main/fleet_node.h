@@ -0,0 +1,50 @@
+#ifndef FLEET_NODE_H
+#define FLEET_NODE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "fleet.h"
+
+// Runs fleet.c on the network: one task owns a UDP socket joined to the fleet's
+// multicast group, sends this unit's heartbeat (and, on the leader, the campaign)
+// every heartbeat period, and applies whatever the other units send.
+#define FLEET_NODE_TASK_STACK 4096
+#define FLEET_NODE_TASK_PRIORITY 4
+
+typedef struct {
+    const char *group;         // Multicast group, e.g. "239.255.42.99"
+    uint16_t port;             // UDP port shared by every unit
+    const char *interface_ip;  // Address of the interface to join the group on
+    uint16_t http_port;        // Advertised in heartbeats so /fleet can point at the leader
+    uint32_t heartbeat_ms;     // A unit silent for three periods is dropped
+    uint32_t attempt_timeout_ms; // An attempt not reported by then goes to another unit
+    // Runs on the fleet task: queue a dial of number. Anything but ESP_OK hands the
+    // number back to the campaign without using up an attempt.
+    esp_err_t (*dial)(const char *number);
+    // Runs on the fleet task before each heartbeat
+    void (*local_status)(bool *bluetooth_connected, bool *busy);
+} fleet_node_config_t;
+
+// Start the fleet task. The strings in config must outlive it.
+esp_err_t fleet_node_start(const fleet_node_config_t *config);
+
+bool fleet_node_running(void);
+
+// Report how this unit's current campaign call ended; no-op when none is in progress.
+// Never blocks, so it is safe on the BT callback path: the fleet task applies the
+// outcome before its next dial or heartbeat, which is what carries the report.
+void fleet_node_attempt_finished(fleet_outcome_t outcome);
+
+// Leader only, see fleet_start_campaign(). Picks a fresh campaign ID.
+esp_err_t fleet_node_start_campaign(const char *const *numbers, size_t count, uint8_t attempts);
+
+// Leader's address and HTTP port, for pointing clients at it. False if this unit
+// leads or the leader's address is not known.
+bool fleet_node_leader_address(char *ip, size_t ip_len, uint16_t *http_port);
+
+// See fleet_write_json()
+int fleet_node_write_json(char *buf, size_t buf_len);
+
+#endif // FLEET_NODE_H
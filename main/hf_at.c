@@ -0,0 +1,198 @@
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_hf_client_api.h"
+#include "metrics.h"
+#include "hf_at.h"
+
+#define TAG "HF_AT"
+
+static hf_at_done_fn done_fn;
+static esp_timer_handle_t deadline_timer;
+
+// Guards channel and the timer. A mutex rather than a spinlock: every caller is a task,
+// and the timer has to be re-armed under it or two tasks could arm it out of order.
+// Never held across an HFP call, which can block on the Bluedroid task's queue while
+// that task waits here to hand over an answer.
+static SemaphoreHandle_t mutex;
+static at_channel_t channel;
+
+static at_result_t result_from_code(int code)
+{
+    switch (code) {
+        case ESP_HF_AT_RESPONSE_CODE_OK:
+            return AT_RESULT_OK;
+        case ESP_HF_AT_RESPONSE_CODE_BUSY:
+        case ESP_HF_AT_RESPONSE_CODE_NO_CARRIER:
+        case ESP_HF_AT_RESPONSE_CODE_NO_ANSWER:
+            return AT_RESULT_BUSY;
+        default:
+            return AT_RESULT_ERROR;
+    }
+}
+
+// Called with the mutex held
+static void arm_timer(void)
+{
+    int64_t deadline_us = at_channel_next_deadline(&channel);
+    esp_timer_stop(deadline_timer);
+    if (deadline_us != 0) {
+        int64_t wait_us = deadline_us - esp_timer_get_time();
+        esp_timer_start_once(deadline_timer, wait_us > 0 ? (uint64_t)wait_us : 0);
+    }
+}
+
+static void finish(const at_completion_t *done)
+{
+    metrics_observe_at(done->type, done->result, done->round_trip_us);
+    if (done->result == AT_RESULT_OK) {
+        ESP_LOGI(TAG, "%s %lu answered OK in %lld ms", at_channel_cmd_name(done->type), (unsigned long)done->id,
+                 (long long)(done->round_trip_us / 1000));
+    } else {
+        ESP_LOGW(TAG, "%s %lu finished: %s after %lld ms", at_channel_cmd_name(done->type), (unsigned long)done->id,
+                 at_channel_result_name(done->result), (long long)(done->round_trip_us / 1000));
+    }
+    if (done_fn) {
+        done_fn(done);
+    }
+}
+
+static void deadline_timer_callback(void *arg)
+{
+    at_completion_t done;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    bool expired = at_channel_expire(&channel, esp_timer_get_time(), &done);
+    arm_timer();
+    xSemaphoreGive(mutex);
+    if (expired) {
+        finish(&done);
+    }
+}
+
+esp_err_t hf_at_init(hf_at_done_fn done)
+{
+    if (mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    mutex = xSemaphoreCreateMutex();
+    if (!mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+    const esp_timer_create_args_t timer_args = {
+        .callback = &deadline_timer_callback,
+        .name = "hf_at_deadline",
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &deadline_timer);
+    if (err != ESP_OK) {
+        vSemaphoreDelete(mutex);
+        mutex = NULL;
+        return err;
+    }
+    at_channel_init(&channel);
+    done_fn = done;
+    return ESP_OK;
+}
+
+static esp_err_t issue(at_cmd_type_t type, const char *arg)
+{
+    switch (type) {
+        case AT_CMD_DIAL:
+            return esp_hf_client_dial(arg);
+        case AT_CMD_REDIAL:
+            return esp_hf_client_dial(NULL); // NULL redials the last number
+        case AT_CMD_MEMORY_DIAL:
+            return esp_hf_client_dial_memory((int)strtol(arg, NULL, 10));
+        case AT_CMD_CLCC:
+            return esp_hf_client_query_current_calls();
+        case AT_CMD_HANGUP:
+            return esp_hf_client_reject_call(); // AT+CHUP, whatever state the call is in
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+esp_err_t hf_at_send(uint32_t id, at_cmd_type_t type, const char *arg)
+{
+    if (!mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if ((type == AT_CMD_DIAL || type == AT_CMD_MEMORY_DIAL) && (arg == NULL || arg[0] == '\0')) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Recorded first: the answer can come back before the HFP call returns
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    esp_err_t err = at_channel_sent(&channel, id, type, esp_timer_get_time());
+    if (err == ESP_OK) {
+        arm_timer();
+    }
+    xSemaphoreGive(mutex);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = issue(type, arg);
+    if (err != ESP_OK) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        at_channel_unsend(&channel, id, esp_timer_get_time());
+        arm_timer();
+        xSemaphoreGive(mutex);
+    }
+    return err;
+}
+
+bool hf_at_answer(int code, int cme)
+{
+    if (!mutex) {
+        return false;
+    }
+    at_completion_t done;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    bool waiting = channel.count > 0;
+    bool matched = at_channel_answer(&channel, result_from_code(code), esp_timer_get_time(), &done);
+    arm_timer();
+    xSemaphoreGive(mutex);
+
+    if (code == ESP_HF_AT_RESPONSE_CODE_CME) {
+        ESP_LOGW(TAG, "+CME ERROR: %d", cme);
+    }
+    if (matched) {
+        finish(&done);
+    } else {
+        metrics_inc(METRIC_AT_UNMATCHED);
+        ESP_LOGW(TAG, "AT answer %d %s", code, waiting ? "arrived after its command timed out" : "with no command outstanding");
+    }
+    return waiting;
+}
+
+void hf_at_link_lost(void)
+{
+    if (!mutex) {
+        return;
+    }
+    // Collected first so done_fn runs without the mutex
+    at_completion_t lost[AT_CHANNEL_DEPTH];
+    size_t count = 0;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    while (count < AT_CHANNEL_DEPTH && at_channel_flush(&channel, &lost[count])) {
+        count++;
+    }
+    arm_timer();
+    xSemaphoreGive(mutex);
+    for (size_t i = 0; i < count; i++) {
+        finish(&lost[i]);
+    }
+}
+
+uint32_t hf_at_pending_id(at_cmd_type_t type)
+{
+    if (!mutex) {
+        return 0;
+    }
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t id = at_channel_pending_id(&channel, type);
+    xSemaphoreGive(mutex);
+    return id;
+}
@@ -0,0 +1,37 @@
+#ifndef HF_AT_H
+#define HF_AT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "at_channel.h"
+
+// Runs at_channel.c against the HFP client: every AT command goes out through here,
+// the HFP callback hands every OK/ERROR answer back, and a one-shot timer reports the
+// commands the phone never answers. Each finished command is passed to the done
+// callback exactly once and counted in /metrics.
+
+// Runs for each finished command, on whichever task finished it: the HFP callback, the
+// timer task, or the caller of hf_at_link_lost(). Must not block.
+typedef void (*hf_at_done_fn)(const at_completion_t *done);
+
+esp_err_t hf_at_init(hf_at_done_fn done);
+
+// Hand one command to Bluedroid: arg is the number for AT_CMD_DIAL and the memory
+// location (in decimal) for AT_CMD_MEMORY_DIAL, otherwise unused. ESP_ERR_NO_MEM when
+// AT_CHANNEL_DEPTH commands are already waiting for an answer; any other error is the
+// HFP API's.
+esp_err_t hf_at_send(uint32_t id, at_cmd_type_t type, const char *arg);
+
+// From the HFP callback: the phone answered with code (an esp_hf_at_response_code_t).
+// Returns false if no command was waiting for an answer, so the caller can treat it as
+// unsolicited.
+bool hf_at_answer(int code, int cme);
+
+// From the HFP callback: the link dropped; everything outstanding finishes as lost
+void hf_at_link_lost(void);
+
+// ID of a command of this type sent and still waiting for its answer, or 0
+uint32_t hf_at_pending_id(at_cmd_type_t type);
+
+#endif // HF_AT_H
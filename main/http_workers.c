@@ -0,0 +1,178 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "http_workers.h"
+
+#define TAG "HTTP_WORKERS"
+
+typedef struct {
+    http_work_fn_t fn;
+    void *arg;
+} http_job_t;
+
+// A request detached from the httpd task, owned by the job that runs it
+typedef struct {
+    httpd_req_t *req;
+    http_async_handler_t handler;
+    http_async_after_t after;
+} deferred_request_t;
+
+static QueueHandle_t job_queue = NULL;
+static TaskHandle_t worker_tasks[HTTP_WORKERS_MAX];
+static size_t worker_count = 0;
+
+// Guarded by lock
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+static http_workers_stats_t stats;
+
+static void http_worker_task(void *arg)
+{
+    http_job_t job;
+
+    for (;;) {
+        if (xQueueReceive(job_queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        portENTER_CRITICAL(&lock);
+        stats.busy++;
+        portEXIT_CRITICAL(&lock);
+
+        job.fn(job.arg);
+
+        portENTER_CRITICAL(&lock);
+        stats.busy--;
+        stats.completed++;
+        portEXIT_CRITICAL(&lock);
+    }
+}
+
+esp_err_t http_workers_init(size_t workers, size_t queue_len)
+{
+    if (workers == 0 || workers > HTTP_WORKERS_MAX || queue_len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    job_queue = xQueueCreate(queue_len, sizeof(http_job_t));
+    if (!job_queue) {
+        ESP_LOGE(TAG, "Failed to allocate the job queue");
+        return ESP_ERR_NO_MEM;
+    }
+    memset(&stats, 0, sizeof(stats));
+    stats.queue_len = queue_len;
+
+    for (worker_count = 0; worker_count < workers; worker_count++) {
+        if (xTaskCreate(http_worker_task, "http_worker", HTTP_WORKER_TASK_STACK, NULL,
+                        HTTP_WORKER_TASK_PRIORITY, &worker_tasks[worker_count]) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create HTTP worker %u", (unsigned)worker_count);
+            http_workers_deinit();
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    stats.workers = worker_count;
+    ESP_LOGI(TAG, "%u HTTP workers started (queue depth %u)", (unsigned)workers, (unsigned)queue_len);
+    return ESP_OK;
+}
+
+void http_workers_deinit(void)
+{
+    for (size_t i = 0; i < worker_count; i++) {
+        vTaskDelete(worker_tasks[i]);
+        worker_tasks[i] = NULL;
+    }
+    worker_count = 0;
+    if (job_queue) {
+        vQueueDelete(job_queue);
+        job_queue = NULL;
+    }
+}
+
+esp_err_t http_workers_submit(http_work_fn_t fn, void *arg)
+{
+    if (!job_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_job_t job = { .fn = fn, .arg = arg };
+    if (xQueueSendToBack(job_queue, &job, 0) != pdTRUE) {
+        portENTER_CRITICAL(&lock);
+        stats.rejected++;
+        portEXIT_CRITICAL(&lock);
+        ESP_LOGW(TAG, "Job queue full");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // The depth read here may already include jobs queued by others since; it only feeds the high-water mark
+    uint32_t depth = uxQueueMessagesWaiting(job_queue);
+    portENTER_CRITICAL(&lock);
+    stats.submitted++;
+    if (depth > stats.queue_high_water) {
+        stats.queue_high_water = depth;
+    }
+    portEXIT_CRITICAL(&lock);
+    return ESP_OK;
+}
+
+static void run_deferred_request(void *arg)
+{
+    deferred_request_t *deferred = arg;
+    esp_err_t err = deferred->handler(deferred->req);
+    if (err != ESP_OK) {
+        ESP_LOGD(TAG, "Deferred %s returned %s", deferred->req->uri, esp_err_to_name(err));
+    }
+    httpd_req_async_handler_complete(deferred->req);
+    if (err == ESP_OK && deferred->after) {
+        deferred->after();
+    }
+    free(deferred);
+}
+
+static void send_busy(httpd_req_t *req)
+{
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_hdr(req, "Retry-After", "1");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, "{\"error\":\"Server busy, try again shortly\"}\n");
+}
+
+esp_err_t http_workers_defer_request(httpd_req_t *req, http_async_handler_t handler, http_async_after_t after)
+{
+    deferred_request_t *deferred = calloc(1, sizeof(*deferred));
+    if (!deferred) {
+        send_busy(req);
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t err = httpd_req_async_handler_begin(req, &deferred->req);
+    if (err != ESP_OK) {
+        free(deferred);
+        send_busy(req);
+        return err;
+    }
+    deferred->handler = handler;
+    deferred->after = after;
+
+    err = http_workers_submit(run_deferred_request, deferred);
+    if (err != ESP_OK) {
+        // The copy now owns the socket, so answer on it and hand it back
+        send_busy(deferred->req);
+        httpd_req_async_handler_complete(deferred->req);
+        free(deferred);
+    }
+    return err;
+}
+
+void http_workers_get_stats(http_workers_stats_t *out)
+{
+    uint32_t depth = job_queue ? uxQueueMessagesWaiting(job_queue) : 0;
+    portENTER_CRITICAL(&lock);
+    *out = stats;
+    portEXIT_CRITICAL(&lock);
+    out->queue_depth = depth;
+}
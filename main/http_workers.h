@@ -0,0 +1,54 @@
+#ifndef HTTP_WORKERS_H
+#define HTTP_WORKERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Small pool of tasks for HTTP work that blocks: NVS commits, Wi-Fi reconfiguration,
+// stopping the server itself. A handler hands its request over with
+// http_workers_defer_request() and returns at once, so the httpd task goes back to
+// serving the other sockets while a worker finishes the request.
+#define HTTP_WORKERS_MAX 4
+#define HTTP_WORKER_TASK_STACK 4096
+#define HTTP_WORKER_TASK_PRIORITY 5
+
+typedef void (*http_work_fn_t)(void *arg);
+
+// Runs on a worker with the detached request; the return value is only logged
+typedef esp_err_t (*http_async_handler_t)(httpd_req_t *req);
+
+// Runs on the same worker after the request has been completed, if the handler
+// returned ESP_OK. For follow-up work that must not hold the request open, such as
+// stopping the server that carried it.
+typedef void (*http_async_after_t)(void);
+
+typedef struct {
+    uint32_t workers;
+    uint32_t queue_len;
+    uint32_t queue_depth;      // Jobs waiting for a worker
+    uint32_t queue_high_water; // Deepest the queue has been
+    uint32_t busy;             // Workers running a job right now
+    uint32_t submitted;
+    uint32_t rejected;         // Refused because the queue was full
+    uint32_t completed;
+} http_workers_stats_t;
+
+// Start `workers` tasks (1..HTTP_WORKERS_MAX) sharing a queue of queue_len jobs
+esp_err_t http_workers_init(size_t workers, size_t queue_len);
+
+// Stop the workers and free everything (used by tests)
+void http_workers_deinit(void);
+
+// Queue fn(arg) without blocking. ESP_ERR_NO_MEM when the queue is full,
+// ESP_ERR_INVALID_STATE before init.
+esp_err_t http_workers_submit(http_work_fn_t fn, void *arg);
+
+// Detach req from the httpd task and finish it on a worker. On failure the client has
+// already been answered with 503 and the caller just returns the error.
+esp_err_t http_workers_defer_request(httpd_req_t *req, http_async_handler_t handler, http_async_after_t after);
+
+void http_workers_get_stats(http_workers_stats_t *stats);
+
+#endif // HTTP_WORKERS_H
@@ -0,0 +1,345 @@
+#include <string.h>
+
+#include "json_kv.h"
+
+#define JSON_KV_KEY_MAX   32 // Longer keys cannot match any field and are only validated
+#define JSON_KV_MAX_DEPTH 8  // Nesting allowed inside skipped values
+
+typedef struct {
+    const char *p;
+    const char *end;
+} json_cursor_t;
+
+// Destination for a decoded string; buf may be NULL to only validate
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    bool overflow;
+} json_str_out_t;
+
+static void skip_ws(json_cursor_t *c)
+{
+    while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) {
+        c->p++;
+    }
+}
+
+static bool consume(json_cursor_t *c, char ch)
+{
+    skip_ws(c);
+    if (c->p < c->end && *c->p == ch) {
+        c->p++;
+        return true;
+    }
+    return false;
+}
+
+static bool consume_literal(json_cursor_t *c, const char *literal)
+{
+    size_t n = strlen(literal);
+    if ((size_t)(c->end - c->p) < n || memcmp(c->p, literal, n) != 0) {
+        return false;
+    }
+    c->p += n;
+    return true;
+}
+
+static void str_put(json_str_out_t *out, char ch)
+{
+    if (!out->buf) {
+        return;
+    }
+    if (out->len + 1 < out->size) {
+        out->buf[out->len++] = ch;
+    } else {
+        out->overflow = true;
+    }
+}
+
+static void str_put_utf8(json_str_out_t *out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        str_put(out, (char)cp);
+    } else if (cp < 0x800) {
+        str_put(out, (char)(0xC0 | (cp >> 6)));
+        str_put(out, (char)(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        str_put(out, (char)(0xE0 | (cp >> 12)));
+        str_put(out, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        str_put(out, (char)(0x80 | (cp & 0x3F)));
+    } else {
+        str_put(out, (char)(0xF0 | (cp >> 18)));
+        str_put(out, (char)(0x80 | ((cp >> 12) & 0x3F)));
+        str_put(out, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        str_put(out, (char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+static bool parse_hex4(json_cursor_t *c, uint32_t *value)
+{
+    if (c->end - c->p < 4) {
+        return false;
+    }
+    *value = 0;
+    for (int i = 0; i < 4; i++) {
+        char h = *c->p++;
+        *value <<= 4;
+        if (h >= '0' && h <= '9') *value |= (uint32_t)(h - '0');
+        else if (h >= 'a' && h <= 'f') *value |= (uint32_t)(h - 'a' + 10);
+        else if (h >= 'A' && h <= 'F') *value |= (uint32_t)(h - 'A' + 10);
+        else return false;
+    }
+    return true;
+}
+
+// Decode a string starting at the opening quote
+static bool parse_string(json_cursor_t *c, json_str_out_t *out)
+{
+    if (c->p >= c->end || *c->p != '"') {
+        return false;
+    }
+    c->p++;
+    while (c->p < c->end) {
+        unsigned char ch = (unsigned char)*c->p++;
+        if (ch == '"') {
+            if (out->buf && out->size > 0) {
+                out->buf[out->len] = '\0';
+            }
+            return true;
+        }
+        if (ch < 0x20) {
+            return false; // Raw control characters are not allowed in JSON strings
+        }
+        if (ch != '\\') {
+            str_put(out, (char)ch);
+            continue;
+        }
+        if (c->p >= c->end) {
+            return false;
+        }
+        char esc = *c->p++;
+        switch (esc) {
+            case '"':  str_put(out, '"'); break;
+            case '\\': str_put(out, '\\'); break;
+            case '/':  str_put(out, '/'); break;
+            case 'b':  str_put(out, '\b'); break;
+            case 'f':  str_put(out, '\f'); break;
+            case 'n':  str_put(out, '\n'); break;
+            case 'r':  str_put(out, '\r'); break;
+            case 't':  str_put(out, '\t'); break;
+            case 'u': {
+                uint32_t cp;
+                if (!parse_hex4(c, &cp)) {
+                    return false;
+                }
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // High surrogate; must be followed by an escaped low surrogate
+                    uint32_t low;
+                    if (!consume_literal(c, "\\u") || !parse_hex4(c, &low) ||
+                        low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return false;
+                }
+                str_put_utf8(out, cp);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false; // Unterminated
+}
+
+// Parse a JSON number. *fits is set when it is a non-negative value whose integer part
+// fits in a uint32_t and which has no exponent.
+static bool parse_number(json_cursor_t *c, uint32_t *value, bool *fits)
+{
+    uint64_t acc = 0;
+    bool negative = false;
+    bool overflow = false;
+    bool exponent = false;
+
+    if (c->p < c->end && *c->p == '-') {
+        negative = true;
+        c->p++;
+    }
+    if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+        return false;
+    }
+    if (*c->p == '0') {
+        c->p++; // No leading zeros
+    } else {
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            acc = acc * 10 + (uint64_t)(*c->p++ - '0');
+            if (acc > UINT32_MAX) {
+                overflow = true;
+                acc = UINT32_MAX;
+            }
+        }
+    }
+    if (c->p < c->end && *c->p == '.') {
+        c->p++;
+        if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+            return false;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') c->p++;
+    }
+    if (c->p < c->end && (*c->p == 'e' || *c->p == 'E')) {
+        exponent = true;
+        c->p++;
+        if (c->p < c->end && (*c->p == '+' || *c->p == '-')) c->p++;
+        if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+            return false;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') c->p++;
+    }
+
+    *value = (uint32_t)acc;
+    *fits = !overflow && !exponent && (!negative || acc == 0);
+    return true;
+}
+
+// Skip over any value, bounding the nesting depth
+static bool skip_value(json_cursor_t *c, int depth)
+{
+    skip_ws(c);
+    if (c->p >= c->end || depth > JSON_KV_MAX_DEPTH) {
+        return false;
+    }
+
+    json_str_out_t discard = {0};
+    uint32_t number;
+    bool fits;
+
+    switch (*c->p) {
+        case '"':
+            return parse_string(c, &discard);
+        case 't':
+            return consume_literal(c, "true");
+        case 'f':
+            return consume_literal(c, "false");
+        case 'n':
+            return consume_literal(c, "null");
+        case '{':
+            c->p++;
+            if (consume(c, '}')) {
+                return true;
+            }
+            do {
+                skip_ws(c);
+                if (!parse_string(c, &discard) || !consume(c, ':') || !skip_value(c, depth + 1)) {
+                    return false;
+                }
+            } while (consume(c, ','));
+            return consume(c, '}');
+        case '[':
+            c->p++;
+            if (consume(c, ']')) {
+                return true;
+            }
+            do {
+                if (!skip_value(c, depth + 1)) {
+                    return false;
+                }
+            } while (consume(c, ','));
+            return consume(c, ']');
+        default:
+            return parse_number(c, &number, &fits);
+    }
+}
+
+static json_kv_field_t *find_field(json_kv_field_t *fields, size_t field_count, const char *key)
+{
+    for (size_t i = 0; i < field_count; i++) {
+        if (strcmp(fields[i].key, key) == 0) {
+            return &fields[i];
+        }
+    }
+    return NULL;
+}
+
+// Parse one member value into its field, or skip it if the type does not match
+static bool parse_field_value(json_cursor_t *c, json_kv_field_t *field)
+{
+    skip_ws(c);
+    if (c->p >= c->end) {
+        return false;
+    }
+
+    char lead = *c->p;
+    if (field->type == JSON_KV_STRING && lead == '"') {
+        json_str_out_t out = { .buf = field->out, .size = field->out_size };
+        if (!parse_string(c, &out)) {
+            return false;
+        }
+        field->present = !out.overflow && field->out_size > 0;
+        if (!field->present && field->out_size > 0) {
+            ((char *)field->out)[0] = '\0'; // Don't leave a truncated value behind
+        }
+        return true;
+    }
+    if (field->type == JSON_KV_BOOL && (lead == 't' || lead == 'f')) {
+        bool value = (lead == 't');
+        if (!consume_literal(c, value ? "true" : "false")) {
+            return false;
+        }
+        *(bool *)field->out = value;
+        field->present = true;
+        return true;
+    }
+    if (field->type == JSON_KV_UINT32 && (lead == '-' || (lead >= '0' && lead <= '9'))) {
+        uint32_t value;
+        bool fits;
+        if (!parse_number(c, &value, &fits)) {
+            return false;
+        }
+        if (fits) {
+            *(uint32_t *)field->out = value;
+            field->present = true;
+        }
+        return true;
+    }
+    return skip_value(c, 0);
+}
+
+esp_err_t json_kv_parse(const char *json, size_t len, json_kv_field_t *fields, size_t field_count)
+{
+    json_cursor_t c = { .p = json, .end = json + len };
+
+    for (size_t i = 0; i < field_count; i++) {
+        fields[i].present = false;
+    }
+
+    if (!consume(&c, '{')) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!consume(&c, '}')) {
+        do {
+            char key[JSON_KV_KEY_MAX];
+            json_str_out_t key_out = { .buf = key, .size = sizeof(key) };
+
+            skip_ws(&c);
+            if (!parse_string(&c, &key_out) || !consume(&c, ':')) {
+                return ESP_ERR_INVALID_ARG;
+            }
+
+            // Like cJSON's lookup, the first occurrence of a duplicated key wins
+            json_kv_field_t *field = key_out.overflow ? NULL : find_field(fields, field_count, key);
+            bool ok = (field && !field->present) ? parse_field_value(&c, field) : skip_value(&c, 0);
+            if (!ok) {
+                return ESP_ERR_INVALID_ARG;
+            }
+        } while (consume(&c, ','));
+
+        if (!consume(&c, '}')) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    skip_ws(&c);
+    return (c.p == c.end) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
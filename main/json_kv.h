@@ -0,0 +1,32 @@
+#ifndef JSON_KV_H
+#define JSON_KV_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Allocation-free parser for the small, flat JSON objects the POST handlers accept.
+// Values are written straight into caller storage; no cJSON tree is built.
+
+typedef enum {
+    JSON_KV_STRING, // out points at a char[out_size] buffer
+    JSON_KV_BOOL,   // out points at a bool
+    JSON_KV_UINT32, // out points at a uint32_t; non-negative numbers only, fraction truncated
+} json_kv_type_t;
+
+typedef struct {
+    const char *key;
+    json_kv_type_t type;
+    void *out;
+    size_t out_size;    // Size of the string buffer, including the terminator
+    bool present;       // Set when the key held a value of the expected type that fit in out
+} json_kv_field_t;
+
+// Parse a JSON object and fill in the fields whose keys appear in it.
+// Unknown keys (including nested objects and arrays) are skipped, and a value of the
+// wrong type just leaves its field not present. Returns ESP_ERR_INVALID_ARG if the
+// text is not a well-formed JSON object.
+esp_err_t json_kv_parse(const char *json, size_t len, json_kv_field_t *fields, size_t field_count);
+
+#endif // JSON_KV_H
@@ -0,0 +1,93 @@
+#include <string.h>
+
+#include "led_pattern.h"
+
+static const char *const morse_digits[10] = {
+    "-----", ".----", "..---", "...--", "....-", ".....", "-....", "--...", "---..", "----.",
+};
+#define MORSE_FULL_STOP ".-.-.-"
+
+static const char *morse_for(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return morse_digits[c - '0'];
+    }
+    return c == '.' ? MORSE_FULL_STOP : NULL;
+}
+
+static void append_step(led_pattern_t *pattern, uint16_t on_ms, uint16_t off_ms)
+{
+    pattern->steps_ms[pattern->count++] = on_ms;
+    pattern->steps_ms[pattern->count++] = off_ms;
+}
+
+// Lengthen the dark step that ends the pattern so far
+static void extend_pause(led_pattern_t *pattern, uint16_t extra_ms)
+{
+    if (pattern->count > 0) {
+        pattern->steps_ms[pattern->count - 1] += extra_ms;
+    }
+}
+
+static esp_err_t append_morse_within(led_pattern_t *pattern, const char *text, size_t max_steps)
+{
+    size_t needed = 0;
+    for (const char *p = text; *p; p++) {
+        const char *code = morse_for(*p);
+        needed += code ? 2 * strlen(code) : 0;
+    }
+    if (pattern->count + needed > max_steps) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    for (const char *p = text; *p; p++) {
+        const char *code = morse_for(*p);
+        if (code == NULL) {
+            continue;
+        }
+        for (const char *s = code; *s; s++) {
+            append_step(pattern, *s == '-' ? MORSE_DASH_DURATION : MORSE_DOT_DURATION, MORSE_SYMBOL_PAUSE);
+        }
+        extend_pause(pattern, MORSE_CHAR_PAUSE);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_pattern_append_morse(led_pattern_t *pattern, const char *text)
+{
+    return append_morse_within(pattern, text, LED_PATTERN_MAX_STEPS);
+}
+
+void led_pattern_build(const led_status_t *status, led_pattern_t *out)
+{
+    out->count = 0;
+    if (status->call == LED_CALL_ACTIVE) {
+        append_step(out, LED_CALL_ACTIVE_ON_MS, LED_CALL_ACTIVE_OFF_MS);
+        return;
+    }
+
+    // Leave room for a marker; a readout too long for that is dropped rather than cut short
+    if (status->ip != NULL) {
+        append_morse_within(out, status->ip, LED_PATTERN_MAX_STEPS - LED_MARKER_MAX_STEPS);
+    }
+    if (status->call == LED_CALL_FAILED || status->bluetooth_connected) {
+        extend_pause(out, LED_MARKER_PAUSE);
+        if (status->call == LED_CALL_FAILED) {
+            for (int i = 0; i < LED_CALL_FAILED_BLINKS; i++) {
+                append_step(out, LED_CALL_FAILED_BLINK_MS, LED_CALL_FAILED_BLINK_MS);
+            }
+        } else {
+            append_step(out, LED_BT_CONNECTED_ON_MS, 0);
+        }
+    }
+    extend_pause(out, MORSE_IP_READOUT_PAUSE);
+}
+
+uint32_t led_pattern_period_ms(const led_pattern_t *pattern)
+{
+    uint32_t total = 0;
+    for (size_t i = 0; i < pattern->count; i++) {
+        total += pattern->steps_ms[i];
+    }
+    return total;
+}
@@ -0,0 +1,61 @@
+#ifndef LED_PATTERN_H
+#define LED_PATTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Status LED waveforms, compiled once when the device state changes and then played
+// back step by step by a one-shot timer. Pure logic, so it runs unchanged in host tests.
+
+// Morse code timing (milliseconds)
+#define MORSE_DOT_DURATION 200
+#define MORSE_DASH_DURATION 600
+#define MORSE_SYMBOL_PAUSE 200
+#define MORSE_CHAR_PAUSE 600        // On top of the symbol pause after a character's last symbol
+#define MORSE_IP_READOUT_PAUSE 5000 // Dark gap before the readout repeats
+
+// Markers shown after the IP readout (or on their own when there is no IP)
+#define LED_BT_CONNECTED_ON_MS 1500 // One long bar: the phone is connected
+#define LED_CALL_FAILED_BLINK_MS 100 // Three quick blinks: the last call did not connect
+#define LED_CALL_FAILED_BLINKS 3
+#define LED_CALL_ACTIVE_ON_MS 900   // Nearly solid while a call is being set up or is up
+#define LED_CALL_ACTIVE_OFF_MS 100
+#define LED_MARKER_PAUSE 1000       // Dark gap between the readout and a marker
+
+// "255.255.255.255" is 78 symbols; markers take up to LED_MARKER_MAX_STEPS more
+#define LED_MARKER_MAX_STEPS (2 * LED_CALL_FAILED_BLINKS)
+#define LED_PATTERN_MAX_STEPS 176
+
+// steps_ms alternates on and off, starting with on, so count is always even.
+// An empty pattern means the LED stays off and nothing needs to run.
+typedef struct {
+    uint16_t steps_ms[LED_PATTERN_MAX_STEPS];
+    size_t count;
+} led_pattern_t;
+
+typedef enum {
+    LED_CALL_NONE,
+    LED_CALL_ACTIVE, // Dialing, ringing or connected
+    LED_CALL_FAILED,
+} led_call_status_t;
+
+typedef struct {
+    const char *ip;          // Dotted quad to read out; NULL or "" for none
+    bool bluetooth_connected;
+    led_call_status_t call;
+} led_status_t;
+
+// Append text as Morse code (digits and '.'; anything else is skipped).
+// ESP_ERR_INVALID_SIZE if the pattern is full, leaving it unchanged.
+esp_err_t led_pattern_append_morse(led_pattern_t *pattern, const char *text);
+
+// Build the repeating pattern for a status: an active call shows on its own; otherwise
+// the IP readout followed by the call-failed or Bluetooth marker.
+void led_pattern_build(const led_status_t *status, led_pattern_t *out);
+
+// Total length of one repetition
+uint32_t led_pattern_period_ms(const led_pattern_t *pattern);
+
+#endif // LED_PATTERN_H
@@ -0,0 +1,378 @@
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "log_ring.h"
+
+static log_record_t *ring = NULL;
+static size_t ring_capacity = 0;
+static atomic_uint_least32_t next_seq = 1;
+
+// Wall-clock offset; 0 means unknown. A 64-bit value, so it only changes under the lock:
+// writers never touch it, and a reader must not pair halves of two different offsets.
+static portMUX_TYPE wall_offset_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t wall_offset_us;
+
+typedef struct {
+    char tag[LOG_RING_TAG_MAX];
+    atomic_int level;
+} tag_level_t;
+
+static atomic_int default_level = ESP_LOG_INFO;
+static tag_level_t tag_levels[LOG_RING_MAX_TAG_LEVELS];
+static atomic_int tag_level_count;
+
+static const char level_letters[] = "NEWIDV";
+static const char *const level_names[] = { "none", "error", "warn", "info", "debug", "verbose" };
+
+// One printf conversion, as far as packing its argument is concerned
+typedef struct {
+    const char *start;  // The '%'
+    const char *end;    // One past the conversion character
+    char conv;
+    char length;        // 0, 'h', 'H' (hh), 'l', 'L' (ll), 'j', 'z' or 't'
+    int stars;          // '*' width/precision arguments, each an int
+} fmt_spec_t;
+
+// Find the next conversion at or after p; "%%" is skipped. Returns false at the end.
+static bool next_spec(const char *p, fmt_spec_t *spec)
+{
+    while ((p = strchr(p, '%')) != NULL) {
+        if (p[1] == '%') {
+            p += 2;
+            continue;
+        }
+        spec->start = p++;
+        spec->stars = 0;
+        spec->length = 0;
+        while (*p && strchr("-+ #0", *p)) p++;
+        for (int part = 0; part < 2; part++) { // Width, then precision
+            if (part == 1) {
+                if (*p != '.') break;
+                p++;
+            }
+            if (*p == '*') {
+                spec->stars++;
+                p++;
+            }
+            while (*p >= '0' && *p <= '9') p++;
+        }
+        if (*p == 'h' || *p == 'l') {
+            spec->length = *p++;
+            if (*p == spec->length) {
+                spec->length = (spec->length == 'h') ? 'H' : 'L';
+                p++;
+            }
+        } else if (*p == 'j' || *p == 'z' || *p == 't' || *p == 'L') {
+            spec->length = *p++;
+        }
+        if (*p == '\0') {
+            return false;
+        }
+        spec->conv = *p++;
+        spec->end = p;
+        return true;
+    }
+    return false;
+}
+
+// Bytes the argument occupies in the record, 0 for strings and unsupported conversions
+static size_t arg_size(const fmt_spec_t *spec)
+{
+    if (strchr("diouxXc", spec->conv)) {
+        switch (spec->length) {
+            case 'L': case 'j': return sizeof(long long);
+            case 'l': return sizeof(long);
+            case 'z': return sizeof(size_t);
+            case 't': return sizeof(ptrdiff_t);
+            default: return sizeof(int);
+        }
+    }
+    if (spec->conv == 'p') return sizeof(void *);
+    if (strchr("fFeEgGaA", spec->conv)) return sizeof(double);
+    return 0;
+}
+
+esp_err_t log_ring_init(size_t capacity)
+{
+    if (capacity == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    log_record_t *records = calloc(capacity, sizeof(log_record_t));
+    if (!records) {
+        return ESP_ERR_NO_MEM;
+    }
+    free(ring);
+    ring_capacity = capacity;
+    ring = records;
+    return ESP_OK;
+}
+
+void log_ring_write(esp_log_level_t level, const char *tag, const char *fmt, ...)
+{
+    if (!ring) {
+        return;
+    }
+    uint32_t seq = atomic_fetch_add_explicit(&next_seq, 1, memory_order_relaxed);
+    log_record_t *rec = &ring[seq % ring_capacity];
+
+    // Mark the slot busy so a concurrent reader discards what it copies
+    atomic_store_explicit(&rec->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    rec->level = (uint8_t)level;
+    rec->timestamp_us = esp_timer_get_time();
+    rec->tag = tag;
+    rec->fmt = fmt;
+    rec->arg_len = 0;
+    rec->str_len = 0;
+    rec->truncated = false;
+
+    va_list args;
+    va_start(args, fmt);
+    fmt_spec_t spec;
+    const char *p = fmt;
+    while (!rec->truncated && next_spec(p, &spec)) {
+        p = spec.end;
+        for (int i = 0; i < spec.stars; i++) {
+            int star = va_arg(args, int);
+            if (rec->arg_len + sizeof(star) > LOG_RING_ARG_BYTES) {
+                rec->truncated = true;
+                break;
+            }
+            memcpy(rec->args + rec->arg_len, &star, sizeof(star));
+            rec->arg_len += sizeof(star);
+        }
+        if (rec->truncated) break;
+
+        if (spec.conv == 's') {
+            const char *str = va_arg(args, const char *);
+            if (!str) str = "(null)";
+            size_t room = LOG_RING_STR_BYTES - rec->str_len;
+            size_t n = strnlen(str, room > 0 ? room - 1 : 0);
+            if (room == 0 || str[n] != '\0') {
+                rec->truncated = true; // Keep what fits; formatting stops after it
+            }
+            if (room > 0) {
+                memcpy(rec->strs + rec->str_len, str, n);
+                rec->strs[rec->str_len + n] = '\0';
+                rec->str_len += n + 1;
+            }
+            continue;
+        }
+
+        size_t size = arg_size(&spec);
+        if (size == 0 || rec->arg_len + size > LOG_RING_ARG_BYTES) {
+            rec->truncated = true;
+            break;
+        }
+        if (size == sizeof(double) && strchr("fFeEgGaA", spec.conv)) {
+            double d = va_arg(args, double);
+            memcpy(rec->args + rec->arg_len, &d, size);
+        } else if (size == sizeof(long long) && size != sizeof(int)) {
+            long long ll = va_arg(args, long long);
+            memcpy(rec->args + rec->arg_len, &ll, size);
+        } else if (spec.conv == 'p') {
+            void *ptr = va_arg(args, void *);
+            memcpy(rec->args + rec->arg_len, &ptr, size);
+        } else {
+            int i = va_arg(args, int);
+            memcpy(rec->args + rec->arg_len, &i, size);
+        }
+        rec->arg_len += size;
+    }
+    va_end(args);
+
+    atomic_store_explicit(&rec->seq, seq, memory_order_release);
+}
+
+uint32_t log_ring_next_seq(void)
+{
+    return atomic_load_explicit(&next_seq, memory_order_relaxed);
+}
+
+uint32_t log_ring_oldest_seq(void)
+{
+    uint32_t next = log_ring_next_seq();
+    return (next > ring_capacity) ? next - ring_capacity : 1;
+}
+
+bool log_ring_read(uint32_t seq, log_record_t *out)
+{
+    if (!ring || seq == 0) {
+        return false;
+    }
+    log_record_t *rec = &ring[seq % ring_capacity];
+    if (atomic_load_explicit(&rec->seq, memory_order_acquire) != seq) {
+        return false;
+    }
+    memcpy(out, rec, sizeof(*out));
+    atomic_thread_fence(memory_order_acquire);
+    // A writer that lapped us while copying leaves a different sequence number behind
+    return atomic_load_explicit(&rec->seq, memory_order_relaxed) == seq;
+}
+
+// Format the message of a record by replaying its format with the stored arguments
+static size_t format_message(const log_record_t *rec, char *buf, size_t len)
+{
+    size_t out = 0;
+    size_t arg_off = 0;
+    size_t str_off = 0;
+    const char *p = rec->fmt;
+    fmt_spec_t spec;
+
+#define APPEND(n) do { out += (size_t)(n); if (out >= len) return len - 1; } while (0)
+
+    while (next_spec(p, &spec)) {
+        // Literal text up to this conversion, unescaping "%%"
+        for (const char *c = p; c < spec.start; c++) {
+            if (out + 1 >= len) return out;
+            buf[out++] = *c;
+            if (c[0] == '%' && c[1] == '%') c++;
+        }
+        p = spec.end;
+
+        char one[24];
+        size_t spec_len = (size_t)(spec.end - spec.start);
+        if (spec_len >= sizeof(one)) break;
+        memcpy(one, spec.start, spec_len);
+        one[spec_len] = '\0';
+
+        int stars[2] = { 0, 0 };
+        size_t size = (spec.conv == 's') ? 0 : arg_size(&spec);
+        if (arg_off + spec.stars * sizeof(int) + size > rec->arg_len ||
+            (spec.conv == 's' && str_off >= rec->str_len) ||
+            (spec.conv != 's' && size == 0)) {
+            break; // Not captured; the rest of the message was truncated
+        }
+        for (int i = 0; i < spec.stars; i++) {
+            memcpy(&stars[i], rec->args + arg_off, sizeof(int));
+            arg_off += sizeof(int);
+        }
+
+        int n;
+        if (spec.conv == 's') {
+            const char *str = rec->strs + str_off;
+            str_off += strlen(str) + 1;
+            n = (spec.stars == 2) ? snprintf(buf + out, len - out, one, stars[0], stars[1], str)
+              : (spec.stars == 1) ? snprintf(buf + out, len - out, one, stars[0], str)
+              : snprintf(buf + out, len - out, one, str);
+        } else {
+            union { int i; long l; long long ll; double d; void *ptr; size_t z; ptrdiff_t t; } v;
+            memcpy(&v, rec->args + arg_off, size);
+            arg_off += size;
+#define FORMAT_ARG(value) ((spec.stars == 2) ? snprintf(buf + out, len - out, one, stars[0], stars[1], value) \
+                         : (spec.stars == 1) ? snprintf(buf + out, len - out, one, stars[0], value) \
+                         : snprintf(buf + out, len - out, one, value))
+            if (strchr("fFeEgGaA", spec.conv)) n = FORMAT_ARG(v.d);
+            else if (spec.conv == 'p') n = FORMAT_ARG(v.ptr);
+            else if (spec.length == 'L' || spec.length == 'j') n = FORMAT_ARG(v.ll);
+            else if (spec.length == 'l') n = FORMAT_ARG(v.l);
+            else if (spec.length == 'z') n = FORMAT_ARG(v.z);
+            else if (spec.length == 't') n = FORMAT_ARG(v.t);
+            else n = FORMAT_ARG(v.i);
+#undef FORMAT_ARG
+        }
+        if (n < 0) break;
+        APPEND(n);
+    }
+    if (!rec->truncated) {
+        for (const char *c = p; *c; c++) {
+            if (out + 1 >= len) return out;
+            buf[out++] = *c;
+            if (c[0] == '%' && c[1] == '%') c++;
+        }
+    } else {
+        int n = snprintf(buf + out, len - out, "...");
+        if (n > 0) APPEND(n);
+    }
+#undef APPEND
+    buf[out] = '\0';
+    return out;
+}
+
+int log_ring_format_line(const log_record_t *rec, char *buf, size_t len)
+{
+    if (len < 2) {
+        return 0;
+    }
+    portENTER_CRITICAL(&wall_offset_lock);
+    int64_t ts = rec->timestamp_us + wall_offset_us;
+    portEXIT_CRITICAL(&wall_offset_lock);
+
+    int n = snprintf(buf, len, "%" PRIu32 " %c [%10" PRId64 ".%06" PRId64 "] %s: ",
+                     (uint32_t)atomic_load_explicit(&rec->seq, memory_order_relaxed),
+                     rec->level < sizeof(level_letters) - 1 ? level_letters[rec->level] : '?',
+                     ts / 1000000, ts % 1000000, rec->tag ? rec->tag : "");
+    if (n < 0) {
+        return 0;
+    }
+    size_t out = (size_t)n < len - 1 ? (size_t)n : len - 2; // Keep room for the newline
+    out += format_message(rec, buf + out, len - 1 - out);
+    buf[out++] = '\n';
+    buf[out] = '\0';
+    return (int)out;
+}
+
+void log_ring_set_wall_offset(int64_t offset_us)
+{
+    portENTER_CRITICAL(&wall_offset_lock);
+    wall_offset_us = offset_us;
+    portEXIT_CRITICAL(&wall_offset_lock);
+}
+
+void log_ring_set_default_level(esp_log_level_t level)
+{
+    atomic_store(&default_level, (int)level);
+}
+
+esp_err_t log_ring_set_level(const char *tag, esp_log_level_t level)
+{
+    if (strcmp(tag, "*") == 0) {
+        log_ring_set_default_level(level);
+        return ESP_OK;
+    }
+    int count = atomic_load(&tag_level_count);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(tag_levels[i].tag, tag) == 0) {
+            atomic_store(&tag_levels[i].level, (int)level);
+            return ESP_OK;
+        }
+    }
+    if (count >= LOG_RING_MAX_TAG_LEVELS) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (strlen(tag) >= LOG_RING_TAG_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    strncpy(tag_levels[count].tag, tag, LOG_RING_TAG_MAX - 1);
+    atomic_store(&tag_levels[count].level, (int)level);
+    atomic_store(&tag_level_count, count + 1); // Publish after the entry is complete
+    return ESP_OK;
+}
+
+esp_log_level_t log_ring_get_level(const char *tag)
+{
+    int count = atomic_load_explicit(&tag_level_count, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(tag_levels[i].tag, tag) == 0) {
+            return (esp_log_level_t)atomic_load_explicit(&tag_levels[i].level, memory_order_relaxed);
+        }
+    }
+    return (esp_log_level_t)atomic_load_explicit(&default_level, memory_order_relaxed);
+}
+
+bool log_ring_parse_level(const char *name, esp_log_level_t *level)
+{
+    for (size_t i = 0; i < sizeof(level_names) / sizeof(level_names[0]); i++) {
+        if (strcmp(name, level_names[i]) == 0) {
+            *level = (esp_log_level_t)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,71 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_log.h"
+
+// In-memory binary log. A write stores the format string pointer (the format ID), a
+// monotonic timestamp and the raw argument bytes in a fixed-size slot of a lock-free
+// ring; the printf work happens only when the record is read back (GET /logs).
+// Format strings must be literals; %s arguments are copied into the record.
+#define LOG_RING_ARG_BYTES 32  // Packed non-string arguments
+#define LOG_RING_STR_BYTES 48  // Copies of %s arguments, NUL-separated
+#define LOG_RING_MAX_TAG_LEVELS 8
+#define LOG_RING_TAG_MAX 16
+#define LOG_RING_LINE_MAX 256
+
+typedef struct {
+    atomic_uint_least32_t seq;  // 0 while the slot is being written
+    uint8_t level;              // esp_log_level_t
+    uint8_t arg_len;
+    uint8_t str_len;
+    bool truncated;             // Ran out of argument or string space
+    int64_t timestamp_us;       // esp_timer time
+    const char *tag;
+    const char *fmt;
+    uint8_t args[LOG_RING_ARG_BYTES];
+    char strs[LOG_RING_STR_BYTES];
+} log_record_t;
+
+// Allocate the ring. Records written before this are dropped.
+esp_err_t log_ring_init(size_t capacity);
+
+// Append a record; safe from any task. Use LOG_RING_WRITE to skip disabled levels cheaply.
+void log_ring_write(esp_log_level_t level, const char *tag, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+#define LOG_RING_WRITE(level, tag, format, ...) do { \
+    if ((level) <= log_ring_get_level(tag)) { \
+        log_ring_write(level, tag, format, ##__VA_ARGS__); \
+    } \
+} while (0)
+
+// Sequence number the next record will get, and the oldest one still in the ring.
+// Sequence numbers start at 1.
+uint32_t log_ring_next_seq(void);
+uint32_t log_ring_oldest_seq(void);
+
+// Copy out record seq. Returns false if it has been overwritten or is still being written.
+bool log_ring_read(uint32_t seq, log_record_t *out);
+
+// Render "<seq> <L> [<seconds>.<micros>] <tag>: <message>\n". Timestamps are wall-clock
+// once an offset is known, boot time before that. Returns the length written.
+int log_ring_format_line(const log_record_t *rec, char *buf, size_t len);
+
+// Cache wall-clock minus monotonic time (e.g. after an SNTP sync) so records never
+// read the clock themselves
+void log_ring_set_wall_offset(int64_t offset_us);
+
+// Runtime per-tag capture levels; tags without an entry use the default.
+// Levels are set from one task at a time (the web server).
+void log_ring_set_default_level(esp_log_level_t level);
+esp_err_t log_ring_set_level(const char *tag, esp_log_level_t level);
+esp_log_level_t log_ring_get_level(const char *tag);
+
+// Parse "none", "error", "warn", "info", "debug" or "verbose"
+bool log_ring_parse_level(const char *name, esp_log_level_t *level);
+
+#endif // LOG_RING_H
@@ -4,9 +4,12 @@
 #include <time.h>
 #include <sys/time.h>
 #include <inttypes.h>
+#include <unistd.h> // For close() in the web server close callback
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_bt.h"
 #include "esp_bt_main.h"
@@ -14,58 +17,56 @@
 #include "esp_gap_bt_api.h"
 #include "esp_hf_client_api.h" // Ensure this is included
 #include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_system.h" // For heap statistics
 #include "esp_sntp.h" // Use ESP-IDF v5.x SNTP header
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_http_server.h"
-#include "lwip/ip_addr.h"
 #include "driver/gpio.h"
 #include "cJSON.h"
 #include "esp_spiffs.h" // For SPIFFS file system
+#include "asset_manifest.h"
+#include "asset_pack.h"
+#include "http_workers.h"
+#include "static_cache.h"
+#include "device_state.h"
+#include "device_status.h"
+#include "status_events.h"
+#include "json_kv.h"
+#include "redial_schedule.h"
+#include "settings_store.h"
+#include "call_control.h"
+#include "call_state.h"
+#include "metrics.h"
+#include "log_ring.h"
+#include "boot_timing.h"
+#include "led_pattern.h"
+#include "fleet_node.h"
+#include "wifi_cache.h"
+#include "bt_link.h"
+#include "hf_at.h"
 
 #define TAG "HFP_REDIAL_API"
 
-// Helper function to get timestamp for logging (actual time if available, boot time otherwise)
-static inline void get_log_timestamp(uint32_t *seconds, uint32_t *microseconds) {
-    struct timeval tv;
-    if (gettimeofday(&tv, NULL) == 0 && tv.tv_sec > 1000000000) {
-        // We have a valid time (after year 2001), use actual time
-        *seconds = (uint32_t)tv.tv_sec;
-        *microseconds = (uint32_t)tv.tv_usec;
-    } else {
-        // No valid time set yet, fall back to boot time
-        uint64_t timestamp_us = esp_timer_get_time();
-        *seconds = (uint32_t)(timestamp_us / 1000000);
-        *microseconds = (uint32_t)(timestamp_us % 1000000);
-    }
-}
-
-// Timestamped logging macros using actual time when available
-#define ESP_LOGI_TS(tag, format, ...) do { \
-    uint32_t seconds, microseconds; \
-    get_log_timestamp(&seconds, &microseconds); \
-    ESP_LOGI(tag, "[%10"PRIu32".%06"PRIu32"] " format, seconds, microseconds, ##__VA_ARGS__); \
-} while(0)
-
-#define ESP_LOGW_TS(tag, format, ...) do { \
-    uint32_t seconds, microseconds; \
-    get_log_timestamp(&seconds, &microseconds); \
-    ESP_LOGW(tag, "[%10"PRIu32".%06"PRIu32"] " format, seconds, microseconds, ##__VA_ARGS__); \
-} while(0)
-
-#define ESP_LOGE_TS(tag, format, ...) do { \
-    uint32_t seconds, microseconds; \
-    get_log_timestamp(&seconds, &microseconds); \
-    ESP_LOGE(tag, "[%10"PRIu32".%06"PRIu32"] " format, seconds, microseconds, ##__VA_ARGS__); \
+// Timestamped logging macros. Records go to the in-memory log ring (GET /logs), which
+// captures the arguments and defers all formatting and clock reads to whoever reads
+// them; UART output is optional so the HFP callback path does not wait on the serial port.
+#if CONFIG_REMOTEHEAD_LOG_UART_ECHO
+#define LOG_TS(level, esp_log_macro, tag, format, ...) do { \
+    LOG_RING_WRITE(level, tag, format, ##__VA_ARGS__); \
+    esp_log_macro(tag, format, ##__VA_ARGS__); \
 } while(0)
+#else
+#define LOG_TS(level, esp_log_macro, tag, format, ...) LOG_RING_WRITE(level, tag, format, ##__VA_ARGS__)
+#endif
 
-#define ESP_LOGD_TS(tag, format, ...) do { \
-    uint32_t seconds, microseconds; \
-    get_log_timestamp(&seconds, &microseconds); \
-    ESP_LOGD(tag, "[%10"PRIu32".%06"PRIu32"] " format, seconds, microseconds, ##__VA_ARGS__); \
-} while(0)
+#define ESP_LOGI_TS(tag, format, ...) LOG_TS(ESP_LOG_INFO, ESP_LOGI, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW_TS(tag, format, ...) LOG_TS(ESP_LOG_WARN, ESP_LOGW, tag, format, ##__VA_ARGS__)
+#define ESP_LOGE_TS(tag, format, ...) LOG_TS(ESP_LOG_ERROR, ESP_LOGE, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD_TS(tag, format, ...) LOG_TS(ESP_LOG_DEBUG, ESP_LOGD, tag, format, ##__VA_ARGS__)
 
 // Helper function to send JSON response
 static esp_err_t httpd_resp_send_json(httpd_req_t *req, const char *json_str) {
@@ -73,41 +74,80 @@ static esp_err_t httpd_resp_send_json(httpd_req_t *req, const char *json_str) {
     return httpd_resp_sendstr(req, json_str);
 }
 
+// Several host-build instances can run side by side (a fleet on localhost):
+// REMOTEHEAD_HOST_INSTANCE=<n> moves every TCP port and httpd control port up by 10*n
+#define HOST_INSTANCE_PORT_STRIDE 10
+
+static uint16_t http_server_port(uint16_t port)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    const char *instance = getenv("REMOTEHEAD_HOST_INSTANCE");
+    if (instance) {
+        port += (uint16_t)(atoi(instance) * HOST_INSTANCE_PORT_STRIDE);
+    }
+#endif
+    return port;
+}
+
+// Back-to-back redial guard gap: long enough for the phone to accept a new dial after hanging up
+#define REDIAL_GUARD_DEFAULT_S 3
+#define REDIAL_GUARD_MIN_S 1
+#define REDIAL_GUARD_MAX_S 3600
+
 // --- Global Variables ---
-bool is_bluetooth_connected = false; // Bluetooth HFP connection status
 httpd_handle_t server = NULL; // HTTP server handle
-char current_ip_address[IP4ADDR_STRLEN_MAX]; // To store current IP address
+static httpd_handle_t control_server = NULL; // Call-control listener, started and stopped with server
 wifi_mode_t current_wifi_mode = WIFI_MODE_NULL; // To store current Wi-Fi mode
 esp_netif_t *ap_netif = NULL; // AP network interface handle
 esp_netif_t *sta_netif = NULL; // STA network interface handle
 
+// Station connect state, only touched by start_wifi_sta() and the Wi-Fi event handler
+static wifi_config_t sta_config;          // As last handed to the driver
+static wifi_cache_t sta_cached_ap;        // Valid while sta_cache_usable
+static bool sta_cache_usable;
+static bool sta_cache_failed;             // The cached AP failed this outage; scan until connected
+static bool sta_connect_cached;           // The attempt in progress targets the cached AP
+static bool sta_link_up;                  // Got an address; cleared on disconnect
+static int64_t sta_connect_started_us;    // Start of the current outage; 0 while connected
+
+// Bluetooth link, IP address, redial enable and count live in device_state.c, where
+// readers on other tasks get a consistent copy without locking
+
 // Auto Redial Settings
-bool auto_redial_enabled = false;
-bool last_call_failed = false; // New: track last call failure
 uint32_t redial_period_seconds = 60; // Default to 60 seconds
 uint32_t redial_random_delay_seconds = 0; // New: random delay in seconds
 uint32_t last_random_delay_used = 0; // New: last random value used
 uint32_t redial_max_count = 0; // New: maximum number of redials (0 = infinite)
-uint32_t redial_current_count = 0; // New: current number of redials made
+redial_mode_t redial_mode = REDIAL_MODE_PERIODIC;
+static SemaphoreHandle_t redial_settings_mutex = NULL; // Serializes /set_auto_redial across HTTP workers
+uint32_t redial_guard_seconds = REDIAL_GUARD_DEFAULT_S; // Back-to-back: idle gap before the next attempt
 
-// --- HFP Outgoing Call State Tracking ---
-static volatile bool g_is_outgoing_call_in_progress = false; // Tracks outgoing call process
-static volatile esp_hf_call_status_t g_call_status = ESP_HF_CALL_STATUS_NO_CALLS; // Tracks 'call' indicator
+// --- HFP Call State Tracking ---
+// Fed from the HFP callback and the call-control task, read by the web server
+static call_fsm_t call_fsm;
+static portMUX_TYPE call_fsm_lock = portMUX_INITIALIZER_UNLOCKED;
 
-// Timer handle for automatic redial
+// One-shot timer for automatic redial, re-armed from auto_redial_schedule after each attempt
 esp_timer_handle_t auto_redial_timer;
+static redial_schedule_t auto_redial_schedule;
+static redial_session_t auto_redial_session; // Attempts and time to connect, for comparing modes
+// The session was cut short by the Bluetooth link dropping; carry it on when the link is back
+static bool auto_redial_paused = false;
+// Guards the schedule, session and paused flag, and is held while arming or stopping
+// auto_redial_timer so a stale re-arm can't undo a stop. Written from the esp_timer task,
+// the BT task, the call-control task and HTTP workers. esp_timer_start_once/stop only
+// take esp_timer's own spinlock, so they are safe to call inside it; logging is not.
+static portMUX_TYPE auto_redial_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Status LED task, woken by signal_led_status()
+static TaskHandle_t led_task_handle = NULL;
 
-// Morse code LED task handle
-TaskHandle_t morse_code_task_handle = NULL;
+static EventGroupHandle_t boot_events = NULL; // BOOT_READY_* / BOOT_DONE_* bits
 
 // NVS Namespace and Keys
 #define NVS_NAMESPACE "redial_config"
 #define NVS_KEY_SSID "ssid"
 #define NVS_KEY_PASSWORD "password"
-#define NVS_KEY_AUTO_REDIAL_ENABLED "auto_en"
-#define NVS_KEY_REDIAL_PERIOD "redial_period"
-#define NVS_KEY_AUTO_REDIAL_RANDOM "redial_rand"
-#define NVS_KEY_REDIAL_MAX_COUNT "redial_max"
 
 // AP Mode Configuration
 #define AP_SSID "REMOTEHEAD"
@@ -116,23 +156,46 @@ TaskHandle_t morse_code_task_handle = NULL;
 
 // GPIO Pin for Factory Reset (D13 on many ESP32 boards)
 #define FACTORY_RESET_PIN GPIO_NUM_13
+#define FACTORY_RESET_SETTLE_MS 50
+
+// Boot stages signal these as they finish; the stages that depend on them wait
+#define BOOT_DONE_ASSETS BIT0          // Asset pack mapped, or SPIFFS mounted as the fallback
+#define BOOT_READY_SETTINGS BIT1      // Settings loaded, call-control task and redial timer exist
+#define BOOT_DONE_BT_CONTROLLER BIT2  // Controller init finished, whether or not it succeeded
+#define BOOT_READY_HFP BIT3
+#define BOOT_TASK_STACK 4096
+#define BOOT_TASK_PRIORITY 5
 
 // GPIO Pin for builtin LED (GPIO2 on most ESP32 boards)
 #define BUILTIN_LED_PIN GPIO_NUM_2
 
-// Morse code timing (milliseconds)
-#define MORSE_DOT_DURATION 200
-#define MORSE_DASH_DURATION 600
-#define MORSE_SYMBOL_PAUSE 200
-#define MORSE_CHAR_PAUSE 600
-#define MORSE_IP_READOUT_PAUSE 5000
+#define LED_TASK_STACK 2048
+#define LED_TASK_PRIORITY 1
 
-// SPIFFS Mount Point
+// SPIFFS Mount Point (the host build serves a staged directory instead)
+#ifndef WEB_MOUNT_POINT
 #define WEB_MOUNT_POINT "/spiffs"
+#endif
 
 // File serving constants
 #define FILE_PATH_MAX 1024
 #define CHUNK_SIZE 1024
+#define GZIP_SUFFIX ".gz" // Precompressed siblings generated by tools/prepare_spiffs_image.py
+
+// HTTP caching for static files
+#define STATIC_ASSET_PREFIX "/static/" // React build output with content-hashed file names
+#define CACHE_CONTROL_IMMUTABLE "public, max-age=31536000, immutable"
+#define CACHE_CONTROL_REVALIDATE "no-cache"
+#define ETAG_MAX_LEN 48
+#define ETAG_HEADER_MAX_LEN 256
+#define STATUS_ETAG_LEN 24 // "\"<boot id>-<generation>\""
+#define WIFI_CONFIG_BODY_MAX 256
+#define REDIAL_CONFIG_BODY_MAX 192
+#define BODY_RECV_TIMEOUT_RETRIES 3
+#define RESPONSE_CHUNK_SIZE 1024
+#define LOG_LEVEL_BODY_MAX 96
+#define FLEET_CAMPAIGN_BODY_MAX 512
+#define FLEET_JSON_MAX 4096
 
 // --- Forward Declarations ---
 static void esp_hf_client_cb(esp_hf_client_cb_event_t event, esp_hf_client_cb_param_t *param);
@@ -140,6 +203,8 @@ static void esp_bt_gap_cb(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *pa
 static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
 static esp_err_t redial_get_handler(httpd_req_t *req);
 static esp_err_t dial_get_handler(httpd_req_t *req);
+static esp_err_t hangup_get_handler(httpd_req_t *req);
+static esp_err_t calls_get_handler(httpd_req_t *req);
 static esp_err_t status_get_handler(httpd_req_t *req);
 static esp_err_t configure_wifi_post_handler(httpd_req_t *req);
 static esp_err_t set_auto_redial_post_handler(httpd_req_t *req);
@@ -147,21 +212,32 @@ static httpd_handle_t start_webserver(void);
 static void stop_webserver(httpd_handle_t server);
 static void start_wifi_ap(void);
 static void start_wifi_sta(const char *ssid, const char *password);
+static void connect_sta(bool use_cache);
+static void remember_sta_ap(void);
 static bool load_wifi_credentials_from_nvs(char *ssid, char *password, size_t ssid_len, size_t password_len);
 static void save_wifi_credentials_to_nvs(const char *ssid, const char *password);
-static bool load_auto_redial_settings_from_nvs(void);
-static void save_auto_redial_settings_to_nvs(bool enabled, uint32_t period, uint32_t random_delay, uint32_t max_count);
+static bool load_auto_redial_settings(void);
+static void save_auto_redial_settings(bool enabled, uint32_t period, uint32_t random_delay, uint32_t max_count,
+                                      redial_mode_t mode, uint32_t guard);
 void auto_redial_timer_callback(void* arg);
 static void update_auto_redial_timer(void);
+static void auto_redial_rearm_after_idle(void);
+static void auto_redial_call_answered(int64_t now_us);
 static void selective_factory_reset(void);
 static esp_err_t serve_static_file(httpd_req_t *req); // New static file server handler
-static void morse_code_led_task(void *pvParameters);
-static void morse_dot(void);
-static void morse_dash(void);
-static void morse_digit(char digit);
-static void morse_ip_address(const char* ip_addr);
-static void init_led_gpio(void);
-static void signal_ip_change(void);
+static esp_err_t cache_stats_get_handler(httpd_req_t *req);
+static esp_err_t metrics_get_handler(httpd_req_t *req);
+static esp_err_t logs_get_handler(httpd_req_t *req);
+static esp_err_t boot_timing_get_handler(httpd_req_t *req);
+static const char *reset_reason_name(void);
+static esp_err_t log_level_post_handler(httpd_req_t *req);
+static esp_err_t fleet_get_handler(httpd_req_t *req);
+static esp_err_t fleet_campaign_post_handler(httpd_req_t *req);
+static void fleet_dial_not_sent(uint32_t command_id);
+static void current_calls_add(const esp_hf_client_cb_param_t *param);
+static void current_calls_finished(const at_completion_t *done);
+static void start_fleet(const char *ip);
+static void signal_led_status(void);
 static void url_decode(char *str);
 static void init_ntp(void);
 static void ntp_sync_callback(struct timeval *tv);
@@ -191,40 +267,135 @@ void url_decode(char *str) {
     *p_decoded = '\0'; // Null-terminate the new, shorter string
 }
 
+// --- Call State Machine ---
+static call_state_t call_state_current(void)
+{
+    portENTER_CRITICAL(&call_fsm_lock);
+    call_state_t state = call_fsm.state;
+    portEXIT_CRITICAL(&call_fsm_lock);
+    return state;
+}
+
+// Feed an event to the call state machine and apply the side effects of the transition.
+// Every call outcome goes through here, so a failure is handled the same way whichever
+// HFP event reported it.
+static void call_state_event(call_event_t event)
+{
+    portENTER_CRITICAL(&call_fsm_lock);
+    call_state_t from = call_fsm.state;
+    bool changed = call_fsm_handle(&call_fsm, event, esp_timer_get_time());
+    call_fsm_t fsm = call_fsm;
+    portEXIT_CRITICAL(&call_fsm_lock);
+
+    if (!changed) {
+        ESP_LOGD_TS(TAG, "Call event %s ignored in state %s", call_event_name(event), call_state_name(from));
+        return;
+    }
+    ESP_LOGI_TS(TAG, "Call state %s -> %s (%s)", call_state_name(from), call_state_name(fsm.state), call_event_name(event));
+    signal_led_status();
+
+    switch (fsm.state) {
+        case CALL_STATE_ALERTING:
+            if (from == CALL_STATE_DIALING) {
+                ESP_LOGI_TS(TAG, "Remote end ringing after %lld ms", (long long)(fsm.dial_to_alert.last_us / 1000));
+            }
+            break;
+        case CALL_STATE_ACTIVE:
+            if (from == CALL_STATE_DIALING || from == CALL_STATE_ALERTING) {
+                metrics_inc(METRIC_DIAL_ANSWERS);
+                auto_redial_call_answered(fsm.entered_us);
+                fleet_node_attempt_finished(FLEET_OUTCOME_ANSWERED);
+            }
+            if (from == CALL_STATE_ALERTING) {
+                ESP_LOGI_TS(TAG, "Outgoing call answered after %lld ms of ringing", (long long)(fsm.alert_to_answer.last_us / 1000));
+            }
+            device_state_set_last_call_failed(false);
+            break;
+        case CALL_STATE_IDLE:
+            if (from == CALL_STATE_ACTIVE) {
+                ESP_LOGI_TS(TAG, "Active call has ended.");
+                device_state_set_last_call_failed(false);
+            } else if (from == CALL_STATE_DIALING || from == CALL_STATE_ALERTING) {
+                fleet_node_attempt_finished(FLEET_OUTCOME_NOT_SENT); // Phone link lost mid-setup
+            }
+            break;
+        case CALL_STATE_FAILED:
+            ESP_LOGE_TS(TAG, "CALL FAILED! The call did not connect (Busy, Invalid Number, etc.).");
+            metrics_inc(METRIC_DIAL_FAILURES);
+            device_state_set_last_call_failed(true);
+            fleet_node_attempt_finished(FLEET_OUTCOME_FAILED);
+            bool auto_redial = device_state_auto_redial_enabled();
+            if (auto_redial && redial_mode == REDIAL_MODE_BACK_TO_BACK && event != CALL_EVT_AT_ERROR) {
+                // Busy or unanswered: go again as soon as the line is idle. A rejected
+                // command would only be rejected again, so that stops redial as before.
+                auto_redial_rearm_after_idle();
+            } else if (auto_redial) {
+                device_state_set_auto_redial_enabled(false);
+                save_auto_redial_settings(false, redial_period_seconds, redial_random_delay_seconds, redial_max_count,
+                                          redial_mode, redial_guard_seconds);
+                update_auto_redial_timer();
+            }
+            break;
+        default:
+            break;
+    }
+    status_events_notify();
+}
+
 // --- HFP Client Callback ---
 static void esp_hf_client_cb(esp_hf_client_cb_event_t event, esp_hf_client_cb_param_t *param)
 {
     ESP_LOGI_TS(TAG, "HFP_CLIENT_EVT: %d", event);
+    metrics_hfp_event(event);
 
     switch (event) {
         case ESP_HF_CLIENT_CONNECTION_STATE_EVT:
             if (param->conn_stat.state == ESP_HF_CLIENT_CONNECTION_STATE_CONNECTED) {
                 ESP_LOGI_TS(TAG, "HFP Client Connected to phone!");
-                is_bluetooth_connected = true;
+                boot_timing_mark(BOOT_MILESTONE_HFP_CONNECTED, esp_timer_get_time());
+                device_state_set_bluetooth_connected(true);
+                bt_link_connected(param->conn_stat.remote_bda);
                 update_auto_redial_timer(); // Update timer state
             } else if (param->conn_stat.state == ESP_HF_CLIENT_CONNECTION_STATE_DISCONNECTED) {
+                // Also how a page that the phone did not answer ends
+                bool was_connected = device_state_bluetooth_connected();
+                bt_link_disconnected(was_connected);
+                if (!was_connected) {
+                    ESP_LOGI_TS(TAG, "HFP connect to phone failed");
+                    break;
+                }
                 ESP_LOGI_TS(TAG, "HFP Client Disconnected from phone!");
-                is_bluetooth_connected = false;
+                device_state_set_bluetooth_connected(false);
+                hf_at_link_lost(); // Nothing outstanding will be answered now
+                call_state_event(CALL_EVT_LINK_LOST);
                 update_auto_redial_timer(); // Update timer state
+            } else if (param->conn_stat.state == ESP_HF_CLIENT_CONNECTION_STATE_CONNECTING) {
+                ESP_LOGD_TS(TAG, "HFP paging phone"); // Every bt_link.c attempt starts here
+            } else if (param->conn_stat.state == ESP_HF_CLIENT_CONNECTION_STATE_SLC_CONNECTED) {
+                ESP_LOGI_TS(TAG, "HFP service level connection up");
+            } else if (param->conn_stat.state == ESP_HF_CLIENT_CONNECTION_STATE_DISCONNECTING) {
+                ESP_LOGD_TS(TAG, "HFP disconnecting from phone");
             } else {
                 ESP_LOGE_TS(TAG, "HFP Client Connection failed! State: %d", param->conn_stat.state);
             }
             break;
         case ESP_HF_CLIENT_AT_RESPONSE_EVT:
-            switch ((int)param->at_response.code) {
-                case ESP_HF_AT_RESPONSE_ERROR:
-                    ESP_LOGW_TS(TAG, "Call failed: AT response error code %d", param->at_response.cme);
-                    if (g_is_outgoing_call_in_progress) {
-                        last_call_failed = true;
-                        if (auto_redial_enabled) {
-                            auto_redial_enabled = false;
-                            save_auto_redial_settings_to_nvs(false, redial_period_seconds, redial_random_delay_seconds, redial_max_count);
-                        }
-                    }
-                    break;
-                // No default: do not change last_call_failed here
+            // code is an esp_hf_at_response_code_t. It answers the oldest outstanding
+            // command, and at_command_finished() decides what that means for the call.
+            if (!hf_at_answer(param->at_response.code, param->at_response.cme)) {
+                // Nothing was waiting for it. BUSY / NO CARRIER / NO ANSWER still report
+                // the line; a stray ERROR says nothing about any call.
+                bool line_busy = param->at_response.code == ESP_HF_AT_RESPONSE_CODE_BUSY ||
+                                 param->at_response.code == ESP_HF_AT_RESPONSE_CODE_NO_CARRIER ||
+                                 param->at_response.code == ESP_HF_AT_RESPONSE_CODE_NO_ANSWER;
+                if (line_busy) {
+                    call_state_event(CALL_EVT_LINE_BUSY);
+                }
             }
             break;
+        case ESP_HF_CLIENT_CLCC_EVT:
+            current_calls_add(param); // One line of the answer to AT+CLCC
+            break;
         case ESP_HF_CLIENT_AUDIO_STATE_EVT:
             ESP_LOGI_TS(TAG, "HFP Audio State: %d", param->audio_stat.state);
             break;
@@ -233,53 +404,27 @@ static void esp_hf_client_cb(esp_hf_client_cb_event_t event, esp_hf_client_cb_pa
             break;
         case ESP_HF_CLIENT_CIND_CALL_EVT:
             // This event corresponds to the 'call' indicator
-            g_call_status = param->call.status;
-            ESP_LOGI_TS(TAG, "Call Indicator status: %d", g_call_status);
-
-            if (g_call_status == ESP_HF_CALL_STATUS_CALL_IN_PROGRESS && g_is_outgoing_call_in_progress) {
-                // The call successfully connected!
-                ESP_LOGI_TS(TAG, "Outgoing call has been answered and is now active.");
-                g_is_outgoing_call_in_progress = false; // Reset the flag
-                last_call_failed = false;
-            } 
-            else if (g_call_status == ESP_HF_CALL_STATUS_NO_CALLS && !g_is_outgoing_call_in_progress) {
-                // This detects when a previously active call has been ended normally by the recipient or user.
-                ESP_LOGI_TS(TAG, "Active call has ended.");
-                last_call_failed = false;
-            }
+            ESP_LOGI_TS(TAG, "Call Indicator status: %d", param->call.status);
+            call_state_event(param->call.status == ESP_HF_CALL_STATUS_CALL_IN_PROGRESS ?
+                             CALL_EVT_CALL_ACTIVE : CALL_EVT_CALL_NONE);
             break;
-        case ESP_HF_CLIENT_CIND_CALL_SETUP_EVT: {
+        case ESP_HF_CLIENT_CIND_CALL_SETUP_EVT:
             // This event corresponds to the 'callsetup' indicator
-            esp_hf_call_setup_status_t call_setup_status = param->call_setup.status;
-            ESP_LOGI_TS(TAG, "Call Setup Indicator status: %d", call_setup_status);
-
-            if (call_setup_status == ESP_HF_CALL_SETUP_STATUS_OUTGOING_DIALING ||
-                call_setup_status == ESP_HF_CALL_SETUP_STATUS_OUTGOING_ALERTING)
-            {
-                // We have started an outgoing call. Set our flag.
-                g_is_outgoing_call_in_progress = true;
-                ESP_LOGI_TS(TAG, "Outgoing call process started (Dialing/Alerting)...");
-            }
-            else if (call_setup_status == ESP_HF_CALL_SETUP_STATUS_IDLE)
-            {
-                // The call setup process has ended. Now we check if it failed.
-                if (g_is_outgoing_call_in_progress) {
-                    // We were trying to make a call, but the setup process ended.
-                    // Check if the call ever became active.
-                    if (g_call_status == ESP_HF_CALL_STATUS_NO_CALLS) {
-                        // ******************************************************
-                        // ***** CALL FAILED DETECTION *****
-                        // ******************************************************
-                        ESP_LOGE_TS(TAG, "CALL FAILED! The call did not connect (Busy, Invalid Number, etc.).");
-                        last_call_failed = true;
-                        auto_redial_enabled = false;
-                    }
-                    // Reset the flag regardless of success or failure, as the setup process is over.
-                    g_is_outgoing_call_in_progress = false;
-                }
+            ESP_LOGI_TS(TAG, "Call Setup Indicator status: %d", param->call_setup.status);
+            switch (param->call_setup.status) {
+                case ESP_HF_CALL_SETUP_STATUS_OUTGOING_DIALING:
+                    call_state_event(CALL_EVT_SETUP_DIALING);
+                    break;
+                case ESP_HF_CALL_SETUP_STATUS_OUTGOING_ALERTING:
+                    call_state_event(CALL_EVT_SETUP_ALERTING);
+                    break;
+                case ESP_HF_CALL_SETUP_STATUS_IDLE:
+                    call_state_event(CALL_EVT_SETUP_IDLE);
+                    break;
+                default:
+                    break; // Incoming calls are not tracked
             }
             break;
-        }
         case ESP_HF_CLIENT_CIND_SERVICE_AVAILABILITY_EVT:
             ESP_LOGI_TS(TAG, "Call indicator status update received");
             break;
@@ -311,11 +456,11 @@ static void esp_bt_gap_cb(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *pa
         }
 #ifdef CONFIG_BT_SSP_ENABLED
         case ESP_BT_GAP_CFM_REQ_EVT:
-            ESP_LOGI_TS(TAG, "ESP_BT_GAP_CFM_REQ_EVT Please compare the numeric value: %lu", param->cfm_req.num_val);
+            ESP_LOGI_TS(TAG, "ESP_BT_GAP_CFM_REQ_EVT Please compare the numeric value: %" PRIu32, param->cfm_req.num_val);
             esp_bt_gap_ssp_confirm_reply(param->cfm_req.bda, true);
             break;
         case ESP_BT_GAP_KEY_NOTIF_EVT:
-            ESP_LOGI_TS(TAG, "ESP_BT_GAP_KEY_NOTIF_EVT passkey:%lu", param->key_notif.passkey);
+            ESP_LOGI_TS(TAG, "ESP_BT_GAP_KEY_NOTIF_EVT passkey:%" PRIu32, param->key_notif.passkey);
             break;
         case ESP_BT_GAP_KEY_REQ_EVT:
             ESP_LOGI_TS(TAG, "ESP_BT_GAP_KEY_REQ_EVT");
@@ -397,100 +542,46 @@ static void save_wifi_credentials_to_nvs(const char *ssid, const char *password)
     nvs_close(nvs_handle);
 }
 
-static bool load_auto_redial_settings_from_nvs(void) {
-    nvs_handle_t nvs_handle;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+// Load the persisted redial settings into the live globals. Settings saved before
+// back-to-back mode existed (or out of range) keep the periodic behaviour.
+static bool load_auto_redial_settings(void) {
+    settings_t settings;
+    esp_err_t err = settings_store_init(CONFIG_REMOTEHEAD_SETTINGS_FLUSH_DELAY_MS, &settings);
     if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) opening NVS handle for auto redial!", esp_err_to_name(err));
-        return false;
-    }
-
-    err = nvs_get_u32(nvs_handle, NVS_KEY_REDIAL_PERIOD, &redial_period_seconds);
-    if (err == ESP_ERR_NVS_NOT_FOUND) {
-        ESP_LOGI_TS(TAG, "Redial period not found in NVS, using default.");
-        redial_period_seconds = 60; // Default
-    } else if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) reading redial period from NVS!", esp_err_to_name(err));
-        nvs_close(nvs_handle);
-        return false;
-    }
-
-    uint8_t enabled_u8 = 0;
-    err = nvs_get_u8(nvs_handle, NVS_KEY_AUTO_REDIAL_ENABLED, &enabled_u8);
-    if (err == ESP_ERR_NVS_NOT_FOUND) {
-        ESP_LOGI_TS(TAG, "Auto redial enabled flag not found in NVS, using default (false).");
-        auto_redial_enabled = false; // Default
-    } else if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) reading auto redial enabled flag from NVS!", esp_err_to_name(err));
-        nvs_close(nvs_handle);
-        return false;
-    } else {
-        auto_redial_enabled = (enabled_u8 != 0);
-    }
-
-    // New: Load random delay
-    err = nvs_get_u32(nvs_handle, NVS_KEY_AUTO_REDIAL_RANDOM, &redial_random_delay_seconds);
-    if (err == ESP_ERR_NVS_NOT_FOUND) {
-        redial_random_delay_seconds = 0;
-    } else if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) reading redial random delay from NVS!", esp_err_to_name(err));
-        nvs_close(nvs_handle);
+        ESP_LOGE_TS(TAG, "Error (%s) starting the settings store!", esp_err_to_name(err));
         return false;
     }
 
-    // New: Load max count
-    err = nvs_get_u32(nvs_handle, NVS_KEY_REDIAL_MAX_COUNT, &redial_max_count);
-    if (err == ESP_ERR_NVS_NOT_FOUND) {
-        redial_max_count = 0; // Default: infinite
-    } else if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Error (%s) reading redial max count from NVS!", esp_err_to_name(err));
-        nvs_close(nvs_handle);
-        return false;
+    device_state_set_auto_redial_enabled(settings.auto_redial_enabled);
+    redial_period_seconds = settings.redial_period_s;
+    redial_random_delay_seconds = settings.redial_random_delay_s;
+    redial_max_count = settings.redial_max_count;
+    redial_mode = settings.redial_mode < REDIAL_MODE_COUNT ? (redial_mode_t)settings.redial_mode : REDIAL_MODE_PERIODIC;
+    redial_guard_seconds = settings.redial_guard_s;
+    if (redial_guard_seconds < REDIAL_GUARD_MIN_S || redial_guard_seconds > REDIAL_GUARD_MAX_S) {
+        redial_guard_seconds = REDIAL_GUARD_DEFAULT_S;
     }
 
-    nvs_close(nvs_handle);
-    ESP_LOGI(TAG, "Loaded auto redial settings: Enabled=%s, Period=%lu seconds, RandomDelay=%lu seconds, MaxCount=%lu",
-             auto_redial_enabled ? "true" : "false", redial_period_seconds, redial_random_delay_seconds, redial_max_count);
+    ESP_LOGI(TAG, "Loaded auto redial settings: Enabled=%s, Mode=%s, Period=%" PRIu32 " seconds, Guard=%" PRIu32 " seconds, RandomDelay=%" PRIu32 " seconds, MaxCount=%" PRIu32,
+             settings.auto_redial_enabled ? "true" : "false", redial_mode_name(redial_mode), redial_period_seconds,
+             redial_guard_seconds, redial_random_delay_seconds, redial_max_count);
     return true;
 }
 
-static void save_auto_redial_settings_to_nvs(bool enabled, uint32_t period, uint32_t random_delay, uint32_t max_count) {
-    nvs_handle_t nvs_handle;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) opening NVS handle for auto redial writing!", esp_err_to_name(err));
-        return;
-    }
-
-    err = nvs_set_u8(nvs_handle, NVS_KEY_AUTO_REDIAL_ENABLED, enabled ? 1 : 0);
-    if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) writing auto redial enabled to NVS!", esp_err_to_name(err));
-    }
-
-    err = nvs_set_u32(nvs_handle, NVS_KEY_REDIAL_PERIOD, period);
-    if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) writing redial period to NVS!", esp_err_to_name(err));
-    }
-
-    // New: Save random delay
-    err = nvs_set_u32(nvs_handle, NVS_KEY_AUTO_REDIAL_RANDOM, random_delay);
-    if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) writing redial random delay to NVS!", esp_err_to_name(err));
-    }
-
-    // New: Save max count
-    err = nvs_set_u32(nvs_handle, NVS_KEY_REDIAL_MAX_COUNT, max_count);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Error (%s) writing redial max count to NVS!", esp_err_to_name(err));
-    }
-
-    err = nvs_commit(nvs_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE_TS(TAG, "Error (%s) committing NVS auto redial changes!", esp_err_to_name(err));
-    }
-
-    nvs_close(nvs_handle);
-    ESP_LOGI(TAG, "Saved auto redial settings: Enabled=%s, Period=%lu seconds, RandomDelay=%lu seconds, MaxCount=%lu",
+// Hand the settings to the store; it writes them to flash from its own task once they
+// stop changing, so this is cheap enough for the HFP callback and every UI change
+static void save_auto_redial_settings(bool enabled, uint32_t period, uint32_t random_delay, uint32_t max_count,
+                                      redial_mode_t mode, uint32_t guard) {
+    const settings_t settings = {
+        .auto_redial_enabled = enabled,
+        .redial_period_s = period,
+        .redial_random_delay_s = random_delay,
+        .redial_max_count = max_count,
+        .redial_mode = (uint8_t)mode,
+        .redial_guard_s = guard,
+    };
+    settings_store_update(&settings);
+    ESP_LOGI(TAG, "Saved auto redial settings: Enabled=%s, Period=%" PRIu32 " seconds, RandomDelay=%" PRIu32 " seconds, MaxCount=%" PRIu32,
              enabled ? "true" : "false", period, random_delay, max_count);
 }
 
@@ -502,8 +593,9 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t e
         if (event_id == WIFI_EVENT_AP_START) {
             ESP_LOGI_TS(TAG, "Wi-Fi AP started. Connect to SSID: %s", AP_SSID);
             current_wifi_mode = WIFI_MODE_AP;
-            strcpy(current_ip_address, "192.168.4.1"); // Default AP IP
-            signal_ip_change(); // Signal morse code task about IP change
+            device_state_set_ip_address("192.168.4.1"); // Default AP IP
+            boot_timing_mark(BOOT_MILESTONE_NETWORK_UP, esp_timer_get_time());
+            signal_led_status(); // Rebuild the LED readout for the new address
             if (server == NULL) {
                 server = start_webserver();
             }
@@ -511,20 +603,41 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t e
         } else if (event_id == WIFI_EVENT_STA_START) {
             ESP_LOGI_TS(TAG, "Wi-Fi STA started. Connecting...");
             current_wifi_mode = WIFI_MODE_STA;
-            esp_wifi_connect();
+            connect_sta(true);
             update_auto_redial_timer(); // Update timer state
         } else if (event_id == WIFI_EVENT_STA_DISCONNECTED) {
             ESP_LOGW_TS(TAG, "Wi-Fi STA disconnected. Retrying connection...");
-            esp_wifi_connect(); // Attempt to reconnect
-            memset(current_ip_address, 0, sizeof(current_ip_address)); // Clear IP on disconnect
-            signal_ip_change(); // Signal morse code task about IP change
+            metrics_inc(METRIC_WIFI_DISCONNECTS);
+            if (!sta_link_up && sta_connect_cached) {
+                // Gone, moved channel or replaced: find it the slow way, then cache the new one
+                ESP_LOGW_TS(TAG, "Cached AP not reachable on channel %u, scanning all channels", sta_cached_ap.channel);
+                metrics_inc(METRIC_WIFI_CACHE_FALLBACKS);
+                sta_cache_failed = true;
+            }
+            sta_link_up = false;
+            connect_sta(!sta_cache_failed); // Attempt to reconnect
+            device_state_set_ip_address(NULL); // Clear IP on disconnect
+            signal_led_status(); // Rebuild the LED readout for the new address
             update_auto_redial_timer(); // Update timer state
         }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         ESP_LOGI_TS(TAG, "Got IP address: " IPSTR, IP2STR(&event->ip_info.ip));
-        ip4addr_ntoa_r((const ip4_addr_t*)&event->ip_info.ip, current_ip_address, sizeof(current_ip_address));
-        signal_ip_change(); // Signal morse code task about IP change
+        if (sta_connect_started_us != 0) {
+            int64_t connect_us = esp_timer_get_time() - sta_connect_started_us;
+            ESP_LOGI_TS(TAG, "Connected in %lld ms (%s)", (long long)(connect_us / 1000), sta_connect_cached ? "cached AP" : "full scan");
+            metrics_observe_wifi_connect(connect_us, sta_connect_cached);
+            sta_connect_started_us = 0;
+        }
+        sta_link_up = true;
+        sta_cache_failed = false;
+        remember_sta_ap();
+        char ip[DEVICE_STATE_IP_MAX];
+        esp_ip4addr_ntoa(&event->ip_info.ip, ip, sizeof(ip));
+        device_state_set_ip_address(ip);
+        boot_timing_mark(BOOT_MILESTONE_NETWORK_UP, esp_timer_get_time());
+        signal_led_status(); // Rebuild the LED readout for the new address
+        start_fleet(ip);
         current_wifi_mode = WIFI_MODE_STA;
         if (server == NULL) {
             server = start_webserver(); // Start web server once IP is obtained
@@ -559,6 +672,32 @@ static void start_wifi_ap(void) {
     ESP_ERROR_CHECK(esp_wifi_start());
 }
 
+#if CONFIG_REMOTEHEAD_WIFI_STATIC_IP
+// A fixed address skips DHCP altogether; the gateway doubles as the DNS server
+static void apply_static_ip(void)
+{
+    esp_netif_ip_info_t ip_info = { 0 };
+    if (esp_netif_str_to_ip4(CONFIG_REMOTEHEAD_WIFI_STATIC_IP_ADDRESS, &ip_info.ip) != ESP_OK ||
+        esp_netif_str_to_ip4(CONFIG_REMOTEHEAD_WIFI_STATIC_IP_NETMASK, &ip_info.netmask) != ESP_OK ||
+        esp_netif_str_to_ip4(CONFIG_REMOTEHEAD_WIFI_STATIC_IP_GATEWAY, &ip_info.gw) != ESP_OK) {
+        ESP_LOGE_TS(TAG, "Invalid static IP configuration, using DHCP");
+        return;
+    }
+    esp_err_t err = esp_netif_dhcpc_stop(sta_netif);
+    if (err != ESP_OK && err != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED) {
+        ESP_LOGE_TS(TAG, "Error (%s) stopping the DHCP client, using DHCP", esp_err_to_name(err));
+        return;
+    }
+    ESP_ERROR_CHECK(esp_netif_set_ip_info(sta_netif, &ip_info));
+    esp_netif_dns_info_t dns = {
+        .ip.u_addr.ip4 = ip_info.gw,
+        .ip.type = ESP_IPADDR_TYPE_V4,
+    };
+    esp_netif_set_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+    ESP_LOGI_TS(TAG, "Using static IP " IPSTR, IP2STR(&ip_info.ip));
+}
+#endif
+
 static void start_wifi_sta(const char *ssid, const char *password) {
     if (current_wifi_mode == WIFI_MODE_AP) {
         // If currently in AP mode, stop it first
@@ -581,34 +720,253 @@ static void start_wifi_sta(const char *ssid, const char *password) {
         sta_netif = esp_netif_create_default_wifi_sta(); // Create STA interface
     }
 
-    wifi_config_t wifi_config = {
+#if CONFIG_REMOTEHEAD_WIFI_STATIC_IP
+    apply_static_ip();
+#endif
+
+    sta_config = (wifi_config_t){
         .sta = {
             .threshold.authmode = WIFI_AUTH_WPA2_PSK, // Default to WPA2_PSK, adjust if needed
             .sae_pwe_h2e = WPA3_SAE_PWE_BOTH, // Optional: for WPA3
         },
     };
-    strncpy((char *)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid) - 1);
-    strncpy((char *)wifi_config.sta.password, password, sizeof(wifi_config.sta.password) - 1);
-    wifi_config.sta.ssid[sizeof(wifi_config.sta.ssid) - 1] = '\0';
-    wifi_config.sta.password[sizeof(wifi_config.sta.password) - 1] = '\0';
+    strncpy((char *)sta_config.sta.ssid, ssid, sizeof(sta_config.sta.ssid) - 1);
+    strncpy((char *)sta_config.sta.password, password, sizeof(sta_config.sta.password) - 1);
+    sta_config.sta.ssid[sizeof(sta_config.sta.ssid) - 1] = '\0';
+    sta_config.sta.password[sizeof(sta_config.sta.password) - 1] = '\0';
+
+    // New credentials miss the cache, since it is tied to the SSID it was learned for
+    sta_cache_usable = wifi_cache_load(ssid, &sta_cached_ap) == ESP_OK;
+    sta_cache_failed = false;
+    sta_link_up = false;
+    if (sta_cache_usable) {
+        ESP_LOGI_TS(TAG, "Reconnecting to the cached AP on channel %u", sta_cached_ap.channel);
+    }
 
     ESP_LOGI_TS(TAG, "Setting WiFi mode to STA");
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     
     ESP_LOGI_TS(TAG, "Setting STA configuration for SSID: %s", ssid);
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &sta_config));
     
     ESP_LOGI_TS(TAG, "Starting WiFi in STA mode");
     ESP_ERROR_CHECK(esp_wifi_start());
 }
 
+// Connect straight to the cached BSSID on its channel, or scan every channel for the
+// SSID. The driver is only reconfigured when that choice changes. Times the connect
+// from the first attempt of an outage to the address.
+static void connect_sta(bool use_cache)
+{
+    wifi_config_t next = sta_config;
+    sta_connect_cached = use_cache && sta_cache_usable;
+    next.sta.bssid_set = sta_connect_cached;
+    if (sta_connect_cached) {
+        memcpy(next.sta.bssid, sta_cached_ap.bssid, sizeof(next.sta.bssid));
+        next.sta.channel = sta_cached_ap.channel;
+    } else {
+        memset(next.sta.bssid, 0, sizeof(next.sta.bssid));
+        next.sta.channel = 0;
+    }
+    if (memcmp(&next, &sta_config, sizeof(next)) != 0) {
+        sta_config = next; // Copied from sta_config, so padding compares equal too
+        esp_err_t err = esp_wifi_set_config(WIFI_IF_STA, &sta_config);
+        if (err != ESP_OK) {
+            ESP_LOGE_TS(TAG, "Error (%s) retargeting the station", esp_err_to_name(err));
+        }
+    }
+
+    if (sta_connect_started_us == 0) {
+        sta_connect_started_us = esp_timer_get_time();
+    }
+    esp_wifi_connect();
+}
+
+// Cache the AP just connected to; a write only happens when it differs from the last one
+static void remember_sta_ap(void)
+{
+    wifi_ap_record_t ap;
+    if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK) {
+        return;
+    }
+    wifi_cache_set(&sta_cached_ap, (const char *)sta_config.sta.ssid, ap.bssid, ap.primary);
+    sta_cache_usable = true;
+    wifi_cache_store(&sta_cached_ap);
+}
+
+
+// --- Call Control ---
+static at_cmd_type_t call_cmd_at_type(call_cmd_type_t type)
+{
+    switch (type) {
+        case CALL_CMD_DIAL:
+            return AT_CMD_DIAL;
+        case CALL_CMD_MEMORY_DIAL:
+            return AT_CMD_MEMORY_DIAL;
+        case CALL_CMD_QUERY_CALLS:
+            return AT_CMD_CLCC;
+        case CALL_CMD_HANGUP:
+            return AT_CMD_HANGUP;
+        default:
+            return AT_CMD_REDIAL;
+    }
+}
+
+// Runs on the call-control task, one command at a time, so dials never race each other.
+// It only hands commands to the HFP stack; hf_at.c matches the phone's answers to them.
+static void execute_call_command(const call_cmd_t *cmd)
+{
+    at_cmd_type_t at = call_cmd_at_type(cmd->type);
+    if (!device_state_bluetooth_connected()) {
+        ESP_LOGW_TS(TAG, "Dropping call command %" PRIu32 ": Bluetooth not connected", cmd->id);
+        fleet_dial_not_sent(cmd->id);
+        return;
+    }
+
+    if (at == AT_CMD_CLCC || at == AT_CMD_HANGUP) {
+        ESP_LOGI_TS(TAG, "Sending %s command %" PRIu32, at_channel_cmd_name(at), cmd->id);
+        esp_err_t err = hf_at_send(cmd->id, at, NULL);
+        if (err != ESP_OK) {
+            ESP_LOGE_TS(TAG, "Call command %" PRIu32 " not sent: %s", cmd->id, esp_err_to_name(err));
+        }
+        return;
+    }
+
+    if (cmd->priority == CALL_CMD_PRIORITY_AUTO) {
+        if (call_state_is_busy(call_state_current())) {
+            ESP_LOGI_TS(TAG, "Skipping auto redial %" PRIu32 ": a call is already in progress", cmd->id);
+            return;
+        }
+        // Count attempts that actually reach the phone
+        uint32_t count = device_state_count_redial();
+        portENTER_CRITICAL(&auto_redial_lock);
+        redial_session_attempt(&auto_redial_session);
+        portEXIT_CRITICAL(&auto_redial_lock);
+        ESP_LOGI(TAG, "Auto Redial: Sending redial command %" PRIu32 "... (count: %" PRIu32 "/%" PRIu32 ")",
+                 cmd->id, count, redial_max_count > 0 ? redial_max_count : 999999);
+    } else {
+        ESP_LOGI_TS(TAG, "Sending %s command %" PRIu32, at_channel_cmd_name(at), cmd->id);
+    }
+
+    esp_err_t err = hf_at_send(cmd->id, at, cmd->number);
+    if (err != ESP_OK) {
+        ESP_LOGE_TS(TAG, "Call command %" PRIu32 " not sent: %s", cmd->id, esp_err_to_name(err));
+        fleet_dial_not_sent(cmd->id);
+        return;
+    }
+    metrics_inc(METRIC_DIAL_ATTEMPTS);
+    call_state_event(CALL_EVT_DIAL_SENT);
+}
+
+// Runs once for every AT command the phone answered, never answered, or had outstanding
+// when the link dropped. BUSY / NO CARRIER / NO ANSWER report the line whichever command
+// they were taken as the answer to; otherwise only a dial's own answer says anything
+// about the call.
+static void at_command_finished(const at_completion_t *done)
+{
+    if (done->result == AT_RESULT_BUSY) {
+        call_state_event(CALL_EVT_LINE_BUSY);
+    }
+    switch (done->type) {
+        case AT_CMD_DIAL:
+        case AT_CMD_REDIAL:
+        case AT_CMD_MEMORY_DIAL:
+            if (done->result == AT_RESULT_ERROR || done->result == AT_RESULT_TIMEOUT) {
+                call_state_event(CALL_EVT_AT_ERROR);
+            }
+            break; // A lost link reaches the call state machine by itself
+        case AT_CMD_CLCC:
+            current_calls_finished(done);
+            break;
+        default:
+            break; // A refused hang-up leaves the call as the indicators say it is
+    }
+}
+
+// --- Current Calls ---
+// The phone answers AT+CLCC with one +CLCC line per call, then OK. Lines collect in
+// calls_listing and become the published list when that OK arrives, so /calls never
+// shows half an answer.
+#define CURRENT_CALLS_MAX 4
+#define CURRENT_CALL_NUMBER_MAX 32
+
+typedef struct {
+    int index;
+    bool incoming;
+    int status; // esp_hf_current_call_status_t
+    char number[CURRENT_CALL_NUMBER_MAX];
+} current_call_t;
+
+static portMUX_TYPE current_calls_lock = portMUX_INITIALIZER_UNLOCKED;
+static current_call_t calls_listing[CURRENT_CALLS_MAX];
+static size_t calls_listing_count;
+static current_call_t current_calls[CURRENT_CALLS_MAX];
+static size_t current_calls_count;
+static int64_t current_calls_listed_us; // 0 until the first answer
+
+static const char *const current_call_status_names[] = {
+    "active", "held", "dialing", "alerting", "incoming", "waiting", "held_by_response_hold",
+};
+
+static void current_calls_add(const esp_hf_client_cb_param_t *param)
+{
+    current_call_t call = {
+        .index = param->clcc.idx,
+        .incoming = param->clcc.dir == ESP_HF_CURRENT_CALL_DIRECTION_INCOMING,
+        .status = param->clcc.status,
+    };
+    // Dial-string characters only, so the number can go into JSON as it is
+    size_t len = 0;
+    for (const char *c = param->clcc.number; c && *c && len < sizeof(call.number) - 1; c++) {
+        if (strchr("0123456789+*#ABCDabcdPpWw,", *c)) {
+            call.number[len++] = *c;
+        }
+    }
+    portENTER_CRITICAL(&current_calls_lock);
+    if (calls_listing_count < CURRENT_CALLS_MAX) {
+        calls_listing[calls_listing_count++] = call;
+    }
+    portEXIT_CRITICAL(&current_calls_lock);
+}
+
+static void current_calls_finished(const at_completion_t *done)
+{
+    portENTER_CRITICAL(&current_calls_lock);
+    if (done->result == AT_RESULT_OK) {
+        memcpy(current_calls, calls_listing, sizeof(current_calls));
+        current_calls_count = calls_listing_count;
+        current_calls_listed_us = esp_timer_get_time();
+    }
+    calls_listing_count = 0; // The next query's lines start afresh
+    portEXIT_CRITICAL(&current_calls_lock);
+}
+
+// Reply to a call request with its command ID, or 429 if the queue is full
+static esp_err_t send_call_command_response(httpd_req_t *req, esp_err_t err, uint32_t command_id, const char *what)
+{
+    char response[96];
+
+    if (err == ESP_ERR_NO_MEM) {
+        httpd_resp_set_status(req, "429 Too Many Requests");
+        httpd_resp_set_hdr(req, "Retry-After", "1");
+        httpd_resp_send_json(req, "{\"error\":\"Too many pending call commands, try again shortly\"}");
+        return ESP_OK;
+    }
+    if (err != ESP_OK) {
+        httpd_resp_send_json(req, "{\"error\":\"Call control unavailable\"}");
+        return ESP_FAIL;
+    }
+    snprintf(response, sizeof(response), "{\"message\":\"%s command queued\",\"command_id\":%" PRIu32 "}",
+             what, command_id);
+    return httpd_resp_send_json(req, response);
+}
 
 // --- HTTP Server Handlers ---
 
 // Handler for /redial endpoint
 static esp_err_t redial_get_handler(httpd_req_t *req)
 {
-    if (!is_bluetooth_connected) {
+    if (!device_state_bluetooth_connected()) {
         httpd_resp_send_json(req, "{\"error\":\"Bluetooth not connected to phone\"}");
         return ESP_FAIL;
     }
@@ -618,16 +976,15 @@ static esp_err_t redial_get_handler(httpd_req_t *req)
     }
 
     ESP_LOGI_TS(TAG, "HTTP: Received /redial command.");
-    esp_hf_client_dial(NULL); // Send the redial command - NULL
-
-    httpd_resp_send_json(req, "{\"message\":\"Redial command sent\"}");
-    return ESP_OK;
+    uint32_t command_id = 0;
+    esp_err_t err = call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_MANUAL, NULL, &command_id);
+    return send_call_command_response(req, err, command_id, "Redial");
 }
 
-// Handler for /dial?number=<num> endpoint
+// Handler for /dial?number=<num> and /dial?memory=<location> endpoint
 static esp_err_t dial_get_handler(httpd_req_t *req)
 {
-    if (!is_bluetooth_connected) {
+    if (!device_state_bluetooth_connected()) {
         httpd_resp_send_json(req, "{\"error\":\"Bluetooth not connected to phone\"}");
         return ESP_FAIL;
     }
@@ -650,163 +1007,574 @@ static esp_err_t dial_get_handler(httpd_req_t *req)
             if (httpd_query_key_value(buf, "number", param, sizeof(param)) == ESP_OK) {
                 url_decode(param);
                 ESP_LOGI_TS(TAG, "HTTP: Received /dial command for number: %s", param);
-                esp_hf_client_dial(param); // Send the dial command with the number
                 free(buf);
-                httpd_resp_send_json(req, "{\"message\":\"Dial command sent\"}");
-                return ESP_OK;
+                uint32_t command_id = 0;
+                esp_err_t err = call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, param, &command_id);
+                return send_call_command_response(req, err, command_id, "Dial");
+            }
+            // A location in the phone's own memory (ATD>n;), e.g. a speed-dial slot
+            if (httpd_query_key_value(buf, "memory", param, sizeof(param)) == ESP_OK &&
+                param[0] != '\0' && strlen(param) <= 5 && strspn(param, "0123456789") == strlen(param)) {
+                ESP_LOGI_TS(TAG, "HTTP: Received /dial command for memory location %s", param);
+                free(buf);
+                uint32_t command_id = 0;
+                esp_err_t err = call_control_submit(CALL_CMD_MEMORY_DIAL, CALL_CMD_PRIORITY_MANUAL, param, &command_id);
+                return send_call_command_response(req, err, command_id, "Memory dial");
             }
         }
         free(buf);
     }
 
-    httpd_resp_send_json(req, "{\"error\":\"Invalid or missing 'number' parameter\"}");
+    httpd_resp_send_json(req, "{\"error\":\"Invalid or missing 'number' or 'memory' parameter\"}");
     return ESP_FAIL;
 }
 
-// Handler for /status endpoint
-static esp_err_t status_get_handler(httpd_req_t *req)
+// Handler for /hangup endpoint: ends the current call, or stops the one being set up
+static esp_err_t hangup_get_handler(httpd_req_t *req)
 {
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddBoolToObject(root, "bluetooth_connected", is_bluetooth_connected);
+    if (!device_state_bluetooth_connected()) {
+        httpd_resp_send_json(req, "{\"error\":\"Bluetooth not connected to phone\"}");
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI_TS(TAG, "HTTP: Received /hangup command.");
+    uint32_t command_id = 0;
+    esp_err_t err = call_control_submit(CALL_CMD_HANGUP, CALL_CMD_PRIORITY_MANUAL, NULL, &command_id);
+    return send_call_command_response(req, err, command_id, "Hang-up");
+}
 
-    const char* wifi_mode_str = "Unknown";
-    if (current_wifi_mode == WIFI_MODE_AP) wifi_mode_str = "AP";
-    else if (current_wifi_mode == WIFI_MODE_STA) wifi_mode_str = "STA";
-    cJSON_AddStringToObject(root, "wifi_mode", wifi_mode_str);
+// Handler for /calls endpoint: the calls the phone listed in its last AT+CLCC answer.
+// A request queues a fresh query only when none is already pending, and otherwise reports
+// the pending one's command ID, so polling keeps the list current without piling up queries.
+static esp_err_t calls_get_handler(httpd_req_t *req)
+{
+    if (!device_state_bluetooth_connected()) {
+        httpd_resp_send_json(req, "{\"error\":\"Bluetooth not connected to phone\"}");
+        return ESP_FAIL;
+    }
+    // A poll while a query is on the air shares its answer; call_control_submit() does the
+    // same for one still queued. So polling /calls holds at most one slot in either queue.
+    uint32_t command_id = hf_at_pending_id(AT_CMD_CLCC);
+    if (command_id == 0) {
+        esp_err_t err = call_control_submit(CALL_CMD_QUERY_CALLS, CALL_CMD_PRIORITY_MANUAL, NULL, &command_id);
+        if (err != ESP_OK) {
+            return send_call_command_response(req, err, command_id, "Call list");
+        }
+    }
 
-    cJSON_AddStringToObject(root, "ip_address", strlen(current_ip_address) > 0 ? current_ip_address : "N/A");
+    current_call_t calls[CURRENT_CALLS_MAX];
+    portENTER_CRITICAL(&current_calls_lock);
+    size_t count = current_calls_count;
+    int64_t listed_us = current_calls_listed_us;
+    memcpy(calls, current_calls, sizeof(calls));
+    portEXIT_CRITICAL(&current_calls_lock);
 
-    cJSON_AddBoolToObject(root, "auto_redial_enabled", auto_redial_enabled);
-    cJSON_AddNumberToObject(root, "redial_period", redial_period_seconds);
-    cJSON_AddNumberToObject(root, "redial_random_delay", redial_random_delay_seconds); // New
-    cJSON_AddNumberToObject(root, "last_random_delay", last_random_delay_used); // New
-    cJSON_AddBoolToObject(root, "last_call_failed", last_call_failed); // New
-    cJSON_AddNumberToObject(root, "redial_max_count", redial_max_count); // New
-    cJSON_AddNumberToObject(root, "redial_current_count", redial_current_count); // New
+    char json[96 + CURRENT_CALLS_MAX * (96 + CURRENT_CALL_NUMBER_MAX)];
+    int len = snprintf(json, sizeof(json), "{\"command_id\":%" PRIu32 ",\"listed_ms_ago\":", command_id);
+    if (listed_us == 0) {
+        len += snprintf(json + len, sizeof(json) - len, "null");
+    } else {
+        len += snprintf(json + len, sizeof(json) - len, "%lld", (long long)((esp_timer_get_time() - listed_us) / 1000));
+    }
+    len += snprintf(json + len, sizeof(json) - len, ",\"calls\":[");
+    for (size_t i = 0; i < count; i++) {
+        size_t status = (size_t)calls[i].status;
+        len += snprintf(json + len, sizeof(json) - len,
+                        "%s{\"index\":%d,\"direction\":\"%s\",\"status\":\"%s\",\"number\":\"%s\"}",
+                        i > 0 ? "," : "", calls[i].index, calls[i].incoming ? "incoming" : "outgoing",
+                        status < sizeof(current_call_status_names) / sizeof(current_call_status_names[0]) ?
+                        current_call_status_names[status] : "unknown", calls[i].number);
+    }
+    snprintf(json + len, sizeof(json) - len, "]}");
+    httpd_resp_set_hdr(req, "Cache-Control", CACHE_CONTROL_REVALIDATE);
+    return httpd_resp_send_json(req, json);
+}
 
-    cJSON_AddStringToObject(root, "message", is_bluetooth_connected ? "Bluetooth connected" : "Bluetooth disconnected");
+// --- Fleet Mode ---
+// Numbers the fleet leader hands to this unit go through the call-control queue like
+// any other dial, and the call state machine reports how each one ended
+static SemaphoreHandle_t fleet_dial_mutex = NULL;
+static uint32_t fleet_command_id; // Guarded by fleet_dial_mutex: the current campaign dial
+static char fleet_interface_ip[DEVICE_STATE_IP_MAX];
 
-    const char *json_response = cJSON_PrintUnformatted(root);
-    httpd_resp_sendstr(req, json_response);
-    cJSON_Delete(root);
-    free((void*)json_response); // Free the string allocated by cJSON_PrintUnformatted
-    return ESP_OK;
+static esp_err_t fleet_dial(const char *number)
+{
+    if (!device_state_bluetooth_connected()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Held across the submit so the call-control task, which may run the command
+    // before call_control_submit() returns, sees the ID it is checking against
+    xSemaphoreTake(fleet_dial_mutex, portMAX_DELAY);
+    uint32_t command_id = 0;
+    esp_err_t err = call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, number, &command_id);
+    fleet_command_id = err == ESP_OK ? command_id : 0;
+    xSemaphoreGive(fleet_dial_mutex);
+    return err;
 }
 
-// Handler for /configure_wifi POST endpoint
-static esp_err_t configure_wifi_post_handler(httpd_req_t *req)
+// A queued campaign dial that never reached the phone goes back to the campaign
+static void fleet_dial_not_sent(uint32_t command_id)
 {
-    char content_buffer[256];
-    int ret = httpd_req_recv(req, content_buffer, sizeof(content_buffer) - 1); // -1 for null terminator
-    if (ret <= 0) {  // 0 means connection closed, < 0 means error
-        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
-            httpd_resp_send_408(req);
-        }
-        return ESP_FAIL;
+    if (!fleet_dial_mutex) {
+        return;
     }
-    content_buffer[ret] = '\0';
-
-    cJSON *root = cJSON_Parse(content_buffer);
-    if (!root) {
-        httpd_resp_send_json(req, "{\"error\":\"Invalid JSON format.\"}\n");
-        return ESP_FAIL;
+    xSemaphoreTake(fleet_dial_mutex, portMAX_DELAY);
+    bool campaign_dial = command_id == fleet_command_id;
+    xSemaphoreGive(fleet_dial_mutex);
+    if (campaign_dial) {
+        fleet_node_attempt_finished(FLEET_OUTCOME_NOT_SENT);
     }
+}
 
-    cJSON *ssid_json = cJSON_GetObjectItemCaseSensitive(root, "ssid");
-    cJSON *password_json = cJSON_GetObjectItemCaseSensitive(root, "password");
+static void fleet_local_status(bool *bluetooth_connected, bool *busy)
+{
+    *bluetooth_connected = device_state_bluetooth_connected();
+    *busy = call_state_is_busy(call_state_current());
+}
 
-    if (cJSON_IsString(ssid_json) && (ssid_json->valuestring != NULL) &&
-        cJSON_IsString(password_json) && (password_json->valuestring != NULL)) {
+// Join the fleet once the station has an address; a later address change keeps the
+// membership on the first one
+static void start_fleet(const char *ip)
+{
+#if CONFIG_REMOTEHEAD_FLEET
+    if (fleet_node_running()) {
+        return;
+    }
+    if (!fleet_dial_mutex) {
+        fleet_dial_mutex = xSemaphoreCreateMutex();
+        if (!fleet_dial_mutex) {
+            ESP_LOGE_TS(TAG, "Fleet mode not started: out of memory");
+            return;
+        }
+    }
+    strncpy(fleet_interface_ip, ip, sizeof(fleet_interface_ip) - 1);
+    const fleet_node_config_t config = {
+        .group = CONFIG_REMOTEHEAD_FLEET_GROUP,
+        .port = CONFIG_REMOTEHEAD_FLEET_PORT,
+        .interface_ip = fleet_interface_ip,
+        .http_port = http_server_port(CONFIG_REMOTEHEAD_HTTP_PORT),
+        .heartbeat_ms = CONFIG_REMOTEHEAD_FLEET_HEARTBEAT_MS,
+        .attempt_timeout_ms = CONFIG_REMOTEHEAD_FLEET_ATTEMPT_TIMEOUT_S * 1000,
+        .dial = fleet_dial,
+        .local_status = fleet_local_status,
+    };
+    esp_err_t err = fleet_node_start(&config);
+    if (err != ESP_OK) {
+        ESP_LOGE_TS(TAG, "Fleet mode not started: %s", esp_err_to_name(err));
+    }
+#else
+    (void)ip;
+#endif
+}
 
-        save_wifi_credentials_to_nvs(ssid_json->valuestring, password_json->valuestring);
+// --- Device Status Snapshot ---
+void device_status_capture(device_status_t *status)
+{
+    device_state_t state;
+    device_state_read(&state);
+    status->bluetooth_connected = state.bluetooth_connected;
+
+    status->wifi_mode = "Unknown";
+    if (current_wifi_mode == WIFI_MODE_AP) status->wifi_mode = "AP";
+    else if (current_wifi_mode == WIFI_MODE_STA) status->wifi_mode = "STA";
+
+    memcpy(status->ip_address, state.ip_address, sizeof(status->ip_address));
+
+    status->auto_redial_enabled = state.auto_redial_enabled;
+    status->redial_period = redial_period_seconds;
+    status->redial_random_delay = redial_random_delay_seconds;
+    status->last_random_delay = last_random_delay_used;
+    status->last_call_failed = state.last_call_failed;
+    status->redial_max_count = redial_max_count;
+    status->redial_current_count = state.redial_count;
+    status->redial_mode = redial_mode_name(redial_mode);
+    status->redial_guard = redial_guard_seconds;
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&auto_redial_lock);
+    status->redial_next_deadline_ms = (uint64_t)(auto_redial_schedule.next_deadline_us / 1000);
+    status->redial_drift_ms = (uint64_t)(auto_redial_schedule.drift_us / 1000);
+    status->redial_attempts_per_hour = redial_session_attempts_per_hour(&auto_redial_session, now_us);
+    status->redial_time_to_connect_ms = (uint32_t)(auto_redial_session.last_connect_us / 1000);
+    portEXIT_CRITICAL(&auto_redial_lock);
+
+    portENTER_CRITICAL(&call_fsm_lock);
+    status->call_state = call_state_name(call_fsm.state);
+    status->call_dial_to_alert_ms = (uint32_t)(call_fsm.dial_to_alert.last_us / 1000);
+    status->call_alert_to_answer_ms = (uint32_t)(call_fsm.alert_to_answer.last_us / 1000);
+    portEXIT_CRITICAL(&call_fsm_lock);
+
+    bt_link_stats_t link;
+    bt_link_get_stats(&link);
+    status->bt_reconnecting = link.reconnecting;
+    status->bt_reconnect_attempts = link.attempts;
+    status->bt_last_reconnect_ms = link.last_latency_ms;
+    status->bt_last_reconnect_attempts = link.last_attempts;
+}
 
-        // Send response first, then switch WiFi modes
-        cJSON_Delete(root);
-        httpd_resp_send_json(req, "{\"message\":\"Wi-Fi credentials received and device is attempting to connect to home network.\"}\n");
+// Handler for /status endpoint
+static esp_err_t status_get_handler(httpd_req_t *req)
+{
+    // Random per boot so ETags from before a reboot never match a fresh generation counter
+    static uint32_t status_boot_id = 0;
+    if (status_boot_id == 0) {
+        status_boot_id = esp_random() | 1;
+    }
 
-        ESP_LOGI_TS(TAG, "Switching to STA mode with SSID: %s", ssid_json->valuestring);
-        // Small delay to ensure HTTP response is sent before stopping server
-        vTaskDelay(pdMS_TO_TICKS(100));
-        
-        stop_webserver(server); // Stop server before Wi-Fi mode change
-        server = NULL; // Clear server handle
-        start_wifi_sta(ssid_json->valuestring, password_json->valuestring); // Start STA mode
+    // Both listeners serve /status, so each request sends from its own copy
+    device_status_t status;
+    device_status_rendered_t rendered;
+    char json[DEVICE_STATUS_JSON_MAX];
+    device_status_capture(&status);
+    device_status_render_cached(&status, json, sizeof(json), &rendered);
 
-        return ESP_OK;
+    char etag[STATUS_ETAG_LEN];
+    snprintf(etag, sizeof(etag), "\"%08" PRIx32 "-%" PRIu32 "\"", status_boot_id, rendered.generation);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", CACHE_CONTROL_REVALIDATE);
 
-    } else {
-        cJSON_Delete(root);
-        httpd_resp_send_json(req, "{\"error\":\"Missing or invalid 'ssid' or 'password' in JSON.\"}\n");
-        return ESP_FAIL;
+    // Pollers that already hold this generation only get the headers back
+    char if_none_match[ETAG_HEADER_MAX_LEN];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK &&
+        etag_matches(if_none_match, etag)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
     }
+
+    return httpd_resp_send(req, rendered.json, rendered.len);
 }
 
-// Handler for /set_auto_redial POST endpoint
-static esp_err_t set_auto_redial_post_handler(httpd_req_t *req)
+// Read the whole request body into buf and NUL-terminate it, looping until content_len
+// bytes have arrived however the client segmented them. Oversized bodies are refused
+// with 413 before anything is read. On failure the error response has been sent.
+static esp_err_t read_request_body(httpd_req_t *req, char *buf, size_t buf_len, size_t *out_len)
 {
-    char content_buffer[128];
-    int ret = httpd_req_recv(req, content_buffer, sizeof(content_buffer) - 1);
-    if (ret <= 0) {
-        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
-            httpd_resp_send_408(req);
-        }
+    size_t total = req->content_len;
+    if (total >= buf_len) {
+        ESP_LOGW_TS(TAG, "Request body for %s too large: %u bytes (max %u)",
+                    req->uri, (unsigned)total, (unsigned)(buf_len - 1));
+        httpd_resp_set_status(req, "413 Payload Too Large");
+        httpd_resp_send_json(req, "{\"error\":\"Request body too large.\"}\n");
         return ESP_FAIL;
     }
-    content_buffer[ret] = '\0';
-
-    cJSON *root = cJSON_Parse(content_buffer);
-    if (!root) {
+    if (total == 0) {
         httpd_resp_send_json(req, "{\"error\":\"Invalid JSON format.\"}\n");
         return ESP_FAIL;
     }
 
-    cJSON *enabled_json = cJSON_GetObjectItemCaseSensitive(root, "enabled");
-    cJSON *period_json = cJSON_GetObjectItemCaseSensitive(root, "period");
-    cJSON *random_json = cJSON_GetObjectItemCaseSensitive(root, "random_delay"); // New
-    cJSON *max_count_json = cJSON_GetObjectItemCaseSensitive(root, "max_count"); // New
-
-    if (cJSON_IsBool(enabled_json) && cJSON_IsNumber(period_json)) {
-        auto_redial_enabled = cJSON_IsTrue(enabled_json);
-        redial_period_seconds = (uint32_t)cJSON_GetNumberValue(period_json);
-        if (cJSON_IsNumber(random_json)) {
-            redial_random_delay_seconds = (uint32_t)cJSON_GetNumberValue(random_json);
+    size_t received = 0;
+    int timeouts = 0;
+    while (received < total) {
+        int ret = httpd_req_recv(req, buf + received, total - received);
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts <= BODY_RECV_TIMEOUT_RETRIES) {
+            continue; // Slow client; give it a few more receive timeouts
         }
-        if (cJSON_IsNumber(max_count_json)) {
-            redial_max_count = (uint32_t)cJSON_GetNumberValue(max_count_json);
+        if (ret <= 0) {  // 0 means connection closed, < 0 means error
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
+            }
+            return ESP_FAIL;
         }
+        received += ret;
+    }
+    buf[received] = '\0';
+    *out_len = received;
+    return ESP_OK;
+}
 
-        // Clamp period to valid range
-        if (redial_period_seconds < 10) redial_period_seconds = 10;
-        if (redial_period_seconds > 84600) redial_period_seconds = 84600;
-        if (redial_random_delay_seconds > 86400) redial_random_delay_seconds = 86400;
+// Credentials accepted by /configure_wifi, applied once its response has gone out. Workers
+// run concurrently, so only the request that claimed pending_sta_claimed writes them, and
+// the claim is held until switch_to_pending_sta() has handed them to the Wi-Fi driver.
+static portMUX_TYPE pending_sta_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool pending_sta_claimed;
+static char pending_sta_ssid[33];     // 802.11 SSIDs are at most 32 bytes
+static char pending_sta_password[65]; // WPA2 passphrases are at most 64 characters
+
+// Runs on an HTTP worker once the request is complete. Stopping the server from here
+// rather than from its own task lets httpd_stop() wait for the task to exit.
+static void switch_to_pending_sta(void)
+{
+    ESP_LOGI_TS(TAG, "Switching to STA mode with SSID: %s", pending_sta_ssid);
+    // Small delay to let the client read the response before its socket is closed
+    vTaskDelay(pdMS_TO_TICKS(100));
 
-        save_auto_redial_settings_to_nvs(auto_redial_enabled, redial_period_seconds, redial_random_delay_seconds, redial_max_count);
-        update_auto_redial_timer(); // Update timer based on new settings
+    stop_webserver(server); // Stop server before Wi-Fi mode change
+    server = NULL; // Clear server handle
+    start_wifi_sta(pending_sta_ssid, pending_sta_password); // Start STA mode
+
+    portENTER_CRITICAL(&pending_sta_lock);
+    pending_sta_claimed = false;
+    portEXIT_CRITICAL(&pending_sta_lock);
+}
+
+// /configure_wifi on an HTTP worker: the body read and the NVS commit can both block
+static esp_err_t configure_wifi_worker(httpd_req_t *req)
+{
+    char content_buffer[WIFI_CONFIG_BODY_MAX];
+    size_t content_len;
+    if (read_request_body(req, content_buffer, sizeof(content_buffer), &content_len) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    char ssid[sizeof(pending_sta_ssid)];
+    char password[sizeof(pending_sta_password)];
+    json_kv_field_t fields[] = {
+        { .key = "ssid",     .type = JSON_KV_STRING, .out = ssid,     .out_size = sizeof(ssid) },
+        { .key = "password", .type = JSON_KV_STRING, .out = password, .out_size = sizeof(password) },
+    };
+    if (json_kv_parse(content_buffer, content_len, fields, sizeof(fields) / sizeof(fields[0])) != ESP_OK) {
+        httpd_resp_send_json(req, "{\"error\":\"Invalid JSON format.\"}\n");
+        return ESP_FAIL;
+    }
+
+    if (fields[0].present && fields[1].present) {
+        portENTER_CRITICAL(&pending_sta_lock);
+        bool busy = pending_sta_claimed;
+        pending_sta_claimed = true;
+        portEXIT_CRITICAL(&pending_sta_lock);
+        if (busy) {
+            httpd_resp_set_status(req, "409 Conflict");
+            httpd_resp_send_json(req, "{\"error\":\"A Wi-Fi change is already in progress.\"}\n");
+            return ESP_FAIL;
+        }
+
+        save_wifi_credentials_to_nvs(ssid, password);
+        strcpy(pending_sta_ssid, ssid);
+        strcpy(pending_sta_password, password);
+
+        // Send response first; switch_to_pending_sta changes Wi-Fi modes after completion
+        httpd_resp_send_json(req, "{\"message\":\"Wi-Fi credentials received and device is attempting to connect to home network.\"}\n");
+        return ESP_OK;
+
+    } else {
+        httpd_resp_send_json(req, "{\"error\":\"Missing or invalid 'ssid' or 'password' in JSON.\"}\n");
+        return ESP_FAIL;
+    }
+}
+
+// Handler for /configure_wifi POST endpoint
+static esp_err_t configure_wifi_post_handler(httpd_req_t *req)
+{
+    return http_workers_defer_request(req, configure_wifi_worker, switch_to_pending_sta);
+}
+
+// /set_auto_redial on an HTTP worker. Workers run concurrently, so the settings are
+// applied under redial_settings_mutex to keep two saves from interleaving.
+static esp_err_t set_auto_redial_worker(httpd_req_t *req)
+{
+    char content_buffer[REDIAL_CONFIG_BODY_MAX];
+    size_t content_len;
+    if (read_request_body(req, content_buffer, sizeof(content_buffer), &content_len) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    bool enabled = false;
+    uint32_t period = 0, random_delay = 0, max_count = 0, guard = 0;
+    char mode_name[16] = {0};
+    json_kv_field_t fields[] = {
+        { .key = "enabled",      .type = JSON_KV_BOOL,   .out = &enabled },
+        { .key = "period",       .type = JSON_KV_UINT32, .out = &period },
+        { .key = "random_delay", .type = JSON_KV_UINT32, .out = &random_delay },
+        { .key = "max_count",    .type = JSON_KV_UINT32, .out = &max_count },
+        { .key = "mode",         .type = JSON_KV_STRING, .out = mode_name, .out_size = sizeof(mode_name) },
+        { .key = "guard",        .type = JSON_KV_UINT32, .out = &guard },
+    };
+    if (json_kv_parse(content_buffer, content_len, fields, sizeof(fields) / sizeof(fields[0])) != ESP_OK) {
+        httpd_resp_send_json(req, "{\"error\":\"Invalid JSON format.\"}\n");
+        return ESP_FAIL;
+    }
+
+    redial_mode_t mode = redial_mode;
+    if (fields[4].present && !redial_mode_from_name(mode_name, &mode)) {
+        httpd_resp_send_json(req, "{\"error\":\"'mode' must be 'periodic' or 'back_to_back'.\"}\n");
+        return ESP_FAIL;
+    }
+
+    if (fields[0].present && fields[1].present) {
+        xSemaphoreTake(redial_settings_mutex, portMAX_DELAY);
+        device_state_set_auto_redial_enabled(enabled);
+        redial_period_seconds = period;
+        if (fields[2].present) {
+            redial_random_delay_seconds = random_delay;
+        }
+        if (fields[3].present) {
+            redial_max_count = max_count;
+        }
+        redial_mode = mode;
+        if (fields[5].present) {
+            redial_guard_seconds = guard;
+        }
+
+        // Clamp period to valid range
+        if (redial_period_seconds < 10) redial_period_seconds = 10;
+        if (redial_period_seconds > 84600) redial_period_seconds = 84600;
+        if (redial_random_delay_seconds > 86400) redial_random_delay_seconds = 86400;
+        if (redial_guard_seconds < REDIAL_GUARD_MIN_S) redial_guard_seconds = REDIAL_GUARD_MIN_S;
+        if (redial_guard_seconds > REDIAL_GUARD_MAX_S) redial_guard_seconds = REDIAL_GUARD_MAX_S;
+
+        save_auto_redial_settings(enabled, redial_period_seconds, redial_random_delay_seconds, redial_max_count,
+                                  redial_mode, redial_guard_seconds);
+        update_auto_redial_timer(); // Update timer based on new settings
+        xSemaphoreGive(redial_settings_mutex);
 
-        cJSON_Delete(root);
         httpd_resp_send_json(req, "{\"message\":\"Automatic redial settings updated.\"}\n");
         return ESP_OK;
     } else {
-        cJSON_Delete(root);
         httpd_resp_send_json(req, "{\"error\":\"Missing or invalid 'enabled' or 'period' in JSON.\"}\n");
         return ESP_FAIL;
     }
 }
 
+// Handler for /set_auto_redial POST endpoint
+static esp_err_t set_auto_redial_post_handler(httpd_req_t *req)
+{
+    return http_workers_defer_request(req, set_auto_redial_worker, NULL);
+}
+
 // --- Static File Server Handler ---
+
+// Helper function to check whether a string ends with the given suffix
+static bool str_ends_with(const char *str, const char *suffix)
+{
+    size_t str_len = strlen(str);
+    size_t suffix_len = strlen(suffix);
+    return str_len >= suffix_len && strcmp(str + str_len - suffix_len, suffix) == 0;
+}
+
+// Determine content type based on file extension (of the uncompressed name)
+static const char *get_content_type(const char *filename)
+{
+    if (str_ends_with(filename, ".html")) return "text/html";
+    if (str_ends_with(filename, ".js")) return "application/javascript";
+    if (str_ends_with(filename, ".css")) return "text/css";
+    if (str_ends_with(filename, ".json")) return "application/json";
+    if (str_ends_with(filename, ".map")) return "application/json";
+    if (str_ends_with(filename, ".svg")) return "image/svg+xml";
+    if (str_ends_with(filename, ".png")) return "image/png";
+    if (str_ends_with(filename, ".ico")) return "image/x-icon";
+    if (str_ends_with(filename, ".txt")) return "text/plain";
+    return "application/octet-stream";
+}
+
+// Check the Accept-Encoding request header for gzip support
+static bool client_accepts_gzip(httpd_req_t *req)
+{
+    char accept_encoding[64] = {0};
+    esp_err_t err = httpd_req_get_hdr_value_str(req, "Accept-Encoding", accept_encoding, sizeof(accept_encoding));
+    // A truncated value still holds the leading encodings, which is where browsers list gzip
+    if (err != ESP_OK && err != ESP_ERR_HTTPD_RESULT_TRUNC) {
+        return false;
+    }
+    return accept_encoding_allows_gzip(accept_encoding);
+}
+
+// Hashed React bundles under /static/ never change in place; everything else must revalidate
+static const char *static_cache_control(const char *filename)
+{
+    return strncmp(filename, STATIC_ASSET_PREFIX, strlen(STATIC_ASSET_PREFIX)) == 0
+               ? CACHE_CONTROL_IMMUTABLE : CACHE_CONTROL_REVALIDATE;
+}
+
+// True when the client's If-None-Match already names this representation
+static bool client_has_etag(httpd_req_t *req, const char *etag)
+{
+    char if_none_match[ETAG_HEADER_MAX_LEN];
+    return httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK &&
+           etag_matches(if_none_match, etag);
+}
+
+// Serve from the memory-mapped asset pack. The MIME type, ETag and body all point into
+// the flash mapping, so nothing is copied, allocated or opened on this path.
+static esp_err_t serve_packed_file(httpd_req_t *req, const char *filename)
+{
+    asset_pack_file_t file;
+    if (!asset_pack_find(filename, client_accepts_gzip(req), &file)) {
+        ESP_LOGE_TS(TAG, "File not found: %s", filename);
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "File not found");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, file.mime);
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+    httpd_resp_set_hdr(req, "ETag", file.etag);
+    httpd_resp_set_hdr(req, "Cache-Control", static_cache_control(filename));
+    if (client_has_etag(req, file.etag)) {
+        ESP_LOGD_TS(TAG, "Not modified: %s", filename);
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+    if (file.gzip) {
+        httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    }
+    // One send with a Content-Length; httpd hands the mapping to the socket in MSS-sized writes
+    return httpd_resp_send(req, (const char *)file.data, file.len);
+}
+
 static esp_err_t serve_static_file(httpd_req_t *req)
 {
     char filepath[FILE_PATH_MAX];
     const char *filename = req->uri;
 
+    // The API is served as soon as the network is up; the files only once the assets are
+    if (!(xEventGroupGetBits(boot_events) & BOOT_DONE_ASSETS)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "1");
+        return httpd_resp_send(req, "Starting up", HTTPD_RESP_USE_STRLEN);
+    }
+
     // If URI is just "/", serve index.html
     if (strcmp(req->uri, "/") == 0) {
         filename = "/index.html";
     }
 
-    snprintf(filepath, sizeof(filepath), "%s%s", WEB_MOUNT_POINT, filename);
+    if (asset_pack_is_mounted()) {
+        return serve_packed_file(req, filename);
+    }
+
+    // The build-time manifest tells us about the .gz sibling and the content hash without touching flash
+    const asset_manifest_entry_t *asset = asset_manifest_find(filename);
 
+    // Prefer the precompressed sibling generated at build time when the client accepts gzip
+    bool gzip_encoded = false;
     struct stat file_stat;
+    if (client_accepts_gzip(req) && (asset == NULL || asset->has_gzip)) {
+        snprintf(filepath, sizeof(filepath), "%s%s%s", WEB_MOUNT_POINT, filename, GZIP_SUFFIX);
+        gzip_encoded = (asset != NULL) || (stat(filepath, &file_stat) == 0);
+    }
+
+    // Content type always follows the original name, not the .gz sibling
+    httpd_resp_set_type(req, get_content_type(filename));
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+
+    char etag[ETAG_MAX_LEN];
+    if (asset != NULL) {
+        // Each encoding is a distinct representation, so it gets its own ETag
+        snprintf(etag, sizeof(etag), "\"%s%s\"", asset->hash, gzip_encoded ? "-gz" : "");
+        httpd_resp_set_hdr(req, "ETag", etag);
+        httpd_resp_set_hdr(req, "Cache-Control", static_cache_control(filename));
+        if (client_has_etag(req, etag)) {
+            ESP_LOGD_TS(TAG, "Not modified: %s", filename);
+            httpd_resp_set_status(req, "304 Not Modified");
+            return httpd_resp_send(req, NULL, 0);
+        }
+    } else {
+        httpd_resp_set_hdr(req, "Cache-Control", CACHE_CONTROL_REVALIDATE);
+    }
+
+    if (!gzip_encoded) {
+        snprintf(filepath, sizeof(filepath), "%s%s", WEB_MOUNT_POINT, filename);
+    }
+
+    // Hot files come straight out of RAM in a single send, without touching SPIFFS
+    const static_cache_entry_t *cached = static_cache_get(filepath);
+    if (cached) {
+        if (gzip_encoded) {
+            httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+        }
+        ESP_LOGD_TS(TAG, "File served from cache: %s", filepath);
+        return httpd_resp_send(req, (const char *)cached->data, cached->len);
+    }
+
     if (stat(filepath, &file_stat) == -1) {
         ESP_LOGE_TS(TAG, "File not found: %s", filepath);
         /* Respond with 404 Error */
@@ -814,6 +1582,10 @@ static esp_err_t serve_static_file(httpd_req_t *req)
         return ESP_FAIL;
     }
 
+    if (gzip_encoded) {
+        httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    }
+
     FILE *fd = fopen(filepath, "r");
     if (!fd) {
         ESP_LOGE_TS(TAG, "Failed to read file : %s", filepath);
@@ -822,19 +1594,20 @@ static esp_err_t serve_static_file(httpd_req_t *req)
         return ESP_FAIL;
     }
 
-    // Determine content type based on file extension
-    if (strstr(filename, ".html")) {
-        httpd_resp_set_type(req, "text/html");
-    } else if (strstr(filename, ".js")) {
-        httpd_resp_set_type(req, "application/javascript");
-    } else if (strstr(filename, ".css")) {
-        httpd_resp_set_type(req, "text/css");
-    } else if (strstr(filename, ".png")) {
-        httpd_resp_set_type(req, "image/png");
-    } else if (strstr(filename, ".ico")) {
-        httpd_resp_set_type(req, "image/x-icon");
-    } else {
-        httpd_resp_set_type(req, "application/octet-stream");
+    // Small files are read whole into the cache and sent in one go
+    static_cache_entry_t *entry = static_cache_reserve(filepath, (size_t)file_stat.st_size);
+    if (entry) {
+        size_t read_total = fread(entry->data, 1, entry->len, fd);
+        fclose(fd);
+        if (read_total != entry->len) {
+            ESP_LOGE_TS(TAG, "Short read on %s (%u of %u bytes)", filepath, (unsigned)read_total, (unsigned)entry->len);
+            static_cache_discard(entry);
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to read file");
+            return ESP_FAIL;
+        }
+        static_cache_commit(entry);
+        ESP_LOGI_TS(TAG, "File served and cached: %s (%u bytes%s)", filepath, (unsigned)entry->len, gzip_encoded ? ", gzip" : "");
+        return httpd_resp_send(req, (const char *)entry->data, entry->len);
     }
 
     char *chunk = (char *)malloc(CHUNK_SIZE);
@@ -848,16 +1621,342 @@ static esp_err_t serve_static_file(httpd_req_t *req)
     size_t read_bytes;
     do {
         read_bytes = fread(chunk, 1, CHUNK_SIZE, fd);
-        httpd_resp_send_chunk(req, chunk, read_bytes);
+        if (read_bytes > 0) {
+            httpd_resp_send_chunk(req, chunk, read_bytes);
+        }
     } while (read_bytes > 0);
 
     free(chunk);
     fclose(fd);
-    ESP_LOGI_TS(TAG, "File served: %s", filepath);
+    ESP_LOGI_TS(TAG, "File served: %s (%ld bytes%s)", filepath, (long)file_stat.st_size, gzip_encoded ? ", gzip" : "");
     httpd_resp_send_chunk(req, NULL, 0); // End response
     return ESP_OK;
 }
 
+// Handler for /cache_stats endpoint
+static esp_err_t cache_stats_get_handler(httpd_req_t *req)
+{
+    static_cache_stats_t stats;
+    static_cache_get_stats(&stats);
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "hits", stats.hits);
+    cJSON_AddNumberToObject(root, "misses", stats.misses);
+    cJSON_AddNumberToObject(root, "insertions", stats.insertions);
+    cJSON_AddNumberToObject(root, "evictions", stats.evictions);
+    cJSON_AddNumberToObject(root, "entries", stats.entries);
+    cJSON_AddNumberToObject(root, "bytes_used", stats.bytes_used);
+    cJSON_AddNumberToObject(root, "capacity_bytes", stats.capacity_bytes);
+    cJSON_AddNumberToObject(root, "max_file_bytes", stats.max_entry_bytes);
+
+    const char *json_response = cJSON_PrintUnformatted(root);
+    httpd_resp_send_json(req, json_response);
+    cJSON_Delete(root);
+    free((void*)json_response); // Free the string allocated by cJSON_PrintUnformatted
+    return ESP_OK;
+}
+
+// Collects generated text and sends it in chunks of up to RESPONSE_CHUNK_SIZE bytes
+typedef struct {
+    httpd_req_t *req;
+    char buf[RESPONSE_CHUNK_SIZE];
+    size_t len;
+    esp_err_t err;
+} chunked_writer_t;
+
+static void chunked_writer_flush(chunked_writer_t *chunker)
+{
+    if (chunker->len > 0 && chunker->err == ESP_OK) {
+        chunker->err = httpd_resp_send_chunk(chunker->req, chunker->buf, chunker->len);
+    }
+    chunker->len = 0;
+}
+
+static void chunked_writer_emit(void *ctx, const char *text, size_t len)
+{
+    chunked_writer_t *chunker = ctx;
+    if (chunker->len + len > sizeof(chunker->buf)) {
+        chunked_writer_flush(chunker);
+    }
+    if (len > sizeof(chunker->buf)) {
+        len = sizeof(chunker->buf); // Lines are far shorter than a chunk; never expected
+    }
+    memcpy(chunker->buf + chunker->len, text, len);
+    chunker->len += len;
+}
+
+static chunked_writer_t *chunked_writer_new(httpd_req_t *req)
+{
+    chunked_writer_t *chunker = malloc(sizeof(*chunker)); // Too big for the httpd stack
+    if (chunker) {
+        chunker->req = req;
+        chunker->len = 0;
+        chunker->err = ESP_OK;
+    }
+    return chunker;
+}
+
+// Flush, free and terminate the chunked response
+static esp_err_t chunked_writer_finish(chunked_writer_t *chunker)
+{
+    chunked_writer_flush(chunker);
+    httpd_req_t *req = chunker->req;
+    esp_err_t err = chunker->err;
+    free(chunker);
+    if (err != ESP_OK) {
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// Handler for /boot_timing: when each bring-up phase of this boot started and finished
+static esp_err_t boot_timing_get_handler(httpd_req_t *req)
+{
+    char json[BOOT_TIMING_JSON_MAX];
+    if (boot_timing_write_json(reset_reason_name(), json, sizeof(json)) < 0) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    httpd_resp_set_hdr(req, "Cache-Control", CACHE_CONTROL_REVALIDATE);
+    return httpd_resp_send_json(req, json);
+}
+
+// Handler for /fleet endpoint: members, leader and campaign progress
+static esp_err_t fleet_get_handler(httpd_req_t *req)
+{
+    if (!fleet_node_running()) {
+        httpd_resp_set_status(req, "404 Not Found");
+        return httpd_resp_send_json(req, "{\"error\":\"Fleet mode is off\"}\n");
+    }
+    char *json = malloc(FLEET_JSON_MAX); // Too big for the httpd stack
+    if (!json) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    esp_err_t ret = ESP_FAIL;
+    if (fleet_node_write_json(json, FLEET_JSON_MAX) < 0) {
+        httpd_resp_send_500(req);
+    } else {
+        httpd_resp_set_hdr(req, "Cache-Control", CACHE_CONTROL_REVALIDATE);
+        ret = httpd_resp_send_json(req, json);
+    }
+    free(json);
+    return ret;
+}
+
+// Handler for POST /fleet/campaign: {"numbers":"<n1>,<n2>,...","attempts":<n>}.
+// Only the leader takes a campaign; followers answer 409 with the leader's URL.
+static esp_err_t fleet_campaign_post_handler(httpd_req_t *req)
+{
+    if (!fleet_node_running()) {
+        httpd_resp_set_status(req, "404 Not Found");
+        return httpd_resp_send_json(req, "{\"error\":\"Fleet mode is off\"}\n");
+    }
+    char content_buffer[FLEET_CAMPAIGN_BODY_MAX];
+    size_t content_len;
+    if (read_request_body(req, content_buffer, sizeof(content_buffer), &content_len) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    char number_list[FLEET_CAMPAIGN_BODY_MAX];
+    uint32_t attempts = 1;
+    json_kv_field_t fields[] = {
+        { .key = "numbers",  .type = JSON_KV_STRING, .out = number_list, .out_size = sizeof(number_list) },
+        { .key = "attempts", .type = JSON_KV_UINT32, .out = &attempts },
+    };
+    const char *numbers[FLEET_CAMPAIGN_MAX_NUMBERS];
+    size_t count = 0;
+    bool valid = json_kv_parse(content_buffer, content_len, fields, sizeof(fields) / sizeof(fields[0])) == ESP_OK &&
+                 fields[0].present && attempts >= 1 && attempts <= FLEET_ATTEMPTS_MAX;
+    char *save = NULL;
+    for (char *n = valid ? strtok_r(number_list, ",", &save) : NULL; n; n = strtok_r(NULL, ",", &save)) {
+        while (*n == ' ') n++;
+        if (count == FLEET_CAMPAIGN_MAX_NUMBERS) {
+            valid = false;
+            break;
+        }
+        numbers[count++] = n;
+    }
+
+    esp_err_t err = valid ? fleet_node_start_campaign(numbers, count, (uint8_t)attempts) : ESP_ERR_INVALID_ARG;
+    if (err == ESP_ERR_INVALID_STATE) {
+        char leader_ip[DEVICE_STATE_IP_MAX];
+        uint16_t leader_port = 0;
+        char body[128];
+        if (fleet_node_leader_address(leader_ip, sizeof(leader_ip), &leader_port)) {
+            snprintf(body, sizeof(body), "{\"error\":\"Not the fleet leader\",\"leader\":\"http://%s:%u/fleet/campaign\"}\n",
+                     leader_ip, (unsigned)leader_port);
+        } else {
+            snprintf(body, sizeof(body), "{\"error\":\"Not the fleet leader\"}\n");
+        }
+        httpd_resp_set_status(req, "409 Conflict");
+        httpd_resp_send_json(req, body);
+        return ESP_FAIL;
+    }
+    if (err != ESP_OK) {
+        httpd_resp_send_json(req, "{\"error\":\"Expected {\\\"numbers\\\":\\\"<n1>,<n2>,...\\\",\\\"attempts\\\":<1-255>} with up to 16 numbers of digits, +, * and #\"}\n");
+        return ESP_FAIL;
+    }
+    ESP_LOGI_TS(TAG, "HTTP: Fleet campaign of %u numbers started", (unsigned)count);
+    return httpd_resp_send_json(req, "{\"message\":\"Campaign started\"}\n");
+}
+
+// Handler for /metrics endpoint (Prometheus text exposition format)
+static esp_err_t metrics_get_handler(httpd_req_t *req)
+{
+    settings_store_stats_t settings_stats;
+    settings_store_get_stats(&settings_stats);
+    http_workers_stats_t worker_stats;
+    http_workers_get_stats(&worker_stats);
+    metrics_system_t sys = {
+        .uptime_us = esp_timer_get_time(),
+        .free_heap = esp_get_free_heap_size(),
+        .min_free_heap = esp_get_minimum_free_heap_size(),
+        .settings_updates = settings_stats.updates,
+        .settings_unchanged = settings_stats.unchanged,
+        .settings_flushes = settings_stats.flushes,
+        .settings_bytes_written = settings_stats.bytes_written,
+        .settings_flush_errors = settings_stats.flush_errors,
+        .settings_dirty = settings_stats.dirty,
+        .http_workers = worker_stats.workers,
+        .http_worker_queue_depth = worker_stats.queue_depth,
+        .http_worker_queue_high_water = worker_stats.queue_high_water,
+        .http_workers_busy = worker_stats.busy,
+        .http_worker_jobs = worker_stats.submitted,
+        .http_worker_rejected = worker_stats.rejected,
+    };
+    chunked_writer_t *chunker = chunked_writer_new(req);
+    if (!chunker) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "text/plain; version=0.0.4; charset=utf-8");
+    httpd_resp_set_hdr(req, "Cache-Control", CACHE_CONTROL_REVALIDATE);
+    metrics_render(&sys, chunked_writer_emit, chunker);
+    return chunked_writer_finish(chunker);
+}
+
+// Handler for /logs?since=<seq>: records from the log ring as text, oldest first.
+// X-Log-Next-Seq is the since value for the next poll; X-Log-Dropped counts records
+// that were overwritten before this poll could read them.
+static esp_err_t logs_get_handler(httpd_req_t *req)
+{
+    char query[32];
+    char param[12];
+    uint32_t since = 0;
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "since", param, sizeof(param)) == ESP_OK) {
+        since = (uint32_t)strtoul(param, NULL, 10);
+    }
+
+    uint32_t next = log_ring_next_seq();
+    uint32_t oldest = log_ring_oldest_seq();
+    uint32_t first = since > oldest ? since : oldest;
+    uint32_t dropped = (since > 0 && since < oldest) ? oldest - since : 0;
+
+    char next_header[12];
+    char dropped_header[12];
+    snprintf(next_header, sizeof(next_header), "%" PRIu32, next);
+    snprintf(dropped_header, sizeof(dropped_header), "%" PRIu32, dropped);
+
+    chunked_writer_t *chunker = chunked_writer_new(req);
+    log_record_t *rec = malloc(sizeof(*rec));
+    char *line = malloc(LOG_RING_LINE_MAX);
+    if (!chunker || !rec || !line) {
+        free(chunker);
+        free(rec);
+        free(line);
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "text/plain; charset=utf-8");
+    httpd_resp_set_hdr(req, "Cache-Control", CACHE_CONTROL_REVALIDATE);
+    httpd_resp_set_hdr(req, "X-Log-Next-Seq", next_header);
+    httpd_resp_set_hdr(req, "X-Log-Dropped", dropped_header);
+    for (uint32_t seq = first; seq < next && chunker->err == ESP_OK; seq++) {
+        if (log_ring_read(seq, rec)) {
+            int len = log_ring_format_line(rec, line, LOG_RING_LINE_MAX);
+            chunked_writer_emit(chunker, line, (size_t)len);
+        }
+    }
+    free(rec);
+    free(line);
+    return chunked_writer_finish(chunker);
+}
+
+// Handler for /log_level POST endpoint: {"tag":"<tag or *>","level":"none|error|warn|info|debug|verbose"}
+static esp_err_t log_level_post_handler(httpd_req_t *req)
+{
+    char content_buffer[LOG_LEVEL_BODY_MAX];
+    size_t content_len;
+    if (read_request_body(req, content_buffer, sizeof(content_buffer), &content_len) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    char tag[LOG_RING_TAG_MAX];
+    char level_name[10];
+    json_kv_field_t fields[] = {
+        { .key = "tag",   .type = JSON_KV_STRING, .out = tag,        .out_size = sizeof(tag) },
+        { .key = "level", .type = JSON_KV_STRING, .out = level_name, .out_size = sizeof(level_name) },
+    };
+    esp_log_level_t level;
+    if (json_kv_parse(content_buffer, content_len, fields, sizeof(fields) / sizeof(fields[0])) != ESP_OK ||
+        !fields[0].present || !fields[1].present || tag[0] == '\0' ||
+        !log_ring_parse_level(level_name, &level)) {
+        httpd_resp_send_json(req, "{\"error\":\"Expected {\\\"tag\\\":\\\"<tag or *>\\\",\\\"level\\\":\\\"none|error|warn|info|debug|verbose\\\"}\"}");
+        return ESP_FAIL;
+    }
+
+    if (log_ring_set_level(tag, level) != ESP_OK) {
+        httpd_resp_send_json(req, "{\"error\":\"Too many per-tag log levels\"}");
+        return ESP_FAIL;
+    }
+    esp_log_level_set(tag, level); // Keep UART output for the tag in step
+    ESP_LOGI_TS(TAG, "Log level for %s set to %s", tag, level_name);
+    httpd_resp_send_json(req, "{\"message\":\"Log level updated\"}");
+    return ESP_OK;
+}
+
+// Every URI handler is registered through this wrapper, which counts the request and
+// times the handler for /metrics before restoring the handler's own user_ctx
+typedef struct {
+    esp_err_t (*handler)(httpd_req_t *req);
+    void *user_ctx;
+    int endpoint;
+} metered_uri_t;
+
+static metered_uri_t metered_uris[METRICS_MAX_ENDPOINTS];
+
+static esp_err_t metered_handler(httpd_req_t *req)
+{
+    const metered_uri_t *metered = req->user_ctx;
+    req->user_ctx = metered->user_ctx;
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t ret = metered->handler(req);
+    metrics_observe_request(metered->endpoint, esp_timer_get_time() - start_us, ret != ESP_OK);
+    return ret;
+}
+
+static esp_err_t register_metered_uri_handler(httpd_handle_t hd, const httpd_uri_t *uri)
+{
+    int endpoint = metrics_register_endpoint(http_method_str(uri->method), uri->uri);
+    if (endpoint < 0) {
+        ESP_LOGW_TS(TAG, "No metrics slot left for %s", uri->uri);
+        return httpd_register_uri_handler(hd, uri);
+    }
+    metered_uris[endpoint] = (metered_uri_t){
+        .handler = uri->handler,
+        .user_ctx = uri->user_ctx,
+        .endpoint = endpoint,
+    };
+    httpd_uri_t wrapped = *uri;
+    wrapped.handler = metered_handler;
+    wrapped.user_ctx = &metered_uris[endpoint];
+    return httpd_register_uri_handler(hd, &wrapped);
+}
+
 
 // --- HTTP Server Configuration and Start/Stop ---
 static httpd_uri_t redial_uri = {
@@ -874,6 +1973,20 @@ static httpd_uri_t dial_uri = {
     .user_ctx  = NULL
 };
 
+static httpd_uri_t hangup_uri = {
+    .uri       = "/hangup",
+    .method    = HTTP_GET,
+    .handler   = hangup_get_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t calls_uri = {
+    .uri       = "/calls",
+    .method    = HTTP_GET,
+    .handler   = calls_get_handler,
+    .user_ctx  = NULL
+};
+
 static httpd_uri_t status_uri = {
     .uri       = "/status",
     .method    = HTTP_GET,
@@ -881,6 +1994,62 @@ static httpd_uri_t status_uri = {
     .user_ctx  = NULL
 };
 
+static httpd_uri_t cache_stats_uri = {
+    .uri       = "/cache_stats",
+    .method    = HTTP_GET,
+    .handler   = cache_stats_get_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t metrics_uri = {
+    .uri       = "/metrics",
+    .method    = HTTP_GET,
+    .handler   = metrics_get_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t logs_uri = {
+    .uri       = "/logs",
+    .method    = HTTP_GET,
+    .handler   = logs_get_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t log_level_uri = {
+    .uri       = "/log_level",
+    .method    = HTTP_POST,
+    .handler   = log_level_post_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t events_uri = {
+    .uri       = "/events",
+    .method    = HTTP_GET,
+    .handler   = status_events_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t boot_timing_uri = {
+    .uri       = "/boot_timing",
+    .method    = HTTP_GET,
+    .handler   = boot_timing_get_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t fleet_uri = {
+    .uri       = "/fleet",
+    .method    = HTTP_GET,
+    .handler   = fleet_get_handler,
+    .user_ctx  = NULL
+};
+
+static httpd_uri_t fleet_campaign_uri = {
+    .uri       = "/fleet/campaign",
+    .method    = HTTP_POST,
+    .handler   = fleet_campaign_post_handler,
+    .user_ctx  = NULL
+};
+
 static httpd_uri_t configure_wifi_uri = {
     .uri       = "/configure_wifi",
     .method    = HTTP_POST,
@@ -904,28 +2073,98 @@ static httpd_uri_t static_files_uri = {
 };
 
 
+// Called by the web server whenever a session socket is closed
+static void webserver_close_fn(httpd_handle_t hd, int sockfd)
+{
+    status_events_socket_closed(sockfd);
+    close(sockfd);
+}
+
+// Control plane: /dial, /redial, /hangup and /status on their own port, task and socket
+// quota, so a slow client pulling the web UI off the main server cannot hold up a call
+// command. The task runs above the main server's (tskIDLE_PRIORITY + 5) and below the
+// Bluetooth stack.
+#define CONTROL_SERVER_TASK_PRIORITY (tskIDLE_PRIORITY + 7)
+#define CONTROL_SERVER_STACK_SIZE 6144
+#define MAIN_SERVER_SOCKETS 7
+
+// Each server holds its sessions plus a listen, a control and a briefly accepted LRU-purge
+// socket; the fleet node adds one UDP socket. SNTP uses lwIP's raw API and takes none.
+#if defined(CONFIG_LWIP_MAX_SOCKETS) && \
+    (MAIN_SERVER_SOCKETS + 3) + (CONFIG_REMOTEHEAD_CONTROL_HTTP_SOCKETS + 3) + CONFIG_REMOTEHEAD_FLEET > CONFIG_LWIP_MAX_SOCKETS
+#error "CONFIG_LWIP_MAX_SOCKETS is too small for both HTTP servers and the fleet socket"
+#endif
+
+static httpd_handle_t start_control_server(void)
+{
+    httpd_handle_t handle = NULL;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = http_server_port(CONFIG_REMOTEHEAD_CONTROL_HTTP_PORT);
+    config.ctrl_port = http_server_port(ESP_HTTPD_DEF_CTRL_PORT + 1); // Each instance needs its own control socket
+    config.task_priority = CONTROL_SERVER_TASK_PRIORITY;
+    config.stack_size = CONTROL_SERVER_STACK_SIZE;
+    config.max_open_sockets = CONFIG_REMOTEHEAD_CONTROL_HTTP_SOCKETS;
+    config.max_uri_handlers = 4;
+    config.backlog_conn = 2;
+    config.recv_wait_timeout = 2; // Requests are one short line; don't let a stalled client hold a slot
+    config.send_wait_timeout = 2;
+    config.lru_purge_enable = true;
+
+    ESP_LOGI_TS(TAG, "Starting control server on port: '%d'", config.server_port);
+    if (httpd_start(&handle, &config) != ESP_OK) {
+        ESP_LOGE_TS(TAG, "Error starting control server!");
+        return NULL;
+    }
+    // Same handlers as on the main server; metrics are shared per endpoint
+    register_metered_uri_handler(handle, &dial_uri);
+    register_metered_uri_handler(handle, &redial_uri);
+    register_metered_uri_handler(handle, &status_uri);
+    register_metered_uri_handler(handle, &hangup_uri);
+    return handle;
+}
+
 static httpd_handle_t start_webserver(void)
 {
     httpd_handle_t server = NULL;
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = http_server_port(CONFIG_REMOTEHEAD_HTTP_PORT);
+    config.ctrl_port = http_server_port(ESP_HTTPD_DEF_CTRL_PORT);
+    config.max_open_sockets = MAIN_SERVER_SOCKETS;
     config.uri_match_fn = httpd_uri_match_wildcard;
-    config.max_uri_handlers = 6; // Increased to accommodate new handler (root is handled by static_files_uri)
+    config.max_uri_handlers = 16; // One per registered handler (root is handled by static_files_uri)
     config.stack_size = 8192; // Increase stack size for HTTP server task if needed
     config.recv_wait_timeout = 10; // Increase timeout for receiving data
     config.send_wait_timeout = 10; // Increase timeout for sending data
+    config.close_fn = webserver_close_fn; // Drop event stream subscribers when their socket closes
+    config.lru_purge_enable = true; // Long-lived event streams must not lock out new clients
 
 
     ESP_LOGI_TS(TAG, "Starting web server on port: '%d'", config.server_port);
     if (httpd_start(&server, &config) == ESP_OK) {
         ESP_LOGI_TS(TAG, "Registering URI handlers");
         // Register API handlers first so they take precedence
-        httpd_register_uri_handler(server, &redial_uri);
-        httpd_register_uri_handler(server, &dial_uri);
-        httpd_register_uri_handler(server, &status_uri);
-        httpd_register_uri_handler(server, &configure_wifi_uri);
-        httpd_register_uri_handler(server, &set_auto_redial_uri);
+        register_metered_uri_handler(server, &redial_uri);
+        register_metered_uri_handler(server, &dial_uri);
+        register_metered_uri_handler(server, &hangup_uri);
+        register_metered_uri_handler(server, &calls_uri);
+        register_metered_uri_handler(server, &status_uri);
+        register_metered_uri_handler(server, &cache_stats_uri);
+        register_metered_uri_handler(server, &metrics_uri);
+        register_metered_uri_handler(server, &logs_uri);
+        register_metered_uri_handler(server, &log_level_uri);
+        register_metered_uri_handler(server, &events_uri);
+        register_metered_uri_handler(server, &boot_timing_uri);
+        register_metered_uri_handler(server, &fleet_uri);
+        register_metered_uri_handler(server, &fleet_campaign_uri);
+        register_metered_uri_handler(server, &configure_wifi_uri);
+        register_metered_uri_handler(server, &set_auto_redial_uri);
         // Register static file handler last as a catch-all
-        httpd_register_uri_handler(server, &static_files_uri);
+        register_metered_uri_handler(server, &static_files_uri);
+        status_events_start(server);
+        if (control_server == NULL) {
+            control_server = start_control_server(); // The main server still answers if this fails
+        }
+        boot_timing_mark(BOOT_MILESTONE_WEB_SERVER, esp_timer_get_time());
         return server;
     }
 
@@ -937,174 +2176,288 @@ static void stop_webserver(httpd_handle_t server)
 {
     if (server) {
         ESP_LOGI_TS(TAG, "Stopping web server");
+        status_events_stop();
         httpd_stop(server);
     }
+    if (control_server) {
+        httpd_stop(control_server);
+        control_server = NULL;
+    }
 }
 
 // --- Auto Redial Timer Callback ---
+// Runs on the esp_timer task, so it must never block: the jitter is folded into the
+// next one-shot deadline instead of being slept off here.
 void auto_redial_timer_callback(void* arg)
 {
-    if (is_bluetooth_connected && auto_redial_enabled && current_wifi_mode == WIFI_MODE_STA) {
-        // Check if we've reached the maximum count (when max_count > 0)
-        if (redial_max_count > 0 && redial_current_count >= redial_max_count) {
-            ESP_LOGI(TAG, "Auto Redial Timer: Maximum redial count (%lu) reached, stopping auto redial", redial_max_count);
-            auto_redial_enabled = false;
-            update_auto_redial_timer(); // This will stop the timer
-            return;
-        }
-        
-        uint32_t extra = 0;
-        if (redial_random_delay_seconds > 0) {
-            extra = rand() % (redial_random_delay_seconds + 1); // 0..random_delay
-        }
-        last_random_delay_used = extra;
-        
-        // Increment the call counter before making the call
-        redial_current_count++;
-        
-        ESP_LOGI(TAG, "Auto Redial Timer: Sending redial command... (count: %lu/%lu, random extra delay: %lu)", 
-                 redial_current_count, redial_max_count > 0 ? redial_max_count : 999999, extra);
-        esp_hf_client_dial(NULL); // Use NULL for last number redial
-        if (extra > 0) {
-            vTaskDelay(pdMS_TO_TICKS(extra * 1000)); // Wait extra seconds before next period
-        }
-    } else {
+    int64_t now_us = esp_timer_get_time();
+    device_state_t state;
+    device_state_read(&state);
+    bool redial = state.bluetooth_connected && state.auto_redial_enabled && current_wifi_mode == WIFI_MODE_STA;
+
+    // Check if we've reached the maximum count (when max_count > 0)
+    if (redial && redial_max_count > 0 && state.redial_count >= redial_max_count) {
+        ESP_LOGI(TAG, "Auto Redial Timer: Maximum redial count (%" PRIu32 ") reached, stopping auto redial", redial_max_count);
+        device_state_set_auto_redial_enabled(false);
+        update_auto_redial_timer(); // This will stop the timer
+        return;
+    }
+
+    // Re-arm before queueing, but only while the schedule this deadline belongs to is still
+    // running: update_auto_redial_timer() may have stopped it, or auto_redial_rearm_after_idle()
+    // replaced the deadline, after the timer fired. In back-to-back mode this period-based
+    // deadline is only the fallback for an attempt that never reports an outcome.
+    bool armed = false;
+    int64_t late_us = 0;
+    int64_t delay_us = 0;
+    esp_err_t err = ESP_OK;
+    portENTER_CRITICAL(&auto_redial_lock);
+    if (redial && auto_redial_schedule.next_deadline_us != 0 && !esp_timer_is_active(auto_redial_timer)) {
+        late_us = now_us - auto_redial_schedule.next_deadline_us;
+        delay_us = redial_schedule_advance(&auto_redial_schedule, now_us, esp_random());
+        last_random_delay_used = auto_redial_schedule.last_jitter_s;
+        err = esp_timer_start_once(auto_redial_timer, (uint64_t)delay_us);
+        armed = true;
+    }
+    portEXIT_CRITICAL(&auto_redial_lock);
+
+    if (!redial) {
+        // Whatever turned redial off also calls update_auto_redial_timer(), which restarts it
         ESP_LOGD_TS(TAG, "Auto Redial Timer: Conditions not met for redial (BT Connected: %d, Auto Enabled: %d, WiFi Mode: %d)",
-                 is_bluetooth_connected, auto_redial_enabled, current_wifi_mode);
+                 state.bluetooth_connected, state.auto_redial_enabled, current_wifi_mode);
+        return;
     }
-}
+    if (!armed) {
+        ESP_LOGD_TS(TAG, "Auto Redial Timer: Stale deadline, the schedule was stopped or re-planned");
+        return;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW_TS(TAG, "Auto redial timer not re-armed: %s", esp_err_to_name(err));
+    }
+    ESP_LOGD_TS(TAG, "Next auto redial in %lld ms (random extra delay: %" PRIu32 " s)",
+                (long long)(delay_us / 1000), last_random_delay_used);
 
-// --- Function to update the auto redial timer state ---
-static void update_auto_redial_timer(void) {
-    if (auto_redial_enabled && is_bluetooth_connected && current_wifi_mode == WIFI_MODE_STA) {
-        if (esp_timer_is_active(auto_redial_timer)) {
-            ESP_ERROR_CHECK(esp_timer_stop(auto_redial_timer));
-            ESP_LOGI_TS(TAG, "Stopped existing auto redial timer.");
-        }
-        
-        // Reset the redial counter when starting a new redial session
-        redial_current_count = 0;
-        ESP_LOGI(TAG, "Reset redial counter to 0. Max count: %lu (0 = infinite)", redial_max_count);
-        
-        // Seed random if not already seeded
-        static bool seeded = false;
-        if (!seeded) {
-            srand((unsigned int)time(NULL));
-            seeded = true;
-        }
-        ESP_ERROR_CHECK(esp_timer_start_periodic(auto_redial_timer, redial_period_seconds * 1000 * 1000)); // Period in microseconds
-        ESP_LOGI_TS(TAG, "Started auto redial timer with period %lu seconds.", redial_period_seconds);
+    // The call-control task dials and counts the attempt; this callback only queues it
+    uint32_t command_id = 0;
+    err = call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_AUTO, NULL, &command_id);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Auto Redial Timer: Queued redial command %" PRIu32 " (fired %lld ms late)",
+                 command_id, (long long)(late_us / 1000));
     } else {
-        if (esp_timer_is_active(auto_redial_timer)) {
-            ESP_ERROR_CHECK(esp_timer_stop(auto_redial_timer));
-            ESP_LOGI_TS(TAG, "Stopped auto redial timer.");
-        } else {
-            ESP_LOGI_TS(TAG, "Auto redial timer not active or conditions not met.");
-        }
+        ESP_LOGW_TS(TAG, "Auto Redial Timer: Redial not queued: %s", esp_err_to_name(err));
     }
+    status_events_notify();
 }
 
-// --- LED Morse Code Functions ---
-static void init_led_gpio(void)
+// Back-to-back mode: the last attempt's call setup ended without an answer, so the next
+// one follows a guard gap (plus jitter) after now instead of the rest of the period
+static void auto_redial_rearm_after_idle(void)
 {
-    gpio_set_direction(BUILTIN_LED_PIN, GPIO_MODE_OUTPUT);
-    gpio_set_level(BUILTIN_LED_PIN, 0); // LED off initially
-    ESP_LOGI_TS(TAG, "LED GPIO%d initialized for morse code", BUILTIN_LED_PIN);
+    if (!device_state_bluetooth_connected() || current_wifi_mode != WIFI_MODE_STA) {
+        return; // update_auto_redial_timer() starts over once both links are back
+    }
+    int64_t delay_us = 0;
+    esp_err_t err = ESP_OK;
+    portENTER_CRITICAL(&auto_redial_lock);
+    if (auto_redial_schedule.next_deadline_us == 0) {
+        portEXIT_CRITICAL(&auto_redial_lock);
+        return; // Auto redial was stopped while the call was set up
+    }
+    if (esp_timer_is_active(auto_redial_timer)) {
+        esp_timer_stop(auto_redial_timer); // Drop the fallback deadline
+    }
+    delay_us = redial_schedule_after_idle(&auto_redial_schedule, esp_timer_get_time(),
+                                          redial_guard_seconds, esp_random());
+    last_random_delay_used = auto_redial_schedule.last_jitter_s;
+    err = esp_timer_start_once(auto_redial_timer, (uint64_t)delay_us);
+    portEXIT_CRITICAL(&auto_redial_lock);
+    if (err != ESP_OK) {
+        ESP_LOGW_TS(TAG, "Back-to-back redial not armed: %s", esp_err_to_name(err));
+        return;
+    }
+    ESP_LOGI_TS(TAG, "Line idle, next back-to-back redial in %lld ms", (long long)(delay_us / 1000));
 }
 
-static void morse_dot(void)
+// An outgoing call was answered: close the redial session's books, and stop back-to-back
+// redial since it has got through
+static void auto_redial_call_answered(int64_t now_us)
 {
-    gpio_set_level(BUILTIN_LED_PIN, 1);
-    vTaskDelay(pdMS_TO_TICKS(MORSE_DOT_DURATION));
-    gpio_set_level(BUILTIN_LED_PIN, 0);
-    vTaskDelay(pdMS_TO_TICKS(MORSE_SYMBOL_PAUSE));
+    portENTER_CRITICAL(&auto_redial_lock);
+    bool connected = redial_session_connected(&auto_redial_session, now_us);
+    redial_session_t session = auto_redial_session;
+    portEXIT_CRITICAL(&auto_redial_lock);
+    if (connected) {
+        ESP_LOGI_TS(TAG, "Auto redial (%s) connected after %lld ms and %" PRIu32 " attempts (%" PRIu32 " attempts/hour)",
+                    redial_mode_name(redial_mode), (long long)(session.last_connect_us / 1000),
+                    session.last_attempts, session.last_attempts_per_hour);
+    }
+    if (device_state_auto_redial_enabled() && redial_mode == REDIAL_MODE_BACK_TO_BACK) {
+        device_state_set_auto_redial_enabled(false);
+        save_auto_redial_settings(false, redial_period_seconds, redial_random_delay_seconds, redial_max_count,
+                                  redial_mode, redial_guard_seconds);
+        update_auto_redial_timer();
+    }
 }
 
-static void morse_dash(void)
-{
-    gpio_set_level(BUILTIN_LED_PIN, 1);
-    vTaskDelay(pdMS_TO_TICKS(MORSE_DASH_DURATION));
-    gpio_set_level(BUILTIN_LED_PIN, 0);
-    vTaskDelay(pdMS_TO_TICKS(MORSE_SYMBOL_PAUSE));
-}
+// --- Function to update the auto redial timer state ---
+static void update_auto_redial_timer(void) {
+    device_state_t state;
+    device_state_read(&state);
+    bool run = state.auto_redial_enabled && state.bluetooth_connected && current_wifi_mode == WIFI_MODE_STA;
+    int64_t now_us = esp_timer_get_time();
+    bool was_active = false;
+    bool resume = false;
+    int64_t delay_us = 0;
+    esp_err_t err = ESP_OK;
+
+    portENTER_CRITICAL(&auto_redial_lock);
+    if (esp_timer_is_active(auto_redial_timer)) {
+        err = esp_timer_stop(auto_redial_timer);
+        was_active = true;
+    }
+    if (run) {
+        resume = auto_redial_paused;
+        auto_redial_paused = false;
+        if (!resume) {
+            redial_session_start(&auto_redial_session, now_us);
+        }
+        delay_us = redial_schedule_start(&auto_redial_schedule, now_us,
+                                         redial_period_seconds, redial_random_delay_seconds, esp_random());
+        if (redial_mode == REDIAL_MODE_BACK_TO_BACK || resume) {
+            // The line is idle now, so the first attempt only waits out the guard gap; a
+            // resumed session has already waited out the drop
+            delay_us = redial_schedule_after_idle(&auto_redial_schedule, now_us, redial_guard_seconds, esp_random());
+        }
+        last_random_delay_used = auto_redial_schedule.last_jitter_s;
+        if (err == ESP_OK) {
+            err = esp_timer_start_once(auto_redial_timer, (uint64_t)delay_us);
+        }
+    } else {
+        redial_schedule_stop(&auto_redial_schedule);
+        // Only the Bluetooth link going away pauses a running session; anything else ends it
+        auto_redial_paused = state.auto_redial_enabled && !state.bluetooth_connected &&
+                             current_wifi_mode == WIFI_MODE_STA &&
+                             (auto_redial_paused || auto_redial_session.started_us != 0);
+        if (!auto_redial_paused) {
+            redial_session_stop(&auto_redial_session);
+        }
+    }
+    portEXIT_CRITICAL(&auto_redial_lock);
+    ESP_ERROR_CHECK(err);
 
-static void morse_digit(char digit)
-{
-    switch (digit) {
-        case '0': // -----
-            morse_dash(); morse_dash(); morse_dash(); morse_dash(); morse_dash();
-            break;
-        case '1': // .----
-            morse_dot(); morse_dash(); morse_dash(); morse_dash(); morse_dash();
-            break;
-        case '2': // ..---
-            morse_dot(); morse_dot(); morse_dash(); morse_dash(); morse_dash();
-            break;
-        case '3': // ...--
-            morse_dot(); morse_dot(); morse_dot(); morse_dash(); morse_dash();
-            break;
-        case '4': // ....-
-            morse_dot(); morse_dot(); morse_dot(); morse_dot(); morse_dash();
-            break;
-        case '5': // .....
-            morse_dot(); morse_dot(); morse_dot(); morse_dot(); morse_dot();
-            break;
-        case '6': // -....
-            morse_dash(); morse_dot(); morse_dot(); morse_dot(); morse_dot();
-            break;
-        case '7': // --...
-            morse_dash(); morse_dash(); morse_dot(); morse_dot(); morse_dot();
-            break;
-        case '8': // ---..
-            morse_dash(); morse_dash(); morse_dash(); morse_dot(); morse_dot();
-            break;
-        case '9': // ----.
-            morse_dash(); morse_dash(); morse_dash(); morse_dash(); morse_dot();
-            break;
-        case '.': // .-.-.-
-            morse_dot(); morse_dash(); morse_dot(); morse_dash(); morse_dot(); morse_dash();
-            break;
-        default:
-            // Unknown character, skip
-            break;
+    if (was_active) {
+        ESP_LOGI_TS(TAG, "Stopped existing auto redial timer.");
+    }
+    if (run) {
+        if (resume) {
+            // Same session as before the drop: keep its count, max count and time to connect
+            ESP_LOGI_TS(TAG, "Bluetooth back, resuming auto redial after %" PRIu32 " attempts", state.redial_count);
+        } else {
+            // Reset the redial counter when starting a new redial session
+            device_state_reset_redial_count();
+            ESP_LOGI(TAG, "Reset redial counter to 0. Max count: %" PRIu32 " (0 = infinite)", redial_max_count);
+        }
+        ESP_LOGI_TS(TAG, "Started %s auto redial with period %" PRIu32 " seconds (first attempt in %lld ms).",
+                    redial_mode_name(redial_mode), redial_period_seconds, (long long)(delay_us / 1000));
+    } else {
+        ESP_LOGI_TS(TAG, "Auto redial timer not active or conditions not met.");
     }
-    vTaskDelay(pdMS_TO_TICKS(MORSE_CHAR_PAUSE));
+    status_events_notify(); // Redial, Bluetooth and Wi-Fi state all funnel through here
+    signal_led_status();
 }
 
-static void morse_ip_address(const char* ip_addr)
+// --- Status LED ---
+// The LED task sleeps until something the LED shows changes, compiles the new pattern
+// once and hands it to led_timer, whose callback drives the pin one step at a time.
+// Nothing runs while the pattern is empty.
+static portMUX_TYPE led_lock = portMUX_INITIALIZER_UNLOCKED;
+static led_pattern_t led_next_pattern;          // Guarded by led_lock
+static bool led_next_ready = false;             // Guarded by led_lock
+static led_pattern_t led_playing;               // Owned by led_timer_callback
+static size_t led_step;
+static esp_timer_handle_t led_timer;
+
+static void led_timer_callback(void *arg)
 {
-    if (ip_addr == NULL || strlen(ip_addr) == 0) {
-        ESP_LOGW_TS(TAG, "No IP address to signal in morse code");
-        return;
+    portENTER_CRITICAL(&led_lock);
+    if (led_next_ready) {
+        led_playing = led_next_pattern;
+        led_next_ready = false;
+        led_step = 0;
     }
-    
-    ESP_LOGI_TS(TAG, "Signaling IP address in morse code: %s", ip_addr);
-    
-    for (int i = 0; ip_addr[i] != '\0'; i++) {
-        morse_digit(ip_addr[i]);
+    portEXIT_CRITICAL(&led_lock);
+
+    if (led_playing.count == 0) {
+        gpio_set_level(BUILTIN_LED_PIN, 0);
+        return;
     }
+    gpio_set_level(BUILTIN_LED_PIN, led_step % 2 == 0); // Even steps are on
+    uint64_t step_us = (uint64_t)led_playing.steps_ms[led_step] * 1000;
+    led_step = (led_step + 1) % led_playing.count;
+    esp_timer_start_once(led_timer, step_us);
 }
 
-static void morse_code_led_task(void *pvParameters)
+static void led_status_task(void *pvParameters)
 {
-    ESP_LOGI_TS(TAG, "Morse code LED task started on core %d", xPortGetCoreID());
-    
-    while (1) {
-        // Wait for IP address to be available
-        if (strlen(current_ip_address) > 0) {
-            morse_ip_address(current_ip_address);
-        } else {
-            ESP_LOGD_TS(TAG, "No IP address available for morse code");
+    static led_pattern_t pattern; // Only this task builds patterns; keeps it off the stack
+    device_state_t state;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        device_state_read(&state);
+        call_state_t call = call_state_current();
+        led_status_t status = {
+            .ip = state.ip_address,
+            .bluetooth_connected = state.bluetooth_connected,
+            .call = call_state_is_busy(call) ? LED_CALL_ACTIVE
+                  : call == CALL_STATE_FAILED ? LED_CALL_FAILED : LED_CALL_NONE,
+        };
+        led_pattern_build(&status, &pattern);
+
+        portENTER_CRITICAL(&led_lock);
+        led_next_pattern = pattern;
+        led_next_ready = true;
+        portEXIT_CRITICAL(&led_lock);
+        // Switch now rather than at the end of the current step, which can be seconds away
+        esp_timer_stop(led_timer);
+        if (esp_timer_start_once(led_timer, 0) != ESP_OK) {
+            esp_timer_restart(led_timer, 0); // The callback re-armed it in between
         }
-        
-        // 5 second pause between readouts
-        vTaskDelay(pdMS_TO_TICKS(MORSE_IP_READOUT_PAUSE));
+        ESP_LOGI_TS(TAG, "LED pattern for ip=%s bt=%d call=%s: %u steps, %lu ms",
+                    state.ip_address[0] ? state.ip_address : "-",
+                    status.bluetooth_connected, call_state_name(call), (unsigned)pattern.count,
+                    (unsigned long)led_pattern_period_ms(&pattern));
+    }
+}
+
+// Wake the LED task to rebuild its pattern. Cheap enough to call on every state change.
+static void signal_led_status(void)
+{
+    if (led_task_handle) {
+        xTaskNotifyGive(led_task_handle);
     }
 }
 
-static void signal_ip_change(void)
+static esp_err_t init_led_status(void)
 {
-    ESP_LOGI_TS(TAG, "IP address change signaled for morse code update");
+    gpio_set_direction(BUILTIN_LED_PIN, GPIO_MODE_OUTPUT);
+    gpio_set_level(BUILTIN_LED_PIN, 0); // LED off initially
+
+    const esp_timer_create_args_t led_timer_args = {
+        .callback = &led_timer_callback,
+        .name = "led_pattern",
+    };
+    esp_err_t err = esp_timer_create(&led_timer_args, &led_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (xTaskCreate(led_status_task, "led_status", LED_TASK_STACK, NULL, LED_TASK_PRIORITY, &led_task_handle) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI_TS(TAG, "Status LED on GPIO%d", BUILTIN_LED_PIN);
+    signal_led_status(); // Pick up anything signalled before the task existed
+    return ESP_OK;
 }
 
 // --- SPIFFS Initialization ---
@@ -1137,8 +2490,14 @@ static esp_err_t init_spiffs(void)
     if (ret != ESP_OK) {
         ESP_LOGE_TS(TAG, "Failed to get SPIFFS partition information (%s)", esp_err_to_name(ret));
     } else {
-        ESP_LOGI_TS(TAG, "Partition size: total: %d, used: %d", total, used);
+        ESP_LOGI_TS(TAG, "Partition size: total: %u, used: %u", (unsigned)total, (unsigned)used);
     }
+
+    // Load content hashes for ETags; a missing manifest only disables conditional requests
+    asset_manifest_load(WEB_MOUNT_POINT ASSET_MANIFEST_FILENAME);
+
+    // RAM cache in front of SPIFFS for index.html and the other small hot files
+    static_cache_init(CONFIG_REMOTEHEAD_STATIC_CACHE_SIZE, CONFIG_REMOTEHEAD_STATIC_CACHE_MAX_FILE_SIZE);
     return ret;
 }
 
@@ -1194,6 +2553,11 @@ static void selective_factory_reset(void)
         // bt_config namespace might not exist if no devices have been paired
         ESP_LOGI_TS(TAG, "bt_config namespace not found or inaccessible - no Bluetooth pairing data to erase");
     }
+    // Without the pairing there is no phone to reconnect to
+    err = bt_reconnect_forget_peer();
+    if (err != ESP_OK) {
+        ESP_LOGE_TS(TAG, "Failed to erase the last phone's address: %s", esp_err_to_name(err));
+    }
     
     ESP_LOGI_TS(TAG, "Selective factory reset completed - WiFi and Bluetooth pairing data cleared");
 }
@@ -1201,6 +2565,8 @@ static void selective_factory_reset(void)
 // --- NTP Time Synchronization Functions ---
 static void ntp_sync_callback(struct timeval *tv)
 {
+    // Let the log ring turn its boot-time stamps into wall-clock time when read
+    log_ring_set_wall_offset((int64_t)tv->tv_sec * 1000000 + tv->tv_usec - esp_timer_get_time());
     ESP_LOGI_TS(TAG, "NTP time synchronized: %ld seconds since epoch", (long)tv->tv_sec);
     
     // Get current time to log for verification
@@ -1231,91 +2597,77 @@ static void init_ntp(void)
 }
 
 // --- Main Application Entry Point ---
-void app_main(void)
+// --- Boot Bring-up ---
+// app_main only sequences what has to happen in order. The web assets and the
+// Bluetooth stack each run on their own boot task, and the stages that depend on
+// them wait for these bits instead of the whole boot running back to back.
+static const char *reset_reason_name(void)
 {
-    esp_err_t ret;
-
-    // --- Factory Reset Pin Check ---
-    gpio_set_direction(FACTORY_RESET_PIN, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(FACTORY_RESET_PIN, GPIO_PULLUP_ONLY);
-    vTaskDelay(pdMS_TO_TICKS(50)); // Allow pin to settle
-
-    if (gpio_get_level(FACTORY_RESET_PIN) == 0) { // Pin pulled low
-        ESP_LOGW_TS(TAG, "FACTORY RESET PIN (GPIO%d) DETECTED LOW! Performing selective factory reset...", FACTORY_RESET_PIN);
-        
-        // Perform selective factory reset - only erase WiFi and Bluetooth pairing data
-        // Do NOT erase SPIFFS (preserves React web app) or other NVS settings
-        selective_factory_reset();
-    } else {
-        ESP_LOGI_TS(TAG, "FACTORY RESET PIN (GPIO%d) is HIGH. Proceeding with normal boot.", FACTORY_RESET_PIN);
+#if CONFIG_IDF_TARGET_LINUX
+    return "poweron"; // The host build has no reset cause
+#else
+    switch (esp_reset_reason()) {
+        case ESP_RST_POWERON:   return "poweron";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:       return "watchdog";
+        case ESP_RST_DEEPSLEEP: return "deepsleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        default:                return "unknown";
     }
+#endif
+}
 
-    // Initialize NVS
-    ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase()); // Full erase only if NVS version is incompatible
-        ret = nvs_flash_init();
+// Map the asset pack; flash without an assets partition (older partition tables, the
+// host build) still has the web UI on SPIFFS
+static void boot_assets_task(void *pvParameters)
+{
+    boot_timing_start(BOOT_PHASE_ASSETS, esp_timer_get_time());
+    esp_err_t err = asset_pack_mount();
+    if (err != ESP_OK) {
+        ESP_LOGW_TS(TAG, "No asset pack (%s), serving the web UI from SPIFFS", esp_err_to_name(err));
+        err = init_spiffs();
     }
-    ESP_ERROR_CHECK(ret);
-
-    // Initialize SPIFFS
-    ESP_ERROR_CHECK(init_spiffs());
-
-    // Initialize TCP/IP stack and event loop
-    ESP_ERROR_CHECK(esp_netif_init());
-    ESP_ERROR_CHECK(esp_event_loop_create_default());
-
-    // Register Wi-Fi event handler
-    esp_event_handler_instance_t instance_any_id;
-    esp_event_handler_instance_t instance_got_ip;
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
-                                                        ESP_EVENT_ANY_ID,
-                                                        &wifi_event_handler,
-                                                        NULL,
-                                                        &instance_any_id));
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT,
-                                                        IP_EVENT_STA_GOT_IP,
-                                                        &wifi_event_handler,
-                                                        NULL,
-                                                        &instance_got_ip));
-
-    // Initialize Wi-Fi
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    boot_timing_end(BOOT_PHASE_ASSETS, esp_timer_get_time(), err);
+    // Set even on failure so static requests get a 404 rather than waiting forever
+    xEventGroupSetBits(boot_events, BOOT_DONE_ASSETS);
+    vTaskDelete(NULL);
+}
 
-    // Try to load Wi-Fi credentials from NVS
-    char stored_ssid[32];
-    char stored_password[64];
-    if (load_wifi_credentials_from_nvs(stored_ssid, stored_password, sizeof(stored_ssid), sizeof(stored_password))) {
-        ESP_LOGI_TS(TAG, "Found stored Wi-Fi credentials. Starting in STA mode.");
-        start_wifi_sta(stored_ssid, stored_password);
-    } else {
-        ESP_LOGI_TS(TAG, "No stored Wi-Fi credentials. Starting in AP mode for configuration.");
-        start_wifi_ap();
+static esp_err_t init_bt_controller(void)
+{
+    esp_err_t ret = esp_bt_controller_mem_release(ESP_BT_MODE_BLE); // Release BLE memory if not used
+    if (ret) {
+        ESP_LOGE_TS(TAG, "%s release BLE memory failed: %s", __func__, esp_err_to_name(ret));
+        return ret;
     }
-
-    // Initialize Bluetooth controller and host
-    ESP_ERROR_CHECK(esp_bt_controller_mem_release(ESP_BT_MODE_BLE)); // Release BLE memory if not used
     esp_bt_controller_config_t bt_cfg = BT_CONTROLLER_INIT_CONFIG_DEFAULT();
     ret = esp_bt_controller_init(&bt_cfg);
     if (ret) {
         ESP_LOGE_TS(TAG, "%s initialize controller failed: %s", __func__, esp_err_to_name(ret));
-        return;
+        return ret;
     }
     ret = esp_bt_controller_enable(ESP_BT_MODE_CLASSIC_BT); // Enable Classic Bluetooth
     if (ret) {
         ESP_LOGE_TS(TAG, "%s enable controller failed: %s", __func__, esp_err_to_name(ret));
-        return;
     }
-    ret = esp_bluedroid_init();
+    return ret;
+}
+
+static esp_err_t init_bluedroid(void)
+{
+    esp_err_t ret = esp_bluedroid_init();
     if (ret) {
         ESP_LOGE_TS(TAG, "%s initialize bluedroid failed: %s", __func__, esp_err_to_name(ret));
-        return;
+        return ret;
     }
     ret = esp_bluedroid_enable();
     if (ret) {
         ESP_LOGE_TS(TAG, "%s enable bluedroid failed: %s", __func__, esp_err_to_name(ret));
-        return;
+        return ret;
     }
 
     // Register GAP callback
@@ -1357,45 +2709,213 @@ void app_main(void)
     // Set Bluetooth device name
     const char *device_name = "RemoteHead";
     esp_bt_gap_set_device_name(device_name);
+    return ESP_OK;
+}
 
-    // Initialize HFP client
-    ret = esp_hf_client_init();
+static esp_err_t init_hfp_client(void)
+{
+    esp_err_t ret = esp_hf_client_init();
     if (ret) {
         ESP_LOGE_TS(TAG, "%s initialize HFP client failed: %s", __func__, esp_err_to_name(ret));
-        return;
+        return ret;
     }
     ret = esp_hf_client_register_callback(esp_hf_client_cb);
     if (ret) {
         ESP_LOGE_TS(TAG, "%s register HFP client callback failed: %s", __func__, esp_err_to_name(ret));
-        return;
+    }
+    return ret;
+}
+
+// Controller -> Bluedroid -> HFP. A failure leaves Bluetooth down but the web UI running.
+static void boot_bluetooth_task(void *pvParameters)
+{
+    boot_timing_start(BOOT_PHASE_BT_CONTROLLER, esp_timer_get_time());
+    esp_err_t err = init_bt_controller();
+    boot_timing_end(BOOT_PHASE_BT_CONTROLLER, esp_timer_get_time(), err);
+    // Set even on failure: Wi-Fi only waits so the two radios are not initialized together
+    xEventGroupSetBits(boot_events, BOOT_DONE_BT_CONTROLLER);
+
+    if (err == ESP_OK) {
+        boot_timing_start(BOOT_PHASE_BLUEDROID, esp_timer_get_time());
+        err = init_bluedroid();
+        boot_timing_end(BOOT_PHASE_BLUEDROID, esp_timer_get_time(), err);
+    }
+    if (err == ESP_OK) {
+        // The HFP callback drives the redial timer and the call-control queue
+        xEventGroupWaitBits(boot_events, BOOT_READY_SETTINGS, pdFALSE, pdTRUE, portMAX_DELAY);
+        boot_timing_start(BOOT_PHASE_HFP, esp_timer_get_time());
+        err = init_hfp_client();
+        boot_timing_end(BOOT_PHASE_HFP, esp_timer_get_time(), err);
+    }
+    if (err == ESP_OK) {
+        xEventGroupSetBits(boot_events, BOOT_READY_HFP);
+#if CONFIG_REMOTEHEAD_BT_RECONNECT
+        const bt_link_config_t link_config = {
+            .base_ms = CONFIG_REMOTEHEAD_BT_RECONNECT_BASE_MS,
+            .max_ms = CONFIG_REMOTEHEAD_BT_RECONNECT_MAX_MS,
+            .changed = status_events_notify,
+        };
+        esp_err_t link_err = bt_link_start(&link_config);
+        if (link_err != ESP_OK) {
+            // The phone can still connect to us; we just never page it
+            ESP_LOGW_TS(TAG, "Bluetooth reconnect unavailable: %s", esp_err_to_name(link_err));
+        }
+#endif
+    }
+    vTaskDelete(NULL);
+}
+
+static esp_err_t init_settings_and_call_control(void)
+{
+    // Load auto redial settings from NVS; the defaults stand if that fails
+    load_auto_redial_settings();
+
+    // Start the call-control task before anything can submit dial commands, and the AT
+    // channel it sends them through before that
+    esp_err_t err = hf_at_init(at_command_finished);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = call_control_init(CONFIG_REMOTEHEAD_CALL_QUEUE_LEN, execute_call_command);
+    if (err != ESP_OK) {
+        return err;
     }
 
-    // Load auto redial settings from NVS
-    load_auto_redial_settings_from_nvs();
+    // Handlers defer slow work to the pool, so it has to exist before the web server does
+    redial_settings_mutex = xSemaphoreCreateMutex();
+    if (redial_settings_mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    err = http_workers_init(CONFIG_REMOTEHEAD_HTTP_WORKERS, CONFIG_REMOTEHEAD_HTTP_WORKER_QUEUE_LEN);
+    if (err != ESP_OK) {
+        return err;
+    }
 
     // Create the auto redial timer (but don't start it yet, update_auto_redial_timer will handle it)
     const esp_timer_create_args_t auto_redial_timer_args = {
             .callback = &auto_redial_timer_callback,
             .name = "auto_redial_timer"
     };
-    ESP_ERROR_CHECK(esp_timer_create(&auto_redial_timer_args, &auto_redial_timer));
+    err = esp_timer_create(&auto_redial_timer_args, &auto_redial_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
 
     // Initial update of the timer state based on loaded settings and current connection status
     update_auto_redial_timer();
+    return ESP_OK;
+}
+
+static void init_wifi(void)
+{
+    // Initialize TCP/IP stack and event loop
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
 
-    // Initialize LED GPIO for morse code
-    init_led_gpio();
+    // Register Wi-Fi event handler
+    esp_event_handler_instance_t instance_any_id;
+    esp_event_handler_instance_t instance_got_ip;
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
+                                                        ESP_EVENT_ANY_ID,
+                                                        &wifi_event_handler,
+                                                        NULL,
+                                                        &instance_any_id));
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT,
+                                                        IP_EVENT_STA_GOT_IP,
+                                                        &wifi_event_handler,
+                                                        NULL,
+                                                        &instance_got_ip));
+
+    // Initialize Wi-Fi once the Bluetooth controller is up, not alongside it
+    xEventGroupWaitBits(boot_events, BOOT_DONE_BT_CONTROLLER, pdFALSE, pdTRUE, portMAX_DELAY);
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    // Credentials and the cached AP have their own NVS keys; keeping the driver's copy in
+    // RAM stops every switch between cached and scanning connects from writing flash
+    ESP_ERROR_CHECK(esp_wifi_set_storage(WIFI_STORAGE_RAM));
+
+    // Try to load Wi-Fi credentials from NVS
+    char stored_ssid[32];
+    char stored_password[64];
+    if (load_wifi_credentials_from_nvs(stored_ssid, stored_password, sizeof(stored_ssid), sizeof(stored_password))) {
+        ESP_LOGI_TS(TAG, "Found stored Wi-Fi credentials. Starting in STA mode.");
+        start_wifi_sta(stored_ssid, stored_password);
+    } else {
+        ESP_LOGI_TS(TAG, "No stored Wi-Fi credentials. Starting in AP mode for configuration.");
+        start_wifi_ap();
+    }
+}
+
+void app_main(void)
+{
+    // Capture logs from here on; everything before is only on UART
+    if (log_ring_init(CONFIG_REMOTEHEAD_LOG_RING_RECORDS) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to allocate log ring");
+    }
+    boot_events = xEventGroupCreate();
+    ESP_ERROR_CHECK(boot_events ? ESP_OK : ESP_ERR_NO_MEM);
+    ESP_LOGI_TS(TAG, "Booting after %s reset", reset_reason_name());
+
+    // --- Factory Reset Pin Check ---
+    // The pin settles while NVS comes up; the check itself needs NVS
+    boot_timing_start(BOOT_PHASE_RESET_PIN, esp_timer_get_time());
+    int64_t pin_configured_us = esp_timer_get_time();
+    gpio_set_direction(FACTORY_RESET_PIN, GPIO_MODE_INPUT);
+    gpio_set_pull_mode(FACTORY_RESET_PIN, GPIO_PULLUP_ONLY);
+
+    // The web assets only gate the static files, so they come up alongside everything
+    // else; serve_static_file answers 503 until they are ready
+    if (xTaskCreate(boot_assets_task, "boot_assets", BOOT_TASK_STACK, NULL, BOOT_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_ERROR_CHECK(ESP_ERR_NO_MEM);
+    }
+
+    // Initialize NVS
+    boot_timing_start(BOOT_PHASE_NVS, esp_timer_get_time());
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase()); // Full erase only if NVS version is incompatible
+        ret = nvs_flash_init();
+    }
+    boot_timing_end(BOOT_PHASE_NVS, esp_timer_get_time(), ret);
+    ESP_ERROR_CHECK(ret);
+
+    int64_t settled_us = esp_timer_get_time() - pin_configured_us;
+    if (settled_us < FACTORY_RESET_SETTLE_MS * 1000) {
+        vTaskDelay(pdMS_TO_TICKS(FACTORY_RESET_SETTLE_MS - settled_us / 1000)); // Allow pin to settle
+    }
+    if (gpio_get_level(FACTORY_RESET_PIN) == 0) { // Pin pulled low
+        ESP_LOGW_TS(TAG, "FACTORY RESET PIN (GPIO%d) DETECTED LOW! Performing selective factory reset...", FACTORY_RESET_PIN);
+        
+        // Perform selective factory reset - only erase WiFi and Bluetooth pairing data
+        // Do NOT erase SPIFFS (preserves React web app) or other NVS settings
+        selective_factory_reset();
+    } else {
+        ESP_LOGI_TS(TAG, "FACTORY RESET PIN (GPIO%d) is HIGH. Proceeding with normal boot.", FACTORY_RESET_PIN);
+    }
+    boot_timing_end(BOOT_PHASE_RESET_PIN, esp_timer_get_time(), ESP_OK);
+
+    // Before Bluetooth and Wi-Fi, whose events are what the LED shows. It is only a
+    // status display, so the boot carries on without it.
+    ret = init_led_status();
+    if (ret != ESP_OK) {
+        ESP_LOGW_TS(TAG, "Status LED unavailable: %s", esp_err_to_name(ret));
+    }
+
+    // Bluetooth starts once the pairing data can no longer be erased under it
+    if (xTaskCreate(boot_bluetooth_task, "boot_bt", BOOT_TASK_STACK, NULL, BOOT_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_ERROR_CHECK(ESP_ERR_NO_MEM);
+    }
+
+    boot_timing_start(BOOT_PHASE_SETTINGS, esp_timer_get_time());
+    ret = init_settings_and_call_control();
+    boot_timing_end(BOOT_PHASE_SETTINGS, esp_timer_get_time(), ret);
+    ESP_ERROR_CHECK(ret);
+    xEventGroupSetBits(boot_events, BOOT_READY_SETTINGS);
 
-    // Create morse code LED task on CPU core 1
-    xTaskCreatePinnedToCore(
-        morse_code_led_task,
-        "morse_led_task",
-        2048,
-        NULL,
-        1,  // Priority
-        &morse_code_task_handle,
-        1   // CPU core 1
-    );
+    boot_timing_start(BOOT_PHASE_WIFI, esp_timer_get_time());
+    init_wifi();
+    boot_timing_end(BOOT_PHASE_WIFI, esp_timer_get_time(), ESP_OK);
 
+    boot_timing_mark(BOOT_MILESTONE_APP_MAIN_DONE, esp_timer_get_time());
     ESP_LOGI_TS(TAG, "ESP32 HFP Headset Emulator with API initialized.");
 }
@@ -0,0 +1,346 @@
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "metrics.h"
+
+#define METRIC_PREFIX "remotehead_"
+
+// Histogram upper bounds in microseconds, with the matching "le" labels in seconds
+static const uint32_t bucket_bounds_us[] = {
+    1000, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000,
+};
+static const char *const bucket_labels[] = {
+    "0.001", "0.005", "0.01", "0.025", "0.05", "0.1", "0.25", "0.5", "1", "2.5",
+};
+#define BUCKET_COUNT (sizeof(bucket_bounds_us) / sizeof(bucket_bounds_us[0]))
+
+// Wi-Fi connects take seconds rather than milliseconds, so they get their own bounds
+static const uint32_t wifi_bucket_bounds_ms[] = { 250, 500, 1000, 2000, 4000, 8000, 16000 };
+static const char *const wifi_bucket_labels[] = { "0.25", "0.5", "1", "2", "4", "8", "16" };
+#define WIFI_BUCKET_COUNT (sizeof(wifi_bucket_bounds_ms) / sizeof(wifi_bucket_bounds_ms[0]))
+
+// Bluetooth outages last as long as the backoff lets them, up to minutes
+static const uint32_t bt_bucket_bounds_ms[] = { 1000, 2000, 4000, 8000, 16000, 32000, 64000, 128000, 256000 };
+static const char *const bt_bucket_labels[] = { "1", "2", "4", "8", "16", "32", "64", "128", "256" };
+#define BT_BUCKET_COUNT (sizeof(bt_bucket_bounds_ms) / sizeof(bt_bucket_bounds_ms[0]))
+
+// The phone takes from tens of milliseconds (+CLCC) to seconds (accepting a dial)
+static const uint32_t at_bucket_bounds_ms[] = { 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000 };
+static const char *const at_bucket_labels[] = { "0.025", "0.05", "0.1", "0.25", "0.5", "1", "2.5", "5", "10" };
+#define AT_BUCKET_COUNT (sizeof(at_bucket_bounds_ms) / sizeof(at_bucket_bounds_ms[0]))
+
+typedef struct {
+    const char *method;
+    const char *uri;
+    atomic_uint_least32_t buckets[BUCKET_COUNT + 1]; // Last slot is +Inf; not cumulative
+    atomic_uint_least64_t sum_us;  // 32 bits of microseconds would wrap after about 71 minutes
+    atomic_uint_least32_t errors;
+} endpoint_metrics_t;
+
+typedef struct {
+    atomic_uint_least32_t buckets[WIFI_BUCKET_COUNT + 1]; // Last slot is +Inf; not cumulative
+    atomic_uint_least32_t sum_ms;
+} wifi_connect_metrics_t;
+
+typedef struct {
+    atomic_uint_least32_t buckets[BT_BUCKET_COUNT + 1]; // Last slot is +Inf; not cumulative
+    atomic_uint_least32_t sum_ms;
+} bt_reconnect_metrics_t;
+
+typedef struct {
+    atomic_uint_least32_t buckets[AT_BUCKET_COUNT + 1]; // Last slot is +Inf; not cumulative
+    atomic_uint_least32_t sum_ms;
+    atomic_uint_least32_t results[AT_RESULT_COUNT];
+} at_command_metrics_t;
+
+static const struct {
+    const char *name;
+    const char *help;
+} counter_info[METRIC_COUNTER_COUNT] = {
+    [METRIC_DIAL_ATTEMPTS]    = { "dial_attempts_total",    "Dial and redial commands sent to the phone" },
+    [METRIC_DIAL_FAILURES]    = { "dial_failures_total",    "Outgoing calls that did not connect" },
+    [METRIC_DIAL_ANSWERS]     = { "dial_answers_total",     "Outgoing calls that were answered" },
+    [METRIC_WIFI_DISCONNECTS] = { "wifi_disconnects_total", "Wi-Fi station disconnect events" },
+    [METRIC_WIFI_CACHE_FALLBACKS] = { "wifi_cache_fallbacks_total", "Connects to the cached AP that failed and fell back to a full scan" },
+    [METRIC_BT_RECONNECT_ATTEMPTS] = { "bt_reconnect_attempts_total", "Connects to the last phone started after the HFP link dropped" },
+    [METRIC_BT_RECONNECTS] = { "bt_reconnects_total", "HFP link outages that ended with the link back up" },
+    [METRIC_AT_UNMATCHED] = { "at_unmatched_answers_total", "AT answers no command was waiting for, late ones included" },
+};
+
+static atomic_uint_least32_t counters[METRIC_COUNTER_COUNT];
+static atomic_uint_least32_t hfp_events[METRICS_HFP_EVENT_MAX + 1];
+static endpoint_metrics_t endpoints[METRICS_MAX_ENDPOINTS];
+static atomic_int endpoint_count;
+static wifi_connect_metrics_t wifi_connects[2]; // Indexed by cached_ap
+static bt_reconnect_metrics_t bt_reconnects;
+static at_command_metrics_t at_commands[AT_CMD_TYPE_COUNT];
+
+void metrics_inc(metrics_counter_t counter)
+{
+    if (counter < METRIC_COUNTER_COUNT) {
+        atomic_fetch_add_explicit(&counters[counter], 1, memory_order_relaxed);
+    }
+}
+
+void metrics_hfp_event(int event)
+{
+    if (event < 0 || event > METRICS_HFP_EVENT_MAX) {
+        event = METRICS_HFP_EVENT_MAX;
+    }
+    atomic_fetch_add_explicit(&hfp_events[event], 1, memory_order_relaxed);
+}
+
+// Only called while the web server is being set up, never concurrently with itself
+int metrics_register_endpoint(const char *method, const char *uri)
+{
+    int count = atomic_load(&endpoint_count);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(endpoints[i].method, method) == 0 && strcmp(endpoints[i].uri, uri) == 0) {
+            return i;
+        }
+    }
+    if (count >= METRICS_MAX_ENDPOINTS) {
+        return -1;
+    }
+    endpoints[count].method = method;
+    endpoints[count].uri = uri;
+    atomic_store(&endpoint_count, count + 1); // Publish only once the labels are set
+    return count;
+}
+
+void metrics_observe_request(int endpoint, int64_t duration_us, bool failed)
+{
+    if (endpoint < 0 || endpoint >= atomic_load_explicit(&endpoint_count, memory_order_relaxed)) {
+        return;
+    }
+    endpoint_metrics_t *ep = &endpoints[endpoint];
+    size_t bucket = 0;
+    while (bucket < BUCKET_COUNT && duration_us > bucket_bounds_us[bucket]) {
+        bucket++;
+    }
+    atomic_fetch_add_explicit(&ep->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ep->sum_us, (uint64_t)(duration_us > 0 ? duration_us : 0), memory_order_relaxed);
+    if (failed) {
+        atomic_fetch_add_explicit(&ep->errors, 1, memory_order_relaxed);
+    }
+}
+
+void metrics_observe_wifi_connect(int64_t duration_us, bool cached_ap)
+{
+    wifi_connect_metrics_t *m = &wifi_connects[cached_ap ? 1 : 0];
+    uint32_t duration_ms = duration_us > 0 ? (uint32_t)(duration_us / 1000) : 0;
+    size_t bucket = 0;
+    while (bucket < WIFI_BUCKET_COUNT && duration_ms > wifi_bucket_bounds_ms[bucket]) {
+        bucket++;
+    }
+    atomic_fetch_add_explicit(&m->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&m->sum_ms, duration_ms, memory_order_relaxed);
+}
+
+void metrics_observe_bt_reconnect(int64_t duration_us)
+{
+    uint32_t duration_ms = duration_us > 0 ? (uint32_t)(duration_us / 1000) : 0;
+    size_t bucket = 0;
+    while (bucket < BT_BUCKET_COUNT && duration_ms > bt_bucket_bounds_ms[bucket]) {
+        bucket++;
+    }
+    atomic_fetch_add_explicit(&bt_reconnects.buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bt_reconnects.sum_ms, duration_ms, memory_order_relaxed);
+}
+
+void metrics_observe_at(at_cmd_type_t command, at_result_t result, int64_t round_trip_us)
+{
+    if (command >= AT_CMD_TYPE_COUNT || result >= AT_RESULT_COUNT) {
+        return;
+    }
+    at_command_metrics_t *m = &at_commands[command];
+    atomic_fetch_add_explicit(&m->results[result], 1, memory_order_relaxed);
+    if (result == AT_RESULT_TIMEOUT || result == AT_RESULT_LINK_LOST) {
+        return; // No answer, so no round trip
+    }
+    uint32_t duration_ms = round_trip_us > 0 ? (uint32_t)(round_trip_us / 1000) : 0;
+    size_t bucket = 0;
+    while (bucket < AT_BUCKET_COUNT && duration_ms > at_bucket_bounds_ms[bucket]) {
+        bucket++;
+    }
+    atomic_fetch_add_explicit(&m->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&m->sum_ms, duration_ms, memory_order_relaxed);
+}
+
+// printf-style line into a stack buffer, then out through emit
+static void emitf(metrics_emit_fn emit, void *ctx, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+static void emitf(metrics_emit_fn emit, void *ctx, const char *fmt, ...)
+{
+    char line[192];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (len > 0) {
+        emit(ctx, line, (size_t)len < sizeof(line) ? (size_t)len : sizeof(line) - 1);
+    }
+}
+
+static void emit_header(metrics_emit_fn emit, void *ctx, const char *name, const char *type, const char *help)
+{
+    emitf(emit, ctx, "# HELP " METRIC_PREFIX "%s %s\n# TYPE " METRIC_PREFIX "%s %s\n", name, help, name, type);
+}
+
+static uint32_t load(atomic_uint_least32_t *value)
+{
+    return (uint32_t)atomic_load_explicit(value, memory_order_relaxed);
+}
+
+void metrics_render(const metrics_system_t *sys, metrics_emit_fn emit, void *ctx)
+{
+    emit_header(emit, ctx, "uptime_seconds", "gauge", "Time since boot");
+    emitf(emit, ctx, METRIC_PREFIX "uptime_seconds %" PRId64 ".%06" PRId64 "\n",
+          sys->uptime_us / 1000000, sys->uptime_us % 1000000);
+    emit_header(emit, ctx, "free_heap_bytes", "gauge", "Currently free heap");
+    emitf(emit, ctx, METRIC_PREFIX "free_heap_bytes %" PRIu32 "\n", sys->free_heap);
+    emit_header(emit, ctx, "min_free_heap_bytes", "gauge", "Lowest free heap since boot");
+    emitf(emit, ctx, METRIC_PREFIX "min_free_heap_bytes %" PRIu32 "\n", sys->min_free_heap);
+
+    emit_header(emit, ctx, "settings_updates_total", "counter", "Settings changes accepted in RAM");
+    emitf(emit, ctx, METRIC_PREFIX "settings_updates_total %" PRIu32 "\n", sys->settings_updates);
+    emit_header(emit, ctx, "settings_unchanged_total", "counter", "Settings saves that changed nothing");
+    emitf(emit, ctx, METRIC_PREFIX "settings_unchanged_total %" PRIu32 "\n", sys->settings_unchanged);
+    emit_header(emit, ctx, "settings_flushes_total", "counter", "Settings blobs committed to NVS");
+    emitf(emit, ctx, METRIC_PREFIX "settings_flushes_total %" PRIu32 "\n", sys->settings_flushes);
+    emit_header(emit, ctx, "settings_flash_bytes_total", "counter", "Settings bytes written to NVS");
+    emitf(emit, ctx, METRIC_PREFIX "settings_flash_bytes_total %" PRIu32 "\n", sys->settings_bytes_written);
+    emit_header(emit, ctx, "settings_flush_errors_total", "counter", "Failed settings writes");
+    emitf(emit, ctx, METRIC_PREFIX "settings_flush_errors_total %" PRIu32 "\n", sys->settings_flush_errors);
+    emit_header(emit, ctx, "settings_dirty", "gauge", "1 while settings changes are not yet on flash");
+    emitf(emit, ctx, METRIC_PREFIX "settings_dirty %d\n", sys->settings_dirty ? 1 : 0);
+
+    emit_header(emit, ctx, "http_workers", "gauge", "Tasks in the HTTP worker pool");
+    emitf(emit, ctx, METRIC_PREFIX "http_workers %" PRIu32 "\n", sys->http_workers);
+    emit_header(emit, ctx, "http_workers_busy", "gauge", "HTTP workers running a deferred request");
+    emitf(emit, ctx, METRIC_PREFIX "http_workers_busy %" PRIu32 "\n", sys->http_workers_busy);
+    emit_header(emit, ctx, "http_worker_queue_depth", "gauge", "Deferred requests waiting for a worker");
+    emitf(emit, ctx, METRIC_PREFIX "http_worker_queue_depth %" PRIu32 "\n", sys->http_worker_queue_depth);
+    emit_header(emit, ctx, "http_worker_queue_high_water", "gauge", "Deepest the worker queue has been since boot");
+    emitf(emit, ctx, METRIC_PREFIX "http_worker_queue_high_water %" PRIu32 "\n", sys->http_worker_queue_high_water);
+    emit_header(emit, ctx, "http_worker_jobs_total", "counter", "Requests handed to the worker pool");
+    emitf(emit, ctx, METRIC_PREFIX "http_worker_jobs_total %" PRIu32 "\n", sys->http_worker_jobs);
+    emit_header(emit, ctx, "http_worker_rejected_total", "counter", "Requests answered 503 because the worker queue was full");
+    emitf(emit, ctx, METRIC_PREFIX "http_worker_rejected_total %" PRIu32 "\n", sys->http_worker_rejected);
+
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        emit_header(emit, ctx, counter_info[i].name, "counter", counter_info[i].help);
+        emitf(emit, ctx, METRIC_PREFIX "%s %" PRIu32 "\n", counter_info[i].name, load(&counters[i]));
+    }
+
+    emit_header(emit, ctx, "hfp_events_total", "counter", "HFP client callback events by esp_hf_client_cb_event_t value");
+    for (int i = 0; i <= METRICS_HFP_EVENT_MAX; i++) {
+        uint32_t count = load(&hfp_events[i]);
+        if (count == 0) continue;
+        if (i == METRICS_HFP_EVENT_MAX) {
+            emitf(emit, ctx, METRIC_PREFIX "hfp_events_total{event=\"other\"} %" PRIu32 "\n", count);
+        } else {
+            emitf(emit, ctx, METRIC_PREFIX "hfp_events_total{event=\"%d\"} %" PRIu32 "\n", i, count);
+        }
+    }
+
+    emit_header(emit, ctx, "wifi_connect_seconds", "histogram",
+                "Wi-Fi station start or link loss until an IP address, by connect path");
+    for (int c = 0; c < 2; c++) {
+        wifi_connect_metrics_t *m = &wifi_connects[c];
+        const char *path = c ? "cached" : "scan";
+        uint32_t cumulative = 0;
+        for (size_t b = 0; b <= WIFI_BUCKET_COUNT; b++) {
+            cumulative += load(&m->buckets[b]);
+            emitf(emit, ctx, METRIC_PREFIX "wifi_connect_seconds_bucket{path=\"%s\",le=\"%s\"} %" PRIu32 "\n",
+                  path, b < WIFI_BUCKET_COUNT ? wifi_bucket_labels[b] : "+Inf", cumulative);
+        }
+        uint32_t sum_ms = load(&m->sum_ms);
+        emitf(emit, ctx, METRIC_PREFIX "wifi_connect_seconds_sum{path=\"%s\"} %" PRIu32 ".%03" PRIu32 "\n",
+              path, sum_ms / 1000, sum_ms % 1000);
+        emitf(emit, ctx, METRIC_PREFIX "wifi_connect_seconds_count{path=\"%s\"} %" PRIu32 "\n", path, cumulative);
+    }
+
+    emit_header(emit, ctx, "bt_reconnect_seconds", "histogram", "HFP link lost until it is back up");
+    uint32_t bt_cumulative = 0;
+    for (size_t b = 0; b <= BT_BUCKET_COUNT; b++) {
+        bt_cumulative += load(&bt_reconnects.buckets[b]);
+        emitf(emit, ctx, METRIC_PREFIX "bt_reconnect_seconds_bucket{le=\"%s\"} %" PRIu32 "\n",
+              b < BT_BUCKET_COUNT ? bt_bucket_labels[b] : "+Inf", bt_cumulative);
+    }
+    uint32_t bt_sum_ms = load(&bt_reconnects.sum_ms);
+    emitf(emit, ctx, METRIC_PREFIX "bt_reconnect_seconds_sum %" PRIu32 ".%03" PRIu32 "\n",
+          bt_sum_ms / 1000, bt_sum_ms % 1000);
+    emitf(emit, ctx, METRIC_PREFIX "bt_reconnect_seconds_count %" PRIu32 "\n", bt_cumulative);
+
+    emit_header(emit, ctx, "at_commands_total", "counter", "AT commands sent to the phone, by how they finished");
+    for (int c = 0; c < AT_CMD_TYPE_COUNT; c++) {
+        for (int r = 0; r < AT_RESULT_COUNT; r++) {
+            uint32_t finished = load(&at_commands[c].results[r]);
+            if (finished == 0) continue;
+            emitf(emit, ctx, METRIC_PREFIX "at_commands_total{command=\"%s\",result=\"%s\"} %" PRIu32 "\n",
+                  at_channel_cmd_name(c), at_channel_result_name(r), finished);
+        }
+    }
+
+    emit_header(emit, ctx, "at_round_trip_seconds", "histogram",
+                "AT command on the air until the phone answered, by command");
+    for (int c = 0; c < AT_CMD_TYPE_COUNT; c++) {
+        at_command_metrics_t *m = &at_commands[c];
+        const char *command = at_channel_cmd_name(c);
+        uint32_t cumulative = 0;
+        for (size_t b = 0; b <= AT_BUCKET_COUNT; b++) {
+            cumulative += load(&m->buckets[b]);
+            emitf(emit, ctx, METRIC_PREFIX "at_round_trip_seconds_bucket{command=\"%s\",le=\"%s\"} %" PRIu32 "\n",
+                  command, b < AT_BUCKET_COUNT ? at_bucket_labels[b] : "+Inf", cumulative);
+        }
+        uint32_t sum_ms = load(&m->sum_ms);
+        emitf(emit, ctx, METRIC_PREFIX "at_round_trip_seconds_sum{command=\"%s\"} %" PRIu32 ".%03" PRIu32 "\n",
+              command, sum_ms / 1000, sum_ms % 1000);
+        emitf(emit, ctx, METRIC_PREFIX "at_round_trip_seconds_count{command=\"%s\"} %" PRIu32 "\n", command, cumulative);
+    }
+
+    int count = atomic_load(&endpoint_count);
+    emit_header(emit, ctx, "http_requests_total", "counter", "HTTP requests handled");
+    for (int i = 0; i < count; i++) {
+        uint32_t total = 0;
+        for (size_t b = 0; b <= BUCKET_COUNT; b++) total += load(&endpoints[i].buckets[b]);
+        emitf(emit, ctx, METRIC_PREFIX "http_requests_total{method=\"%s\",uri=\"%s\"} %" PRIu32 "\n",
+              endpoints[i].method, endpoints[i].uri, total);
+    }
+    emit_header(emit, ctx, "http_handler_errors_total", "counter", "HTTP handlers that returned an error");
+    for (int i = 0; i < count; i++) {
+        emitf(emit, ctx, METRIC_PREFIX "http_handler_errors_total{method=\"%s\",uri=\"%s\"} %" PRIu32 "\n",
+              endpoints[i].method, endpoints[i].uri, load(&endpoints[i].errors));
+    }
+    emit_header(emit, ctx, "http_handler_duration_seconds", "histogram", "Time spent in HTTP handlers");
+    for (int i = 0; i < count; i++) {
+        endpoint_metrics_t *ep = &endpoints[i];
+        uint32_t cumulative = 0;
+        for (size_t b = 0; b <= BUCKET_COUNT; b++) {
+            cumulative += load(&ep->buckets[b]);
+            emitf(emit, ctx, METRIC_PREFIX "http_handler_duration_seconds_bucket{method=\"%s\",uri=\"%s\",le=\"%s\"} %" PRIu32 "\n",
+                  ep->method, ep->uri, b < BUCKET_COUNT ? bucket_labels[b] : "+Inf", cumulative);
+        }
+        uint64_t sum_us = (uint64_t)atomic_load_explicit(&ep->sum_us, memory_order_relaxed);
+        emitf(emit, ctx, METRIC_PREFIX "http_handler_duration_seconds_sum{method=\"%s\",uri=\"%s\"} %" PRIu64 ".%06" PRIu64 "\n",
+              ep->method, ep->uri, sum_us / 1000000, sum_us % 1000000);
+        emitf(emit, ctx, METRIC_PREFIX "http_handler_duration_seconds_count{method=\"%s\",uri=\"%s\"} %" PRIu32 "\n",
+              ep->method, ep->uri, cumulative);
+    }
+}
+
+void metrics_reset(void)
+{
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++) atomic_store(&counters[i], 0);
+    for (int i = 0; i <= METRICS_HFP_EVENT_MAX; i++) atomic_store(&hfp_events[i], 0);
+    atomic_store(&endpoint_count, 0);
+    memset(wifi_connects, 0, sizeof(wifi_connects));
+    memset(&bt_reconnects, 0, sizeof(bt_reconnects));
+    memset(at_commands, 0, sizeof(at_commands));
+    memset(endpoints, 0, sizeof(endpoints));
+}
@@ -0,0 +1,76 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "at_channel.h"
+
+// Counters and latency histograms for GET /metrics (Prometheus text format).
+// Every update is a single relaxed atomic add, so they are safe and cheap to call from
+// the HFP callback, the httpd task and timer callbacks alike.
+#define METRICS_MAX_ENDPOINTS 16
+#define METRICS_HFP_EVENT_MAX 40 // Larger esp_hf_client_cb_event_t values share one "other" slot
+
+typedef enum {
+    METRIC_DIAL_ATTEMPTS,
+    METRIC_DIAL_FAILURES,
+    METRIC_DIAL_ANSWERS,
+    METRIC_WIFI_DISCONNECTS,
+    METRIC_WIFI_CACHE_FALLBACKS,
+    METRIC_BT_RECONNECT_ATTEMPTS,
+    METRIC_BT_RECONNECTS,
+    METRIC_AT_UNMATCHED,
+    METRIC_COUNTER_COUNT,
+} metrics_counter_t;
+
+// Values sampled by the caller at scrape time
+typedef struct {
+    int64_t uptime_us;
+    uint32_t free_heap;
+    uint32_t min_free_heap;
+    uint32_t settings_updates;       // settings_store_stats_t, to watch write amplification
+    uint32_t settings_unchanged;
+    uint32_t settings_flushes;
+    uint32_t settings_bytes_written;
+    uint32_t settings_flush_errors;
+    bool settings_dirty;
+    uint32_t http_workers;           // http_workers_stats_t, to size the pool and its queue
+    uint32_t http_worker_queue_depth;
+    uint32_t http_worker_queue_high_water;
+    uint32_t http_workers_busy;
+    uint32_t http_worker_jobs;
+    uint32_t http_worker_rejected;
+} metrics_system_t;
+
+// Receives the exposition text piece by piece
+typedef void (*metrics_emit_fn)(void *ctx, const char *text, size_t len);
+
+void metrics_inc(metrics_counter_t counter);
+void metrics_hfp_event(int event);
+
+// Look up or add an HTTP endpoint; registering the same method and URI again (e.g. on a
+// web server restart) returns the same index. uri and method must be string literals.
+// Returns -1 when the table is full.
+int metrics_register_endpoint(const char *method, const char *uri);
+
+// Add one station connect (STA start or link loss until an address) to the histogram
+// for its path: straight to the cached AP, or a full scan
+void metrics_observe_wifi_connect(int64_t duration_us, bool cached_ap);
+
+// Add one Bluetooth outage (HFP link lost until it is back up) to its histogram
+void metrics_observe_bt_reconnect(int64_t duration_us);
+
+// Count one finished AT command by result; answered ones also add their round trip to
+// the command's histogram
+void metrics_observe_at(at_cmd_type_t command, at_result_t result, int64_t round_trip_us);
+
+// Count one handled request and add its duration to the endpoint's histogram
+void metrics_observe_request(int endpoint, int64_t duration_us, bool failed);
+
+void metrics_render(const metrics_system_t *sys, metrics_emit_fn emit, void *ctx);
+
+// Zero every counter and forget the endpoints (used by tests)
+void metrics_reset(void);
+
+#endif // METRICS_H
@@ -0,0 +1,123 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "redial_schedule.h"
+
+static const char *const mode_names[REDIAL_MODE_COUNT] = {
+    [REDIAL_MODE_PERIODIC] = "periodic",
+    [REDIAL_MODE_BACK_TO_BACK] = "back_to_back",
+};
+
+static uint32_t pick_jitter(const redial_schedule_t *s, uint32_t random)
+{
+    if (s->jitter_max_s == 0) {
+        return 0;
+    }
+    return random % (s->jitter_max_s + 1); // 0..jitter_max inclusive
+}
+
+int64_t redial_schedule_start(redial_schedule_t *s, int64_t now_us, uint32_t period_s,
+                              uint32_t jitter_max_s, uint32_t random)
+{
+    s->period_us = (int64_t)(period_s > 0 ? period_s : 1) * 1000000;
+    s->jitter_max_s = jitter_max_s;
+    s->drift_us = 0;
+    s->last_lateness_us = 0;
+    s->last_jitter_s = pick_jitter(s, random);
+    s->next_deadline_us = now_us + s->period_us + (int64_t)s->last_jitter_s * 1000000;
+    return s->next_deadline_us - now_us;
+}
+
+int64_t redial_schedule_advance(redial_schedule_t *s, int64_t now_us, uint32_t random)
+{
+    int64_t fired_deadline = s->next_deadline_us;
+    s->last_lateness_us = now_us > fired_deadline ? now_us - fired_deadline : 0;
+    s->last_jitter_s = pick_jitter(s, random);
+
+    int64_t step = s->period_us + (int64_t)s->last_jitter_s * 1000000;
+    int64_t next = fired_deadline + step;
+    if (next <= now_us) {
+        // A whole interval was missed; shift the plan rather than dialing back-to-back
+        s->drift_us += now_us - fired_deadline;
+        next = now_us + step;
+    }
+    s->next_deadline_us = next;
+    return next - now_us;
+}
+
+int64_t redial_schedule_after_idle(redial_schedule_t *s, int64_t now_us, uint32_t guard_s, uint32_t random)
+{
+    s->last_lateness_us = 0;
+    s->last_jitter_s = pick_jitter(s, random);
+    s->next_deadline_us = now_us + ((int64_t)guard_s + s->last_jitter_s) * 1000000;
+    return s->next_deadline_us - now_us;
+}
+
+void redial_schedule_stop(redial_schedule_t *s)
+{
+    s->next_deadline_us = 0;
+    s->last_lateness_us = 0;
+}
+
+const char *redial_mode_name(redial_mode_t mode)
+{
+    return mode < REDIAL_MODE_COUNT ? mode_names[mode] : "unknown";
+}
+
+bool redial_mode_from_name(const char *name, redial_mode_t *mode)
+{
+    for (int i = 0; i < REDIAL_MODE_COUNT; i++) {
+        if (strcmp(name, mode_names[i]) == 0) {
+            *mode = (redial_mode_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t per_hour(uint32_t attempts, int64_t elapsed_us)
+{
+    if (elapsed_us <= 0) {
+        return 0;
+    }
+    return (uint32_t)(((int64_t)attempts * 3600 * 1000000) / elapsed_us);
+}
+
+void redial_session_start(redial_session_t *session, int64_t now_us)
+{
+    session->started_us = now_us > 0 ? now_us : 1; // 0 means "not running"
+    session->attempts = 0;
+}
+
+void redial_session_attempt(redial_session_t *session)
+{
+    if (session->started_us != 0) {
+        session->attempts++;
+    }
+}
+
+bool redial_session_connected(redial_session_t *session, int64_t now_us)
+{
+    if (session->started_us == 0) {
+        return false;
+    }
+    int64_t elapsed_us = now_us - session->started_us;
+    session->last_attempts = session->attempts;
+    session->last_connect_us = elapsed_us;
+    session->last_attempts_per_hour = per_hour(session->attempts, elapsed_us);
+    session->started_us = 0;
+    return true;
+}
+
+void redial_session_stop(redial_session_t *session)
+{
+    session->started_us = 0;
+}
+
+uint32_t redial_session_attempts_per_hour(const redial_session_t *session, int64_t now_us)
+{
+    if (session->started_us == 0) {
+        return session->last_attempts_per_hour;
+    }
+    return per_hour(session->attempts, now_us - session->started_us);
+}
@@ -0,0 +1,72 @@
+#ifndef REDIAL_SCHEDULE_H
+#define REDIAL_SCHEDULE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// How automatic redial decides when to try again
+typedef enum {
+    REDIAL_MODE_PERIODIC,     // Fixed period plus jitter, regardless of how long attempts take
+    REDIAL_MODE_BACK_TO_BACK, // Guard gap plus jitter after each attempt's call setup ends
+    REDIAL_MODE_COUNT,
+} redial_mode_t;
+
+// Deadline bookkeeping for automatic redial. Each attempt is planned at the previous
+// attempt's deadline + period + jitter, and the caller arms a one-shot timer with the
+// returned delay, so nothing ever sleeps on the esp_timer task. Scheduling from the
+// deadline rather than from when the timer actually fired keeps timer latency from
+// accumulating. Times are esp_timer microseconds; no timers are touched here.
+typedef struct {
+    int64_t period_us;
+    uint32_t jitter_max_s;
+    int64_t next_deadline_us;  // Absolute time of the next attempt; 0 when stopped
+    int64_t drift_us;          // How far the schedule has slipped behind its plan
+    int64_t last_lateness_us;  // How late the last attempt fired after its deadline
+    uint32_t last_jitter_s;    // Jitter applied to the next attempt
+} redial_schedule_t;
+
+// Plan the first attempt one period plus jitter after now. random supplies the jitter
+// (e.g. esp_random()). Returns the delay to arm the one-shot timer with.
+int64_t redial_schedule_start(redial_schedule_t *s, int64_t now_us, uint32_t period_s,
+                              uint32_t jitter_max_s, uint32_t random);
+
+// Record the attempt that fired at now_us and plan the next one. If it fired so late
+// that the next deadline has already passed, the schedule is re-anchored at now_us
+// instead of firing a burst, and the slip is added to drift_us.
+int64_t redial_schedule_advance(redial_schedule_t *s, int64_t now_us, uint32_t random);
+
+// Back-to-back mode: plan the next attempt guard_s plus jitter after the line went idle
+// at now_us. The period set by redial_schedule_start() is left alone so the caller can
+// still use it as a fallback when an attempt never reports an outcome.
+int64_t redial_schedule_after_idle(redial_schedule_t *s, int64_t now_us, uint32_t guard_s, uint32_t random);
+
+void redial_schedule_stop(redial_schedule_t *s);
+
+const char *redial_mode_name(redial_mode_t mode);
+
+// Parse "periodic" or "back_to_back"; returns false for anything else
+bool redial_mode_from_name(const char *name, redial_mode_t *mode);
+
+// Outcome of one auto-redial session, from enabling it to the first answered call, so the
+// two modes can be compared on attempts per hour and time to connect.
+typedef struct {
+    int64_t started_us;           // 0 when no session is running
+    uint32_t attempts;            // Attempts that reached the phone this session
+    uint32_t last_attempts;       // Attempts the last connected session needed
+    int64_t last_connect_us;      // Time to connect of the last connected session; 0 if none
+    uint32_t last_attempts_per_hour;
+} redial_session_t;
+
+void redial_session_start(redial_session_t *session, int64_t now_us);
+void redial_session_attempt(redial_session_t *session);
+
+// Record that the session's call was answered and end the session. Returns false (and
+// changes nothing) if no session is running.
+bool redial_session_connected(redial_session_t *session, int64_t now_us);
+
+void redial_session_stop(redial_session_t *session);
+
+// Attempt rate of the running session, or of the last connected one when none is running
+uint32_t redial_session_attempts_per_hour(const redial_session_t *session, int64_t now_us);
+
+#endif // REDIAL_SCHEDULE_H
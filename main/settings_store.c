@@ -0,0 +1,425 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "nvs.h"
+#include "settings_store.h"
+
+#define TAG "SETTINGS"
+
+#define DEFAULT_REDIAL_PERIOD_S 60
+#define DEFAULT_REDIAL_GUARD_S 3
+
+// Per-setting keys written by firmware before the blob existed; migrated once, then erased
+#define LEGACY_KEY_AUTO_REDIAL_ENABLED "auto_en"
+#define LEGACY_KEY_REDIAL_PERIOD "redial_period"
+#define LEGACY_KEY_REDIAL_RANDOM "redial_rand"
+#define LEGACY_KEY_REDIAL_MAX_COUNT "redial_max"
+#define LEGACY_KEY_REDIAL_MODE "redial_mode"
+#define LEGACY_KEY_REDIAL_GUARD "redial_guard"
+
+// Guarded by lock: the RAM copy, its generation and the stats. Generations let a flush
+// tell whether the settings changed again while it was writing.
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+static settings_t current;
+static uint32_t generation;
+static uint32_t flushed_generation;
+static settings_store_stats_t stats;
+
+static SemaphoreHandle_t flush_mutex = NULL; // Serializes NVS writes between the task and shutdown
+// Legacy keys still on flash next to (or instead of) the blob; the next successful flush
+// writes the blob and erases them in one commit. Guarded by flush_mutex.
+static bool legacy_erase_pending;
+static TaskHandle_t flush_task = NULL;
+static uint32_t flush_delay_ms;
+static bool shutdown_handler_registered;
+
+void settings_defaults(settings_t *settings)
+{
+    *settings = (settings_t){
+        .auto_redial_enabled = false,
+        .redial_period_s = DEFAULT_REDIAL_PERIOD_S,
+        .redial_random_delay_s = 0,
+        .redial_max_count = 0,
+        .redial_mode = 0, // REDIAL_MODE_PERIODIC
+        .redial_guard_s = DEFAULT_REDIAL_GUARD_S,
+    };
+}
+
+// Field by field: settings_t has padding, so memcmp could see stale bytes
+static bool settings_equal(const settings_t *a, const settings_t *b)
+{
+    return a->auto_redial_enabled == b->auto_redial_enabled &&
+           a->redial_period_s == b->redial_period_s &&
+           a->redial_random_delay_s == b->redial_random_delay_s &&
+           a->redial_max_count == b->redial_max_count &&
+           a->redial_mode == b->redial_mode &&
+           a->redial_guard_s == b->redial_guard_s;
+}
+
+uint32_t settings_crc32(const uint8_t *data, size_t len)
+{
+    // Bitwise CRC-32 (IEEE 802.3); a 28-byte blob does not warrant a lookup table
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t settings_blob_encode(const settings_t *settings, uint8_t *buf, size_t buf_len)
+{
+    if (buf_len < SETTINGS_BLOB_SIZE) {
+        return 0;
+    }
+    put_u16(buf, SETTINGS_BLOB_MAGIC);
+    buf[2] = SETTINGS_BLOB_VERSION;
+    buf[3] = 0; // Reserved
+    put_u16(buf + 4, SETTINGS_BLOB_PAYLOAD_SIZE);
+
+    uint8_t *p = buf + SETTINGS_BLOB_HEADER_SIZE;
+    p[0] = settings->auto_redial_enabled ? 1 : 0;
+    put_u32(p + 1, settings->redial_period_s);
+    put_u32(p + 5, settings->redial_random_delay_s);
+    put_u32(p + 9, settings->redial_max_count);
+    p[13] = settings->redial_mode;
+    put_u32(p + 14, settings->redial_guard_s);
+
+    size_t crc_offset = SETTINGS_BLOB_HEADER_SIZE + SETTINGS_BLOB_PAYLOAD_SIZE;
+    put_u32(buf + crc_offset, settings_crc32(buf, crc_offset));
+    return SETTINGS_BLOB_SIZE;
+}
+
+esp_err_t settings_blob_decode(const uint8_t *buf, size_t len, settings_t *out)
+{
+    if (len < SETTINGS_BLOB_HEADER_SIZE + 4) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (get_u16(buf) != SETTINGS_BLOB_MAGIC) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    size_t payload_len = get_u16(buf + 4);
+    if (len != SETTINGS_BLOB_HEADER_SIZE + payload_len + 4) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t crc_offset = SETTINGS_BLOB_HEADER_SIZE + payload_len;
+    if (get_u32(buf + crc_offset) != settings_crc32(buf, crc_offset)) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    // Fields past the end of an older, shorter payload keep their defaults
+    const uint8_t *p = buf + SETTINGS_BLOB_HEADER_SIZE;
+    settings_t s;
+    settings_defaults(&s);
+    if (payload_len >= 1) s.auto_redial_enabled = p[0] != 0;
+    if (payload_len >= 5) s.redial_period_s = get_u32(p + 1);
+    if (payload_len >= 9) s.redial_random_delay_s = get_u32(p + 5);
+    if (payload_len >= 13) s.redial_max_count = get_u32(p + 9);
+    if (payload_len >= 14) s.redial_mode = p[13];
+    if (payload_len >= 18) s.redial_guard_s = get_u32(p + 14);
+    *out = s;
+    return ESP_OK;
+}
+
+// Read the pre-blob keys; returns false if none of them exist
+static bool load_legacy(nvs_handle_t handle, settings_t *out)
+{
+    settings_t s;
+    settings_defaults(&s);
+    bool found = false;
+    uint8_t u8;
+    uint32_t u32;
+
+    if (nvs_get_u8(handle, LEGACY_KEY_AUTO_REDIAL_ENABLED, &u8) == ESP_OK) {
+        s.auto_redial_enabled = u8 != 0;
+        found = true;
+    }
+    if (nvs_get_u32(handle, LEGACY_KEY_REDIAL_PERIOD, &u32) == ESP_OK) {
+        s.redial_period_s = u32;
+        found = true;
+    }
+    if (nvs_get_u32(handle, LEGACY_KEY_REDIAL_RANDOM, &u32) == ESP_OK) {
+        s.redial_random_delay_s = u32;
+        found = true;
+    }
+    if (nvs_get_u32(handle, LEGACY_KEY_REDIAL_MAX_COUNT, &u32) == ESP_OK) {
+        s.redial_max_count = u32;
+        found = true;
+    }
+    if (nvs_get_u8(handle, LEGACY_KEY_REDIAL_MODE, &u8) == ESP_OK) {
+        s.redial_mode = u8;
+        found = true;
+    }
+    if (nvs_get_u32(handle, LEGACY_KEY_REDIAL_GUARD, &u32) == ESP_OK) {
+        s.redial_guard_s = u32;
+        found = true;
+    }
+    *out = s;
+    return found;
+}
+
+static void erase_legacy(nvs_handle_t handle)
+{
+    static const char *const keys[] = {
+        LEGACY_KEY_AUTO_REDIAL_ENABLED, LEGACY_KEY_REDIAL_PERIOD, LEGACY_KEY_REDIAL_RANDOM,
+        LEGACY_KEY_REDIAL_MAX_COUNT, LEGACY_KEY_REDIAL_MODE, LEGACY_KEY_REDIAL_GUARD,
+    };
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        nvs_erase_key(handle, keys[i]); // ESP_ERR_NVS_NOT_FOUND is fine
+    }
+}
+
+// Write the blob (and drop the legacy keys, which it supersedes) in one commit
+static esp_err_t write_blob(const settings_t *settings, bool erase_legacy_keys)
+{
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    size_t len = settings_blob_encode(settings, blob, sizeof(blob));
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(SETTINGS_STORE_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, SETTINGS_STORE_KEY, blob, len);
+        if (err == ESP_OK && erase_legacy_keys) {
+            erase_legacy(handle);
+        }
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+
+    portENTER_CRITICAL(&lock);
+    if (err == ESP_OK) {
+        stats.flushes++;
+        stats.bytes_written += (uint32_t)len;
+    } else {
+        stats.flush_errors++;
+    }
+    portEXIT_CRITICAL(&lock);
+    return err;
+}
+
+esp_err_t settings_store_flush(void)
+{
+    if (flush_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(flush_mutex, portMAX_DELAY);
+
+    portENTER_CRITICAL(&lock);
+    bool dirty = generation != flushed_generation;
+    settings_t snapshot = current;
+    uint32_t snapshot_generation = generation;
+    portEXIT_CRITICAL(&lock);
+
+    esp_err_t err = ESP_OK;
+    if (dirty || legacy_erase_pending) {
+        err = write_blob(&snapshot, legacy_erase_pending);
+        if (err == ESP_OK) {
+            portENTER_CRITICAL(&lock);
+            flushed_generation = snapshot_generation; // Later updates stay dirty
+            stats.dirty = generation != flushed_generation;
+            stats.migrated |= legacy_erase_pending;
+            portEXIT_CRITICAL(&lock);
+            if (legacy_erase_pending) {
+                legacy_erase_pending = false;
+                ESP_LOGI(TAG, "Legacy redial settings erased");
+            }
+            ESP_LOGI(TAG, "Settings written (%d bytes)", SETTINGS_BLOB_SIZE);
+        } else {
+            ESP_LOGE(TAG, "Error (%s) writing settings", esp_err_to_name(err));
+        }
+    }
+    xSemaphoreGive(flush_mutex);
+    return err;
+}
+
+static void settings_store_shutdown(void)
+{
+    settings_store_flush();
+}
+
+// Sleeps until an update arrives, then waits for the settings to go quiet before writing
+static void settings_flush_task(void *arg)
+{
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Every further update restarts the quiet period, up to a cap so a steady stream
+        // of changes is still written eventually
+        TickType_t started = xTaskGetTickCount();
+        TickType_t max_defer = pdMS_TO_TICKS(flush_delay_ms * SETTINGS_STORE_MAX_DEFER_FACTOR);
+        while (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(flush_delay_ms)) > 0) {
+            if (xTaskGetTickCount() - started >= max_defer) {
+                break;
+            }
+        }
+        if (settings_store_flush() != ESP_OK) {
+            vTaskDelay(pdMS_TO_TICKS(flush_delay_ms)); // Back off, then try again
+            xTaskNotifyGive(flush_task);
+        }
+    }
+}
+
+esp_err_t settings_store_init(uint32_t delay_ms, settings_t *out)
+{
+    settings_t loaded;
+    settings_defaults(&loaded);
+    bool needs_write = false;
+    bool migrating = false;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(SETTINGS_STORE_NAMESPACE, NVS_READONLY, &handle);
+    if (err == ESP_OK) {
+        uint8_t blob[SETTINGS_BLOB_MAX_SIZE];
+        size_t len = sizeof(blob);
+        err = nvs_get_blob(handle, SETTINGS_STORE_KEY, blob, &len);
+        if (err == ESP_OK) {
+            err = settings_blob_decode(blob, len, &loaded);
+            settings_t legacy;
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Stored settings rejected (%s), using defaults", esp_err_to_name(err));
+                stats.load_errors++;
+                settings_defaults(&loaded);
+                needs_write = true;
+            } else if (load_legacy(handle, &legacy)) {
+                // Left by a migration whose blob was written but whose erase never was
+                legacy_erase_pending = true;
+            }
+        } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+            migrating = load_legacy(handle, &loaded);
+        } else {
+            ESP_LOGE(TAG, "Error (%s) reading settings, using defaults", esp_err_to_name(err));
+            stats.load_errors++;
+        }
+        nvs_close(handle);
+    } else if (err != ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGE(TAG, "Error (%s) opening settings namespace", esp_err_to_name(err));
+    }
+
+    if (migrating) {
+        // Written synchronously: the legacy keys are only erased once the blob is safe
+        err = write_blob(&loaded, true);
+        if (err == ESP_OK) {
+            stats.migrated = true;
+            ESP_LOGI(TAG, "Migrated legacy redial settings to a single blob");
+        } else {
+            // A later flush would write the blob without the erase, and the next boot
+            // would never look at the legacy keys again; keep retrying from the flush task
+            ESP_LOGE(TAG, "Error (%s) migrating legacy settings; will retry", esp_err_to_name(err));
+            legacy_erase_pending = true;
+        }
+    }
+
+    flush_mutex = xSemaphoreCreateMutex();
+    if (flush_mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    flush_delay_ms = delay_ms > 0 ? delay_ms : 1;
+    current = loaded;
+    generation = needs_write ? 1 : 0;
+    flushed_generation = 0;
+    stats.dirty = needs_write;
+
+    if (xTaskCreate(settings_flush_task, "settings_flush", SETTINGS_STORE_TASK_STACK, NULL,
+                    SETTINGS_STORE_TASK_PRIORITY, &flush_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create settings flush task");
+        settings_store_deinit();
+        return ESP_ERR_NO_MEM;
+    }
+    if (!shutdown_handler_registered) {
+        // Only registered once; it is a no-op while nothing is dirty or after deinit
+        shutdown_handler_registered = esp_register_shutdown_handler(settings_store_shutdown) == ESP_OK;
+    }
+    if (needs_write || legacy_erase_pending) {
+        xTaskNotifyGive(flush_task);
+    }
+
+    *out = loaded;
+    return ESP_OK;
+}
+
+void settings_store_get(settings_t *out)
+{
+    portENTER_CRITICAL(&lock);
+    *out = current;
+    portEXIT_CRITICAL(&lock);
+}
+
+void settings_store_update(const settings_t *settings)
+{
+    portENTER_CRITICAL(&lock);
+    bool changed = !settings_equal(&current, settings);
+    if (changed) {
+        current = *settings;
+        generation++;
+        stats.updates++;
+        stats.dirty = true;
+    } else {
+        stats.unchanged++;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (changed && flush_task != NULL) {
+        xTaskNotifyGive(flush_task);
+    }
+}
+
+void settings_store_get_stats(settings_store_stats_t *out)
+{
+    portENTER_CRITICAL(&lock);
+    *out = stats;
+    portEXIT_CRITICAL(&lock);
+}
+
+void settings_store_deinit(void)
+{
+    if (flush_mutex) {
+        xSemaphoreTake(flush_mutex, portMAX_DELAY); // Never stop the task mid-write
+    }
+    if (flush_task) {
+        vTaskDelete(flush_task);
+        flush_task = NULL;
+    }
+    if (flush_mutex) {
+        vSemaphoreDelete(flush_mutex);
+        flush_mutex = NULL;
+    }
+    legacy_erase_pending = false;
+    portENTER_CRITICAL(&lock);
+    settings_defaults(&current);
+    generation = 0;
+    flushed_generation = 0;
+    memset(&stats, 0, sizeof(stats));
+    portEXIT_CRITICAL(&lock);
+}
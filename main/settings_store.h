@@ -0,0 +1,79 @@
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Auto redial settings persisted as one versioned, CRC-checked NVS blob. Updates only
+// change the RAM copy and mark it dirty; a low-priority task writes the blob once the
+// settings have been quiet for the flush delay, so a burst of UI changes costs one
+// flash write and callers (including the HFP callback) never wait on flash.
+#define SETTINGS_STORE_NAMESPACE "redial_config"
+#define SETTINGS_STORE_KEY "settings"
+#define SETTINGS_STORE_TASK_STACK 3072
+#define SETTINGS_STORE_TASK_PRIORITY 2
+#define SETTINGS_STORE_MAX_DEFER_FACTOR 10 // Continuous updates still flush after this many delays
+
+// Blob layout: header (magic, version, payload length), payload fields in a fixed
+// little-endian order, CRC-32 of everything before it. Newer firmware only appends
+// fields, so a shorter payload from older firmware decodes with defaults for the rest.
+#define SETTINGS_BLOB_MAGIC 0x5248 // "RH"
+#define SETTINGS_BLOB_VERSION 1
+#define SETTINGS_BLOB_HEADER_SIZE 6
+#define SETTINGS_BLOB_PAYLOAD_SIZE 18
+#define SETTINGS_BLOB_SIZE (SETTINGS_BLOB_HEADER_SIZE + SETTINGS_BLOB_PAYLOAD_SIZE + 4)
+#define SETTINGS_BLOB_MAX_SIZE 256 // Largest blob accepted from a future version
+
+typedef struct {
+    bool auto_redial_enabled;
+    uint32_t redial_period_s;
+    uint32_t redial_random_delay_s;
+    uint32_t redial_max_count;   // 0 = infinite
+    uint8_t redial_mode;         // redial_mode_t
+    uint32_t redial_guard_s;
+} settings_t;
+
+typedef struct {
+    uint32_t updates;        // Update calls that changed a setting
+    uint32_t unchanged;      // Update calls that changed nothing and needed no write
+    uint32_t flushes;        // Blob writes committed to NVS
+    uint32_t bytes_written;  // Blob bytes handed to NVS
+    uint32_t flush_errors;
+    uint32_t load_errors;    // Stored blobs rejected at boot (bad CRC, magic or size)
+    bool migrated;           // The legacy per-key settings were converted (or erased) this boot
+    bool dirty;              // Changes not yet on flash
+} settings_store_stats_t;
+
+void settings_defaults(settings_t *settings);
+
+uint32_t settings_crc32(const uint8_t *data, size_t len);
+
+// Serialize into buf (at least SETTINGS_BLOB_SIZE bytes). Returns the blob length.
+size_t settings_blob_encode(const settings_t *settings, uint8_t *buf, size_t buf_len);
+
+// Parse a stored blob. Returns ESP_ERR_INVALID_SIZE, ESP_ERR_INVALID_CRC or
+// ESP_ERR_INVALID_VERSION (bad magic) without touching out.
+esp_err_t settings_blob_decode(const uint8_t *buf, size_t len, settings_t *out);
+
+// Load the blob (migrating the legacy keys on first boot, falling back to defaults)
+// into out and start the flush task. NVS must already be initialized.
+esp_err_t settings_store_init(uint32_t flush_delay_ms, settings_t *out);
+
+void settings_store_get(settings_t *out);
+
+// Replace the settings. Marks them dirty and restarts the quiet period if anything
+// changed; never touches flash itself.
+void settings_store_update(const settings_t *settings);
+
+// Write pending changes now, on the calling task. Registered as a shutdown handler so
+// esp_restart() never loses them; also safe to call when nothing is dirty.
+esp_err_t settings_store_flush(void);
+
+void settings_store_get_stats(settings_store_stats_t *out);
+
+// Stop the flush task and forget the RAM copy (used by tests)
+void settings_store_deinit(void);
+
+#endif // SETTINGS_STORE_H
@@ -0,0 +1,144 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "static_cache.h"
+
+#define TAG "STATIC_CACHE"
+
+static static_cache_entry_t *lru_head = NULL; // Most recently used
+static static_cache_entry_t *lru_tail = NULL; // Least recently used
+static static_cache_stats_t cache_stats = {0};
+
+static void lru_unlink(static_cache_entry_t *entry)
+{
+    if (entry->prev) entry->prev->next = entry->next;
+    else lru_head = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else lru_tail = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+static void lru_push_front(static_cache_entry_t *entry)
+{
+    entry->prev = NULL;
+    entry->next = lru_head;
+    if (lru_head) lru_head->prev = entry;
+    lru_head = entry;
+    if (!lru_tail) lru_tail = entry;
+}
+
+static void evict_entry(static_cache_entry_t *entry)
+{
+    lru_unlink(entry);
+    cache_stats.bytes_used -= entry->len;
+    cache_stats.entries--;
+    free(entry); // Key and data live in the same allocation
+}
+
+void static_cache_clear(void)
+{
+    while (lru_tail) {
+        evict_entry(lru_tail);
+    }
+}
+
+esp_err_t static_cache_init(size_t capacity_bytes, size_t max_entry_bytes)
+{
+    static_cache_clear();
+    if (max_entry_bytes > capacity_bytes) {
+        max_entry_bytes = capacity_bytes;
+    }
+    cache_stats.capacity_bytes = capacity_bytes;
+    cache_stats.max_entry_bytes = max_entry_bytes;
+    ESP_LOGI(TAG, "Static file cache: %u bytes, files up to %u bytes",
+             (unsigned)capacity_bytes, (unsigned)max_entry_bytes);
+    return ESP_OK;
+}
+
+const static_cache_entry_t *static_cache_get(const char *key)
+{
+    for (static_cache_entry_t *entry = lru_head; entry != NULL; entry = entry->next) {
+        if (strcmp(entry->key, key) == 0) {
+            if (entry != lru_head) {
+                lru_unlink(entry);
+                lru_push_front(entry);
+            }
+            cache_stats.hits++;
+            return entry;
+        }
+    }
+    cache_stats.misses++;
+    return NULL;
+}
+
+bool static_cache_accepts(size_t len)
+{
+    return len > 0 && len <= cache_stats.max_entry_bytes;
+}
+
+static_cache_entry_t *static_cache_reserve(const char *key, size_t len)
+{
+    if (!static_cache_accepts(len)) {
+        return NULL;
+    }
+
+    // Replace a stale copy rather than holding two
+    for (static_cache_entry_t *entry = lru_head; entry != NULL; entry = entry->next) {
+        if (strcmp(entry->key, key) == 0) {
+            evict_entry(entry);
+            break;
+        }
+    }
+
+    while (lru_tail && cache_stats.bytes_used + len > cache_stats.capacity_bytes) {
+        ESP_LOGD(TAG, "Evicting %s", lru_tail->key);
+        evict_entry(lru_tail);
+        cache_stats.evictions++;
+    }
+
+    // One allocation per entry: header, then key, then file data
+    size_t key_len = strlen(key) + 1;
+    static_cache_entry_t *entry = (static_cache_entry_t *)malloc(sizeof(static_cache_entry_t) + key_len + len);
+    if (!entry) {
+        ESP_LOGW(TAG, "No memory to cache %s (%u bytes)", key, (unsigned)len);
+        return NULL;
+    }
+    char *key_copy = (char *)(entry + 1);
+    memcpy(key_copy, key, key_len);
+    entry->prev = entry->next = NULL;
+    entry->key = key_copy;
+    entry->data = (uint8_t *)key_copy + key_len;
+    entry->len = len;
+    return entry;
+}
+
+void static_cache_commit(static_cache_entry_t *entry)
+{
+    lru_push_front(entry);
+    cache_stats.bytes_used += entry->len;
+    cache_stats.entries++;
+    cache_stats.insertions++;
+}
+
+void static_cache_discard(static_cache_entry_t *entry)
+{
+    free(entry);
+}
+
+const static_cache_entry_t *static_cache_put(const char *key, const uint8_t *data, size_t len)
+{
+    static_cache_entry_t *entry = static_cache_reserve(key, len);
+    if (!entry) {
+        return NULL;
+    }
+    memcpy(entry->data, data, len);
+    static_cache_commit(entry);
+    return entry;
+}
+
+void static_cache_get_stats(static_cache_stats_t *stats)
+{
+    *stats = cache_stats;
+}
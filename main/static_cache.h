@@ -0,0 +1,54 @@
+#ifndef STATIC_CACHE_H
+#define STATIC_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Bounded in-RAM LRU cache for small, hot static files served from SPIFFS.
+// Not thread-safe: only the static file handler on the httpd task touches it.
+
+typedef struct static_cache_entry {
+    struct static_cache_entry *prev; // Towards most recently used
+    struct static_cache_entry *next; // Towards least recently used
+    const char *key;                 // Full file path, e.g. "/spiffs/index.html.gz"
+    uint8_t *data;
+    size_t len;
+} static_cache_entry_t;
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t insertions;
+    uint32_t evictions;
+    uint32_t entries;
+    size_t bytes_used;
+    size_t capacity_bytes;
+    size_t max_entry_bytes;
+} static_cache_stats_t;
+
+// Configure the cache; capacity 0 disables caching. Clears any cached entries.
+esp_err_t static_cache_init(size_t capacity_bytes, size_t max_entry_bytes);
+
+// Look up a file and mark it most recently used; NULL on miss
+const static_cache_entry_t *static_cache_get(const char *key);
+
+// Check whether a file of this size is eligible for caching
+bool static_cache_accepts(size_t len);
+
+// Reserve an entry for a file of len bytes, evicting least recently used entries to make room.
+// The caller fills entry->data and then either commits or discards it; NULL if not cacheable.
+static_cache_entry_t *static_cache_reserve(const char *key, size_t len);
+void static_cache_commit(static_cache_entry_t *entry);
+void static_cache_discard(static_cache_entry_t *entry);
+
+// Copy a buffer into the cache (reserve + memcpy + commit)
+const static_cache_entry_t *static_cache_put(const char *key, const uint8_t *data, size_t len);
+
+// Drop all entries (counters are kept)
+void static_cache_clear(void);
+
+void static_cache_get_stats(static_cache_stats_t *stats);
+
+#endif // STATIC_CACHE_H
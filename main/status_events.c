@@ -0,0 +1,198 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "device_status.h"
+#include "status_events.h"
+
+#define TAG "STATUS_EVENTS"
+
+static const char sse_response_header[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"
+    "retry: 3000\n\n"; // Reconnect delay hint for EventSource
+
+static const char sse_keepalive[] = ": keepalive\n\n";
+
+// Subscriber list and last pushed snapshot are only touched on the httpd task
+static httpd_handle_t events_server = NULL;
+static int subscriber_fds[STATUS_EVENTS_MAX_SUBSCRIBERS];
+static int subscriber_count = 0;
+static device_status_t last_pushed;
+static bool last_pushed_valid = false;
+
+static atomic_bool push_pending = false;
+static esp_timer_handle_t keepalive_timer = NULL;
+
+static void remove_subscriber(int sockfd)
+{
+    for (int i = 0; i < subscriber_count; i++) {
+        if (subscriber_fds[i] == sockfd) {
+            subscriber_fds[i] = subscriber_fds[--subscriber_count];
+            ESP_LOGI(TAG, "Event subscriber %d removed (%d left)", sockfd, subscriber_count);
+            return;
+        }
+    }
+}
+
+// Send a whole buffer; on failure the session is closed and close_fn drops the subscriber
+static bool send_to_subscriber(int sockfd, const char *buf, size_t len)
+{
+    while (len > 0) {
+        int sent = httpd_socket_send(events_server, sockfd, buf, len, 0);
+        if (sent < 0) {
+            ESP_LOGW(TAG, "Send to event subscriber %d failed, closing", sockfd);
+            httpd_sess_trigger_close(events_server, sockfd);
+            return false;
+        }
+        buf += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+static bool send_status_event(int sockfd, const char *json)
+{
+    char prefix[] = "data: ";
+    return send_to_subscriber(sockfd, prefix, strlen(prefix)) &&
+           send_to_subscriber(sockfd, json, strlen(json)) &&
+           send_to_subscriber(sockfd, "\n\n", 2);
+}
+
+// Runs on the httpd task via httpd_queue_work
+static void push_changes_work(void *arg)
+{
+    atomic_store(&push_pending, false);
+    if (events_server == NULL || subscriber_count == 0) {
+        last_pushed_valid = false;
+        return;
+    }
+
+    device_status_t current;
+    device_status_capture(&current);
+    if (last_pushed_valid && device_status_equal(&current, &last_pushed)) {
+        return;
+    }
+
+    char json[DEVICE_STATUS_JSON_MAX];
+    int len = device_status_write_json(&current, last_pushed_valid ? &last_pushed : NULL, json, sizeof(json));
+    last_pushed = current;
+    last_pushed_valid = true;
+    if (len < 0) {
+        ESP_LOGE(TAG, "Status event does not fit in %d bytes", DEVICE_STATUS_JSON_MAX);
+        return;
+    }
+
+    // Iterate backwards so a failed send can drop the subscriber safely
+    for (int i = subscriber_count - 1; i >= 0; i--) {
+        send_status_event(subscriber_fds[i], json);
+    }
+}
+
+static void keepalive_work(void *arg)
+{
+    for (int i = subscriber_count - 1; i >= 0; i--) {
+        send_to_subscriber(subscriber_fds[i], sse_keepalive, strlen(sse_keepalive));
+    }
+}
+
+static void keepalive_timer_callback(void *arg)
+{
+    if (events_server != NULL && subscriber_count > 0) {
+        httpd_queue_work(events_server, keepalive_work, NULL);
+    }
+}
+
+void status_events_notify(void)
+{
+    if (events_server == NULL) {
+        return;
+    }
+    // Only queue one push at a time; it reads the latest state when it runs
+    if (!atomic_exchange(&push_pending, true)) {
+        if (httpd_queue_work(events_server, push_changes_work, NULL) != ESP_OK) {
+            atomic_store(&push_pending, false);
+        }
+    }
+}
+
+void status_events_start(httpd_handle_t server)
+{
+    events_server = server;
+    subscriber_count = 0;
+    last_pushed_valid = false;
+    atomic_store(&push_pending, false);
+
+    if (keepalive_timer == NULL) {
+        const esp_timer_create_args_t keepalive_timer_args = {
+            .callback = &keepalive_timer_callback,
+            .name = "sse_keepalive"
+        };
+        if (esp_timer_create(&keepalive_timer_args, &keepalive_timer) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create keepalive timer");
+            return;
+        }
+    }
+    if (!esp_timer_is_active(keepalive_timer)) {
+        esp_timer_start_periodic(keepalive_timer, (uint64_t)STATUS_EVENTS_KEEPALIVE_MS * 1000);
+    }
+}
+
+void status_events_stop(void)
+{
+    if (keepalive_timer != NULL && esp_timer_is_active(keepalive_timer)) {
+        esp_timer_stop(keepalive_timer);
+    }
+    events_server = NULL;
+    subscriber_count = 0;
+    last_pushed_valid = false;
+}
+
+void status_events_socket_closed(int sockfd)
+{
+    remove_subscriber(sockfd);
+}
+
+esp_err_t status_events_handler(httpd_req_t *req)
+{
+    if (subscriber_count >= STATUS_EVENTS_MAX_SUBSCRIBERS) {
+        // The web app falls back to polling /status
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_type(req, "application/json");
+        return httpd_resp_sendstr(req, "{\"error\":\"Too many event subscribers\"}");
+    }
+
+    int sockfd = httpd_req_to_sockfd(req);
+
+    // Bring existing subscribers up to date first, so the newcomer's full snapshot
+    // and everyone else's view agree and later diffs apply to all of them
+    if (subscriber_count > 0) {
+        push_changes_work(NULL);
+    } else {
+        device_status_capture(&last_pushed);
+        last_pushed_valid = true;
+    }
+
+    char json[DEVICE_STATUS_JSON_MAX];
+    if (device_status_write_json(&last_pushed, NULL, json, sizeof(json)) < 0) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Status too large");
+        return ESP_FAIL;
+    }
+
+    // Write the response header ourselves: the stream never completes, so it cannot
+    // go through httpd_resp_send*, and the socket stays open after we return
+    bool ok = send_to_subscriber(sockfd, sse_response_header, strlen(sse_response_header)) &&
+              send_status_event(sockfd, json);
+    if (!ok) {
+        return ESP_FAIL;
+    }
+
+    subscriber_fds[subscriber_count++] = sockfd;
+    ESP_LOGI(TAG, "Event subscriber %d added (%d total)", sockfd, subscriber_count);
+    return ESP_OK;
+}
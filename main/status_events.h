@@ -0,0 +1,26 @@
+#ifndef STATUS_EVENTS_H
+#define STATUS_EVENTS_H
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Server-Sent Events channel for device state (GET /events).
+// Each subscriber first receives the full status, then only the fields that changed.
+#define STATUS_EVENTS_MAX_SUBSCRIBERS 3
+#define STATUS_EVENTS_KEEPALIVE_MS 15000
+
+// Attach to a freshly started web server / detach before it is stopped
+void status_events_start(httpd_handle_t server);
+void status_events_stop(void);
+
+// GET /events handler: keeps the socket open as an event stream
+esp_err_t status_events_handler(httpd_req_t *req);
+
+// Must be called from the server's close_fn so dead subscribers are dropped
+void status_events_socket_closed(int sockfd);
+
+// Push changed fields to all subscribers. Safe to call from any task; bursts of
+// calls are coalesced into a single push on the httpd task.
+void status_events_notify(void);
+
+#endif // STATUS_EVENTS_H
@@ -0,0 +1,133 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "wifi_cache.h"
+
+#define TAG "WIFI_CACHE"
+
+// Guarded by lock: the blob last read from or written to flash, so an unchanged AP
+// is not written again. Loads and stores come from different tasks.
+static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t on_flash[WIFI_CACHE_BLOB_SIZE];
+static bool on_flash_known;
+
+void wifi_cache_set(wifi_cache_t *cache, const char *ssid, const uint8_t bssid[6], uint8_t channel)
+{
+    memset(cache, 0, sizeof(*cache));
+    cache->ssid_len = (uint8_t)strnlen(ssid, WIFI_CACHE_SSID_MAX);
+    memcpy(cache->ssid, ssid, cache->ssid_len);
+    memcpy(cache->bssid, bssid, sizeof(cache->bssid));
+    cache->channel = channel;
+}
+
+bool wifi_cache_matches(const wifi_cache_t *cache, const char *ssid)
+{
+    size_t len = strnlen(ssid, WIFI_CACHE_SSID_MAX);
+    return len == cache->ssid_len && memcmp(cache->ssid, ssid, len) == 0;
+}
+
+size_t wifi_cache_encode(const wifi_cache_t *cache, uint8_t *buf, size_t buf_len)
+{
+    if (buf_len < WIFI_CACHE_BLOB_SIZE) {
+        return 0;
+    }
+    memset(buf, 0, WIFI_CACHE_BLOB_SIZE);
+    buf[0] = (uint8_t)WIFI_CACHE_BLOB_MAGIC;
+    buf[1] = (uint8_t)(WIFI_CACHE_BLOB_MAGIC >> 8);
+    buf[2] = WIFI_CACHE_BLOB_VERSION;
+    buf[3] = cache->ssid_len;
+    memcpy(buf + 4, cache->ssid, cache->ssid_len);
+    memcpy(buf + 4 + WIFI_CACHE_SSID_MAX, cache->bssid, sizeof(cache->bssid));
+    buf[4 + WIFI_CACHE_SSID_MAX + 6] = cache->channel;
+    return WIFI_CACHE_BLOB_SIZE;
+}
+
+esp_err_t wifi_cache_decode(const uint8_t *buf, size_t len, wifi_cache_t *out)
+{
+    if (len != WIFI_CACHE_BLOB_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint8_t channel = buf[4 + WIFI_CACHE_SSID_MAX + 6];
+    if ((buf[0] | (buf[1] << 8)) != WIFI_CACHE_BLOB_MAGIC || buf[2] != WIFI_CACHE_BLOB_VERSION ||
+        buf[3] == 0 || buf[3] > WIFI_CACHE_SSID_MAX || channel == 0) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    memset(out, 0, sizeof(*out));
+    out->ssid_len = buf[3];
+    memcpy(out->ssid, buf + 4, out->ssid_len);
+    memcpy(out->bssid, buf + 4 + WIFI_CACHE_SSID_MAX, sizeof(out->bssid));
+    out->channel = channel;
+    return ESP_OK;
+}
+
+static void remember_on_flash(const uint8_t *blob)
+{
+    portENTER_CRITICAL(&lock);
+    memcpy(on_flash, blob, WIFI_CACHE_BLOB_SIZE);
+    on_flash_known = true;
+    portEXIT_CRITICAL(&lock);
+}
+
+esp_err_t wifi_cache_load(const char *ssid, wifi_cache_t *out)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(WIFI_CACHE_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return err == ESP_ERR_NVS_NOT_FOUND ? ESP_ERR_NOT_FOUND : err;
+    }
+    uint8_t blob[WIFI_CACHE_BLOB_SIZE];
+    size_t len = sizeof(blob);
+    err = nvs_get_blob(handle, WIFI_CACHE_KEY, blob, &len);
+    nvs_close(handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (err == ESP_OK) {
+        err = wifi_cache_decode(blob, len, out);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Cached AP unusable (%s), scanning instead", esp_err_to_name(err));
+        return ESP_ERR_NOT_FOUND;
+    }
+    remember_on_flash(blob);
+    return wifi_cache_matches(out, ssid) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t wifi_cache_store(const wifi_cache_t *cache)
+{
+    uint8_t blob[WIFI_CACHE_BLOB_SIZE];
+    wifi_cache_encode(cache, blob, sizeof(blob));
+    portENTER_CRITICAL(&lock);
+    bool unchanged = on_flash_known && memcmp(on_flash, blob, sizeof(blob)) == 0;
+    portEXIT_CRITICAL(&lock);
+    if (unchanged) {
+        return ESP_OK;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(WIFI_CACHE_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, WIFI_CACHE_KEY, blob, sizeof(blob));
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error (%s) saving the cached AP", esp_err_to_name(err));
+        return err;
+    }
+    remember_on_flash(blob);
+    ESP_LOGI(TAG, "Cached AP %02x:%02x:%02x:%02x:%02x:%02x on channel %u", cache->bssid[0], cache->bssid[1],
+             cache->bssid[2], cache->bssid[3], cache->bssid[4], cache->bssid[5], cache->channel);
+    return ESP_OK;
+}
+
+void wifi_cache_reset(void)
+{
+    portENTER_CRITICAL(&lock);
+    on_flash_known = false;
+    portEXIT_CRITICAL(&lock);
+}
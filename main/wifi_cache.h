@@ -0,0 +1,52 @@
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// The AP the station last got an address from, kept in NVS so a reconnect can go
+// straight to its BSSID on its channel instead of scanning every channel first.
+// Tied to the SSID it was learned for: new credentials simply miss the cache.
+#define WIFI_CACHE_NAMESPACE "redial_config"
+#define WIFI_CACHE_KEY "wifi_ap"
+#define WIFI_CACHE_SSID_MAX 32 // As in wifi_sta_config_t; not terminated when full
+
+// Blob layout: magic (2), version (1), SSID length (1), SSID (32, zero padded),
+// BSSID (6), channel (1)
+#define WIFI_CACHE_BLOB_MAGIC 0x5743 // "WC"
+#define WIFI_CACHE_BLOB_VERSION 1
+#define WIFI_CACHE_BLOB_SIZE (4 + WIFI_CACHE_SSID_MAX + 6 + 1)
+
+typedef struct {
+    uint8_t ssid[WIFI_CACHE_SSID_MAX];
+    uint8_t ssid_len;
+    uint8_t bssid[6];
+    uint8_t channel;
+} wifi_cache_t;
+
+// Fill cache from the connected AP's details
+void wifi_cache_set(wifi_cache_t *cache, const char *ssid, const uint8_t bssid[6], uint8_t channel);
+
+bool wifi_cache_matches(const wifi_cache_t *cache, const char *ssid);
+
+// Serialize into buf (at least WIFI_CACHE_BLOB_SIZE bytes). Returns the blob length, or
+// 0 if buf is too small.
+size_t wifi_cache_encode(const wifi_cache_t *cache, uint8_t *buf, size_t buf_len);
+
+// Parse a stored blob. ESP_ERR_INVALID_SIZE or ESP_ERR_INVALID_VERSION (bad magic,
+// version or field) without touching out.
+esp_err_t wifi_cache_decode(const uint8_t *buf, size_t len, wifi_cache_t *out);
+
+// Read the cached AP for ssid. ESP_ERR_NOT_FOUND if nothing usable is stored for it.
+esp_err_t wifi_cache_load(const char *ssid, wifi_cache_t *out);
+
+// Persist cache unless it is what was last loaded or stored, so reconnecting to the
+// same AP costs no flash write
+esp_err_t wifi_cache_store(const wifi_cache_t *cache);
+
+// Forget the RAM copy of what is on flash (used by tests)
+void wifi_cache_reset(void);
+
+#endif // WIFI_CACHE_H
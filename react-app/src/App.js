@@ -1,6 +1,9 @@
 import './index.css';
 import './fallback-tailwind.css';
-import React, { useState, useEffect, useCallback } from 'react';
+import React, { useState, useEffect, useCallback, useRef } from 'react';
+
+// Fallback polling interval used while the /events stream is unavailable
+const STATUS_POLL_INTERVAL_MS = 5000;
 
 // Main App component for the ESP32 Bluetooth Redial Controller
 const App = () => {
@@ -34,6 +37,30 @@ const App = () => {
   // New state for redial count limiting
   const [redialMaxCount, setRedialMaxCount] = useState(0); // 0 = infinite
   const [redialCurrentCount, setRedialCurrentCount] = useState(0);
+  // True while the ESP32's /events stream is open; polling pauses during that time
+  const [eventStreamActive, setEventStreamActive] = useState(false);
+  // Latest full status, so partial updates from /events can be merged into it
+  const lastStatusRef = useRef({});
+
+  // Apply a full (/status) or partial (/events) status report from the ESP32
+  const applyStatus = useCallback((update) => {
+    const data = { ...lastStatusRef.current, ...update };
+    lastStatusRef.current = data;
+    setIsConnectedToEsp32(true);
+    setIsBluetoothConnected(data.bluetooth_connected);
+    setEsp32WifiMode(data.wifi_mode);
+    setAutoRedialEnabled(data.auto_redial_enabled);
+    setRedialPeriod(data.redial_period);
+    setRedialRandomDelay(data.redial_random_delay || 0);
+    setLastRandomDelay(data.last_random_delay || 0);
+    setLastCallFailed(!!data.last_call_failed); // New
+    setRedialMaxCount(data.redial_max_count || 0); // New
+    setRedialCurrentCount(data.redial_current_count || 0); // New
+    // If ESP32 is in STA mode, update IP to the one reported by ESP32 (if available)
+    if (data.wifi_mode === 'STA' && data.ip_address) {
+      setEsp32Ip(data.ip_address);
+    }
+  }, []);
 
   // Function to send commands to the ESP32
   const sendCommand = useCallback(async (endpoint, method = 'GET', body = null) => {
@@ -56,20 +83,9 @@ const App = () => {
       if (response.ok) {
         setStatusMessage(`Command "${endpoint}" successful: ${data.message || JSON.stringify(data)}`);
         if (endpoint === 'status') {
-          setIsConnectedToEsp32(true);
-          setIsBluetoothConnected(data.bluetooth_connected);
-          setEsp32WifiMode(data.wifi_mode);
-          setAutoRedialEnabled(data.auto_redial_enabled);
-          setRedialPeriod(data.redial_period);
-          setRedialRandomDelay(data.redial_random_delay || 0);
-          setLastRandomDelay(data.last_random_delay || 0);
-          setLastCallFailed(!!data.last_call_failed); // New
-          setRedialMaxCount(data.redial_max_count || 0); // New
-          setRedialCurrentCount(data.redial_current_count || 0); // New
-          // If ESP32 is in STA mode, update IP to the one reported by ESP32 (if available)
-          if (data.wifi_mode === 'STA' && data.ip_address) {
-            setEsp32Ip(data.ip_address);
-          }
+          // A full report replaces whatever was merged from earlier events
+          lastStatusRef.current = {};
+          applyStatus(data);
         } else if (endpoint === 'configure_wifi') {
           // After configuring, assume ESP32 will reboot or switch, so clear connection status and let status polling update IP
           setStatusMessage('Wi-Fi configured. ESP32 is switching to home network. The IP address will be automatically updated when the device reconnects.');
@@ -78,13 +94,15 @@ const App = () => {
         }
       } else {
         setStatusMessage(`Error sending "${endpoint}" command: ${data.error || response.statusText}`);
-        setIsConnectedToEsp32(false); // If error, assume connection lost
+        if (response.status !== 429) {
+          setIsConnectedToEsp32(false); // If error, assume connection lost (429 only means the device is busy)
+        }
       }
     } catch (error) {
       setStatusMessage(`Network error for "${endpoint}": ${error.message}. Ensure ESP32 IP is correct and device is reachable.`);
       setIsConnectedToEsp32(false); // If network error, assume connection lost
     }
-  }, [esp32Ip]);
+  }, [esp32Ip, applyStatus]);
 
   // Handler for the "Redial Last Number" button
   const handleRedial = () => {
@@ -182,12 +200,41 @@ const App = () => {
     sendCommand('status');
   }, [sendCommand]);
 
-  // Check status automatically when component mounts and every 5 seconds
+  // Check status once when the component mounts or the IP changes
   useEffect(() => {
     checkStatus(); // Initial check
-    const interval = setInterval(checkStatus, 5000); // Check every 5 seconds
+  }, [esp32Ip, checkStatus]);
+
+  // Subscribe to pushed status changes; the ESP32 sends the full status first, then only changed fields
+  useEffect(() => {
+    if (typeof window.EventSource === 'undefined') {
+      return undefined; // No SSE support, rely on polling
+    }
+    const source = new window.EventSource(`http://${esp32Ip}/events`);
+    source.onopen = () => setEventStreamActive(true);
+    source.onmessage = (event) => {
+      try {
+        applyStatus(JSON.parse(event.data));
+      } catch (e) {
+        // Ignore malformed events, the next one or a poll will resync
+      }
+    };
+    // EventSource reconnects on its own; polling covers the gap (and 503 when the device is full)
+    source.onerror = () => setEventStreamActive(false);
+    return () => {
+      source.close();
+      setEventStreamActive(false);
+    };
+  }, [esp32Ip, applyStatus]);
+
+  // Poll status every 5 seconds only while the event stream is not delivering updates
+  useEffect(() => {
+    if (eventStreamActive) {
+      return undefined;
+    }
+    const interval = setInterval(checkStatus, STATUS_POLL_INTERVAL_MS);
     return () => clearInterval(interval); // Cleanup interval on unmount
-  }, [esp32Ip, checkStatus]); // Added checkStatus to dependency array
+  }, [checkStatus, eventStreamActive]);
 
   return (
     <div className="min-h-screen bg-gradient-to-br from-blue-100 to-purple-200 flex items-center justify-center p-4 font-sans">
@@ -1,5 +1,5 @@
 import React from 'react';
-import { render, screen, waitFor } from '@testing-library/react';
+import { render, screen, waitFor, act } from '@testing-library/react';
 import userEvent from '@testing-library/user-event';
 import App from './App';
 
@@ -501,4 +501,102 @@ describe('Redial Count Limiting', () => {
       expect(screen.getByText('5')).toBeInTheDocument(); // Just "5"
     });
   });
-});
\ No newline at end of file
+});
+
+describe('Server-Sent Events', () => {
+  // Minimal EventSource stand-in that records every stream the app opens
+  class MockEventSource {
+    static instances = [];
+
+    constructor(url) {
+      this.url = url;
+      this.closed = false;
+      MockEventSource.instances.push(this);
+    }
+
+    emit(data) {
+      this.onmessage({ data: JSON.stringify(data) });
+    }
+
+    close() {
+      this.closed = true;
+    }
+  }
+
+  beforeEach(() => {
+    fetch.mockClear();
+    MockEventSource.instances = [];
+    window.EventSource = MockEventSource;
+    delete window.location;
+    window.location = { hostname: 'localhost' };
+    fetch.mockResolvedValue({
+      ok: true,
+      json: async () => ({
+        bluetooth_connected: false,
+        wifi_mode: 'STA',
+        ip_address: '192.168.4.1',
+        auto_redial_enabled: false,
+        redial_period: 60,
+        message: 'Bluetooth disconnected'
+      })
+    });
+  });
+
+  afterEach(() => {
+    delete window.EventSource;
+    jest.useRealTimers();
+  });
+
+  test('subscribes to the /events stream', async () => {
+    render(<App />);
+    await waitFor(() => {
+      expect(MockEventSource.instances.length).toBeGreaterThan(0);
+    });
+    expect(MockEventSource.instances[0].url).toBe('http://192.168.4.1/events');
+  });
+
+  test('applies partial updates pushed by the ESP32', async () => {
+    render(<App />);
+    await waitFor(() => {
+      expect(screen.getByText('Disconnected from Phone')).toBeInTheDocument();
+    });
+
+    const source = MockEventSource.instances[MockEventSource.instances.length - 1];
+    act(() => {
+      source.onopen();
+      source.emit({ bluetooth_connected: true, message: 'Bluetooth connected' });
+    });
+
+    await waitFor(() => {
+      expect(screen.getByText('Connected to Phone')).toBeInTheDocument();
+    });
+    // Fields not in the update keep their previous values
+    expect(screen.getByText('STA')).toBeInTheDocument();
+  });
+
+  test('stops polling while the event stream is open', async () => {
+    jest.useFakeTimers();
+    render(<App />);
+    await waitFor(() => {
+      expect(fetch).toHaveBeenCalledTimes(1);
+    });
+
+    const source = MockEventSource.instances[MockEventSource.instances.length - 1];
+    act(() => {
+      source.onopen();
+    });
+    act(() => {
+      jest.advanceTimersByTime(20000);
+    });
+    expect(fetch).toHaveBeenCalledTimes(1);
+
+    // Losing the stream brings polling back
+    act(() => {
+      source.onerror();
+    });
+    act(() => {
+      jest.advanceTimersByTime(5000);
+    });
+    expect(fetch).toHaveBeenCalledTimes(2);
+  });
+});
@@ -0,0 +1,53 @@
+#include "unity.h"
+#include <string.h>
+#include "asset_manifest.h"
+
+static const char *sample_manifest =
+    "/static/js/main.1a2b3c4d.js 0123456789abcdef 1\n"
+    "/index.html fedcba9876543210 1\n"
+    "/favicon.png 00112233aabbccdd 0\n";
+
+// Entries are found by exact path regardless of the order in the file
+void test_asset_manifest_lookup(void) {
+    TEST_ASSERT_EQUAL(ESP_OK, asset_manifest_parse(sample_manifest, strlen(sample_manifest)));
+    TEST_ASSERT_EQUAL(3, asset_manifest_count());
+
+    const asset_manifest_entry_t *entry = asset_manifest_find("/index.html");
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_STRING("fedcba9876543210", entry->hash);
+    TEST_ASSERT_TRUE(entry->has_gzip);
+
+    entry = asset_manifest_find("/favicon.png");
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_FALSE(entry->has_gzip);
+
+    TEST_ASSERT_NULL(asset_manifest_find("/missing.js"));
+    asset_manifest_free();
+    TEST_ASSERT_NULL(asset_manifest_find("/index.html"));
+}
+
+// If-None-Match lists, weak validators and the wildcard
+void test_etag_matches(void) {
+    TEST_ASSERT_TRUE(etag_matches("\"abc\"", "\"abc\""));
+    TEST_ASSERT_TRUE(etag_matches("\"x\", \"abc\"", "\"abc\""));
+    TEST_ASSERT_TRUE(etag_matches("W/\"abc\"", "\"abc\""));
+    TEST_ASSERT_TRUE(etag_matches("*", "\"abc\""));
+    TEST_ASSERT_FALSE(etag_matches("\"abc-gz\"", "\"abc\""));
+    TEST_ASSERT_FALSE(etag_matches("", "\"abc\""));
+    TEST_ASSERT_FALSE(etag_matches(NULL, "\"abc\""));
+}
+
+void test_accept_encoding_gzip(void) {
+    TEST_ASSERT_TRUE(accept_encoding_allows_gzip("gzip, deflate, br"));
+    TEST_ASSERT_TRUE(accept_encoding_allows_gzip("br;q=1.0, GZIP;q=0.5"));
+    TEST_ASSERT_TRUE(accept_encoding_allows_gzip("x-gzip"));
+    TEST_ASSERT_TRUE(accept_encoding_allows_gzip("*"));
+    TEST_ASSERT_FALSE(accept_encoding_allows_gzip("gzip;q=0"));
+    TEST_ASSERT_FALSE(accept_encoding_allows_gzip("deflate, gzip ; q=0.000"));
+    TEST_ASSERT_FALSE(accept_encoding_allows_gzip("*, gzip;q=0")); // Explicit beats wildcard
+    TEST_ASSERT_FALSE(accept_encoding_allows_gzip("*;q=0"));
+    TEST_ASSERT_FALSE(accept_encoding_allows_gzip("deflate, br"));
+    TEST_ASSERT_FALSE(accept_encoding_allows_gzip("gzipx"));
+    TEST_ASSERT_FALSE(accept_encoding_allows_gzip(""));
+    TEST_ASSERT_FALSE(accept_encoding_allows_gzip(NULL));
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+void test_asset_manifest_lookup(void);
+void test_etag_matches(void);
+void test_accept_encoding_gzip(void);
@@ -0,0 +1,150 @@
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+#include "asset_pack.h"
+#include "esp_crc.h"
+
+// Small pack assembled the way tools/pack_assets.py lays it out
+#define PACK_FILES 2
+#define PACK_STRINGS_SIZE 128
+
+typedef struct {
+    asset_pack_header_t header;
+    asset_pack_entry_t entries[PACK_FILES];
+    char strings[PACK_STRINGS_SIZE];
+    uint8_t data[64];
+} test_pack_t;
+
+static test_pack_t pack;
+
+static uint32_t add_string(size_t *used, const char *text) {
+    uint32_t offset = (uint32_t)*used;
+    strcpy(pack.strings + offset, text);
+    *used += strlen(text) + 1;
+    return offset;
+}
+
+static uint32_t add_data(size_t *used, const char *bytes) {
+    uint32_t offset = (uint32_t)(offsetof(test_pack_t, data) + *used);
+    memcpy(pack.data + *used, bytes, strlen(bytes));
+    *used += (strlen(bytes) + 3) & ~3u;
+    return offset;
+}
+
+static void seal_pack(void) {
+    pack.header.index_crc32 = esp_crc32_le(0, (const uint8_t *)pack.entries,
+                                           sizeof(pack.entries) + sizeof(pack.strings));
+}
+
+static void build_pack(void) {
+    memset(&pack, 0, sizeof(pack));
+    size_t strings = 0, data = 0;
+    const char *paths[PACK_FILES] = { "/index.html", "/static/js/main.1a2b.js" };
+    const char *mimes[PACK_FILES] = { "text/html", "application/javascript" };
+    const char *etags[PACK_FILES] = { "\"0011\"", "\"2233\"" };
+    const char *etags_gz[PACK_FILES] = { "\"0011-gz\"", "\"2233-gz\"" };
+    const char *bodies[PACK_FILES] = { "<html></html>", "console.log(1)" };
+
+    asset_pack_entry_t entries[PACK_FILES];
+    for (int i = 0; i < PACK_FILES; i++) {
+        entries[i] = (asset_pack_entry_t){
+            .path_hash = asset_pack_hash(paths[i]),
+            .path = add_string(&strings, paths[i]),
+            .mime = add_string(&strings, mimes[i]),
+            .etag = add_string(&strings, etags[i]),
+            .etag_gzip = add_string(&strings, etags_gz[i]),
+        };
+        entries[i].data_len = strlen(bodies[i]);
+        entries[i].data_offset = add_data(&data, bodies[i]);
+    }
+    // Only index.html has a precompressed copy (contents don't matter here)
+    entries[0].flags = ASSET_PACK_FLAG_GZIP;
+    entries[0].gzip_len = 4;
+    entries[0].gzip_offset = add_data(&data, "\x1f\x8b\x08\x00");
+    TEST_ASSERT_LESS_OR_EQUAL(PACK_STRINGS_SIZE, strings);
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(pack.data), data);
+
+    // The index is sorted by path hash
+    int first = entries[0].path_hash <= entries[1].path_hash ? 0 : 1;
+    pack.entries[0] = entries[first];
+    pack.entries[1] = entries[1 - first];
+
+    pack.header = (asset_pack_header_t){
+        .magic = ASSET_PACK_MAGIC,
+        .version = ASSET_PACK_VERSION,
+        .header_size = sizeof(asset_pack_header_t),
+        .entry_count = PACK_FILES,
+        .entry_size = sizeof(asset_pack_entry_t),
+        .strings_offset = offsetof(test_pack_t, strings),
+        .strings_size = PACK_STRINGS_SIZE,
+        .total_size = sizeof(pack),
+    };
+    seal_pack();
+}
+
+void test_asset_pack_lookup(void) {
+    build_pack();
+    TEST_ASSERT_EQUAL(ESP_OK, asset_pack_attach(&pack, sizeof(pack)));
+    TEST_ASSERT_TRUE(asset_pack_is_mounted());
+    TEST_ASSERT_EQUAL(PACK_FILES, asset_pack_count());
+
+    asset_pack_file_t file;
+    TEST_ASSERT_TRUE(asset_pack_find("/static/js/main.1a2b.js", false, &file));
+    TEST_ASSERT_EQUAL_STRING("application/javascript", file.mime);
+    TEST_ASSERT_EQUAL_STRING("\"2233\"", file.etag);
+    TEST_ASSERT_EQUAL(14, file.len);
+    TEST_ASSERT_EQUAL(0, memcmp(file.data, "console.log(1)", file.len));
+    TEST_ASSERT_FALSE(file.gzip);
+    // Served in place: the body points into the image
+    TEST_ASSERT_TRUE(file.data > (const uint8_t *)&pack && file.data < (const uint8_t *)(&pack + 1));
+
+    TEST_ASSERT_FALSE(asset_pack_find("/missing.html", false, &file));
+    TEST_ASSERT_FALSE(asset_pack_find("/index.htm", true, &file));
+
+    asset_pack_detach();
+    TEST_ASSERT_FALSE(asset_pack_is_mounted());
+    TEST_ASSERT_FALSE(asset_pack_find("/index.html", false, &file));
+}
+
+void test_asset_pack_gzip_preference(void) {
+    build_pack();
+    TEST_ASSERT_EQUAL(ESP_OK, asset_pack_attach(&pack, sizeof(pack)));
+
+    asset_pack_file_t file;
+    TEST_ASSERT_TRUE(asset_pack_find("/index.html", true, &file));
+    TEST_ASSERT_TRUE(file.gzip);
+    TEST_ASSERT_EQUAL_STRING("\"0011-gz\"", file.etag);
+    TEST_ASSERT_EQUAL(4, file.len);
+    TEST_ASSERT_EQUAL(0x1f, file.data[0]);
+
+    TEST_ASSERT_TRUE(asset_pack_find("/index.html", false, &file));
+    TEST_ASSERT_FALSE(file.gzip);
+    TEST_ASSERT_EQUAL_STRING("\"0011\"", file.etag);
+    TEST_ASSERT_EQUAL(0, memcmp(file.data, "<html></html>", file.len));
+
+    // No precompressed copy: identity even when the client takes gzip
+    TEST_ASSERT_TRUE(asset_pack_find("/static/js/main.1a2b.js", true, &file));
+    TEST_ASSERT_FALSE(file.gzip);
+    asset_pack_detach();
+}
+
+void test_asset_pack_rejects_damage(void) {
+    build_pack();
+    pack.header.magic = 0xFFFFFFFF; // Erased flash
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_VERSION, asset_pack_attach(&pack, sizeof(pack)));
+    TEST_ASSERT_FALSE(asset_pack_is_mounted());
+
+    build_pack();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, asset_pack_attach(&pack, sizeof(pack) - 4)); // Truncated
+
+    build_pack();
+    pack.strings[1] ^= 0x20;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, asset_pack_attach(&pack, sizeof(pack)));
+
+    // A consistent CRC does not make an out-of-range offset acceptable
+    build_pack();
+    pack.entries[0].data_len = sizeof(pack);
+    seal_pack();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, asset_pack_attach(&pack, sizeof(pack)));
+    TEST_ASSERT_FALSE(asset_pack_is_mounted());
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+void test_asset_pack_lookup(void);
+void test_asset_pack_gzip_preference(void);
+void test_asset_pack_rejects_damage(void);
@@ -0,0 +1,138 @@
+#include "unity.h"
+#include "at_channel.h"
+
+#define MS 1000
+
+// Answers go to the commands in the order they went out, each timed from when it
+// reached the head of the queue
+void test_at_channel_fifo_correlation(void) {
+    at_channel_t ch;
+    at_channel_init(&ch);
+    at_completion_t done;
+
+    TEST_ASSERT_FALSE(at_channel_answer(&ch, AT_RESULT_OK, 1 * MS, &done)); // Nothing outstanding
+    TEST_ASSERT_EQUAL_UINT32(1, ch.stats.unmatched);
+
+    TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, 10, AT_CMD_DIAL, 100 * MS));
+    TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, 11, AT_CMD_CLCC, 120 * MS));
+    TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, 12, AT_CMD_HANGUP, 130 * MS));
+    TEST_ASSERT_EQUAL_UINT32(11, at_channel_pending_id(&ch, AT_CMD_CLCC));
+    TEST_ASSERT_EQUAL_UINT32(0, at_channel_pending_id(&ch, AT_CMD_REDIAL));
+
+    TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_OK, 900 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(10, done.id);
+    TEST_ASSERT_EQUAL(AT_CMD_DIAL, done.type);
+    TEST_ASSERT_EQUAL(AT_RESULT_OK, done.result);
+    TEST_ASSERT_EQUAL(800 * MS, done.round_trip_us);
+
+    // The query only went on the air once the dial was answered
+    TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_ERROR, 950 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(11, done.id);
+    TEST_ASSERT_EQUAL(AT_RESULT_ERROR, done.result);
+    TEST_ASSERT_EQUAL_UINT32(0, at_channel_pending_id(&ch, AT_CMD_CLCC));
+    TEST_ASSERT_EQUAL(50 * MS, done.round_trip_us);
+
+    TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_OK, 1000 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(12, done.id);
+    TEST_ASSERT_EQUAL(AT_CMD_HANGUP, done.type);
+    TEST_ASSERT_EQUAL(0, ch.count);
+    TEST_ASSERT_EQUAL_UINT32(3, ch.stats.sent);
+    TEST_ASSERT_EQUAL_UINT32(3, ch.stats.answered);
+}
+
+// The queue is bounded, and a command Bluedroid refused can be taken back
+void test_at_channel_depth_and_unsend(void) {
+    at_channel_t ch;
+    at_channel_init(&ch);
+    at_completion_t done;
+
+    for (uint32_t id = 1; id <= AT_CHANNEL_DEPTH; id++) {
+        TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, id, AT_CMD_CLCC, id * MS));
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, at_channel_sent(&ch, 99, AT_CMD_DIAL, 20 * MS));
+    TEST_ASSERT_FALSE(at_channel_unsend(&ch, 99, 20 * MS));
+    TEST_ASSERT_TRUE(at_channel_unsend(&ch, AT_CHANNEL_DEPTH, 20 * MS));
+    TEST_ASSERT_TRUE(at_channel_unsend(&ch, 3, 20 * MS)); // Another command was recorded after it
+    TEST_ASSERT_EQUAL(AT_CHANNEL_DEPTH - 2, ch.count);
+    TEST_ASSERT_EQUAL_UINT32(AT_CHANNEL_DEPTH - 2, ch.stats.sent);
+
+    // Taking back the head puts the next one on the air
+    TEST_ASSERT_TRUE(at_channel_unsend(&ch, 1, 25 * MS));
+    TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_OK, 30 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(2, done.id);
+    TEST_ASSERT_EQUAL(5 * MS, done.round_trip_us);
+
+    // Wraps around the ring without losing the order
+    TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, 100, AT_CMD_DIAL, 32 * MS));
+    TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, 101, AT_CMD_HANGUP, 33 * MS));
+    for (uint32_t id = 4; id < AT_CHANNEL_DEPTH; id++) {
+        TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_OK, 40 * MS, &done));
+        TEST_ASSERT_EQUAL_UINT32(id, done.id);
+    }
+    TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_BUSY, 50 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(100, done.id);
+    TEST_ASSERT_EQUAL(AT_RESULT_BUSY, done.result);
+    TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_OK, 60 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(101, done.id);
+    TEST_ASSERT_EQUAL(0, ch.count);
+}
+
+// A timed-out command keeps its place so its late answer is not handed to the next
+// one, whose clock only starts once that answer is in
+void test_at_channel_timeout_and_late_answer(void) {
+    at_channel_t ch;
+    at_channel_init(&ch);
+    at_completion_t done;
+
+    TEST_ASSERT_EQUAL(0, at_channel_next_deadline(&ch));
+    TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, 1, AT_CMD_CLCC, 1000 * MS));
+    TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, 2, AT_CMD_DIAL, 1001 * MS));
+    int64_t deadline = 1000 * MS + (int64_t)at_channel_timeout_ms(AT_CMD_CLCC) * 1000;
+    TEST_ASSERT_EQUAL(deadline, at_channel_next_deadline(&ch));
+
+    TEST_ASSERT_FALSE(at_channel_expire(&ch, deadline - 1, &done));
+    TEST_ASSERT_TRUE(at_channel_expire(&ch, deadline, &done));
+    TEST_ASSERT_EQUAL_UINT32(1, done.id);
+    TEST_ASSERT_EQUAL(AT_RESULT_TIMEOUT, done.result);
+    TEST_ASSERT_FALSE(at_channel_expire(&ch, deadline + 60000 * MS, &done)); // Reported once
+    TEST_ASSERT_EQUAL_UINT32(0, at_channel_pending_id(&ch, AT_CMD_CLCC)); // A fresh query may go out
+    TEST_ASSERT_EQUAL(0, at_channel_next_deadline(&ch));
+
+    // The query's late OK is swallowed; the dial goes on the air now
+    TEST_ASSERT_FALSE(at_channel_answer(&ch, AT_RESULT_OK, deadline + 500 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(1, ch.stats.late);
+    TEST_ASSERT_EQUAL(deadline + 500 * MS + (int64_t)at_channel_timeout_ms(AT_CMD_DIAL) * 1000,
+                      at_channel_next_deadline(&ch));
+    TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_OK, deadline + 700 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(2, done.id);
+    TEST_ASSERT_EQUAL(200 * MS, done.round_trip_us);
+    TEST_ASSERT_EQUAL_UINT32(1, ch.stats.timeouts);
+}
+
+// A link loss completes everything still owed an answer, once each
+void test_at_channel_flush(void) {
+    at_channel_t ch;
+    at_channel_init(&ch);
+    at_completion_t done;
+
+    at_channel_sent(&ch, 1, AT_CMD_HANGUP, 1 * MS);
+    at_channel_sent(&ch, 2, AT_CMD_DIAL, 2 * MS);
+    at_channel_sent(&ch, 3, AT_CMD_CLCC, 3 * MS);
+    TEST_ASSERT_TRUE(at_channel_expire(&ch, 10000 * MS, &done)); // Already reported
+
+    TEST_ASSERT_TRUE(at_channel_flush(&ch, &done));
+    TEST_ASSERT_EQUAL_UINT32(2, done.id);
+    TEST_ASSERT_EQUAL(AT_RESULT_LINK_LOST, done.result);
+    TEST_ASSERT_TRUE(at_channel_flush(&ch, &done));
+    TEST_ASSERT_EQUAL_UINT32(3, done.id);
+    TEST_ASSERT_FALSE(at_channel_flush(&ch, &done));
+    TEST_ASSERT_EQUAL(0, ch.count);
+    TEST_ASSERT_EQUAL_UINT32(2, ch.stats.lost);
+    TEST_ASSERT_EQUAL(0, at_channel_next_deadline(&ch));
+
+    // Fresh commands after the link is back start a fresh queue
+    TEST_ASSERT_EQUAL(ESP_OK, at_channel_sent(&ch, 4, AT_CMD_REDIAL, 20000 * MS));
+    TEST_ASSERT_TRUE(at_channel_answer(&ch, AT_RESULT_OK, 20300 * MS, &done));
+    TEST_ASSERT_EQUAL_UINT32(4, done.id);
+    TEST_ASSERT_EQUAL(300 * MS, done.round_trip_us);
+}
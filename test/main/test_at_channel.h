@@ -0,0 +1,6 @@
+#pragma once
+
+void test_at_channel_fifo_correlation(void);
+void test_at_channel_depth_and_unsend(void);
+void test_at_channel_timeout_and_late_answer(void);
+void test_at_channel_flush(void);
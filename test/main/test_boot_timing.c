@@ -0,0 +1,62 @@
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+#include "nvs.h"
+#include "boot_timing.h"
+
+static char json[BOOT_TIMING_JSON_MAX];
+
+static const char *render(const char *reset_reason) {
+    TEST_ASSERT_GREATER_THAN(0, boot_timing_write_json(reset_reason, json, sizeof(json)));
+    return json;
+}
+
+// Pending, running, finished and failed phases, including two that overlap
+void test_boot_timing_phases(void) {
+    boot_timing_reset();
+    boot_timing_start(BOOT_PHASE_NVS, 1000);
+    boot_timing_end(BOOT_PHASE_NVS, 21000, ESP_OK);
+    boot_timing_start(BOOT_PHASE_ASSETS, 2000);          // Runs alongside the Bluetooth bring-up
+    boot_timing_start(BOOT_PHASE_BT_CONTROLLER, 25000);
+    boot_timing_end(BOOT_PHASE_BT_CONTROLLER, 90000, ESP_ERR_NO_MEM);
+
+    boot_phase_timing_t nvs;
+    boot_timing_get(BOOT_PHASE_NVS, &nvs);
+    TEST_ASSERT_EQUAL(1000, nvs.start_us);
+    TEST_ASSERT_EQUAL(21000, nvs.end_us);
+
+    const char *text = render("brownout");
+    TEST_ASSERT_EQUAL(0, strncmp(text, "{\"reset_reason\":\"brownout\",\"phases\":[", 37));
+    TEST_ASSERT_NOT_NULL(strstr(text, "{\"name\":\"nvs\",\"status\":\"ok\",\"start_us\":1000,\"end_us\":21000,\"duration_us\":20000}"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "{\"name\":\"assets\",\"status\":\"running\",\"start_us\":2000}"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "{\"name\":\"hfp\",\"status\":\"pending\"}"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"name\":\"bt_controller\",\"status\":\"ESP_ERR_NO_MEM\""));
+    TEST_ASSERT_EQUAL('}', text[strlen(text) - 1]);
+}
+
+// Milestones keep their first time; unreached ones are null
+void test_boot_timing_milestones(void) {
+    boot_timing_reset();
+    boot_timing_mark(BOOT_MILESTONE_NETWORK_UP, 3000000);
+    boot_timing_mark(BOOT_MILESTONE_NETWORK_UP, 9000000); // Reconnect later on
+    boot_timing_mark(BOOT_MILESTONE_COUNT, 1);            // Out of range is ignored
+
+    const char *text = render("poweron");
+    TEST_ASSERT_NOT_NULL(strstr(text, "\"milestones\":{\"app_main_done_us\":null,\"web_server_us\":null,"
+                                      "\"network_up_us\":3000000,\"hfp_connected_us\":null}}"));
+}
+
+// Every phase failed at the largest timestamps still fits the handler's buffer
+void test_boot_timing_worst_case_fits(void) {
+    boot_timing_reset();
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        boot_timing_start((boot_phase_t)i, 1);
+        boot_timing_end((boot_phase_t)i, INT64_MAX, ESP_ERR_NVS_NEW_VERSION_FOUND);
+    }
+    for (int i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+        boot_timing_mark((boot_milestone_t)i, INT64_MAX);
+    }
+    TEST_ASSERT_GREATER_THAN(0, boot_timing_write_json("deepsleep", json, sizeof(json)));
+    TEST_ASSERT_EQUAL(-1, boot_timing_write_json("deepsleep", json, 64));
+    boot_timing_reset();
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+void test_boot_timing_phases(void);
+void test_boot_timing_milestones(void);
+void test_boot_timing_worst_case_fits(void);
@@ -0,0 +1,111 @@
+#include "unity.h"
+#include <string.h>
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "bt_reconnect.h"
+
+#define BASE_MS 2000
+#define MAX_MS 60000
+
+static const uint8_t phone[BT_RECONNECT_BDA_LEN] = { 0x58, 0xcb, 0x52, 0x11, 0x22, 0x33 };
+
+// Each wait falls between half and all of a ceiling that doubles up to the cap
+void test_bt_reconnect_backoff_bounds(void) {
+    bt_reconnect_t r;
+    bt_reconnect_init(&r, BASE_MS, MAX_MS);
+    bt_reconnect_link_lost(&r, 1000);
+    TEST_ASSERT_TRUE(bt_reconnect_active(&r));
+
+    static const uint32_t ceilings[] = { 2000, 4000, 8000, 16000, 32000, 60000, 60000 };
+    for (size_t i = 0; i < sizeof(ceilings) / sizeof(ceilings[0]); i++) {
+        bt_reconnect_t lo = r, hi = r;
+        TEST_ASSERT_EQUAL_UINT32(ceilings[i] / 2, bt_reconnect_next_delay_ms(&lo, 0));
+        TEST_ASSERT_EQUAL_UINT32(ceilings[i], bt_reconnect_next_delay_ms(&hi, ceilings[i] / 2));
+        uint32_t delay = bt_reconnect_next_delay_ms(&r, 0x9e3779b9u * (i + 1));
+        TEST_ASSERT_GREATER_OR_EQUAL(ceilings[i] / 2, delay);
+        TEST_ASSERT_LESS_OR_EQUAL(ceilings[i], delay);
+    }
+
+    // A long outage stays on the cap rather than overflowing the shift
+    r.attempts = 40;
+    TEST_ASSERT_LESS_OR_EQUAL(MAX_MS, bt_reconnect_next_delay_ms(&r, UINT32_MAX));
+    bt_reconnect_init(&r, UINT32_MAX, UINT32_MAX);
+    bt_reconnect_link_lost(&r, 1);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, bt_reconnect_next_delay_ms(&r, UINT32_MAX / 2 + 1));
+}
+
+// Latency runs from the drop to the link coming back, however it came back
+void test_bt_reconnect_latency_and_attempts(void) {
+    bt_reconnect_t r;
+    bt_reconnect_init(&r, BASE_MS, MAX_MS);
+    TEST_ASSERT_FALSE(bt_reconnect_connected(&r, 500)); // First connect after boot: no outage
+
+    bt_reconnect_link_lost(&r, 1000000);
+    bt_reconnect_next_delay_ms(&r, 0);
+    bt_reconnect_link_lost(&r, 2000000); // Failed attempt reported again: same outage
+    bt_reconnect_next_delay_ms(&r, 0);
+    bt_reconnect_next_delay_ms(&r, 0);
+    TEST_ASSERT_TRUE(bt_reconnect_connected(&r, 9500000));
+    TEST_ASSERT_FALSE(bt_reconnect_active(&r));
+    TEST_ASSERT_EQUAL(8500000, r.last_latency_us);
+    TEST_ASSERT_EQUAL_UINT32(3, r.last_attempts);
+    TEST_ASSERT_EQUAL_UINT32(1, r.reconnects);
+
+    // The phone came back on its own before our first page: the next outage starts over
+    bt_reconnect_link_lost(&r, 20000000);
+    TEST_ASSERT_EQUAL_UINT32(0, r.attempts);
+    TEST_ASSERT_TRUE(bt_reconnect_connected(&r, 20250000));
+    TEST_ASSERT_EQUAL(250000, r.last_latency_us);
+    TEST_ASSERT_EQUAL_UINT32(0, r.last_attempts);
+    TEST_ASSERT_EQUAL_UINT32(2, r.reconnects);
+    TEST_ASSERT_EQUAL_UINT32(3, r.attempts_total);
+}
+
+static bool on_flash(void) {
+    nvs_handle_t handle;
+    if (nvs_open(BT_RECONNECT_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false; // Namespace empty
+    }
+    size_t len = 0;
+    esp_err_t err = nvs_get_blob(handle, BT_RECONNECT_KEY, NULL, &len);
+    nvs_close(handle);
+    return err == ESP_OK;
+}
+
+// The same phone again writes nothing; forgetting it leaves nothing to page
+void test_bt_reconnect_peer_store(void) {
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        TEST_ASSERT_EQUAL(ESP_OK, nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(ESP_OK, bt_reconnect_forget_peer());
+
+    uint8_t loaded[BT_RECONNECT_BDA_LEN];
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, bt_reconnect_load_peer(loaded));
+    TEST_ASSERT_EQUAL(ESP_OK, bt_reconnect_store_peer(phone));
+    TEST_ASSERT_EQUAL(ESP_OK, bt_reconnect_load_peer(loaded));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(phone, loaded, BT_RECONNECT_BDA_LEN);
+
+    // Erased behind its back, so a second store of the same phone shows as no write
+    nvs_handle_t handle;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open(BT_RECONNECT_NAMESPACE, NVS_READWRITE, &handle));
+    nvs_erase_key(handle, BT_RECONNECT_KEY);
+    nvs_commit(handle);
+    nvs_close(handle);
+    TEST_ASSERT_EQUAL(ESP_OK, bt_reconnect_store_peer(phone));
+    TEST_ASSERT_FALSE(on_flash());
+
+    uint8_t other[BT_RECONNECT_BDA_LEN];
+    memcpy(other, phone, sizeof(other));
+    other[5] ^= 0xff;
+    TEST_ASSERT_EQUAL(ESP_OK, bt_reconnect_store_peer(other));
+    TEST_ASSERT_TRUE(on_flash());
+
+    TEST_ASSERT_EQUAL(ESP_OK, bt_reconnect_forget_peer());
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, bt_reconnect_load_peer(loaded));
+    TEST_ASSERT_EQUAL(ESP_OK, bt_reconnect_store_peer(other)); // Known to be gone: written again
+    TEST_ASSERT_TRUE(on_flash());
+    bt_reconnect_forget_peer();
+}
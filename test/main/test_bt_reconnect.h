@@ -0,0 +1,5 @@
+#pragma once
+
+void test_bt_reconnect_backoff_bounds(void);
+void test_bt_reconnect_latency_and_attempts(void);
+void test_bt_reconnect_peer_store(void);
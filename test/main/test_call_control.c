@@ -0,0 +1,139 @@
+#include "unity.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "call_control.h"
+
+#define SETTLE_MS 50
+
+// The executor parks on a gate so the test controls when each command completes
+static SemaphoreHandle_t executor_gate;
+static call_cmd_t executed[8];
+static volatile int executed_count;
+
+static void gated_executor(const call_cmd_t *cmd) {
+    xSemaphoreTake(executor_gate, portMAX_DELAY);
+    if (executed_count < (int)(sizeof(executed) / sizeof(executed[0]))) {
+        executed[executed_count] = *cmd;
+    }
+    executed_count++;
+}
+
+static void start(size_t queue_len) {
+    executor_gate = xSemaphoreCreateCounting(8, 0);
+    executed_count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_init(queue_len, gated_executor));
+}
+
+static void release_and_stop(int commands) {
+    for (int i = 0; i < commands; i++) {
+        xSemaphoreGive(executor_gate);
+    }
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+    call_control_deinit();
+    vSemaphoreDelete(executor_gate);
+}
+
+// Manual commands overtake queued automatic ones; duplicate auto redials share an ID
+void test_call_control_priority_and_coalescing(void) {
+    uint32_t busy_id, auto_id, dup_id, dial_id;
+    start(4);
+
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_AUTO, NULL, &busy_id));
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS)); // Worker is now parked on busy_id
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_AUTO, NULL, &auto_id));
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_AUTO, NULL, &dup_id));
+    TEST_ASSERT_EQUAL(auto_id, dup_id);
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "5551234", &dial_id));
+
+    release_and_stop(3);
+    TEST_ASSERT_EQUAL(3, executed_count);
+    TEST_ASSERT_EQUAL(busy_id, executed[0].id);
+    TEST_ASSERT_EQUAL(dial_id, executed[1].id);
+    TEST_ASSERT_EQUAL_STRING("5551234", executed[1].number);
+    TEST_ASSERT_EQUAL(auto_id, executed[2].id);
+
+    call_control_stats_t stats;
+    call_control_get_stats(&stats);
+    TEST_ASSERT_EQUAL(3, stats.submitted);
+    TEST_ASSERT_EQUAL(1, stats.coalesced);
+}
+
+// A manual redial replaces a pending automatic one, and later auto redials fold into it
+void test_call_control_manual_supersedes_auto(void) {
+    uint32_t busy_id, auto_id, manual_id, later_id;
+    start(4);
+
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "1", &busy_id));
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_AUTO, NULL, &auto_id));
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_MANUAL, NULL, &manual_id));
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_AUTO, NULL, &later_id));
+    TEST_ASSERT_EQUAL(manual_id, later_id);
+
+    release_and_stop(3);
+    TEST_ASSERT_EQUAL(2, executed_count);
+    TEST_ASSERT_EQUAL(busy_id, executed[0].id);
+    TEST_ASSERT_EQUAL(manual_id, executed[1].id);
+
+    call_control_stats_t stats;
+    call_control_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.superseded);
+    TEST_ASSERT_NOT_EQUAL(auto_id, manual_id);
+}
+
+// Call list queries still waiting to run share one ID, so polling cannot fill the queue
+void test_call_control_query_coalescing(void) {
+    uint32_t busy_id, query_id, dup_id, dial_id, later_id;
+    start(2);
+
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "1", &busy_id));
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_QUERY_CALLS, CALL_CMD_PRIORITY_MANUAL, NULL, &query_id));
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_QUERY_CALLS, CALL_CMD_PRIORITY_MANUAL, NULL, &dup_id));
+        TEST_ASSERT_EQUAL(query_id, dup_id);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "2", &dial_id));
+
+    // Once the query has run, the next one is a fresh command
+    xSemaphoreGive(executor_gate);
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS)); // Worker is now parked on the query
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_QUERY_CALLS, CALL_CMD_PRIORITY_MANUAL, NULL, &later_id));
+    TEST_ASSERT_NOT_EQUAL(query_id, later_id);
+
+    release_and_stop(3);
+    TEST_ASSERT_EQUAL(4, executed_count);
+    TEST_ASSERT_EQUAL(query_id, executed[1].id);
+    TEST_ASSERT_EQUAL(dial_id, executed[2].id);
+    TEST_ASSERT_EQUAL(later_id, executed[3].id);
+
+    call_control_stats_t stats;
+    call_control_get_stats(&stats);
+    TEST_ASSERT_EQUAL(5, stats.coalesced);
+    TEST_ASSERT_EQUAL(0, stats.rejected);
+}
+
+// A full queue is reported to the caller instead of blocking it
+void test_call_control_backpressure(void) {
+    uint32_t id;
+    start(2);
+
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "1", &id));
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "2", &id));
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "3", &id));
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "4", &id));
+    // The automatic queue is separate, so the timer can still get a redial in
+    TEST_ASSERT_EQUAL(ESP_OK, call_control_submit(CALL_CMD_REDIAL, CALL_CMD_PRIORITY_AUTO, NULL, &id));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, call_control_submit(CALL_CMD_DIAL, CALL_CMD_PRIORITY_MANUAL, "", &id));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, call_control_submit(CALL_CMD_MEMORY_DIAL, CALL_CMD_PRIORITY_MANUAL, NULL, &id));
+
+    call_control_stats_t stats;
+    call_control_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.rejected);
+
+    release_and_stop(4);
+    TEST_ASSERT_EQUAL(4, executed_count);
+}
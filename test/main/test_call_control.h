@@ -0,0 +1,6 @@
+#pragma once
+
+void test_call_control_priority_and_coalescing(void);
+void test_call_control_manual_supersedes_auto(void);
+void test_call_control_query_coalescing(void);
+void test_call_control_backpressure(void);
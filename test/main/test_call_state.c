@@ -0,0 +1,95 @@
+#include "unity.h"
+#include <string.h>
+#include "call_state.h"
+
+// Dial -> ring -> answer -> hang up, with both phase latencies recorded
+void test_call_state_answered_call_timing(void) {
+    call_fsm_t fsm;
+    call_fsm_init(&fsm);
+
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_DIAL_SENT, 1000000));
+    TEST_ASSERT_EQUAL(CALL_STATE_DIALING, fsm.state);
+    TEST_ASSERT_FALSE(call_fsm_handle(&fsm, CALL_EVT_SETUP_DIALING, 1200000)); // Phone confirms; no change
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_SETUP_ALERTING, 3500000));
+    TEST_ASSERT_EQUAL(CALL_STATE_ALERTING, fsm.state);
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_CALL_ACTIVE, 9500000));
+    TEST_ASSERT_EQUAL(CALL_STATE_ACTIVE, fsm.state);
+    TEST_ASSERT_FALSE(call_fsm_handle(&fsm, CALL_EVT_SETUP_IDLE, 9600000)); // Setup ends after answer
+    TEST_ASSERT_TRUE(call_state_is_busy(fsm.state));
+
+    TEST_ASSERT_EQUAL(1, fsm.dial_to_alert.count);
+    TEST_ASSERT_TRUE(fsm.dial_to_alert.last_us == 2500000);
+    TEST_ASSERT_EQUAL(1, fsm.alert_to_answer.count);
+    TEST_ASSERT_TRUE(fsm.alert_to_answer.last_us == 6000000);
+    TEST_ASSERT_EQUAL(1, fsm.answered);
+
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_CALL_NONE, 20000000));
+    TEST_ASSERT_EQUAL(CALL_STATE_IDLE, fsm.state);
+    TEST_ASSERT_TRUE(fsm.entered_us == 20000000);
+    TEST_ASSERT_FALSE(call_state_is_busy(fsm.state));
+
+    // A second, faster call updates min/max
+    call_fsm_handle(&fsm, CALL_EVT_DIAL_SENT, 30000000);
+    call_fsm_handle(&fsm, CALL_EVT_SETUP_ALERTING, 31000000);
+    TEST_ASSERT_EQUAL(2, fsm.dial_to_alert.count);
+    TEST_ASSERT_TRUE(fsm.dial_to_alert.min_us == 1000000);
+    TEST_ASSERT_TRUE(fsm.dial_to_alert.max_us == 2500000);
+    TEST_ASSERT_TRUE(fsm.dial_to_alert.total_us == 3500000);
+}
+
+// An AT error and a setup that ends unanswered are the same failure
+void test_call_state_failures(void) {
+    call_fsm_t fsm;
+    call_fsm_init(&fsm);
+
+    call_fsm_handle(&fsm, CALL_EVT_DIAL_SENT, 0);
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_AT_ERROR, 100));
+    TEST_ASSERT_EQUAL(CALL_STATE_FAILED, fsm.state);
+    TEST_ASSERT_FALSE(call_fsm_handle(&fsm, CALL_EVT_CALL_NONE, 200)); // Failure is sticky
+
+    call_fsm_handle(&fsm, CALL_EVT_DIAL_SENT, 1000);
+    call_fsm_handle(&fsm, CALL_EVT_SETUP_ALERTING, 2000);
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_SETUP_IDLE, 3000));
+    TEST_ASSERT_EQUAL(CALL_STATE_FAILED, fsm.state);
+    TEST_ASSERT_EQUAL(2, fsm.failed);
+    TEST_ASSERT_EQUAL(0, fsm.answered);
+    TEST_ASSERT_EQUAL(0, fsm.alert_to_answer.count);
+
+    // A BUSY result for the dial fails the attempt like callsetup=0 does
+    call_fsm_handle(&fsm, CALL_EVT_DIAL_SENT, 3500);
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_LINE_BUSY, 3600));
+    TEST_ASSERT_EQUAL(CALL_STATE_FAILED, fsm.state);
+    TEST_ASSERT_EQUAL(3, fsm.failed);
+
+    // Losing the link mid-setup is not counted as a failed call
+    call_fsm_handle(&fsm, CALL_EVT_DIAL_SENT, 4000);
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_LINK_LOST, 5000));
+    TEST_ASSERT_EQUAL(CALL_STATE_IDLE, fsm.state);
+    TEST_ASSERT_EQUAL(3, fsm.failed);
+}
+
+// Events that make no sense in a state are ignored, and every pair is handled
+void test_call_state_ignored_events(void) {
+    call_fsm_t fsm;
+    call_fsm_init(&fsm);
+
+    TEST_ASSERT_FALSE(call_fsm_handle(&fsm, CALL_EVT_AT_ERROR, 0));     // Error unrelated to a call
+    TEST_ASSERT_FALSE(call_fsm_handle(&fsm, CALL_EVT_SETUP_IDLE, 0));
+    TEST_ASSERT_FALSE(call_fsm_handle(&fsm, CALL_EVT_LINK_LOST, 0));
+    TEST_ASSERT_EQUAL(CALL_STATE_IDLE, fsm.state);
+
+    // Ringing seen without the dialing phase (dialed from the handset): no latency sample
+    TEST_ASSERT_TRUE(call_fsm_handle(&fsm, CALL_EVT_SETUP_ALERTING, 100));
+    TEST_ASSERT_EQUAL(0, fsm.dial_to_alert.count);
+
+    for (int s = 0; s < CALL_STATE_COUNT; s++) {
+        TEST_ASSERT_NOT_NULL(call_state_name((call_state_t)s));
+        TEST_ASSERT_TRUE(strcmp("unknown", call_state_name((call_state_t)s)) != 0);
+        for (int e = 0; e < CALL_EVT_COUNT; e++) {
+            call_fsm_t probe = { .state = (call_state_t)s };
+            call_fsm_handle(&probe, (call_event_t)e, 1);
+            TEST_ASSERT_TRUE(probe.state < CALL_STATE_COUNT);
+            TEST_ASSERT_TRUE(strcmp("unknown", call_event_name((call_event_t)e)) != 0);
+        }
+    }
+}
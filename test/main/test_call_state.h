@@ -0,0 +1,5 @@
+#pragma once
+
+void test_call_state_answered_call_timing(void);
+void test_call_state_failures(void);
+void test_call_state_ignored_events(void);
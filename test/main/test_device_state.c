@@ -0,0 +1,128 @@
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "device_state.h"
+
+#define STRESS_COUNTERS 2 // Tasks counting redials; one more rewrites the IP
+#define STRESS_READERS 3
+#define STRESS_TASKS (STRESS_COUNTERS + 1 + STRESS_READERS)
+#define STRESS_ITERATIONS 20000
+#define STRESS_TASK_STACK 4096
+#define STRESS_TIMEOUT_MS 30000
+
+// Every character differs, so a copy torn between the two is neither of them
+#define IP_A "111.111.111.111"
+#define IP_B "222.222.222.222"
+
+void test_device_state_setters(void) {
+    device_state_reset();
+    device_state_t s;
+    device_state_read(&s);
+    TEST_ASSERT_FALSE(s.bluetooth_connected);
+    TEST_ASSERT_EQUAL_STRING("", s.ip_address);
+
+    device_state_set_bluetooth_connected(true);
+    device_state_set_auto_redial_enabled(true);
+    device_state_set_last_call_failed(true);
+    device_state_set_ip_address("192.168.4.1");
+    TEST_ASSERT_EQUAL(1, device_state_count_redial());
+    TEST_ASSERT_EQUAL(2, device_state_count_redial());
+
+    device_state_read(&s);
+    TEST_ASSERT_TRUE(s.bluetooth_connected);
+    TEST_ASSERT_TRUE(s.auto_redial_enabled);
+    TEST_ASSERT_TRUE(s.last_call_failed);
+    TEST_ASSERT_EQUAL(2, s.redial_count);
+    TEST_ASSERT_EQUAL_STRING("192.168.4.1", s.ip_address);
+    TEST_ASSERT_TRUE(device_state_bluetooth_connected());
+    TEST_ASSERT_TRUE(device_state_auto_redial_enabled());
+
+    // Too long for the field: truncated, never unterminated
+    device_state_set_ip_address("1234567890123456789");
+    device_state_read(&s);
+    TEST_ASSERT_EQUAL_STRING("123456789012345", s.ip_address);
+
+    device_state_set_ip_address(NULL);
+    device_state_reset_redial_count();
+    device_state_read(&s);
+    TEST_ASSERT_EQUAL_STRING("", s.ip_address);
+    TEST_ASSERT_EQUAL(0, device_state_redial_count());
+    device_state_reset();
+}
+
+static SemaphoreHandle_t stress_done;
+static portMUX_TYPE stress_lock = portMUX_INITIALIZER_UNLOCKED;
+static int torn_ips;        // Guarded by stress_lock
+static int counts_went_back; // Guarded by stress_lock
+
+static void counting_writer(void *arg) {
+    for (int i = 0; i < STRESS_ITERATIONS; i++) {
+        device_state_count_redial();
+        device_state_set_bluetooth_connected(i & 1);
+    }
+    xSemaphoreGive(stress_done);
+    vTaskDelete(NULL);
+}
+
+static void ip_writer(void *arg) {
+    for (int i = 0; i < STRESS_ITERATIONS; i++) {
+        device_state_set_ip_address(i & 1 ? IP_B : IP_A);
+    }
+    xSemaphoreGive(stress_done);
+    vTaskDelete(NULL);
+}
+
+static void reader(void *arg) {
+    device_state_t s;
+    uint32_t last_count = 0;
+    int torn = 0, back = 0;
+
+    for (int i = 0; i < STRESS_ITERATIONS; i++) {
+        device_state_read(&s);
+        if (strcmp(s.ip_address, IP_A) != 0 && strcmp(s.ip_address, IP_B) != 0) {
+            torn++;
+        }
+        if (s.redial_count < last_count) {
+            back++; // A snapshot never predates the one before it
+        }
+        last_count = s.redial_count;
+    }
+    portENTER_CRITICAL(&stress_lock);
+    torn_ips += torn;
+    counts_went_back += back;
+    portEXIT_CRITICAL(&stress_lock);
+    xSemaphoreGive(stress_done);
+    vTaskDelete(NULL);
+}
+
+// Writers and readers on every core hammer the state at once: every read must be a
+// state some writer actually left, and no increment may be lost between writers
+void test_device_state_no_torn_reads(void) {
+    device_state_reset();
+    device_state_set_ip_address(IP_A);
+    stress_done = xSemaphoreCreateCounting(STRESS_TASKS, 0);
+    torn_ips = 0;
+    counts_went_back = 0;
+
+    TaskHandle_t task;
+    for (int i = 0; i < STRESS_READERS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(reader, "state_reader", STRESS_TASK_STACK, NULL, tskIDLE_PRIORITY + 1, &task));
+    }
+    for (int i = 0; i < STRESS_COUNTERS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(counting_writer, "state_counter", STRESS_TASK_STACK, NULL, tskIDLE_PRIORITY + 1, &task));
+    }
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(ip_writer, "state_ip", STRESS_TASK_STACK, NULL, tskIDLE_PRIORITY + 1, &task));
+
+    for (int i = 0; i < STRESS_TASKS; i++) {
+        TEST_ASSERT_TRUE(xSemaphoreTake(stress_done, pdMS_TO_TICKS(STRESS_TIMEOUT_MS)));
+    }
+    vSemaphoreDelete(stress_done);
+
+    TEST_ASSERT_EQUAL(0, torn_ips);
+    TEST_ASSERT_EQUAL(0, counts_went_back);
+    TEST_ASSERT_EQUAL(STRESS_COUNTERS * STRESS_ITERATIONS, device_state_redial_count());
+    device_state_reset();
+}
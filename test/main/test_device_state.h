@@ -0,0 +1,4 @@
+#pragma once
+
+void test_device_state_setters(void);
+void test_device_state_no_torn_reads(void);
@@ -0,0 +1,183 @@
+#include "unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON.h"
+#include "esp_timer.h"
+#include "device_status.h"
+
+#define BENCH_ITERATIONS 2000
+
+static void make_sample_status(device_status_t *status) {
+    memset(status, 0, sizeof(*status));
+    status->bluetooth_connected = true;
+    status->wifi_mode = "STA";
+    snprintf(status->ip_address, sizeof(status->ip_address), "%s", "192.168.1.100");
+    status->auto_redial_enabled = true;
+    status->redial_period = 60;
+    status->redial_random_delay = 15;
+    status->last_random_delay = 7;
+    status->last_call_failed = false;
+    status->redial_max_count = 10;
+    status->redial_current_count = 3;
+    status->redial_next_deadline_ms = 123456;
+    status->redial_mode = "periodic";
+    status->redial_guard = 3;
+    status->redial_attempts_per_hour = 58;
+    status->call_state = "idle";
+    status->bt_last_reconnect_ms = 4200;
+    status->bt_last_reconnect_attempts = 2;
+}
+
+// The cJSON serializer /status used to run per request (tree built, printed, freed), kept
+// in step with the status fields as the benchmark baseline
+static char *legacy_status_json(const device_status_t *status) {
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddBoolToObject(root, "bluetooth_connected", status->bluetooth_connected);
+    cJSON_AddStringToObject(root, "wifi_mode", status->wifi_mode);
+    cJSON_AddStringToObject(root, "ip_address", strlen(status->ip_address) > 0 ? status->ip_address : "N/A");
+    cJSON_AddBoolToObject(root, "auto_redial_enabled", status->auto_redial_enabled);
+    cJSON_AddNumberToObject(root, "redial_period", status->redial_period);
+    cJSON_AddNumberToObject(root, "redial_random_delay", status->redial_random_delay);
+    cJSON_AddNumberToObject(root, "last_random_delay", status->last_random_delay);
+    cJSON_AddBoolToObject(root, "last_call_failed", status->last_call_failed);
+    cJSON_AddNumberToObject(root, "redial_max_count", status->redial_max_count);
+    cJSON_AddNumberToObject(root, "redial_current_count", status->redial_current_count);
+    cJSON_AddNumberToObject(root, "redial_next_deadline_ms", (double)status->redial_next_deadline_ms);
+    cJSON_AddNumberToObject(root, "redial_drift_ms", (double)status->redial_drift_ms);
+    cJSON_AddStringToObject(root, "redial_mode", status->redial_mode);
+    cJSON_AddNumberToObject(root, "redial_guard", status->redial_guard);
+    cJSON_AddNumberToObject(root, "redial_attempts_per_hour", status->redial_attempts_per_hour);
+    cJSON_AddNumberToObject(root, "redial_time_to_connect_ms", status->redial_time_to_connect_ms);
+    cJSON_AddStringToObject(root, "call_state", status->call_state);
+    cJSON_AddNumberToObject(root, "call_dial_to_alert_ms", status->call_dial_to_alert_ms);
+    cJSON_AddNumberToObject(root, "call_alert_to_answer_ms", status->call_alert_to_answer_ms);
+    cJSON_AddBoolToObject(root, "bt_reconnecting", status->bt_reconnecting);
+    cJSON_AddNumberToObject(root, "bt_reconnect_attempts", status->bt_reconnect_attempts);
+    cJSON_AddNumberToObject(root, "bt_last_reconnect_ms", status->bt_last_reconnect_ms);
+    cJSON_AddNumberToObject(root, "bt_last_reconnect_attempts", status->bt_last_reconnect_attempts);
+    cJSON_AddStringToObject(root, "message", status->bluetooth_connected ? "Bluetooth connected" : "Bluetooth disconnected");
+    char *json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    return json;
+}
+
+// The fixed-buffer writer produces byte-for-byte what cJSON produced
+void test_device_status_full_json(void) {
+    device_status_t status;
+    char buf[DEVICE_STATUS_JSON_MAX];
+    make_sample_status(&status);
+
+    int len = device_status_write_json(&status, NULL, buf, sizeof(buf));
+    TEST_ASSERT_GREATER_THAN(0, len);
+    char *legacy = legacy_status_json(&status);
+    TEST_ASSERT_EQUAL_STRING(legacy, buf);
+    free(legacy);
+
+    // Empty IP renders as N/A, and a too-small buffer is reported rather than truncated
+    status.ip_address[0] = '\0';
+    device_status_write_json(&status, NULL, buf, sizeof(buf));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"ip_address\":\"N/A\""));
+    TEST_ASSERT_EQUAL(-1, device_status_write_json(&status, NULL, buf, 16));
+}
+
+// Every field at its widest still fits DEVICE_STATUS_JSON_MAX
+void test_device_status_worst_case_fits(void) {
+    device_status_t status;
+    char buf[DEVICE_STATUS_JSON_MAX];
+    memset(&status, 0, sizeof(status));
+    status.bluetooth_connected = false; // "Bluetooth disconnected" is the longer message
+    status.wifi_mode = "Unknown";
+    snprintf(status.ip_address, sizeof(status.ip_address), "%s", "255.255.255.255");
+    status.auto_redial_enabled = false;
+    status.last_call_failed = false;
+    status.redial_period = status.redial_random_delay = status.last_random_delay = UINT32_MAX;
+    status.redial_max_count = status.redial_current_count = UINT32_MAX;
+    status.redial_next_deadline_ms = status.redial_drift_ms = UINT64_MAX;
+    status.redial_mode = "back_to_back";
+    status.redial_guard = status.redial_attempts_per_hour = status.redial_time_to_connect_ms = UINT32_MAX;
+    status.call_state = "alerting";
+    status.call_dial_to_alert_ms = status.call_alert_to_answer_ms = UINT32_MAX;
+    status.bt_reconnecting = false;
+    status.bt_reconnect_attempts = status.bt_last_reconnect_ms = status.bt_last_reconnect_attempts = UINT32_MAX;
+
+    TEST_ASSERT_GREATER_THAN(0, device_status_write_json(&status, NULL, buf, sizeof(buf)));
+}
+
+// Only changed fields are written when a previous snapshot is given
+void test_device_status_diff_json(void) {
+    device_status_t prev, status;
+    char buf[DEVICE_STATUS_JSON_MAX];
+    make_sample_status(&prev);
+    status = prev;
+
+    device_status_write_json(&status, &prev, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("{}", buf);
+
+    status.redial_current_count = 4;
+    status.call_state = "dialing";
+    device_status_write_json(&status, &prev, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("{\"redial_current_count\":4,\"call_state\":\"dialing\"}", buf);
+}
+
+// The cached rendering keeps its generation until the snapshot changes
+void test_device_status_generation(void) {
+    device_status_t status;
+    device_status_rendered_t first, second, third;
+    static char first_json[DEVICE_STATUS_JSON_MAX], second_json[DEVICE_STATUS_JSON_MAX];
+    make_sample_status(&status);
+
+    device_status_render_cached(&status, first_json, sizeof(first_json), &first);
+    device_status_render_cached(&status, second_json, sizeof(second_json), &second);
+    TEST_ASSERT_EQUAL(first.generation, second.generation);
+    TEST_ASSERT_EQUAL_PTR(second_json, second.json); // Each caller gets its own copy
+    TEST_ASSERT_EQUAL(first.len, second.len);
+    TEST_ASSERT_EQUAL_STRING(first.json, second.json);
+
+    status.bluetooth_connected = false;
+    device_status_render_cached(&status, second_json, sizeof(second_json), &third);
+    TEST_ASSERT_EQUAL(second.generation + 1, third.generation);
+    TEST_ASSERT_NOT_NULL(strstr(third.json, "\"bluetooth_connected\":false"));
+    TEST_ASSERT_NOT_NULL(strstr(first_json, "\"bluetooth_connected\":true")); // Untouched
+
+    device_status_render_cached(&status, first_json, 16, &third); // Too small for any status
+    TEST_ASSERT_EQUAL(0, third.len);
+    TEST_ASSERT_EQUAL_STRING("", first_json);
+}
+
+// Per-request serialization cost: legacy cJSON vs fixed buffer vs generation cache
+void test_device_status_benchmark(void) {
+    device_status_t status;
+    device_status_rendered_t rendered;
+    char buf[DEVICE_STATUS_JSON_MAX];
+    char report[160];
+    make_sample_status(&status);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        char *json = legacy_status_json(&status);
+        free(json);
+    }
+    int64_t legacy_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        status.redial_current_count = (uint32_t)i; // Force a fresh render each time
+        device_status_write_json(&status, NULL, buf, sizeof(buf));
+    }
+    int64_t writer_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        device_status_render_cached(&status, buf, sizeof(buf), &rendered);
+    }
+    int64_t cached_us = esp_timer_get_time() - start;
+
+    snprintf(report, sizeof(report),
+             "status serialize ns/request: cJSON=%lld writer=%lld cached=%lld",
+             (long long)(legacy_us * 1000 / BENCH_ITERATIONS),
+             (long long)(writer_us * 1000 / BENCH_ITERATIONS),
+             (long long)(cached_us * 1000 / BENCH_ITERATIONS));
+    TEST_MESSAGE(report);
+    TEST_ASSERT_LESS_OR_EQUAL(legacy_us, writer_us);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+void test_device_status_full_json(void);
+void test_device_status_worst_case_fits(void);
+void test_device_status_diff_json(void);
+void test_device_status_generation(void);
+void test_device_status_benchmark(void);
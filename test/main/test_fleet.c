@@ -0,0 +1,164 @@
+#include "unity.h"
+#include <string.h>
+#include "fleet.h"
+
+#define HEARTBEAT_US 1000000
+#define PEER_TIMEOUT_US (3 * HEARTBEAT_US)
+#define ATTEMPT_TIMEOUT_US (120 * 1000000LL)
+#define ADDR_A 0x0100007f // 127.0.0.1 in network order
+#define ADDR_B 0x0200007f // 127.0.0.2
+
+static const char *const numbers[] = { "5551001", "5551002", "5551003" };
+
+// Static: two units are too big for the Unity task's stack
+static fleet_t a, b;
+
+// One round of datagrams from one unit to another: its heartbeat, plus the campaign
+// if it leads
+static void deliver(const fleet_t *from, fleet_t *to, uint32_t addr, int64_t now_us) {
+    uint8_t buf[FLEET_MSG_MAX];
+    size_t len = fleet_encode_heartbeat(from, buf, sizeof(buf));
+    TEST_ASSERT_NOT_EQUAL(0, len);
+    TEST_ASSERT_EQUAL(ESP_OK, fleet_receive(to, buf, len, addr, now_us));
+    if (fleet_is_leader(from) && from->campaign.id != 0) {
+        len = fleet_encode_campaign(from, buf, sizeof(buf));
+        TEST_ASSERT_NOT_EQUAL(0, len);
+        TEST_ASSERT_EQUAL(ESP_OK, fleet_receive(to, buf, len, addr, now_us));
+    }
+}
+
+static void exchange(fleet_t *leader, fleet_t *follower, int64_t now_us) {
+    deliver(leader, follower, ADDR_A, now_us);
+    deliver(follower, leader, ADDR_B, now_us);
+    fleet_tick(leader, now_us);
+    fleet_tick(follower, now_us);
+    deliver(leader, follower, ADDR_A, now_us); // Hand out whatever the leader just assigned
+}
+
+static void two_units(fleet_t *leader, fleet_t *follower) {
+    fleet_init(leader, 5, 8080, PEER_TIMEOUT_US, ATTEMPT_TIMEOUT_US);
+    fleet_init(follower, 9, 8090, PEER_TIMEOUT_US, ATTEMPT_TIMEOUT_US);
+    fleet_set_local(leader, true, false);
+    fleet_set_local(follower, true, false);
+    exchange(leader, follower, HEARTBEAT_US);
+}
+
+// The lowest ID leads; only the leader takes a campaign, and each idle unit with a
+// phone gets one number at a time
+void test_fleet_election_and_distribution(void) {
+    two_units(&a, &b);
+    TEST_ASSERT_TRUE(fleet_is_leader(&a));
+    TEST_ASSERT_FALSE(fleet_is_leader(&b));
+    TEST_ASSERT_EQUAL(5, b.leader);
+    TEST_ASSERT_EQUAL(1, b.peer_count);
+    TEST_ASSERT_EQUAL(ADDR_A, b.peers[0].addr);
+    TEST_ASSERT_EQUAL(8080, b.peers[0].http_port);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, fleet_start_campaign(&b, 77, numbers, 3, 2));
+    const char *bad[] = { "555-1234" };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, fleet_start_campaign(&a, 77, bad, 1, 2));
+    TEST_ASSERT_EQUAL(ESP_OK, fleet_start_campaign(&a, 77, numbers, 3, 2));
+
+    exchange(&a, &b, 2 * HEARTBEAT_US);
+    TEST_ASSERT_EQUAL(77, b.campaign.id);
+    TEST_ASSERT_EQUAL(a.campaign.version, b.campaign.version);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_ASSIGNED, a.campaign.entries[0].state);
+    TEST_ASSERT_EQUAL(5, a.campaign.entries[0].node);
+    TEST_ASSERT_EQUAL(9, a.campaign.entries[1].node);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_PENDING, a.campaign.entries[2].state);
+
+    char number[FLEET_NUMBER_MAX];
+    uint32_t attempt = 0;
+    TEST_ASSERT_TRUE(fleet_next_dial(&a, number, sizeof(number), &attempt));
+    TEST_ASSERT_EQUAL_STRING("5551001", number);
+    TEST_ASSERT_TRUE(fleet_next_dial(&b, number, sizeof(number), &attempt));
+    TEST_ASSERT_EQUAL_STRING("5551002", number);
+    TEST_ASSERT_FALSE(fleet_next_dial(&b, number, sizeof(number), &attempt)); // Already on it
+
+    // b's call fails: the number keeps one attempt and goes straight back to b
+    fleet_attempt_finished(&b, FLEET_OUTCOME_FAILED);
+    exchange(&a, &b, 3 * HEARTBEAT_US);
+    const fleet_entry_t *e = &a.campaign.entries[1];
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_ASSIGNED, e->state);
+    TEST_ASSERT_EQUAL(1, e->attempts_left);
+    TEST_ASSERT_TRUE(fleet_next_dial(&b, number, sizeof(number), &attempt));
+    TEST_ASSERT_EQUAL_STRING("5551002", number);
+    TEST_ASSERT_EQUAL(e->attempt, attempt);
+
+    // Failing the last attempt exhausts it; a's answer settles the first number
+    fleet_attempt_finished(&b, FLEET_OUTCOME_FAILED);
+    fleet_attempt_finished(&a, FLEET_OUTCOME_ANSWERED);
+    exchange(&a, &b, 4 * HEARTBEAT_US);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_ANSWERED, a.campaign.entries[0].state);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_EXHAUSTED, a.campaign.entries[1].state);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_ASSIGNED, a.campaign.entries[2].state);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_EXHAUSTED, b.campaign.entries[1].state);
+}
+
+// A unit that goes silent or loses its phone gives its number back, and a follower
+// takes over the campaign from its copy when the leader goes silent
+void test_fleet_failover(void) {
+    char number[FLEET_NUMBER_MAX];
+    two_units(&a, &b);
+    TEST_ASSERT_EQUAL(ESP_OK, fleet_start_campaign(&a, 77, numbers, 2, 3));
+    exchange(&a, &b, 2 * HEARTBEAT_US);
+    TEST_ASSERT_TRUE(fleet_next_dial(&b, number, sizeof(number), NULL));
+
+    // b loses its phone: its number is released, and a is busy with its own
+    TEST_ASSERT_TRUE(fleet_next_dial(&a, number, sizeof(number), NULL));
+    fleet_set_local(&b, false, false);
+    exchange(&a, &b, 3 * HEARTBEAT_US);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_PENDING, a.campaign.entries[1].state);
+    TEST_ASSERT_EQUAL(3, a.campaign.entries[1].attempts_left); // Not counted against it
+
+    // b's phone is back, then a goes silent: b takes the lead and a's number
+    fleet_set_local(&b, true, false);
+    exchange(&a, &b, 4 * HEARTBEAT_US);
+    fleet_attempt_finished(&b, FLEET_OUTCOME_NOT_SENT);
+    TEST_ASSERT_TRUE(fleet_tick(&b, 4 * HEARTBEAT_US + PEER_TIMEOUT_US + 1));
+    TEST_ASSERT_TRUE(fleet_is_leader(&b));
+    TEST_ASSERT_EQUAL(0, b.peer_count);
+    TEST_ASSERT_EQUAL(77, b.campaign.id);
+    TEST_ASSERT_EQUAL(9, b.campaign.entries[0].node);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_ASSIGNED, b.campaign.entries[0].state);
+    TEST_ASSERT_EQUAL(FLEET_ENTRY_PENDING, b.campaign.entries[1].state);
+    TEST_ASSERT_TRUE(fleet_next_dial(&b, number, sizeof(number), NULL));
+    TEST_ASSERT_EQUAL_STRING("5551001", number);
+}
+
+void test_fleet_rejects_damage(void) {
+    two_units(&a, &b);
+    TEST_ASSERT_EQUAL(ESP_OK, fleet_start_campaign(&a, 77, numbers, 3, 1));
+    fleet_tick(&a, 2 * HEARTBEAT_US);
+
+    uint8_t buf[FLEET_MSG_MAX];
+    size_t len = fleet_encode_campaign(&a, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(0, fleet_encode_campaign(&a, buf, len - 1)); // Does not fit
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, fleet_receive(&b, buf, len - 1, ADDR_A, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, fleet_receive(&b, buf, 4, ADDR_A, 0));
+    TEST_ASSERT_EQUAL(0, b.campaign.id);
+
+    buf[0] = 'X';
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_VERSION, fleet_receive(&b, buf, len, ADDR_A, 0));
+
+    // A campaign from anyone on the LAN is dialed, so one bad number drops all of it
+    len = fleet_encode_campaign(&a, buf, sizeof(buf));
+    size_t at = 0;
+    while (at + 7 < len && memcmp(buf + at, "5551003", 7) != 0) at++;
+    TEST_ASSERT_EQUAL_MEMORY("5551003", buf + at, 7);
+    buf[at + 3] = '"';
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, fleet_receive(&b, buf, len, ADDR_A, 0));
+    TEST_ASSERT_EQUAL(0, b.campaign.id);
+
+    // A unit's own datagram looped back by the group changes nothing
+    len = fleet_encode_heartbeat(&b, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(ESP_OK, fleet_receive(&b, buf, len, ADDR_B, 0));
+    TEST_ASSERT_EQUAL(1, b.peer_count);
+
+    static char json[1024];
+    TEST_ASSERT_GREATER_THAN(0, fleet_write_json(&a, 2 * HEARTBEAT_US, json, sizeof(json)));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"role\":\"leader\""));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"address\":\"127.0.0.2\""));
+    TEST_ASSERT_NOT_NULL(strstr(json, "{\"number\":\"5551001\",\"state\":\"assigned\""));
+    TEST_ASSERT_EQUAL(-1, fleet_write_json(&a, 0, json, 64));
+}
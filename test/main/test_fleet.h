@@ -0,0 +1,5 @@
+#pragma once
+
+void test_fleet_election_and_distribution(void);
+void test_fleet_failover(void);
+void test_fleet_rejects_damage(void);
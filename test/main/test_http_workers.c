@@ -0,0 +1,95 @@
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "http_workers.h"
+
+#define SETTLE_MS 50
+
+// Jobs park on a gate so the test controls when each one completes
+static SemaphoreHandle_t job_gate;
+static portMUX_TYPE jobs_lock = portMUX_INITIALIZER_UNLOCKED; // Two workers may finish at once
+static volatile int jobs_done;
+static volatile int job_args_sum;
+
+static void gated_job(void *arg) {
+    xSemaphoreTake(job_gate, portMAX_DELAY);
+    portENTER_CRITICAL(&jobs_lock);
+    job_args_sum += (int)(intptr_t)arg;
+    jobs_done++;
+    portEXIT_CRITICAL(&jobs_lock);
+}
+
+static void start(size_t workers, size_t queue_len) {
+    job_gate = xSemaphoreCreateCounting(16, 0);
+    jobs_done = 0;
+    job_args_sum = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, http_workers_init(workers, queue_len));
+}
+
+static void release_and_stop(int jobs) {
+    for (int i = 0; i < jobs; i++) {
+        xSemaphoreGive(job_gate);
+    }
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+    http_workers_deinit();
+    vSemaphoreDelete(job_gate);
+}
+
+// Every worker takes a job; the rest wait in the queue and run once one frees up
+void test_http_workers_run_jobs(void) {
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, http_workers_submit(gated_job, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, http_workers_init(0, 4));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, http_workers_init(HTTP_WORKERS_MAX + 1, 4));
+    start(2, 4);
+
+    for (int i = 1; i <= 4; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, http_workers_submit(gated_job, (void *)(intptr_t)i));
+    }
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+
+    http_workers_stats_t stats;
+    http_workers_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2, stats.workers);
+    TEST_ASSERT_EQUAL(4, stats.queue_len);
+    TEST_ASSERT_EQUAL(2, stats.busy);
+    TEST_ASSERT_EQUAL(2, stats.queue_depth);
+    TEST_ASSERT_EQUAL(4, stats.submitted);
+    TEST_ASSERT_EQUAL(0, stats.completed);
+
+    for (int i = 0; i < 4; i++) {
+        xSemaphoreGive(job_gate);
+    }
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+    TEST_ASSERT_EQUAL(4, jobs_done);
+    TEST_ASSERT_EQUAL(1 + 2 + 3 + 4, job_args_sum);
+
+    http_workers_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.busy);
+    TEST_ASSERT_EQUAL(0, stats.queue_depth);
+    TEST_ASSERT_EQUAL(4, stats.completed);
+    release_and_stop(0);
+}
+
+// A full queue refuses work at once instead of blocking the httpd task
+void test_http_workers_queue_full(void) {
+    start(1, 2);
+
+    TEST_ASSERT_EQUAL(ESP_OK, http_workers_submit(gated_job, NULL));
+    vTaskDelay(pdMS_TO_TICKS(SETTLE_MS)); // The worker is now parked on the first job
+    TEST_ASSERT_EQUAL(ESP_OK, http_workers_submit(gated_job, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, http_workers_submit(gated_job, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, http_workers_submit(gated_job, NULL));
+
+    http_workers_stats_t stats;
+    http_workers_get_stats(&stats);
+    TEST_ASSERT_EQUAL(3, stats.submitted);
+    TEST_ASSERT_EQUAL(1, stats.rejected);
+    TEST_ASSERT_EQUAL(2, stats.queue_depth);
+    TEST_ASSERT_EQUAL(2, stats.queue_high_water);
+
+    release_and_stop(3);
+    TEST_ASSERT_EQUAL(3, jobs_done);
+}
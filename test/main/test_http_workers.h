@@ -0,0 +1,4 @@
+#pragma once
+
+void test_http_workers_run_jobs(void);
+void test_http_workers_queue_full(void);
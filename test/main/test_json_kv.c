@@ -0,0 +1,76 @@
+#include "unity.h"
+#include <string.h>
+#include "json_kv.h"
+
+static esp_err_t parse(const char *json, json_kv_field_t *fields, size_t count) {
+    return json_kv_parse(json, strlen(json), fields, count);
+}
+
+// Escapes are decoded, unknown keys skipped, and oversized strings rejected rather than truncated
+void test_json_kv_strings(void) {
+    char ssid[9];
+    char password[17];
+    json_kv_field_t fields[] = {
+        { .key = "ssid",     .type = JSON_KV_STRING, .out = ssid,     .out_size = sizeof(ssid) },
+        { .key = "password", .type = JSON_KV_STRING, .out = password, .out_size = sizeof(password) },
+    };
+
+    TEST_ASSERT_EQUAL(ESP_OK, parse("{\"extra\":{\"a\":[1,2,{}]},\"ssid\":\"Home\\\"Net\",\"password\":\"p\\u00e9ss\\/w\"}", fields, 2));
+    TEST_ASSERT_TRUE(fields[0].present);
+    TEST_ASSERT_EQUAL_STRING("Home\"Net", ssid);
+    TEST_ASSERT_TRUE(fields[1].present);
+    TEST_ASSERT_EQUAL_STRING("p\xc3\xa9ss/w", password);
+
+    TEST_ASSERT_EQUAL(ESP_OK, parse("{\"ssid\":\"123456789\",\"password\":42}", fields, 2));
+    TEST_ASSERT_FALSE(fields[0].present);
+    TEST_ASSERT_EQUAL_STRING("", ssid);
+    TEST_ASSERT_FALSE(fields[1].present);
+}
+
+// The /set_auto_redial schema: required bool and number, optional numbers
+void test_json_kv_redial_schema(void) {
+    bool enabled = false;
+    uint32_t period = 0, random_delay = 0, max_count = 0;
+    json_kv_field_t fields[] = {
+        { .key = "enabled",      .type = JSON_KV_BOOL,   .out = &enabled },
+        { .key = "period",       .type = JSON_KV_UINT32, .out = &period },
+        { .key = "random_delay", .type = JSON_KV_UINT32, .out = &random_delay },
+        { .key = "max_count",    .type = JSON_KV_UINT32, .out = &max_count },
+    };
+
+    TEST_ASSERT_EQUAL(ESP_OK, parse(" { \"enabled\" : true , \"period\" : 60.7 , \"max_count\" : 0 } ", fields, 4));
+    TEST_ASSERT_TRUE(fields[0].present);
+    TEST_ASSERT_TRUE(enabled);
+    TEST_ASSERT_TRUE(fields[1].present);
+    TEST_ASSERT_EQUAL(60, period);
+    TEST_ASSERT_FALSE(fields[2].present);
+    TEST_ASSERT_TRUE(fields[3].present);
+    TEST_ASSERT_EQUAL(0, max_count);
+
+    // Wrong types, negatives and out-of-range numbers leave fields unset
+    TEST_ASSERT_EQUAL(ESP_OK, parse("{\"enabled\":\"yes\",\"period\":-5,\"random_delay\":4294967296,\"max_count\":1e3}", fields, 4));
+    TEST_ASSERT_FALSE(fields[0].present);
+    TEST_ASSERT_FALSE(fields[1].present);
+    TEST_ASSERT_FALSE(fields[2].present);
+    TEST_ASSERT_FALSE(fields[3].present);
+}
+
+// Anything that is not a single well-formed object is rejected
+void test_json_kv_malformed(void) {
+    bool enabled;
+    json_kv_field_t fields[] = {
+        { .key = "enabled", .type = JSON_KV_BOOL, .out = &enabled },
+    };
+
+    TEST_ASSERT_EQUAL(ESP_OK, parse("{}", fields, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, parse("", fields, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, parse("[true]", fields, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, parse("{\"enabled\":true", fields, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, parse("{\"enabled\":tru}", fields, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, parse("{\"enabled\":true,}", fields, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, parse("{\"enabled\":true} x", fields, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, parse("{\"a\":\"\\x\"}", fields, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, parse("{\"a\":[[[[[[[[[[1]]]]]]]]]]}", fields, 1));
+    // Truncated mid-body, as a short single recv used to leave it
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, json_kv_parse("{\"enabled\":true}", 10, fields, 1));
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+void test_json_kv_strings(void);
+void test_json_kv_redial_schema(void);
+void test_json_kv_malformed(void);
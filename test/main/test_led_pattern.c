@@ -0,0 +1,71 @@
+#include "unity.h"
+#include <string.h>
+#include "led_pattern.h"
+
+#define DOT MORSE_DOT_DURATION
+#define DASH MORSE_DASH_DURATION
+#define GAP MORSE_SYMBOL_PAUSE
+#define CHAR_GAP (MORSE_SYMBOL_PAUSE + MORSE_CHAR_PAUSE)
+
+// Same symbols and timing as the old per-symbol vTaskDelay loop
+void test_led_pattern_morse(void) {
+    led_pattern_t pattern = { .count = 0 };
+    TEST_ASSERT_EQUAL(ESP_OK, led_pattern_append_morse(&pattern, "1.x"));
+    const uint16_t expected[] = {
+        DOT, GAP, DASH, GAP, DASH, GAP, DASH, GAP, DASH, CHAR_GAP,       // 1 .----
+        DOT, GAP, DASH, GAP, DOT, GAP, DASH, GAP, DOT, GAP, DASH, CHAR_GAP, // . .-.-.-
+    };                                                                   // x is skipped
+    TEST_ASSERT_EQUAL(sizeof(expected) / sizeof(expected[0]), pattern.count);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, pattern.steps_ms, pattern.count);
+
+    // A text that does not fit leaves the pattern as it was
+    pattern.count = LED_PATTERN_MAX_STEPS - 8;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, led_pattern_append_morse(&pattern, "0"));
+    TEST_ASSERT_EQUAL(LED_PATTERN_MAX_STEPS - 8, pattern.count);
+}
+
+void test_led_pattern_markers(void) {
+    led_pattern_t pattern;
+
+    // Nothing to show: empty, so no timer has to run
+    led_status_t status = { .ip = "", .bluetooth_connected = false, .call = LED_CALL_NONE };
+    led_pattern_build(&status, &pattern);
+    TEST_ASSERT_EQUAL(0, pattern.count);
+
+    // Bluetooth alone: one long bar, then the readout pause
+    status.bluetooth_connected = true;
+    led_pattern_build(&status, &pattern);
+    TEST_ASSERT_EQUAL(2, pattern.count);
+    TEST_ASSERT_EQUAL(LED_BT_CONNECTED_ON_MS, pattern.steps_ms[0]);
+    TEST_ASSERT_EQUAL(MORSE_IP_READOUT_PAUSE, pattern.steps_ms[1]);
+
+    // IP readout, a gap, then the failed-call blinks instead of the Bluetooth bar
+    status.ip = "7";
+    status.call = LED_CALL_FAILED;
+    led_pattern_build(&status, &pattern);
+    TEST_ASSERT_EQUAL(10 + 2 * LED_CALL_FAILED_BLINKS, pattern.count);
+    TEST_ASSERT_EQUAL(CHAR_GAP + LED_MARKER_PAUSE, pattern.steps_ms[9]);
+    TEST_ASSERT_EQUAL(LED_CALL_FAILED_BLINK_MS, pattern.steps_ms[10]);
+    TEST_ASSERT_EQUAL(LED_CALL_FAILED_BLINK_MS + MORSE_IP_READOUT_PAUSE, pattern.steps_ms[pattern.count - 1]);
+
+    // A call in progress replaces everything else
+    status.call = LED_CALL_ACTIVE;
+    led_pattern_build(&status, &pattern);
+    TEST_ASSERT_EQUAL(2, pattern.count);
+    TEST_ASSERT_EQUAL(LED_CALL_ACTIVE_ON_MS + LED_CALL_ACTIVE_OFF_MS, led_pattern_period_ms(&pattern));
+}
+
+// The longest address plus the longest marker fits; an oversized string drops the readout only
+void test_led_pattern_worst_case_fits(void) {
+    led_pattern_t pattern;
+    led_status_t status = { .ip = "255.255.255.255", .bluetooth_connected = true, .call = LED_CALL_FAILED };
+    led_pattern_build(&status, &pattern);
+    TEST_ASSERT_EQUAL(2 * 78 + 2 * LED_CALL_FAILED_BLINKS, pattern.count);
+
+    status.ip = "................";
+    led_pattern_build(&status, &pattern);
+    TEST_ASSERT_EQUAL(2 * LED_CALL_FAILED_BLINKS, pattern.count);
+    for (size_t i = 0; i < pattern.count; i += 2) {
+        TEST_ASSERT_NOT_EQUAL(0, pattern.steps_ms[i]); // Every on step lights the LED
+    }
+}
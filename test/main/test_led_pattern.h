@@ -0,0 +1,5 @@
+#pragma once
+
+void test_led_pattern_morse(void);
+void test_led_pattern_markers(void);
+void test_led_pattern_worst_case_fits(void);
@@ -0,0 +1,93 @@
+#include "unity.h"
+#include <stdio.h>
+#include <string.h>
+#include "log_ring.h"
+
+static const char *format_seq(uint32_t seq, char *line, size_t len) {
+    log_record_t rec;
+    if (!log_ring_read(seq, &rec)) {
+        return NULL;
+    }
+    log_ring_format_line(&rec, line, len);
+    // Skip "<seq> <L> [<timestamp>] " to compare the tag and message
+    char *body = strchr(line, ']');
+    return body ? body + 2 : line;
+}
+
+// Arguments are captured at write time and formatted only when read back
+void test_log_ring_deferred_format(void) {
+    char line[LOG_RING_LINE_MAX];
+    char scratch[16];
+    TEST_ASSERT_EQUAL(ESP_OK, log_ring_init(8));
+
+    uint32_t seq = log_ring_next_seq();
+    snprintf(scratch, sizeof(scratch), "Home");
+    log_ring_write(ESP_LOG_INFO, "TEST", "ssid=%s count=%lu/%d delta=%lld ms %x%%",
+                   scratch, (unsigned long)3, -1, (long long)-1234567890123LL, 0xbeefu);
+    memset(scratch, 'X', sizeof(scratch) - 1); // The caller's buffer changes before the read
+
+    TEST_ASSERT_EQUAL_STRING("TEST: ssid=Home count=3/-1 delta=-1234567890123 ms beef%\n",
+                             format_seq(seq, line, sizeof(line)));
+    TEST_ASSERT_NOT_NULL(strstr(line, " I ["));
+
+    // Strings beyond the inline space are cut off and marked
+    log_ring_write(ESP_LOG_WARN, "TEST", "%s and %s", "a string that is quite long, nearly forty",
+                   "a second one that no longer fits");
+    const char *msg = format_seq(seq + 1, line, sizeof(line));
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_NOT_NULL(strstr(msg, "TEST: a string that is quite long, nearly forty and a sec...\n"));
+}
+
+// Old records are overwritten and reported as gone
+void test_log_ring_wraparound(void) {
+    char line[LOG_RING_LINE_MAX];
+    TEST_ASSERT_EQUAL(ESP_OK, log_ring_init(4));
+
+    uint32_t first = log_ring_next_seq();
+    for (int i = 0; i < 10; i++) {
+        log_ring_write(ESP_LOG_INFO, "TEST", "record %d", i);
+    }
+    TEST_ASSERT_EQUAL(first + 10, log_ring_next_seq());
+    TEST_ASSERT_EQUAL(first + 6, log_ring_oldest_seq());
+    TEST_ASSERT_NULL(format_seq(first + 5, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("TEST: record 6\n", format_seq(first + 6, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("TEST: record 9\n", format_seq(first + 9, line, sizeof(line)));
+
+    // Wall-clock offset applies when formatting, not when writing
+    log_record_t rec;
+    TEST_ASSERT_TRUE(log_ring_read(first + 9, &rec));
+    rec.timestamp_us = 1500000;
+    log_ring_set_wall_offset(1700000000LL * 1000000);
+    log_ring_format_line(&rec, line, sizeof(line));
+    TEST_ASSERT_NOT_NULL(strstr(line, "[1700000001.500000]"));
+    log_ring_set_wall_offset(5000000000LL * 1000000 + 700000); // Past 32-bit seconds
+    log_ring_format_line(&rec, line, sizeof(line));
+    TEST_ASSERT_NOT_NULL(strstr(line, "[5000000002.200000]"));
+    log_ring_set_wall_offset(0);
+}
+
+// Per-tag levels override the default and filter at the call site
+void test_log_ring_tag_levels(void) {
+    esp_log_level_t level;
+    TEST_ASSERT_EQUAL(ESP_OK, log_ring_init(8));
+    TEST_ASSERT_TRUE(log_ring_parse_level("debug", &level));
+    TEST_ASSERT_EQUAL(ESP_LOG_DEBUG, level);
+    TEST_ASSERT_FALSE(log_ring_parse_level("loud", &level));
+
+    log_ring_set_default_level(ESP_LOG_INFO);
+    TEST_ASSERT_EQUAL(ESP_OK, log_ring_set_level("CHATTY", ESP_LOG_ERROR));
+    TEST_ASSERT_EQUAL(ESP_LOG_ERROR, log_ring_get_level("CHATTY"));
+    TEST_ASSERT_EQUAL(ESP_LOG_INFO, log_ring_get_level("OTHER"));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, log_ring_set_level("A_VERY_LONG_TAG_NAME", ESP_LOG_DEBUG));
+
+    uint32_t before = log_ring_next_seq();
+    LOG_RING_WRITE(ESP_LOG_INFO, "CHATTY", "dropped %d", 1);
+    LOG_RING_WRITE(ESP_LOG_ERROR, "CHATTY", "kept %d", 2);
+    LOG_RING_WRITE(ESP_LOG_DEBUG, "OTHER", "dropped %d", 3);
+    TEST_ASSERT_EQUAL(before + 1, log_ring_next_seq());
+
+    log_ring_set_level("*", ESP_LOG_DEBUG);
+    LOG_RING_WRITE(ESP_LOG_DEBUG, "OTHER", "kept %d", 4);
+    TEST_ASSERT_EQUAL(before + 2, log_ring_next_seq());
+    log_ring_set_default_level(ESP_LOG_INFO);
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+void test_log_ring_deferred_format(void);
+void test_log_ring_wraparound(void);
+void test_log_ring_tag_levels(void);
@@ -4,6 +4,25 @@
 #include "test_utils.h"
 #include "test_http_handlers.h"
 #include "test_nvs_utils.h"
+#include "test_asset_manifest.h"
+#include "test_static_cache.h"
+#include "test_device_status.h"
+#include "test_json_kv.h"
+#include "test_redial_schedule.h"
+#include "test_call_control.h"
+#include "test_call_state.h"
+#include "test_metrics.h"
+#include "test_log_ring.h"
+#include "test_settings_store.h"
+#include "test_boot_timing.h"
+#include "test_asset_pack.h"
+#include "test_http_workers.h"
+#include "test_led_pattern.h"
+#include "test_device_state.h"
+#include "test_fleet.h"
+#include "test_wifi_cache.h"
+#include "test_bt_reconnect.h"
+#include "test_at_channel.h"
 
 /**
  * @brief Tells the QEMU emulator to exit with a success status code.
@@ -44,6 +63,104 @@ void app_main(void)
     RUN_TEST(test_nvs_mock);
     RUN_TEST(test_settings_persistence_mock);
 
+    // Static asset manifest tests
+    RUN_TEST(test_asset_manifest_lookup);
+    RUN_TEST(test_etag_matches);
+    RUN_TEST(test_accept_encoding_gzip);
+    RUN_TEST(test_static_cache_hit_miss);
+    RUN_TEST(test_static_cache_lru_eviction);
+
+    // Status serializer tests and microbenchmark
+    RUN_TEST(test_device_status_full_json);
+    RUN_TEST(test_device_status_worst_case_fits);
+    RUN_TEST(test_device_status_diff_json);
+    RUN_TEST(test_device_status_generation);
+    RUN_TEST(test_device_status_benchmark);
+
+    // POST body parser tests
+    RUN_TEST(test_json_kv_strings);
+    RUN_TEST(test_json_kv_redial_schema);
+    RUN_TEST(test_json_kv_malformed);
+
+    // Auto redial scheduling tests
+    RUN_TEST(test_redial_schedule_jitter_no_drift);
+    RUN_TEST(test_redial_schedule_late_fire_reanchors);
+    RUN_TEST(test_redial_schedule_back_to_back);
+    RUN_TEST(test_redial_session_stats);
+
+    // Call-control queue tests
+    RUN_TEST(test_call_control_priority_and_coalescing);
+    RUN_TEST(test_call_control_manual_supersedes_auto);
+    RUN_TEST(test_call_control_query_coalescing);
+    RUN_TEST(test_call_control_backpressure);
+
+    // Call state machine tests
+    RUN_TEST(test_call_state_answered_call_timing);
+    RUN_TEST(test_call_state_failures);
+    RUN_TEST(test_call_state_ignored_events);
+
+    // Metrics exposition tests
+    RUN_TEST(test_metrics_counters);
+    RUN_TEST(test_metrics_http_histogram);
+    RUN_TEST(test_metrics_wifi_connect_histogram);
+    RUN_TEST(test_metrics_bt_reconnect_histogram);
+    RUN_TEST(test_metrics_at_round_trip_histogram);
+
+    // Log ring tests
+    RUN_TEST(test_log_ring_deferred_format);
+    RUN_TEST(test_log_ring_wraparound);
+    RUN_TEST(test_log_ring_tag_levels);
+
+    // Settings blob and write coalescing tests
+    RUN_TEST(test_settings_blob_round_trip);
+    RUN_TEST(test_settings_blob_rejects_corruption);
+    RUN_TEST(test_settings_blob_older_payload);
+    RUN_TEST(test_settings_store_migrates_and_coalesces);
+    RUN_TEST(test_settings_store_erases_leftover_legacy_keys);
+
+    // Boot phase timing tests
+    RUN_TEST(test_boot_timing_phases);
+    RUN_TEST(test_boot_timing_milestones);
+    RUN_TEST(test_boot_timing_worst_case_fits);
+
+    // Memory-mapped asset pack tests
+    RUN_TEST(test_asset_pack_lookup);
+    RUN_TEST(test_asset_pack_gzip_preference);
+    RUN_TEST(test_asset_pack_rejects_damage);
+
+    // HTTP worker pool tests
+    RUN_TEST(test_http_workers_run_jobs);
+    RUN_TEST(test_http_workers_queue_full);
+
+    // Status LED pattern tests
+    RUN_TEST(test_led_pattern_morse);
+    RUN_TEST(test_led_pattern_markers);
+    RUN_TEST(test_led_pattern_worst_case_fits);
+
+    // Shared device state tests
+    RUN_TEST(test_device_state_setters);
+    RUN_TEST(test_device_state_no_torn_reads);
+
+    // Fleet coordinator tests
+    RUN_TEST(test_fleet_election_and_distribution);
+    RUN_TEST(test_fleet_failover);
+    RUN_TEST(test_fleet_rejects_damage);
+
+    // Wi-Fi AP cache tests
+    RUN_TEST(test_wifi_cache_blob_round_trip);
+    RUN_TEST(test_wifi_cache_store_skips_unchanged);
+
+    // Bluetooth reconnect tests
+    RUN_TEST(test_bt_reconnect_backoff_bounds);
+    RUN_TEST(test_bt_reconnect_latency_and_attempts);
+    RUN_TEST(test_bt_reconnect_peer_store);
+
+    // AT command channel tests
+    RUN_TEST(test_at_channel_fifo_correlation);
+    RUN_TEST(test_at_channel_depth_and_unsend);
+    RUN_TEST(test_at_channel_timeout_and_late_answer);
+    RUN_TEST(test_at_channel_flush);
+
     // UNITY_END() returns the number of failures.
     int failures = UNITY_END();
 
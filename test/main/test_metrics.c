@@ -0,0 +1,154 @@
+#include "unity.h"
+#include <string.h>
+#include "metrics.h"
+
+static char exposition[16384];
+static size_t exposition_len;
+
+static void collect(void *ctx, const char *text, size_t len) {
+    (void)ctx;
+    if (exposition_len + len < sizeof(exposition)) {
+        memcpy(exposition + exposition_len, text, len);
+        exposition_len += len;
+        exposition[exposition_len] = '\0';
+    }
+}
+
+static const char *render(void) {
+    metrics_system_t sys = { .uptime_us = 12500000, .free_heap = 150000, .min_free_heap = 98000,
+                             .settings_updates = 7, .settings_flushes = 2, .settings_bytes_written = 56,
+                             .settings_dirty = true, .http_workers = 2, .http_worker_queue_depth = 1,
+                             .http_worker_queue_high_water = 3, .http_worker_rejected = 4 };
+    exposition_len = 0;
+    exposition[0] = '\0';
+    metrics_render(&sys, collect, NULL);
+    return exposition;
+}
+
+// Plain counters, HFP event counts and the sampled system values
+void test_metrics_counters(void) {
+    metrics_reset();
+    metrics_inc(METRIC_DIAL_ATTEMPTS);
+    metrics_inc(METRIC_DIAL_ATTEMPTS);
+    metrics_inc(METRIC_DIAL_FAILURES);
+    metrics_hfp_event(9);
+    metrics_hfp_event(9);
+    metrics_hfp_event(1000); // Out of range lands in "other"
+
+    const char *text = render();
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE remotehead_dial_attempts_total counter\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_dial_attempts_total 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_dial_failures_total 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_dial_answers_total 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_hfp_events_total{event=\"9\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_hfp_events_total{event=\"other\"} 1\n"));
+    TEST_ASSERT_NULL(strstr(text, "remotehead_hfp_events_total{event=\"0\"}"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_uptime_seconds 12.500000\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_min_free_heap_bytes 98000\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_settings_updates_total 7\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_settings_flushes_total 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_settings_flash_bytes_total 56\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_settings_dirty 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_http_workers 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_http_worker_queue_depth 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_http_worker_queue_high_water 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_http_worker_rejected_total 4\n"));
+}
+
+// Buckets are cumulative and +Inf matches the request count
+void test_metrics_http_histogram(void) {
+    metrics_reset();
+    int status = metrics_register_endpoint("GET", "/status");
+    TEST_ASSERT_EQUAL(status, metrics_register_endpoint("GET", "/status")); // Server restart
+    TEST_ASSERT_NOT_EQUAL(status, metrics_register_endpoint("POST", "/status"));
+
+    metrics_observe_request(status, 800, false);     // <= 1 ms
+    metrics_observe_request(status, 1000, false);    // Bucket bounds are inclusive
+    metrics_observe_request(status, 30000, false);   // <= 50 ms
+    metrics_observe_request(status, 4000000, true);  // Beyond the last bound
+    metrics_observe_request(42, 1000, false);        // Unknown endpoint is ignored
+
+    const char *text = render();
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_http_requests_total{method=\"GET\",uri=\"/status\"} 4\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_http_handler_errors_total{method=\"GET\",uri=\"/status\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "_bucket{method=\"GET\",uri=\"/status\",le=\"0.001\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "_bucket{method=\"GET\",uri=\"/status\",le=\"0.025\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "_bucket{method=\"GET\",uri=\"/status\",le=\"0.05\"} 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "_bucket{method=\"GET\",uri=\"/status\",le=\"2.5\"} 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "_bucket{method=\"GET\",uri=\"/status\",le=\"+Inf\"} 4\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "_sum{method=\"GET\",uri=\"/status\"} 4.031800\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "_count{method=\"GET\",uri=\"/status\"} 4\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_http_requests_total{method=\"POST\",uri=\"/status\"} 0\n"));
+
+    // The sum outgrows 32 bits of microseconds long before the count does
+    for (int i = 0; i < 5; i++) {
+        metrics_observe_request(status, 1000000000, false); // 1000 s each
+    }
+    text = render();
+    TEST_ASSERT_NOT_NULL(strstr(text, "_sum{method=\"GET\",uri=\"/status\"} 5004.031800\n"));
+}
+
+// Cached-AP and full-scan connects land in separate series
+void test_metrics_wifi_connect_histogram(void) {
+    metrics_reset();
+    metrics_observe_wifi_connect(180000, true);   // <= 0.25 s
+    metrics_observe_wifi_connect(250000, true);   // Bucket bounds are inclusive
+    metrics_observe_wifi_connect(3200000, false); // <= 4 s
+    metrics_observe_wifi_connect(30000000, false); // Beyond the last bound
+    metrics_inc(METRIC_WIFI_CACHE_FALLBACKS);
+
+    const char *text = render();
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE remotehead_wifi_connect_seconds histogram\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_wifi_connect_seconds_bucket{path=\"cached\",le=\"0.25\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_wifi_connect_seconds_sum{path=\"cached\"} 0.430\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_wifi_connect_seconds_bucket{path=\"scan\",le=\"2\"} 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_wifi_connect_seconds_bucket{path=\"scan\",le=\"4\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_wifi_connect_seconds_bucket{path=\"scan\",le=\"+Inf\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_wifi_connect_seconds_count{path=\"scan\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_wifi_cache_fallbacks_total 1\n"));
+}
+
+void test_metrics_bt_reconnect_histogram(void) {
+    metrics_reset();
+    metrics_observe_bt_reconnect(1500000);   // <= 2 s
+    metrics_observe_bt_reconnect(90000000);  // <= 128 s
+    metrics_observe_bt_reconnect(600000000); // Beyond the last bound
+    metrics_inc(METRIC_BT_RECONNECT_ATTEMPTS);
+    metrics_inc(METRIC_BT_RECONNECT_ATTEMPTS);
+    metrics_inc(METRIC_BT_RECONNECTS);
+
+    const char *text = render();
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE remotehead_bt_reconnect_seconds histogram\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_bt_reconnect_seconds_bucket{le=\"1\"} 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_bt_reconnect_seconds_bucket{le=\"2\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_bt_reconnect_seconds_bucket{le=\"128\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_bt_reconnect_seconds_bucket{le=\"+Inf\"} 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_bt_reconnect_seconds_sum 691.500\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_bt_reconnect_seconds_count 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_bt_reconnect_attempts_total 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_bt_reconnects_total 1\n"));
+}
+
+// Answered commands land in their own command's histogram; timeouts are only counted
+void test_metrics_at_round_trip_histogram(void) {
+    metrics_reset();
+    metrics_observe_at(AT_CMD_DIAL, AT_RESULT_OK, 1800000);   // <= 2.5 s
+    metrics_observe_at(AT_CMD_DIAL, AT_RESULT_BUSY, 400000);  // <= 0.5 s
+    metrics_observe_at(AT_CMD_DIAL, AT_RESULT_TIMEOUT, 15000000);
+    metrics_observe_at(AT_CMD_CLCC, AT_RESULT_OK, 40000);     // <= 0.05 s
+    metrics_inc(METRIC_AT_UNMATCHED);
+
+    const char *text = render();
+    TEST_ASSERT_NOT_NULL(strstr(text, "# TYPE remotehead_at_round_trip_seconds histogram\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_round_trip_seconds_bucket{command=\"dial\",le=\"0.25\"} 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_round_trip_seconds_bucket{command=\"dial\",le=\"0.5\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_round_trip_seconds_bucket{command=\"dial\",le=\"2.5\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_round_trip_seconds_bucket{command=\"dial\",le=\"+Inf\"} 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_round_trip_seconds_sum{command=\"dial\"} 2.200\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_round_trip_seconds_bucket{command=\"clcc\",le=\"0.05\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_round_trip_seconds_count{command=\"hangup\"} 0\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_commands_total{command=\"dial\",result=\"timeout\"} 1\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_commands_total{command=\"dial\",result=\"busy\"} 1\n"));
+    TEST_ASSERT_NULL(strstr(text, "remotehead_at_commands_total{command=\"hangup\""));
+    TEST_ASSERT_NOT_NULL(strstr(text, "remotehead_at_unmatched_answers_total 1\n"));
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+void test_metrics_counters(void);
+void test_metrics_http_histogram(void);
+void test_metrics_wifi_connect_histogram(void);
+void test_metrics_bt_reconnect_histogram(void);
+void test_metrics_at_round_trip_histogram(void);
@@ -0,0 +1,180 @@
+#include "unity.h"
+#include <stdio.h>
+#include "esp_timer.h"
+#include "redial_schedule.h"
+
+#define SIM_CYCLES 10000
+#define SIM_PERIOD_S 60
+#define SIM_JITTER_S 15
+#define SIM_MAX_LATENESS_US 20000 // Simulated esp_timer dispatch latency per cycle
+
+// Small deterministic generator so the simulation is repeatable
+static uint32_t sim_rand_state;
+static uint32_t sim_rand(void) {
+    sim_rand_state = sim_rand_state * 1664525u + 1013904223u;
+    return sim_rand_state;
+}
+
+// Thousands of cycles with realistic timer latency: every attempt lands at
+// start + sum(period + jitter), jitter stays in range and latency never accumulates
+void test_redial_schedule_jitter_no_drift(void) {
+    redial_schedule_t sched;
+    sim_rand_state = 12345;
+    int64_t now = 1000000;
+    int64_t planned = now;
+    char report[96];
+
+    int64_t delay = redial_schedule_start(&sched, now, SIM_PERIOD_S, SIM_JITTER_S, sim_rand());
+    planned += (int64_t)(SIM_PERIOD_S + sched.last_jitter_s) * 1000000;
+    TEST_ASSERT_TRUE(sched.next_deadline_us == planned);
+
+    int64_t wall_start = esp_timer_get_time();
+    for (int i = 0; i < SIM_CYCLES; i++) {
+        // The one-shot fires a little after the requested delay
+        now += delay + (int64_t)(sim_rand() % SIM_MAX_LATENESS_US);
+        delay = redial_schedule_advance(&sched, now, sim_rand());
+
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(SIM_JITTER_S, sched.last_jitter_s);
+        TEST_ASSERT_TRUE(sched.last_lateness_us < SIM_MAX_LATENESS_US);
+        TEST_ASSERT_TRUE(delay > 0);
+        TEST_ASSERT_TRUE(delay <= (int64_t)(SIM_PERIOD_S + SIM_JITTER_S) * 1000000);
+
+        planned += (int64_t)(SIM_PERIOD_S + sched.last_jitter_s) * 1000000;
+        TEST_ASSERT_TRUE(sched.next_deadline_us == planned);
+    }
+    int64_t wall_us = esp_timer_get_time() - wall_start;
+
+    TEST_ASSERT_TRUE(sched.drift_us == 0);
+    // Scheduling is pure arithmetic; simulated days of redials take well under a second
+    TEST_ASSERT_TRUE(wall_us < 1000000);
+    snprintf(report, sizeof(report), "%d simulated redial cycles in %lld us", SIM_CYCLES, (long long)wall_us);
+    TEST_MESSAGE(report);
+}
+
+// A fire that misses a whole interval shifts the plan once instead of bursting
+void test_redial_schedule_late_fire_reanchors(void) {
+    redial_schedule_t sched;
+    int64_t now = 0;
+
+    int64_t delay = redial_schedule_start(&sched, now, 10, 0, 0);
+    TEST_ASSERT_TRUE(delay == 10000000);
+
+    now = sched.next_deadline_us + 25000000; // 25 s late with a 10 s period
+    delay = redial_schedule_advance(&sched, now, 0);
+    TEST_ASSERT_TRUE(delay == 10000000);
+    TEST_ASSERT_TRUE(sched.drift_us == 25000000);
+    TEST_ASSERT_TRUE(sched.last_lateness_us == 25000000);
+
+    // Back on time: no further drift
+    now = sched.next_deadline_us;
+    delay = redial_schedule_advance(&sched, now, 0);
+    TEST_ASSERT_TRUE(delay == 10000000);
+    TEST_ASSERT_TRUE(sched.drift_us == 25000000);
+
+    redial_schedule_stop(&sched);
+    TEST_ASSERT_TRUE(sched.next_deadline_us == 0);
+}
+
+// Back-to-back: the next attempt follows the guard gap after the line goes idle, the
+// period stays available as the fallback, and busy lines get far more attempts per hour
+void test_redial_schedule_back_to_back(void) {
+    redial_schedule_t sched;
+    int64_t now = 1000000;
+    char report[96];
+
+    redial_schedule_start(&sched, now, 60, 2, 0);
+    int64_t delay = redial_schedule_after_idle(&sched, now, 3, 1); // Jitter 1 s
+    TEST_ASSERT_TRUE(delay == 4000000);
+    TEST_ASSERT_TRUE(sched.next_deadline_us == now + 4000000);
+
+    // Fired on time: the fallback deadline is a full period (+ jitter) out
+    now = sched.next_deadline_us;
+    delay = redial_schedule_advance(&sched, now, 0);
+    TEST_ASSERT_TRUE(delay == 60000000);
+
+    // The busy attempt ends 8 s later and replaces the fallback
+    now += 8000000;
+    delay = redial_schedule_after_idle(&sched, now, 3, 0);
+    TEST_ASSERT_TRUE(delay == 3000000);
+    TEST_ASSERT_TRUE(sched.next_deadline_us == now + 3000000);
+    TEST_ASSERT_TRUE(sched.drift_us == 0);
+
+    // One simulated hour against a line that is busy for 8 s per attempt, driven the way
+    // the firmware drives it: each fire advances the schedule, and in back-to-back mode the
+    // end of the busy call re-plans from the guard gap
+    int64_t start = 1;
+    int64_t hour_us = (int64_t)3600 * 1000000;
+    redial_session_t periodic = {0}, back_to_back = {0};
+
+    redial_session_start(&periodic, start);
+    delay = redial_schedule_start(&sched, start, 60, 0, 0);
+    TEST_ASSERT_TRUE(delay == 60000000);
+    while (sched.next_deadline_us - start <= hour_us) {
+        now = sched.next_deadline_us;
+        redial_session_attempt(&periodic);
+        delay = redial_schedule_advance(&sched, now, 0);
+        TEST_ASSERT_TRUE(delay == 60000000);
+        TEST_ASSERT_TRUE(sched.next_deadline_us == now + 60000000);
+    }
+    TEST_ASSERT_EQUAL_UINT32(60, periodic.attempts);
+    TEST_ASSERT_TRUE(sched.drift_us == 0);
+
+    redial_session_start(&back_to_back, start);
+    redial_schedule_start(&sched, start, 60, 0, 0);
+    delay = redial_schedule_after_idle(&sched, start, 3, 0);
+    TEST_ASSERT_TRUE(delay == 3000000);
+    while (sched.next_deadline_us - start <= hour_us) {
+        now = sched.next_deadline_us;
+        redial_session_attempt(&back_to_back);
+        redial_schedule_advance(&sched, now, 0); // Fallback, replaced when the call ends
+        TEST_ASSERT_TRUE(sched.next_deadline_us == now + 60000000);
+        delay = redial_schedule_after_idle(&sched, now + 8000000, 3, 0);
+        TEST_ASSERT_TRUE(delay == 3000000);
+        TEST_ASSERT_TRUE(sched.next_deadline_us == now + 11000000);
+    }
+    TEST_ASSERT_EQUAL_UINT32(328, back_to_back.attempts); // At 3 s, 14 s, ... 3600 s
+    TEST_ASSERT_TRUE(sched.drift_us == 0);
+
+    uint32_t periodic_rate = redial_session_attempts_per_hour(&periodic, start + hour_us);
+    uint32_t b2b_rate = redial_session_attempts_per_hour(&back_to_back, start + hour_us);
+    TEST_ASSERT_EQUAL_UINT32(60, periodic_rate);
+    TEST_ASSERT_EQUAL_UINT32(328, b2b_rate);
+    snprintf(report, sizeof(report), "busy line attempts/hour: periodic=%lu back_to_back=%lu",
+             (unsigned long)periodic_rate, (unsigned long)b2b_rate);
+    TEST_MESSAGE(report);
+}
+
+// Sessions count attempts until the first answer and keep the result once stopped
+void test_redial_session_stats(void) {
+    redial_session_t session = {0};
+
+    TEST_ASSERT_FALSE(redial_session_connected(&session, 5));
+    redial_session_attempt(&session); // Not running: ignored
+    TEST_ASSERT_EQUAL_UINT32(0, session.attempts);
+
+    redial_session_start(&session, 10000000);
+    redial_session_attempt(&session);
+    redial_session_attempt(&session);
+    redial_session_attempt(&session);
+    // 3 attempts in 90 s
+    TEST_ASSERT_EQUAL_UINT32(120, redial_session_attempts_per_hour(&session, 100000000));
+
+    TEST_ASSERT_TRUE(redial_session_connected(&session, 130000000));
+    TEST_ASSERT_TRUE(session.last_connect_us == 120000000);
+    TEST_ASSERT_EQUAL_UINT32(3, session.last_attempts);
+    TEST_ASSERT_EQUAL_UINT32(90, session.last_attempts_per_hour);
+    // Reported until the next session starts, and a second answer is not double counted
+    TEST_ASSERT_EQUAL_UINT32(90, redial_session_attempts_per_hour(&session, 999000000));
+    TEST_ASSERT_FALSE(redial_session_connected(&session, 140000000));
+
+    redial_session_start(&session, 200000000);
+    redial_session_stop(&session);
+    TEST_ASSERT_TRUE(session.last_connect_us == 120000000);
+
+    redial_mode_t mode = REDIAL_MODE_PERIODIC;
+    TEST_ASSERT_TRUE(redial_mode_from_name("back_to_back", &mode));
+    TEST_ASSERT_EQUAL(REDIAL_MODE_BACK_TO_BACK, mode);
+    TEST_ASSERT_EQUAL_STRING("periodic", redial_mode_name(REDIAL_MODE_PERIODIC));
+    TEST_ASSERT_FALSE(redial_mode_from_name("burst", &mode));
+    TEST_ASSERT_EQUAL(REDIAL_MODE_BACK_TO_BACK, mode);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+void test_redial_schedule_jitter_no_drift(void);
+void test_redial_schedule_late_fire_reanchors(void);
+void test_redial_schedule_back_to_back(void);
+void test_redial_session_stats(void);
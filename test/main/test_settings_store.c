@@ -0,0 +1,179 @@
+#include "unity.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "settings_store.h"
+
+static const settings_t sample = {
+    .auto_redial_enabled = true,
+    .redial_period_s = 90,
+    .redial_random_delay_s = 15,
+    .redial_max_count = 40,
+    .redial_mode = 1,
+    .redial_guard_s = 5,
+};
+
+static void assert_settings_equal(const settings_t *expected, const settings_t *actual) {
+    TEST_ASSERT_EQUAL(expected->auto_redial_enabled, actual->auto_redial_enabled);
+    TEST_ASSERT_EQUAL_UINT32(expected->redial_period_s, actual->redial_period_s);
+    TEST_ASSERT_EQUAL_UINT32(expected->redial_random_delay_s, actual->redial_random_delay_s);
+    TEST_ASSERT_EQUAL_UINT32(expected->redial_max_count, actual->redial_max_count);
+    TEST_ASSERT_EQUAL_UINT8(expected->redial_mode, actual->redial_mode);
+    TEST_ASSERT_EQUAL_UINT32(expected->redial_guard_s, actual->redial_guard_s);
+}
+
+void test_settings_blob_round_trip(void) {
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    TEST_ASSERT_EQUAL(0, settings_blob_encode(&sample, blob, sizeof(blob) - 1));
+    TEST_ASSERT_EQUAL(SETTINGS_BLOB_SIZE, settings_blob_encode(&sample, blob, sizeof(blob)));
+
+    settings_t decoded;
+    TEST_ASSERT_EQUAL(ESP_OK, settings_blob_decode(blob, sizeof(blob), &decoded));
+    assert_settings_equal(&sample, &decoded);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, settings_crc32((const uint8_t *)"123456789", 9)); // Check value
+}
+
+// A damaged blob is reported and leaves the output untouched
+void test_settings_blob_rejects_corruption(void) {
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    settings_blob_encode(&sample, blob, sizeof(blob));
+    settings_t out;
+    settings_defaults(&out);
+
+    blob[SETTINGS_BLOB_HEADER_SIZE + 2] ^= 0x01; // Flip a bit in the period
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, settings_blob_decode(blob, sizeof(blob), &out));
+    TEST_ASSERT_EQUAL_UINT32(60, out.redial_period_s);
+    blob[SETTINGS_BLOB_HEADER_SIZE + 2] ^= 0x01;
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, settings_blob_decode(blob, sizeof(blob) - 1, &out));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, settings_blob_decode(blob, 4, &out));
+    blob[0] ^= 0xFF;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_VERSION, settings_blob_decode(blob, sizeof(blob), &out));
+}
+
+// A blob from firmware that had fewer fields decodes with defaults for the new ones
+void test_settings_blob_older_payload(void) {
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    settings_blob_encode(&sample, blob, sizeof(blob));
+
+    // Truncate to the first four fields (no mode, no guard) and re-seal it
+    const size_t payload_len = 13;
+    blob[4] = payload_len;
+    blob[5] = 0;
+    size_t crc_offset = SETTINGS_BLOB_HEADER_SIZE + payload_len;
+    uint32_t crc = settings_crc32(blob, crc_offset);
+    for (int i = 0; i < 4; i++) blob[crc_offset + i] = (uint8_t)(crc >> (8 * i));
+
+    settings_t decoded;
+    TEST_ASSERT_EQUAL(ESP_OK, settings_blob_decode(blob, crc_offset + 4, &decoded));
+    settings_t expected = sample;
+    expected.redial_mode = 0;
+    expected.redial_guard_s = 3;
+    assert_settings_equal(&expected, &decoded);
+}
+
+// Legacy keys become one blob at boot; a burst of updates costs a single flash write
+void test_settings_store_migrates_and_coalesces(void) {
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        TEST_ASSERT_EQUAL(ESP_OK, nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    nvs_handle_t handle;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open(SETTINGS_STORE_NAMESPACE, NVS_READWRITE, &handle));
+    nvs_erase_all(handle);
+    nvs_set_u8(handle, "auto_en", 1);
+    nvs_set_u32(handle, "redial_period", 120);
+    nvs_commit(handle);
+    nvs_close(handle);
+
+    settings_t loaded;
+    TEST_ASSERT_EQUAL(ESP_OK, settings_store_init(50, &loaded));
+    TEST_ASSERT_TRUE(loaded.auto_redial_enabled);
+    TEST_ASSERT_EQUAL_UINT32(120, loaded.redial_period_s);
+    TEST_ASSERT_EQUAL_UINT32(3, loaded.redial_guard_s);
+
+    settings_store_stats_t stats;
+    settings_store_get_stats(&stats);
+    TEST_ASSERT_TRUE(stats.migrated);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.flushes);
+
+    uint32_t legacy;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open(SETTINGS_STORE_NAMESPACE, NVS_READONLY, &handle));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs_get_u32(handle, "redial_period", &legacy));
+    nvs_close(handle);
+
+    settings_t s = loaded;
+    for (uint32_t period = 10; period <= 50; period += 10) {
+        s.redial_period_s = period;
+        settings_store_update(&s);
+    }
+    settings_store_update(&s); // Same values again: no write needed
+    settings_store_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.updates);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.unchanged);
+    TEST_ASSERT_TRUE(stats.dirty);
+
+    vTaskDelay(pdMS_TO_TICKS(300));
+    settings_store_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.flushes);
+    TEST_ASSERT_EQUAL_UINT32(2 * SETTINGS_BLOB_SIZE, stats.bytes_written);
+    TEST_ASSERT_FALSE(stats.dirty);
+
+    // A reboot reads back the last values from the blob
+    settings_store_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, settings_store_init(50, &loaded));
+    TEST_ASSERT_EQUAL_UINT32(50, loaded.redial_period_s);
+    settings_store_get_stats(&stats);
+    TEST_ASSERT_FALSE(stats.migrated);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.flushes);
+    settings_store_deinit();
+}
+
+// Legacy keys left beside a valid blob (a migration whose erase never reached flash)
+// are erased by the next flush, and the blob's values win over theirs
+void test_settings_store_erases_leftover_legacy_keys(void) {
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_flash_init());
+
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    TEST_ASSERT_EQUAL(SETTINGS_BLOB_SIZE, settings_blob_encode(&sample, blob, sizeof(blob)));
+    nvs_handle_t handle;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open(SETTINGS_STORE_NAMESPACE, NVS_READWRITE, &handle));
+    nvs_erase_all(handle);
+    nvs_set_blob(handle, SETTINGS_STORE_KEY, blob, sizeof(blob));
+    nvs_set_u32(handle, "redial_period", 120);
+    nvs_set_u8(handle, "redial_mode", 0);
+    nvs_commit(handle);
+    nvs_close(handle);
+
+    settings_t loaded;
+    TEST_ASSERT_EQUAL(ESP_OK, settings_store_init(50, &loaded));
+    assert_settings_equal(&sample, &loaded);
+
+    vTaskDelay(pdMS_TO_TICKS(300));
+    settings_store_stats_t stats;
+    settings_store_get_stats(&stats);
+    TEST_ASSERT_TRUE(stats.migrated);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.flushes);
+    TEST_ASSERT_FALSE(stats.dirty);
+
+    uint32_t u32;
+    uint8_t u8;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open(SETTINGS_STORE_NAMESPACE, NVS_READONLY, &handle));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs_get_u32(handle, "redial_period", &u32));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs_get_u8(handle, "redial_mode", &u8));
+    nvs_close(handle);
+
+    // Nothing left to erase: the next boot writes nothing
+    settings_store_deinit();
+    TEST_ASSERT_EQUAL(ESP_OK, settings_store_init(50, &loaded));
+    vTaskDelay(pdMS_TO_TICKS(300));
+    settings_store_get_stats(&stats);
+    TEST_ASSERT_FALSE(stats.migrated);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.flushes);
+    settings_store_deinit();
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+void test_settings_blob_round_trip(void);
+void test_settings_blob_rejects_corruption(void);
+void test_settings_blob_older_payload(void);
+void test_settings_store_migrates_and_coalesces(void);
+void test_settings_store_erases_leftover_legacy_keys(void);
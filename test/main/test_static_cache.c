@@ -0,0 +1,50 @@
+#include "unity.h"
+#include <string.h>
+#include "static_cache.h"
+
+static const uint8_t payload[100] = {0};
+
+// A second lookup of the same file is a hit and returns the same bytes
+void test_static_cache_hit_miss(void) {
+    static_cache_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, static_cache_init(1024, 512));
+
+    TEST_ASSERT_NULL(static_cache_get("/spiffs/index.html"));
+    TEST_ASSERT_NOT_NULL(static_cache_put("/spiffs/index.html", payload, sizeof(payload)));
+    const static_cache_entry_t *entry = static_cache_get("/spiffs/index.html");
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL(sizeof(payload), entry->len);
+
+    static_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.hits);
+    TEST_ASSERT_EQUAL(1, stats.misses);
+    TEST_ASSERT_EQUAL(1, stats.entries);
+    TEST_ASSERT_EQUAL(sizeof(payload), stats.bytes_used);
+
+    // Files over the per-entry limit are never cached
+    TEST_ASSERT_FALSE(static_cache_accepts(513));
+    static_cache_clear();
+}
+
+// The least recently used file is evicted first once the capacity is reached
+void test_static_cache_lru_eviction(void) {
+    static_cache_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, static_cache_init(300, 100));
+
+    static_cache_put("/a", payload, 100);
+    static_cache_put("/b", payload, 100);
+    static_cache_put("/c", payload, 100);
+    TEST_ASSERT_NOT_NULL(static_cache_get("/a")); // "/b" is now the oldest
+    static_cache_put("/d", payload, 100);
+
+    TEST_ASSERT_NULL(static_cache_get("/b"));
+    TEST_ASSERT_NOT_NULL(static_cache_get("/a"));
+    TEST_ASSERT_NOT_NULL(static_cache_get("/c"));
+    TEST_ASSERT_NOT_NULL(static_cache_get("/d"));
+
+    static_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.evictions);
+    TEST_ASSERT_EQUAL(3, stats.entries);
+    TEST_ASSERT_LESS_OR_EQUAL(300, stats.bytes_used);
+    static_cache_clear();
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+void test_static_cache_hit_miss(void);
+void test_static_cache_lru_eviction(void);
@@ -0,0 +1,90 @@
+#include "unity.h"
+#include <string.h>
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "wifi_cache.h"
+
+static const uint8_t home_bssid[6] = { 0x24, 0x0a, 0xc4, 0x12, 0x34, 0x56 };
+
+void test_wifi_cache_blob_round_trip(void) {
+    wifi_cache_t cache, decoded;
+    wifi_cache_set(&cache, "home", home_bssid, 11);
+    TEST_ASSERT_TRUE(wifi_cache_matches(&cache, "home"));
+    TEST_ASSERT_FALSE(wifi_cache_matches(&cache, "home2"));
+    TEST_ASSERT_FALSE(wifi_cache_matches(&cache, "hom"));
+
+    uint8_t blob[WIFI_CACHE_BLOB_SIZE];
+    TEST_ASSERT_EQUAL(0, wifi_cache_encode(&cache, blob, sizeof(blob) - 1));
+    TEST_ASSERT_EQUAL(WIFI_CACHE_BLOB_SIZE, wifi_cache_encode(&cache, blob, sizeof(blob)));
+    TEST_ASSERT_EQUAL(ESP_OK, wifi_cache_decode(blob, sizeof(blob), &decoded));
+    TEST_ASSERT_TRUE(wifi_cache_matches(&decoded, "home"));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(home_bssid, decoded.bssid, 6);
+    TEST_ASSERT_EQUAL_UINT8(11, decoded.channel);
+
+    // A full-length SSID has no terminator and still matches
+    wifi_cache_set(&cache, "0123456789abcdef0123456789abcdef", home_bssid, 1);
+    wifi_cache_encode(&cache, blob, sizeof(blob));
+    TEST_ASSERT_EQUAL(ESP_OK, wifi_cache_decode(blob, sizeof(blob), &decoded));
+    TEST_ASSERT_TRUE(wifi_cache_matches(&decoded, "0123456789abcdef0123456789abcdef"));
+
+    // Damage is reported without touching the output
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, wifi_cache_decode(blob, sizeof(blob) - 1, &decoded));
+    blob[WIFI_CACHE_BLOB_SIZE - 1] = 0; // No channel
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_VERSION, wifi_cache_decode(blob, sizeof(blob), &decoded));
+    blob[WIFI_CACHE_BLOB_SIZE - 1] = 1;
+    blob[2] = WIFI_CACHE_BLOB_VERSION + 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_VERSION, wifi_cache_decode(blob, sizeof(blob), &decoded));
+    TEST_ASSERT_EQUAL_UINT8(1, decoded.channel);
+}
+
+static bool on_flash(void) {
+    nvs_handle_t handle;
+    if (nvs_open(WIFI_CACHE_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false; // Namespace empty
+    }
+    size_t len = 0;
+    esp_err_t err = nvs_get_blob(handle, WIFI_CACHE_KEY, NULL, &len);
+    nvs_close(handle);
+    return err == ESP_OK;
+}
+
+static void erase_behind_its_back(void) {
+    nvs_handle_t handle;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open(WIFI_CACHE_NAMESPACE, NVS_READWRITE, &handle));
+    nvs_erase_key(handle, WIFI_CACHE_KEY);
+    nvs_commit(handle);
+    nvs_close(handle);
+}
+
+// Only the SSID it was learned for gets the cache, and reconnecting to the same AP
+// writes nothing
+void test_wifi_cache_store_skips_unchanged(void) {
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        TEST_ASSERT_EQUAL(ESP_OK, nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    wifi_cache_reset();
+    erase_behind_its_back();
+
+    wifi_cache_t cache, loaded;
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, wifi_cache_load("home", &loaded));
+    wifi_cache_set(&cache, "home", home_bssid, 6);
+    TEST_ASSERT_EQUAL(ESP_OK, wifi_cache_store(&cache));
+    TEST_ASSERT_EQUAL(ESP_OK, wifi_cache_load("home", &loaded));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(home_bssid, loaded.bssid, 6);
+    TEST_ASSERT_EQUAL_UINT8(6, loaded.channel);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, wifi_cache_load("office", &loaded));
+
+    erase_behind_its_back();
+    TEST_ASSERT_EQUAL(ESP_OK, wifi_cache_store(&cache)); // Same AP: no write
+    TEST_ASSERT_FALSE(on_flash());
+
+    wifi_cache_set(&cache, "home", home_bssid, 1); // AP moved channel
+    TEST_ASSERT_EQUAL(ESP_OK, wifi_cache_store(&cache));
+    TEST_ASSERT_TRUE(on_flash());
+    TEST_ASSERT_EQUAL(ESP_OK, wifi_cache_load("home", &loaded));
+    TEST_ASSERT_EQUAL_UINT8(1, loaded.channel);
+    erase_behind_its_back();
+}
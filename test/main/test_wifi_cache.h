@@ -0,0 +1,4 @@
+#pragma once
+
+void test_wifi_cache_blob_round_trip(void);
+void test_wifi_cache_store_skips_unchanged(void);
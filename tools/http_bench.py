@@ -0,0 +1,565 @@
+#!/usr/bin/env python3
+"""Load generator and latency benchmark for the device HTTP API.
+
+Drives ``/status``, ``/dial``, ``/redial``, ``/set_auto_redial`` and static
+file fetches from a pool of concurrent clients with a weighted request mix,
+against either the host build (``host/``, port 8080) or a real device.
+
+Each client is a closed loop: it sends a request, waits for the response,
+optionally sleeps ``--think-ms`` and goes again, reusing its keep-alive
+connection like a browser tab would. The report covers throughput,
+p50/p95/p99 latency per endpoint, HTTP error and 5xx rates, JSON
+``{"error": ...}`` replies, and socket-exhaustion events: connects that are
+refused or time out, and keep-alive connections the server drops before
+answering (the LRU purge kicking in once ``max_open_sockets`` is reached).
+
+With ``--control-port`` the ``dial``/``redial`` requests go to the separate
+control listener instead of the main port. ``--static-read-bps`` makes the
+static fetches read their response slowly, like a browser on a poor link,
+which ties up the server task sending to it. The ``asset_load`` and
+``asset_load_control`` profiles run the same slow-download load with dials on
+either port, so the two ``dial`` rows show what the control listener buys.
+
+Named profiles in ``bench_profiles.json`` pin the mix and concurrency so
+runs are comparable. ``--record`` writes the result, together with the
+``start_webserver`` settings parsed from ``main/main.c``, as a baseline
+under ``bench_baselines/``; ``--compare`` checks a fresh run against one
+and exits non-zero on a regression.
+
+Note that ``dial``/``redial`` queue real calls and ``set_auto_redial``
+rewrites the redial settings in NVS when pointed at a device.
+
+Usage:
+  http_bench.py --target 127.0.0.1:8080 --profile dashboard
+  http_bench.py --target 192.168.1.50 --mix status=8,static=2 -c 4 -d 30
+  http_bench.py --target 127.0.0.1:8080 --profile mixed --record host
+  http_bench.py --target 127.0.0.1:8080 --profile mixed --compare host
+  http_bench.py --target 127.0.0.1:8080 --profile asset_load_control --compare host
+"""
+
+import argparse
+import http.client
+import json
+import math
+import os
+import random
+import re
+import socket
+import sys
+import threading
+import time
+
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+PROFILES_PATH = os.path.join(TOOLS_DIR, "bench_profiles.json")
+BASELINE_DIR = os.path.join(TOOLS_DIR, "bench_baselines")
+MAIN_C_PATH = os.path.join(TOOLS_DIR, "..", "main", "main.c")
+
+# Bumped whenever the result layout changes so stale baselines are rejected
+RESULT_FORMAT = 1
+
+# Samples an endpoint needs in the baseline before its p95/p99 are compared; fewer is just noise
+MIN_SAMPLES_P95 = 20
+MIN_SAMPLES_P99 = 100
+
+# Body sent to /set_auto_redial; leaves auto redial off so the benchmark never starts calls by itself
+SET_AUTO_REDIAL_BODY = {"enabled": False, "period": 60, "random_delay": 0, "max_count": 0}
+
+DEFAULTS = {
+    "mix": {"status": 70, "static": 20, "set_auto_redial": 10},
+    "concurrency": 4,
+    "duration_s": 30.0,
+    "warmup_s": 3.0,
+    "think_ms": 0,
+    "timeout_s": 10.0,
+    "number": "123",
+    "static_paths": ["/"],
+    "keepalive": True,
+    "control_port": None,
+    "static_read_bps": 0,
+}
+
+ENDPOINTS = ("status", "dial", "redial", "set_auto_redial", "static")
+
+# Sent to the control listener instead of the main port when control_port is set
+CONTROL_ENDPOINTS = ("dial", "redial")
+
+# Receive buffer for throttled static fetches; small so the server really has to wait on us
+SLOW_READ_RCVBUF = 4096
+SLOW_READ_CHUNK = 1024
+
+
+def percentile(sorted_values, pct):
+    """Nearest-rank percentile; ``sorted_values`` must already be sorted."""
+    if not sorted_values:
+        return None
+    rank = max(1, math.ceil(pct / 100.0 * len(sorted_values)))
+    return sorted_values[rank - 1]
+
+
+def parse_mix(text):
+    mix = {}
+    for item in text.split(","):
+        name, sep, weight = item.partition("=")
+        name = name.strip()
+        if name not in ENDPOINTS or not sep:
+            raise ValueError("bad mix entry %r (expected one of %s with =weight)" % (item, ", ".join(ENDPOINTS)))
+        mix[name] = int(weight)
+    if sum(mix.values()) <= 0:
+        raise ValueError("mix weights must add up to more than zero")
+    return mix
+
+
+def parse_target(text):
+    host, sep, port = text.rpartition(":")
+    if not sep:
+        return text, 80
+    return host, int(port)
+
+
+def parse_server_config(path=MAIN_C_PATH):
+    """Pull the ``config.<field> = <value>;`` assignments out of start_webserver.
+
+    Fields not listed keep their HTTPD_DEFAULT_CONFIG value (e.g.
+    max_open_sockets = 7), so an added override shows up as a new key. The
+    control listener's settings (start_control_server) are prefixed with
+    ``control.``.
+    """
+    try:
+        with open(path, "r", encoding="utf-8") as f:
+            source = f.read()
+    except OSError:
+        return {}
+    config = {}
+    for function, prefix in (("start_webserver", ""), ("start_control_server", "control.")):
+        match = re.search(r"static httpd_handle_t %s\(void\)\s*\{(.*?)\n\}" % function, source, re.S)
+        if not match:
+            continue
+        for field, value in re.findall(r"^\s*config\.(\w+)\s*=\s*([^;]+);", match.group(1), re.M):
+            config[prefix + field] = value.strip()
+    return config
+
+
+class Stats:
+    """Per-endpoint counters shared by all client threads."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies_ms = {name: [] for name in ENDPOINTS}
+        self.status_codes = {name: {} for name in ENDPOINTS}
+        self.app_errors = {name: 0 for name in ENDPOINTS}
+        self.failures = {name: 0 for name in ENDPOINTS}
+        self.connect_refused = 0
+        self.connect_timeouts = 0
+        self.connections_dropped = 0
+        self.request_timeouts = 0
+        self.connections_opened = 0
+
+    def record(self, name, latency_ms, status, app_error):
+        with self.lock:
+            self.latencies_ms[name].append(latency_ms)
+            codes = self.status_codes[name]
+            codes[status] = codes.get(status, 0) + 1
+            if app_error:
+                self.app_errors[name] += 1
+
+    def bump(self, field, name=None):
+        with self.lock:
+            if name is None:
+                setattr(self, field, getattr(self, field) + 1)
+            else:
+                getattr(self, field)[name] += 1
+
+
+class Client(threading.Thread):
+    """One closed-loop client with its own keep-alive connection."""
+
+    def __init__(self, index, settings, stats, measuring, stop):
+        super().__init__(name="bench-%d" % index, daemon=True)
+        self.settings = settings
+        self.stats = stats
+        self.measuring = measuring
+        self.stop = stop
+        self.rng = random.Random(index)
+        # One keep-alive connection per port, as a browser tab and a script would have
+        self.conns = {}
+        # Handlers that answer with a JSON error return ESP_FAIL, which makes the server close the
+        # socket after the reply; the next request on it failing is expected rather than exhaustion
+        self.expect_close = {}
+
+        names = sorted(settings["mix"])
+        self.names = [n for n in names if settings["mix"][n] > 0]
+        self.weights = [settings["mix"][n] for n in self.names]
+
+    def pick_request(self):
+        name = self.rng.choices(self.names, self.weights)[0]
+        headers = {"Accept-Encoding": "gzip"}
+        if name == "status":
+            return name, "GET", "/status", None, headers
+        if name == "dial":
+            return name, "GET", "/dial?number=%s" % self.settings["number"], None, headers
+        if name == "redial":
+            return name, "GET", "/redial", None, headers
+        if name == "set_auto_redial":
+            headers["Content-Type"] = "application/json"
+            return name, "POST", "/set_auto_redial", json.dumps(SET_AUTO_REDIAL_BODY), headers
+        return name, "GET", self.rng.choice(self.settings["static_paths"]), None, headers
+
+    def port_for(self, name):
+        if self.settings["control_port"] and name in CONTROL_ENDPOINTS:
+            return self.settings["control_port"]
+        return self.settings["port"]
+
+    def connect(self, port, small_window):
+        conn = http.client.HTTPConnection(self.settings["host"], port, timeout=self.settings["timeout_s"])
+        try:
+            if small_window:
+                # The window is set before connecting so the server sees it from the start
+                sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+                sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, SLOW_READ_RCVBUF)
+                sock.settimeout(self.settings["timeout_s"])
+                sock.connect((self.settings["host"], port))
+                conn.sock = sock
+            else:
+                conn.connect()
+        except socket.timeout:
+            self.count("connect_timeouts")
+            return None
+        except OSError:
+            # Refused or reset: the accept backlog is full or the server is restarting
+            self.count("connect_refused")
+            return None
+        # The device answers small requests in one segment; don't let Nagle add delayed-ACK stalls
+        conn.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.count("connections_opened")
+        return conn
+
+    def count(self, field, name=None):
+        if self.measuring.is_set():
+            self.stats.bump(field, name)
+
+    def close(self, port=None):
+        for p in list(self.conns) if port is None else [port]:
+            conn = self.conns.pop(p, None)
+            if conn is not None:
+                conn.close()
+
+    def read_body(self, response, slow_read):
+        if not slow_read:
+            return response.read()
+        bps = self.settings["static_read_bps"]
+        chunks = []
+        while True:
+            chunk = response.read(SLOW_READ_CHUNK)
+            if not chunk:
+                return b"".join(chunks)
+            chunks.append(chunk)
+            time.sleep(len(chunk) / float(bps))
+
+    def run(self):
+        think_s = self.settings["think_ms"] / 1000.0
+        while not self.stop.is_set():
+            name, method, path, body, headers = self.pick_request()
+            port = self.port_for(name)
+            slow_read = name == "static" and self.settings["static_read_bps"] > 0
+            if port not in self.conns:
+                # Shared with the other main-port requests, so size the window for the slow reads
+                conn = self.connect(port, self.settings["static_read_bps"] > 0 and port == self.settings["port"])
+                if conn is None:
+                    time.sleep(0.05)  # Back off briefly instead of hammering a full accept queue
+                    continue
+                self.conns[port] = conn
+                self.expect_close[port] = False
+            conn = self.conns[port]
+
+            if not self.settings["keepalive"]:
+                headers["Connection"] = "close"
+            start = time.monotonic()
+            try:
+                conn.request(method, path, body=body, headers=headers)
+                response = conn.getresponse()
+                payload = self.read_body(response, slow_read)
+            except socket.timeout:
+                self.count("request_timeouts")
+                self.count("failures", name)
+                self.close(port)
+                continue
+            except (http.client.RemoteDisconnected, ConnectionResetError, BrokenPipeError,
+                    http.client.BadStatusLine):
+                if not self.expect_close[port]:
+                    self.count("connections_dropped")
+                self.close(port)
+                continue  # Retried on a fresh connection, as a browser would
+            latency_ms = (time.monotonic() - start) * 1000.0
+
+            app_error = False
+            if response.getheader("Content-Type", "").startswith("application/json") and payload:
+                try:
+                    app_error = "error" in json.loads(payload.decode("utf-8"))
+                except (ValueError, UnicodeDecodeError):
+                    pass
+            if self.measuring.is_set():
+                self.stats.record(name, latency_ms, response.status, app_error)
+
+            self.expect_close[port] = app_error or response.status >= 400
+            if not self.settings["keepalive"] or response.will_close:
+                self.close(port)
+            if think_s > 0:
+                time.sleep(think_s)
+        self.close()
+
+
+def summarize(stats, settings, elapsed_s):
+    endpoints = {}
+    total_requests = 0
+    total_http_errors = 0
+    total_5xx = 0
+    total_app_errors = 0
+    total_failures = 0
+    all_latencies = []
+    for name in ENDPOINTS:
+        latencies = sorted(stats.latencies_ms[name])
+        if not latencies and not stats.failures[name]:
+            continue
+        codes = stats.status_codes[name]
+        http_errors = sum(n for code, n in codes.items() if code >= 400)
+        errors_5xx = sum(n for code, n in codes.items() if code >= 500)
+        endpoints[name] = {
+            "requests": len(latencies),
+            "throughput_rps": round(len(latencies) / elapsed_s, 2),
+            "p50_ms": round(percentile(latencies, 50), 2) if latencies else None,
+            "p95_ms": round(percentile(latencies, 95), 2) if latencies else None,
+            "p99_ms": round(percentile(latencies, 99), 2) if latencies else None,
+            "max_ms": round(latencies[-1], 2) if latencies else None,
+            "status_codes": {str(code): n for code, n in sorted(codes.items())},
+            "http_errors": http_errors,
+            "errors_5xx": errors_5xx,
+            "app_errors": stats.app_errors[name],
+            "failures": stats.failures[name],
+        }
+        total_requests += len(latencies)
+        total_http_errors += http_errors
+        total_5xx += errors_5xx
+        total_app_errors += stats.app_errors[name]
+        total_failures += stats.failures[name]
+        all_latencies.extend(latencies)
+
+    all_latencies.sort()
+    attempted = total_requests + total_failures
+    return {
+        "format": RESULT_FORMAT,
+        "target": "%s:%d" % (settings["host"], settings["port"]),
+        "settings": {k: settings[k] for k in sorted(DEFAULTS)},
+        "elapsed_s": round(elapsed_s, 2),
+        "totals": {
+            "requests": total_requests,
+            "throughput_rps": round(total_requests / elapsed_s, 2),
+            "p50_ms": round(percentile(all_latencies, 50), 2) if all_latencies else None,
+            "p95_ms": round(percentile(all_latencies, 95), 2) if all_latencies else None,
+            "p99_ms": round(percentile(all_latencies, 99), 2) if all_latencies else None,
+            "error_rate": round(total_http_errors / attempted, 4) if attempted else 0.0,
+            "rate_5xx": round(total_5xx / attempted, 4) if attempted else 0.0,
+            "app_error_rate": round(total_app_errors / attempted, 4) if attempted else 0.0,
+            "failures": total_failures,
+        },
+        "sockets": {
+            "connections_opened": stats.connections_opened,
+            "connect_refused": stats.connect_refused,
+            "connect_timeouts": stats.connect_timeouts,
+            "connections_dropped": stats.connections_dropped,
+            "request_timeouts": stats.request_timeouts,
+            "exhaustion_events": stats.connect_refused + stats.connect_timeouts + stats.connections_dropped,
+        },
+        "endpoints": endpoints,
+    }
+
+
+def run(settings):
+    stats = Stats()
+    measuring = threading.Event()
+    stop = threading.Event()
+    clients = [Client(i, settings, stats, measuring, stop) for i in range(settings["concurrency"])]
+    for client in clients:
+        client.start()
+
+    time.sleep(settings["warmup_s"])
+    measuring.set()
+    start = time.monotonic()
+    time.sleep(settings["duration_s"])
+    measuring.clear()
+    elapsed_s = time.monotonic() - start
+    stop.set()
+    for client in clients:
+        client.join(settings["timeout_s"] + 1.0)
+    return summarize(stats, settings, elapsed_s)
+
+
+def print_report(result, out=sys.stderr):
+    def ms(value):
+        return "-" if value is None else "%.1f" % value
+
+    totals = result["totals"]
+    sockets = result["sockets"]
+    out.write("Target %s, %d clients, %.1f s measured\n" % (
+        result["target"], result["settings"]["concurrency"], result["elapsed_s"]))
+    if result["settings"].get("control_port"):
+        out.write("%s sent to control port %d\n" % ("/".join(CONTROL_ENDPOINTS), result["settings"]["control_port"]))
+    out.write("%-16s %8s %8s %8s %8s %8s %6s %6s %6s %6s\n" % (
+        "endpoint", "req", "req/s", "p50 ms", "p95 ms", "p99 ms", "err", "5xx", "app", "fail"))
+    for name, ep in sorted(result["endpoints"].items()):
+        out.write("%-16s %8d %8.1f %8s %8s %8s %6d %6d %6d %6d\n" % (
+            name, ep["requests"], ep["throughput_rps"], ms(ep["p50_ms"]), ms(ep["p95_ms"]), ms(ep["p99_ms"]),
+            ep["http_errors"], ep["errors_5xx"], ep["app_errors"], ep["failures"]))
+    out.write("%-16s %8d %8.1f %8s %8s %8s\n" % (
+        "total", totals["requests"], totals["throughput_rps"], ms(totals["p50_ms"]), ms(totals["p95_ms"]),
+        ms(totals["p99_ms"])))
+    out.write("Error rate %.2f%%, 5xx rate %.2f%%, JSON error replies %.2f%%\n" % (
+        100 * totals["error_rate"], 100 * totals["rate_5xx"], 100 * totals["app_error_rate"]))
+    out.write("Sockets: %d opened, %d refused, %d connect timeouts, %d dropped by server, %d request timeouts\n" % (
+        sockets["connections_opened"], sockets["connect_refused"], sockets["connect_timeouts"],
+        sockets["connections_dropped"], sockets["request_timeouts"]))
+
+
+def compare(result, baseline, tolerance):
+    """Return a list of human-readable regressions of ``result`` against ``baseline``."""
+    regressions = []
+    if baseline.get("format") != RESULT_FORMAT:
+        return ["baseline format %s does not match %d; re-record it" % (baseline.get("format"), RESULT_FORMAT)]
+
+    base_rps = baseline["totals"]["throughput_rps"]
+    if base_rps and result["totals"]["throughput_rps"] < base_rps * (1.0 - tolerance):
+        regressions.append("throughput %.1f req/s < baseline %.1f req/s" % (
+            result["totals"]["throughput_rps"], base_rps))
+
+    for name, base_ep in baseline["endpoints"].items():
+        ep = result["endpoints"].get(name)
+        if ep is None:
+            continue
+        for key, min_samples in (("p95_ms", MIN_SAMPLES_P95), ("p99_ms", MIN_SAMPLES_P99)):
+            if base_ep["requests"] < min_samples:
+                continue
+            if ep[key] is not None and base_ep[key] is not None and ep[key] > base_ep[key] * (1.0 + tolerance):
+                regressions.append("%s %s %.1f ms > baseline %.1f ms" % (name, key, ep[key], base_ep[key]))
+
+    for key in ("error_rate", "rate_5xx"):
+        # Rates start at zero, so allow a small absolute slack instead of a relative one
+        if result["totals"][key] > baseline["totals"][key] + 0.01:
+            regressions.append("%s %.4f > baseline %.4f" % (key, result["totals"][key], baseline["totals"][key]))
+    if result["sockets"]["exhaustion_events"] > baseline["sockets"]["exhaustion_events"]:
+        regressions.append("%d socket exhaustion events > baseline %d" % (
+            result["sockets"]["exhaustion_events"], baseline["sockets"]["exhaustion_events"]))
+
+    base_config = baseline.get("server_config", {})
+    current_config = parse_server_config()
+    for field in sorted(set(base_config) | set(current_config)):
+        if base_config.get(field) != current_config.get(field):
+            sys.stderr.write("Note: start_webserver config.%s changed: %s -> %s\n" % (
+                field, base_config.get(field, "(default)"), current_config.get(field, "(default)")))
+    return regressions
+
+
+def baseline_path(profile, name):
+    return os.path.join(BASELINE_DIR, "%s-%s.json" % (profile, name))
+
+
+def build_settings(args):
+    settings = dict(DEFAULTS)
+    if args.profile:
+        with open(PROFILES_PATH, "r", encoding="utf-8") as f:
+            profiles = json.load(f)
+        if args.profile not in profiles:
+            raise ValueError("unknown profile %r (have %s)" % (args.profile, ", ".join(sorted(profiles))))
+        settings.update({k: v for k, v in profiles[args.profile].items() if k != "description"})
+    if args.mix:
+        settings["mix"] = parse_mix(args.mix)
+    for key in ("concurrency", "duration_s", "warmup_s", "think_ms", "timeout_s", "number", "control_port",
+                "static_read_bps"):
+        value = getattr(args, key)
+        if value is not None:
+            settings[key] = value
+    if args.static_path:
+        settings["static_paths"] = args.static_path
+    if args.no_keepalive:
+        settings["keepalive"] = False
+    settings["host"], settings["port"] = parse_target(args.target)
+    return settings
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--target", required=True, help="host[:port] of the device or host build")
+    parser.add_argument("--profile", help="named settings from bench_profiles.json")
+    parser.add_argument("--mix", help="weighted request mix, e.g. status=70,static=20,dial=10")
+    parser.add_argument("-c", "--concurrency", type=int, help="number of concurrent clients")
+    parser.add_argument("-d", "--duration", dest="duration_s", type=float, help="measured seconds")
+    parser.add_argument("--warmup", dest="warmup_s", type=float, help="unmeasured seconds before measuring")
+    parser.add_argument("--think-ms", dest="think_ms", type=int, help="pause between a client's requests")
+    parser.add_argument("--timeout", dest="timeout_s", type=float, help="connect and response timeout")
+    parser.add_argument("--number", help="number passed to /dial")
+    parser.add_argument("--static-path", action="append", help="static asset to fetch (repeatable)")
+    parser.add_argument("--no-keepalive", action="store_true", help="open a new connection per request")
+    parser.add_argument("--control-port", dest="control_port", type=int,
+                        help="send dial/redial to this port (the control listener, 8081 by default)")
+    parser.add_argument("--static-read-bps", dest="static_read_bps", type=int,
+                        help="read static responses at this many bytes/s to mimic slow clients")
+    parser.add_argument("--json", metavar="PATH", help="also write the result as JSON ('-' for stdout)")
+    parser.add_argument("--record", metavar="NAME", help="save the result as the <profile>-NAME baseline")
+    parser.add_argument("--compare", metavar="NAME", help="fail if worse than the <profile>-NAME baseline")
+    parser.add_argument("--tolerance", type=float, default=0.25,
+                        help="allowed relative slowdown before --compare fails (default 0.25)")
+    args = parser.parse_args()
+
+    if (args.record or args.compare) and not args.profile:
+        parser.error("--record and --compare need --profile so runs use identical settings")
+    try:
+        settings = build_settings(args)
+    except (OSError, ValueError) as e:
+        parser.error(str(e))
+    baseline = None
+    if args.compare:
+        # Read before the run, so a missing baseline does not cost a full measurement.
+        # Exits 1, not 2: there is nothing to regress against.
+        path = baseline_path(args.profile, args.compare)
+        try:
+            with open(path, "r", encoding="utf-8") as f:
+                baseline = json.load(f)
+        except FileNotFoundError:
+            sys.stderr.write("No %s baseline at %s; record one first with --record %s\n" % (
+                args.profile, os.path.relpath(path), args.compare))
+            return 1
+        except (OSError, ValueError) as e:
+            sys.stderr.write("Cannot read %s: %s\n" % (os.path.relpath(path), e))
+            return 1
+
+    result = run(settings)
+    print_report(result)
+
+    if args.json == "-":
+        json.dump(result, sys.stdout, indent=2, sort_keys=True)
+        sys.stdout.write("\n")
+    elif args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump(result, f, indent=2, sort_keys=True)
+            f.write("\n")
+
+    if args.record:
+        result["profile"] = args.profile
+        result["server_config"] = parse_server_config()
+        os.makedirs(BASELINE_DIR, exist_ok=True)
+        path = baseline_path(args.profile, args.record)
+        with open(path, "w", encoding="utf-8") as f:
+            json.dump(result, f, indent=2, sort_keys=True)
+            f.write("\n")
+        sys.stderr.write("Baseline written to %s\n" % os.path.relpath(path))
+
+    if args.compare:
+        regressions = compare(result, baseline, args.tolerance)
+        for line in regressions:
+            sys.stderr.write("REGRESSION: %s\n" % line)
+        if regressions:
+            return 2
+        sys.stderr.write("No regressions against %s-%s\n" % (args.profile, args.compare))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
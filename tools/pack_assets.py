@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Pack the staged web assets into the image for the ``assets`` partition.
+
+Reads the staging directory written by ``prepare_spiffs_image.py`` (files,
+their precompressed ``.gz`` siblings and the ``.manifest``) and writes one
+read-only image that the firmware memory-maps and serves from directly. See
+``main/asset_pack.h`` for the layout; the two must stay in sync.
+
+Usage: pack_assets.py <staging_dir> <output_image> [--max-size BYTES]
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+# Must match main/asset_pack.h
+MAGIC = 0x50414852  # "RHAP"
+VERSION = 1
+HEADER_FORMAT = "<IHHIIIIII"
+ENTRY_FORMAT = "<IIIIIIIIII"
+FLAG_GZIP = 0x1
+
+# Must match MANIFEST_NAME in prepare_spiffs_image.py
+MANIFEST_NAME = ".manifest"
+
+# Same mapping as get_content_type() in main/main.c
+MIME_TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".json": "application/json",
+    ".map": "application/json",
+    ".svg": "image/svg+xml",
+    ".png": "image/png",
+    ".ico": "image/x-icon",
+    ".txt": "text/plain",
+}
+DEFAULT_MIME = "application/octet-stream"
+
+
+def fnv1a32(text):
+    h = 2166136261
+    for b in text.encode("utf-8"):
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def align4(n):
+    return (n + 3) & ~3
+
+
+class StringTable:
+    """NUL-terminated strings, each stored once."""
+
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, text):
+        if text not in self.offsets:
+            self.offsets[text] = len(self.data)
+            self.data += text.encode("utf-8") + b"\0"
+        return self.offsets[text]
+
+
+def read_manifest(staging_dir):
+    path = os.path.join(staging_dir, MANIFEST_NAME)
+    assets = []
+    with open(path, "r", encoding="utf-8") as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 3 and fields[0].startswith("/"):
+                assets.append((fields[0], fields[1], fields[2] == "1"))
+    return assets
+
+
+def pack(staging_dir):
+    assets = read_manifest(staging_dir)
+    assets.sort(key=lambda a: (fnv1a32(a[0]), a[0]))
+
+    strings = StringTable()
+    blobs = []  # (entry index, is_gzip, bytes)
+    records = []
+    for uri_path, content_hash, has_gzip in assets:
+        local = os.path.join(staging_dir, uri_path.lstrip("/"))
+        with open(local, "rb") as f:
+            data = f.read()
+        gz = None
+        if has_gzip:
+            with open(local + ".gz", "rb") as f:
+                gz = f.read()
+        ext = os.path.splitext(uri_path)[1].lower()
+        records.append({
+            "hash": fnv1a32(uri_path),
+            "path": strings.add(uri_path),
+            "mime": strings.add(MIME_TYPES.get(ext, DEFAULT_MIME)),
+            "etag": strings.add('"%s"' % content_hash),
+            "etag_gzip": strings.add('"%s-gz"' % content_hash),
+            "flags": FLAG_GZIP if gz is not None else 0,
+        })
+        blobs.append((len(records) - 1, False, data))
+        if gz is not None:
+            blobs.append((len(records) - 1, True, gz))
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    entry_size = struct.calcsize(ENTRY_FORMAT)
+    strings_offset = header_size + entry_size * len(records)
+    strings_size = align4(len(strings.data))
+    string_bytes = bytes(strings.data) + b"\0" * (strings_size - len(strings.data))
+
+    data = bytearray()
+    data_offset = strings_offset + strings_size
+    for index, is_gzip, blob in blobs:
+        offset = data_offset + len(data)
+        if is_gzip:
+            records[index]["gzip_offset"], records[index]["gzip_len"] = offset, len(blob)
+        else:
+            records[index]["data_offset"], records[index]["data_len"] = offset, len(blob)
+        data += blob + b"\0" * (align4(len(blob)) - len(blob))
+
+    index = b"".join(struct.pack(ENTRY_FORMAT, r["hash"], r["path"], r["mime"], r["etag"], r["etag_gzip"],
+                                 r["flags"], r["data_offset"], r["data_len"],
+                                 r.get("gzip_offset", 0), r.get("gzip_len", 0)) for r in records)
+    total_size = data_offset + len(data)
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, header_size, len(records), entry_size,
+                         strings_offset, strings_size, total_size, zlib.crc32(index + string_bytes))
+    return header + index + string_bytes + bytes(data), len(records)
+
+
+def write_if_changed(dst, data):
+    if os.path.exists(dst):
+        with open(dst, "rb") as f:
+            if f.read() == data:
+                return
+    with open(dst, "wb") as f:
+        f.write(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack staged web assets into an asset partition image")
+    parser.add_argument("staging_dir")
+    parser.add_argument("output")
+    parser.add_argument("--max-size", type=lambda v: int(v, 0), default=0,
+                        help="fail if the image exceeds this many bytes (the partition size)")
+    args = parser.parse_args()
+
+    if not os.path.isfile(os.path.join(args.staging_dir, MANIFEST_NAME)):
+        print("No %s in %s; run prepare_spiffs_image.py first" % (MANIFEST_NAME, args.staging_dir))
+        return 1
+    image, count = pack(args.staging_dir)
+    if args.max_size and len(image) > args.max_size:
+        print("Asset image is %d bytes, partition holds %d" % (len(image), args.max_size))
+        return 1
+    write_if_changed(args.output, image)
+    print("Asset pack: %d files, %d bytes" % (count, len(image)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
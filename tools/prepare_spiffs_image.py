@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Stage the SPIFFS image contents for the firmware build.
+
+Mirrors the source ``spiffs`` directory (the React build output) into a
+staging directory inside the build tree and writes a precompressed ``.gz``
+sibling next to every compressible asset. The firmware picks the ``.gz``
+variant when the browser sends ``Accept-Encoding: gzip``.
+
+A ``.manifest`` file is written at the root of the image with one line per
+asset: ``<uri path> <content hash> <has .gz sibling>``. The firmware loads it
+once at boot to answer ``If-None-Match`` revalidations without touching the
+asset files themselves.
+
+Usage: prepare_spiffs_image.py <source_dir> <staging_dir>
+"""
+
+import gzip
+import hashlib
+import os
+import sys
+
+# Text-like assets that compress well; images and fonts are already compressed
+COMPRESSIBLE_EXTENSIONS = {
+    ".html", ".js", ".css", ".json", ".map", ".svg", ".txt", ".ico",
+}
+
+# Skip tiny files where gzip framing overhead outweighs the savings
+MIN_COMPRESS_SIZE = 256
+
+# Only keep the .gz sibling when it saves at least this fraction of the bytes
+MIN_SAVING_RATIO = 0.10
+
+# Must match ASSET_MANIFEST_FILENAME in main/asset_manifest.h
+MANIFEST_NAME = ".manifest"
+
+# Hex digits of SHA-256 kept for the ETag; 64 bits is plenty for a few dozen files
+HASH_HEX_LEN = 16
+
+
+def should_compress(path):
+    _, ext = os.path.splitext(path)
+    return ext.lower() in COMPRESSIBLE_EXTENSIONS and os.path.getsize(path) >= MIN_COMPRESS_SIZE
+
+
+def write_if_changed(dst, data):
+    if os.path.exists(dst):
+        with open(dst, "rb") as f:
+            if f.read() == data:
+                return False
+    with open(dst, "wb") as f:
+        f.write(data)
+    return True
+
+
+def stage(src_root, dst_root):
+    expected = set()
+    manifest = []
+    raw_total = 0
+    wire_total = 0
+
+    for dirpath, _, filenames in os.walk(src_root):
+        rel_dir = os.path.relpath(dirpath, src_root)
+        out_dir = os.path.normpath(os.path.join(dst_root, rel_dir))
+        os.makedirs(out_dir, exist_ok=True)
+
+        for name in sorted(filenames):
+            if name.endswith(".gz") or name == MANIFEST_NAME:
+                continue  # Never double-compress stale artifacts
+            src = os.path.join(dirpath, name)
+            dst = os.path.join(out_dir, name)
+            with open(src, "rb") as f:
+                data = f.read()
+            write_if_changed(dst, data)
+            expected.add(os.path.normpath(dst))
+            raw_total += len(data)
+
+            uri_path = "/" + os.path.relpath(src, src_root).replace(os.sep, "/")
+            content_hash = hashlib.sha256(data).hexdigest()[:HASH_HEX_LEN]
+            has_gzip = False
+
+            if not should_compress(src):
+                wire_total += len(data)
+                manifest.append((uri_path, content_hash, has_gzip))
+                continue
+
+            # mtime=0 keeps the output byte-identical between builds
+            compressed = gzip.compress(data, compresslevel=9, mtime=0)
+            if len(compressed) <= len(data) * (1.0 - MIN_SAVING_RATIO):
+                write_if_changed(dst + ".gz", compressed)
+                expected.add(os.path.normpath(dst + ".gz"))
+                wire_total += len(compressed)
+                has_gzip = True
+            else:
+                wire_total += len(data)
+            manifest.append((uri_path, content_hash, has_gzip))
+
+    manifest_path = os.path.join(dst_root, MANIFEST_NAME)
+    lines = ["%s %s %d\n" % (path, h, 1 if gz else 0) for path, h, gz in sorted(manifest)]
+    write_if_changed(manifest_path, "".join(lines).encode("utf-8"))
+    expected.add(os.path.normpath(manifest_path))
+
+    # Drop anything left over from a previous build that no longer exists
+    for dirpath, _, filenames in os.walk(dst_root):
+        for name in filenames:
+            path = os.path.normpath(os.path.join(dirpath, name))
+            if path not in expected:
+                os.remove(path)
+
+    print("SPIFFS staging: %d bytes raw, %d bytes on the wire with gzip" % (raw_total, wire_total))
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        return 1
+    src_root, dst_root = sys.argv[1], sys.argv[2]
+    if not os.path.isdir(src_root):
+        print("Source directory not found: %s" % src_root)
+        return 1
+    os.makedirs(dst_root, exist_ok=True)
+    stage(src_root, dst_root)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())